@@ -0,0 +1,402 @@
+/*
+ *
+ * Classification of always constructs into sequential and combinational logic.
+ *
+*/
+
+#include <vector>
+
+#include "AlwaysClassifier.h" // AlwaysClassifier class definition
+#include "UclidVisitor.h"   // Constant labels and selector widths
+
+#include "Array.h"          // Make dynamic array class Array available
+#include "Set.h"            // Make associated hash table class Set available
+
+#include "VeriVisitor.h"    // Visitor base class definition
+#include "VeriId.h"         // Definitions of all identifier definition tree nodes
+#include "VeriExpression.h" // Definitions of all verilog expression tree nodes
+#include "VeriModuleItem.h" // Definitions of all verilog module item tree nodes
+#include "VeriStatement.h"  // Definitions of all verilog statement tree nodes
+#include "VeriMisc.h"       // Definitions of all extraneous verilog tree nodes (ie. range, path, strength, etc...)
+#include "veri_tokens.h"
+
+#ifdef VERIFIC_NAMESPACE
+using namespace Verific ;
+#endif
+
+// The signals an expression reads
+class ReadCollector : public VeriVisitor
+{
+public:
+    explicit ReadCollector(Array &ids) : VeriVisitor(), _ids(ids) { }
+    virtual ~ReadCollector() { }
+
+    virtual void VERI_VISIT(VeriIdRef, node)
+    {
+        VeriIdDef *id = node.GetId() ;
+        if (!id || id->IsParam() || id->IsGenVar() || id->IsFunction() || id->IsTask()) return ;
+        _ids.InsertLast(id) ;
+    }
+
+private:
+    Array   &_ids ;
+} ;
+
+// 'to' = the targets in 'from'
+static void CopyAssigned(const Array &targets, const Set &from, Set &to)
+{
+    to.Reset() ;
+    unsigned i ;
+    VeriIdDef *id ;
+    FOREACH_ARRAY_ITEM(&targets, i, id) {
+        if (from.Get(id)) (void) to.Insert(id) ;
+    }
+}
+
+// Remove from 'assigned' what 'other' does not assign
+static void KeepCommon(const Array &targets, Set &assigned, const Set &other)
+{
+    unsigned i ;
+    VeriIdDef *id ;
+    FOREACH_ARRAY_ITEM(&targets, i, id) {
+        if (!other.Get(id)) (void) assigned.Remove(id) ;
+    }
+}
+
+/*-----------------------------------------------------------------*/
+//                      Constructor / Destructor
+/*-----------------------------------------------------------------*/
+
+AlwaysClassifier::AlwaysClassifier(const VeriAlwaysConstruct &always)
+    : _kind(ALWAYS_OTHER),
+      _targets(),
+      _target_set(POINTER_HASH),
+      _sensitivity(POINTER_HASH),
+      _reads(POINTER_HASH),
+      _implicit(0),
+      _incomplete(0),
+      _read_early(0)
+{
+    VeriStatement *stmt = always.GetStmt() ;
+    if (!stmt || (stmt->GetClassId() != ID_VERIEVENTCONTROLSTATEMENT)) {
+        // always #10 ..., or event controls inside the body : not logic we classify
+        (void) CollectTargets(stmt) ;
+        return ;
+    }
+    VeriEventControlStatement *control = static_cast<VeriEventControlStatement*>(stmt) ;
+    VeriStatement *body = control->GetStmt() ;
+
+    unsigned edges = 0 ;
+    unsigned levels = 0 ;
+    unsigned i ;
+    VeriExpression *event ;
+    FOREACH_ARRAY_ITEM(control->GetAt(), i, event) {
+        if (!event) continue ;
+        VeriExpression *expr = event ;
+        if (event->GetClassId() == ID_VERIEVENTEXPRESSION) {
+            VeriEventExpression *edge = static_cast<VeriEventExpression*>(event) ;
+            if ((edge->GetEdgeToken() == VERI_POSEDGE) || (edge->GetEdgeToken() == VERI_NEGEDGE)) {
+                edges++ ;
+                continue ;
+            }
+            expr = edge->GetExpr() ;
+        }
+        levels++ ;
+        VeriIdDef *id = (expr) ? expr->GetId() : 0 ;
+        if (id) (void) _sensitivity.Insert(id) ;
+    }
+    _implicit = (levels || edges) ? 0 : 1 ; // @* has no event list
+
+    unsigned computable = CollectTargets(body) ;
+    if (edges) {
+        // Flip-flops. Edges mixed with levels are left alone.
+        _kind = (levels) ? ALWAYS_OTHER : ALWAYS_SEQUENTIAL ;
+        return ;
+    }
+
+    Set assigned(POINTER_HASH) ;
+    Scan(body, assigned) ;
+    unsigned complete = (assigned.Size() == _targets.Size()) ? 1 : 0 ;
+
+    // Level sensitive : logic, unless something must hold its value
+    _kind = (computable && complete && _targets.Size() && !_incomplete && !_read_early) ? ALWAYS_COMBINATIONAL : ALWAYS_LATCH ;
+}
+
+AlwaysClassifier::~AlwaysClassifier()
+{
+}
+
+// static
+const char *AlwaysClassifier::KindName(Kind kind)
+{
+    switch (kind) {
+    case ALWAYS_SEQUENTIAL :    return "sequential" ;
+    case ALWAYS_COMBINATIONAL : return "combinational" ;
+    case ALWAYS_LATCH :         return "latch" ;
+    default :                   return "other" ;
+    }
+}
+
+// static
+unsigned AlwaysClassifier::FullCase(const VeriCaseStatement &case_stmt)
+{
+    // Selectors up to 16 bits wide, of a signal or a constant part of it
+    VeriIdDef *id ;
+    unsigned lo, hi ;
+    if (!UclidVisitor::TargetBits(case_stmt.GetCondition(), id, lo, hi) || (hi - lo >= 16)) return 0 ;
+    unsigned long long values = 1ULL << (hi - lo + 1) ;
+
+    std::vector<unsigned char> seen((size_t)values, 0) ;
+    unsigned long long covered = 0 ;
+    unsigned i, j ;
+    VeriCaseItem *item ;
+    VeriExpression *label ;
+    FOREACH_ARRAY_ITEM(case_stmt.GetCaseItems(), i, item) {
+        if (!item) continue ;
+        FOREACH_ARRAY_ITEM(item->GetConditions(), j, label) {
+            long long value ;
+            if (!UclidVisitor::EvalConst(label, value) || (value < 0) || ((unsigned long long)value >= values)) continue ;
+            if (!seen[(size_t)value]) covered++ ;
+            seen[(size_t)value] = 1 ;
+        }
+    }
+    return (covered == values) ? 1 : 0 ;
+}
+
+/*-----------------------------------------------------------------*/
+//                            Analysis
+/*-----------------------------------------------------------------*/
+
+unsigned AlwaysClassifier::CollectTargets(const VeriStatement *stmt)
+{
+    if (!stmt) return 1 ;
+
+    unsigned computable = 1 ;
+    unsigned i ;
+    VeriStatement *sub ;
+    switch (stmt->GetClassId()) {
+    case ID_VERISEQBLOCK :
+        FOREACH_ARRAY_ITEM(static_cast<const VeriSeqBlock*>(stmt)->GetStatements(), i, sub) {
+            if (!CollectTargets(sub)) computable = 0 ;
+        }
+        return computable ;
+
+    case ID_VERIPARBLOCK :
+        FOREACH_ARRAY_ITEM(static_cast<const VeriParBlock*>(stmt)->GetStatements(), i, sub) {
+            if (!CollectTargets(sub)) computable = 0 ;
+        }
+        return computable ;
+
+    case ID_VERIBLOCKINGASSIGN :
+    case ID_VERINONBLOCKINGASSIGN :
+    {
+        VeriExpression *lval = (stmt->GetClassId() == ID_VERIBLOCKINGASSIGN) ?
+            static_cast<const VeriBlockingAssign*>(stmt)->GetLVal() : static_cast<const VeriNonBlockingAssign*>(stmt)->GetLVal() ;
+        if (!lval) return 0 ;
+
+        // Whole identifiers only : bits, words and concatenations are not computed
+        Array lvals ;
+        if (lval->GetClassId() == ID_VERICONCAT) {
+            lvals.Append(static_cast<VeriConcat*>(lval)->GetExpressions()) ;
+            computable = 0 ;
+        } else {
+            lvals.InsertLast(lval) ;
+        }
+        VeriExpression *target ;
+        FOREACH_ARRAY_ITEM(&lvals, i, target) {
+            VeriIdDef *id = (target) ? target->GetId() : 0 ;
+            if (!id) {
+                computable = 0 ;
+                continue ;
+            }
+            // Bit and part-selects are computed from the rest of the value
+            if (((target->GetClassId() != ID_VERIIDREF) && (target->GetClassId() != ID_VERIINDEXEDID)) || id->IsMemory()) computable = 0 ;
+            // Integers (loop counters) are not signals of the model
+            if (UclidVisitor::IsInteger(id)) continue ;
+            if (_target_set.Insert(id)) _targets.InsertLast(id) ;
+        }
+        return computable ;
+    }
+
+    case ID_VERIFOR :
+    {
+        // Unrolled when the trip count is constant (see UclidStmtVisitor)
+        const VeriFor *loop = static_cast<const VeriFor*>(stmt) ;
+        VeriModuleItem *item ;
+        FOREACH_ARRAY_ITEM(loop->GetInitials(), i, item) {
+            if (!item || (item->GetClassId() != ID_VERIBLOCKINGASSIGN) || !CollectTargets(static_cast<VeriStatement*>(item))) computable = 0 ;
+        }
+        FOREACH_ARRAY_ITEM(loop->GetRepetitions(), i, item) {
+            if (!item || (item->GetClassId() != ID_VERIBLOCKINGASSIGN) || !CollectTargets(static_cast<VeriStatement*>(item))) computable = 0 ;
+        }
+        if (!CollectTargets(loop->GetStmt())) computable = 0 ;
+        return computable ;
+    }
+
+    case ID_VERIWHILE :
+    case ID_VERIREPEAT :
+        return CollectTargets(static_cast<const VeriLoop*>(stmt)->GetStmt()) ;
+
+    case ID_VERICONDITIONALSTATEMENT :
+    {
+        const VeriConditionalStatement *cond = static_cast<const VeriConditionalStatement*>(stmt) ;
+        if (!CollectTargets(cond->GetThenStmt())) computable = 0 ;
+        if (!CollectTargets(cond->GetElseStmt())) computable = 0 ;
+        return computable ;
+    }
+
+    case ID_VERICASESTATEMENT :
+    {
+        VeriCaseItem *item ;
+        FOREACH_ARRAY_ITEM(static_cast<const VeriCaseStatement*>(stmt)->GetCaseItems(), i, item) {
+            if (item && !CollectTargets(item->GetStmt())) computable = 0 ;
+        }
+        return computable ;
+    }
+
+    case ID_VERIEVENTCONTROLSTATEMENT :
+        (void) CollectTargets(static_cast<const VeriEventControlStatement*>(stmt)->GetStmt()) ;
+        return 0 ;
+
+    case ID_VERISYSTEMTASKENABLE :
+    case ID_VERINULLSTATEMENT :
+        return 1 ;
+
+    default :
+        return 0 ;
+    }
+}
+
+void AlwaysClassifier::Read(const VeriExpression *expr, const Set &assigned)
+{
+    if (!expr) return ;
+    Array ids ;
+    ReadCollector reads(ids) ;
+    const_cast<VeriExpression*>(expr)->Accept(reads) ;
+
+    unsigned i ;
+    VeriIdDef *id ;
+    FOREACH_ARRAY_ITEM(&ids, i, id) {
+        if (UclidVisitor::IsInteger(id)) continue ;
+        if (_target_set.Get(id)) {
+            if (!assigned.Get(id)) _read_early = 1 ;
+        } else {
+            (void) _reads.Insert(id) ;
+            if (!_implicit && !_sensitivity.Get(id)) _incomplete = 1 ;
+        }
+    }
+}
+
+void AlwaysClassifier::Scan(const VeriStatement *stmt, Set &assigned)
+{
+    if (!stmt) return ;
+
+    unsigned i ;
+    VeriStatement *sub ;
+    switch (stmt->GetClassId()) {
+    case ID_VERISEQBLOCK :
+        FOREACH_ARRAY_ITEM(static_cast<const VeriSeqBlock*>(stmt)->GetStatements(), i, sub) Scan(sub, assigned) ;
+        break ;
+
+    case ID_VERIPARBLOCK :
+        FOREACH_ARRAY_ITEM(static_cast<const VeriParBlock*>(stmt)->GetStatements(), i, sub) Scan(sub, assigned) ;
+        break ;
+
+    case ID_VERIBLOCKINGASSIGN :
+    case ID_VERINONBLOCKINGASSIGN :
+    {
+        unsigned blocking = (stmt->GetClassId() == ID_VERIBLOCKINGASSIGN) ;
+        VeriExpression *lval = (blocking) ? static_cast<const VeriBlockingAssign*>(stmt)->GetLVal() : static_cast<const VeriNonBlockingAssign*>(stmt)->GetLVal() ;
+        Read((blocking) ? static_cast<const VeriBlockingAssign*>(stmt)->GetValue() : static_cast<const VeriNonBlockingAssign*>(stmt)->GetValue(), assigned) ;
+        // A bit or part-select keeps the other bits : it reads the target
+        if (lval && (lval->GetClassId() == ID_VERIINDEXEDID)) Read(lval, assigned) ;
+        VeriIdDef *id = (lval && (lval->GetClassId() == ID_VERIIDREF)) ? lval->GetId() : 0 ;
+        if (id) (void) assigned.Insert(id) ;
+        break ;
+    }
+
+    case ID_VERIFOR :
+    {
+        const VeriFor *loop = static_cast<const VeriFor*>(stmt) ;
+        VeriModuleItem *item ;
+        FOREACH_ARRAY_ITEM(loop->GetInitials(), i, item) {
+            if (item && (item->GetClassId() == ID_VERIBLOCKINGASSIGN)) Scan(static_cast<VeriStatement*>(item), assigned) ;
+        }
+        Read(loop->GetCondition(), assigned) ;
+        // The body may run no times : what it assigns is not assigned after the loop
+        Set body_assigned(POINTER_HASH) ;
+        CopyAssigned(_targets, assigned, body_assigned) ;
+        Scan(loop->GetStmt(), body_assigned) ;
+        FOREACH_ARRAY_ITEM(loop->GetRepetitions(), i, item) {
+            if (item && (item->GetClassId() == ID_VERIBLOCKINGASSIGN)) Scan(static_cast<VeriStatement*>(item), body_assigned) ;
+        }
+        break ;
+    }
+
+    case ID_VERIWHILE :
+    case ID_VERIREPEAT :
+    {
+        Read((stmt->GetClassId() == ID_VERIWHILE) ? static_cast<const VeriWhile*>(stmt)->GetCondition() : static_cast<const VeriRepeat*>(stmt)->GetCondition(), assigned) ;
+        Set body_assigned(POINTER_HASH) ;
+        CopyAssigned(_targets, assigned, body_assigned) ;
+        Scan(static_cast<const VeriLoop*>(stmt)->GetStmt(), body_assigned) ;
+        break ;
+    }
+
+    case ID_VERICONDITIONALSTATEMENT :
+    {
+        const VeriConditionalStatement *cond = static_cast<const VeriConditionalStatement*>(stmt) ;
+        Read(cond->GetIfExpr(), assigned) ;
+        Set then_assigned(POINTER_HASH) ;
+        Set else_assigned(POINTER_HASH) ;
+        CopyAssigned(_targets, assigned, then_assigned) ;
+        CopyAssigned(_targets, assigned, else_assigned) ;
+        Scan(cond->GetThenStmt(), then_assigned) ;
+        Scan(cond->GetElseStmt(), else_assigned) ;
+        // Assigned after the if : assigned in both branches
+        KeepCommon(_targets, then_assigned, else_assigned) ;
+        CopyAssigned(_targets, then_assigned, assigned) ;
+        break ;
+    }
+
+    case ID_VERICASESTATEMENT :
+    {
+        const VeriCaseStatement *case_stmt = static_cast<const VeriCaseStatement*>(stmt) ;
+        Read(case_stmt->GetCondition(), assigned) ;
+
+        // Assigned after the case : assigned by every item, and there is a default
+        Set common(POINTER_HASH) ;
+        unsigned has_default = 0 ;
+        unsigned first = 1 ;
+        VeriCaseItem *item ;
+        FOREACH_ARRAY_ITEM(case_stmt->GetCaseItems(), i, item) {
+            if (!item) continue ;
+            unsigned j ;
+            VeriExpression *label ;
+            FOREACH_ARRAY_ITEM(item->GetConditions(), j, label) Read(label, assigned) ;
+            if (!item->GetConditions()) has_default = 1 ;
+
+            Set item_assigned(POINTER_HASH) ;
+            CopyAssigned(_targets, assigned, item_assigned) ;
+            Scan(item->GetStmt(), item_assigned) ;
+            if (first) {
+                CopyAssigned(_targets, item_assigned, common) ;
+                first = 0 ;
+            } else {
+                KeepCommon(_targets, common, item_assigned) ;
+            }
+        }
+        if (has_default || FullCase(*case_stmt)) CopyAssigned(_targets, common, assigned) ;
+        break ;
+    }
+
+    case ID_VERIEVENTCONTROLSTATEMENT :
+        Scan(static_cast<const VeriEventControlStatement*>(stmt)->GetStmt(), assigned) ;
+        break ;
+
+    default :
+        break ;
+    }
+}
+
+/*---------------------------------------------*/
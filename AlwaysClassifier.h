@@ -0,0 +1,84 @@
+/*
+ *
+ * Classification of always constructs into sequential and combinational logic.
+ *
+ * An always construct is sequential when its event control has edges
+ * (@(posedge clk ...)). It is combinational when it is level sensitive to
+ * everything it reads (@* or a complete list), and every reg it assigns is
+ * assigned on every path through it, before the reg is read. The regs of a
+ * combinational block hold no state : UCLID can compute them instead of
+ * keeping them as variables. Any other level sensitive block infers latches.
+ *
+*/
+#ifndef _VERIFIC_ALWAYS_CLASSIFIER_H_
+#define _VERIFIC_ALWAYS_CLASSIFIER_H_
+
+#include "Array.h"          // Make dynamic array class Array available
+#include "Set.h"            // Make associated hash table class Set available
+
+#ifdef VERIFIC_NAMESPACE
+namespace Verific { // start definitions in verific namespace
+#endif
+
+class VeriAlwaysConstruct ;
+class VeriStatement ;
+class VeriExpression ;
+class VeriCaseStatement ;
+
+/* -------------------------------------------------------------------------- */
+
+class AlwaysClassifier
+{
+public:
+    enum Kind { ALWAYS_SEQUENTIAL, ALWAYS_COMBINATIONAL, ALWAYS_LATCH, ALWAYS_OTHER } ;
+
+    explicit AlwaysClassifier(const VeriAlwaysConstruct &always) ;
+    ~AlwaysClassifier() ;
+
+    Kind GetKind() const                { return _kind ; }
+    static const char *KindName(Kind kind) ;
+
+    // The identifiers the block assigns (VeriIdDef*), in order of first assignment
+    const Array &Targets() const        { return _targets ; }
+
+    // The other identifiers it reads (VeriIdDef*)
+    const Set &Reads() const            { return _reads ; }
+
+    // Every value of the case selector has an item with a constant label,
+    // so a case without default still assigns on every path
+    static unsigned FullCase(const VeriCaseStatement &case_stmt) ;
+
+private:
+    // Collect the targets of 'stmt'. Returns 0 on statements a value can not be
+    // computed for (memory assignments, timing ...). Integers are not targets.
+    unsigned CollectTargets(const VeriStatement *stmt) ;
+
+    // Walk 'stmt' in execution order. 'assigned' holds the targets assigned on
+    // every path so far.
+    void Scan(const VeriStatement *stmt, Set &assigned) ;
+
+    // Note the identifiers 'expr' reads
+    void Read(const VeriExpression *expr, const Set &assigned) ;
+
+private:
+    Kind     _kind ;
+    Array    _targets ;         // VeriIdDef*
+    Set      _target_set ;      // VeriIdDef*, the same
+    Set      _sensitivity ;     // VeriIdDef* of the level event list
+    Set      _reads ;           // VeriIdDef* read, other than the targets
+    unsigned _implicit ;        // @* : sensitive to everything read
+    unsigned _incomplete ;      // Reads something not in the event list
+    unsigned _read_early ;      // Reads a target before it is assigned on every path
+
+    // Prevent the compiler from implementing the following
+    AlwaysClassifier(const AlwaysClassifier &node) ;
+    AlwaysClassifier& operator=(const AlwaysClassifier &rhs) ;
+} ;
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef VERIFIC_NAMESPACE
+} // end definitions in verific namespace
+#endif
+
+#endif // #ifndef _VERIFIC_ALWAYS_CLASSIFIER_H_
@@ -0,0 +1,179 @@
+/*
+ *
+ * Output stream buffer written to disk by a background thread.
+ *
+*/
+
+#include <cerrno>           // errno
+#include <chrono>           // steady_clock
+#include <cstring>          // strerror
+
+#include <unistd.h>         // write
+
+#include "AsyncWriter.h"    // AsyncWriter class definition
+
+#include "Message.h"        // Make message handlers available
+
+#ifdef VERIFIC_NAMESPACE
+using namespace Verific ;
+#endif
+
+static double Seconds(std::chrono::steady_clock::time_point since)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - since).count() ;
+}
+
+/*-----------------------------------------------------------------*/
+//                      Constructor / Destructor
+/*-----------------------------------------------------------------*/
+
+AsyncWriter::AsyncWriter(int fd, unsigned long buffer_size, unsigned num_buffers)
+    : std::streambuf(),
+      _fd(fd),
+      _buffer_size((buffer_size) ? buffer_size : ASYNC_WRITER_BUFFER_SIZE),
+      _num_buffers((num_buffers < 2) ? 2 : num_buffers),
+      _data(0),
+      _sizes(0),
+      _head(0),
+      _tail(0),
+      _closing(false),
+      _error(0),
+      _mutex(),
+      _moved(),
+      _writer(),
+      _bytes(0),
+      _stalls(0),
+      _stall_seconds(0.0),
+      _drain_seconds(0.0),
+      _write_seconds(0.0)
+{
+    _data = new char[_buffer_size * _num_buffers] ;
+    _sizes = new unsigned long[_num_buffers] ;
+
+    setp(_data, _data + _buffer_size) ;
+    _writer = std::thread(&AsyncWriter::Run, this) ;
+}
+
+AsyncWriter::~AsyncWriter()
+{
+    (void) Close() ;
+    delete [] _data ;
+    delete [] _sizes ;
+}
+
+/*-----------------------------------------------------------------*/
+//                             Producer
+/*-----------------------------------------------------------------*/
+
+unsigned AsyncWriter::HandOver()
+{
+    unsigned long long head = _head.load(std::memory_order_relaxed) ;
+    unsigned long used = (unsigned long)(pptr() - pbase()) ;
+    if (used) {
+        _sizes[head % _num_buffers] = used ;
+        _bytes += used ;
+        _head.store(++head, std::memory_order_release) ;
+        Notify() ;
+    }
+
+    // Backpressure : every buffer is waiting for the writer
+    if (head - _tail.load(std::memory_order_acquire) >= _num_buffers) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now() ;
+        std::unique_lock<std::mutex> lock(_mutex) ;
+        while ((head - _tail.load(std::memory_order_acquire) >= _num_buffers) && !_error.load()) _moved.wait(lock) ;
+        _stall_seconds += Seconds(start) ;
+        _stalls++ ;
+    }
+
+    char *next = _data + (head % _num_buffers) * _buffer_size ;
+    setp(next, next + _buffer_size) ;
+    return (_error.load()) ? 0 : 1 ;
+}
+
+AsyncWriter::int_type AsyncWriter::overflow(int_type ch)
+{
+    if (!_writer.joinable() || !HandOver()) return traits_type::eof() ;
+    if (traits_type::eq_int_type(ch, traits_type::eof())) return traits_type::not_eof(ch) ;
+    *pptr() = traits_type::to_char_type(ch) ;
+    pbump(1) ;
+    return ch ;
+}
+
+int AsyncWriter::sync()
+{
+    // The buffer is written when it is full, or on Close
+    return (_error.load()) ? -1 : 0 ;
+}
+
+unsigned AsyncWriter::Close()
+{
+    if (_writer.joinable()) {
+        (void) HandOver() ;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now() ;
+        _closing.store(true, std::memory_order_release) ;
+        Notify() ;
+        _writer.join() ;
+        _drain_seconds = Seconds(start) ;
+        setp(0, 0) ;
+        if (_error.load()) Message::Error(0, "cannot write output : ", strerror(_error.load())) ;
+    }
+    return (_error.load()) ? 0 : 1 ;
+}
+
+void AsyncWriter::Notify()
+{
+    // Taking the lock orders the move before the wait of the other side
+    std::lock_guard<std::mutex> lock(_mutex) ;
+    _moved.notify_all() ;
+}
+
+void AsyncWriter::Report(std::ostream &os) const
+{
+    os << "-- async output : " << _bytes << " bytes in " << NumBuffers() << " buffers, "
+       << "stalled " << (unsigned long long)(_stall_seconds * 1000.0) << " ms (" << _stalls << " times) "
+       << "and " << (unsigned long long)(_drain_seconds * 1000.0) << " ms on close, "
+       << "writer busy " << (unsigned long long)(_write_seconds * 1000.0) << " ms" << std::endl ;
+}
+
+/*-----------------------------------------------------------------*/
+//                              Writer
+/*-----------------------------------------------------------------*/
+
+unsigned AsyncWriter::WriteAll(const char *data, unsigned long size)
+{
+    // At the shared file offset : other writers of the descriptor append after it
+    while (size) {
+        ssize_t written = write(_fd, data, size) ;
+        if (written < 0) {
+            if (errno == EINTR) continue ;
+            _error.store(errno) ;
+            return 0 ;
+        }
+        data += written ;
+        size -= (unsigned long)written ;
+    }
+    return 1 ;
+}
+
+void AsyncWriter::Run()
+{
+    unsigned long long tail = _tail.load(std::memory_order_relaxed) ;
+    for (;;) {
+        if (tail == _head.load(std::memory_order_acquire)) {
+            // Nothing to write : done if the producer is, and handed nothing more
+            std::unique_lock<std::mutex> lock(_mutex) ;
+            while ((tail == _head.load(std::memory_order_acquire)) && !_closing.load(std::memory_order_acquire)) _moved.wait(lock) ;
+            if (tail == _head.load(std::memory_order_acquire)) break ;
+            continue ;
+        }
+        unsigned slot = (unsigned)(tail % _num_buffers) ;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now() ;
+        unsigned ok = WriteAll(_data + slot * _buffer_size, _sizes[slot]) ;
+        _write_seconds += Seconds(start) ;
+        _tail.store(++tail, std::memory_order_release) ;
+        Notify() ;
+        if (!ok) break ; // The producer sees the error
+    }
+}
+
+/*---------------------------------------------*/
@@ -0,0 +1,115 @@
+/*
+ *
+ * Output stream buffer written to disk by a background thread.
+ *
+ * The translation fills fixed-size buffers and hands each full one to a
+ * writer thread through a single-producer / single-consumer ring. The
+ * writer writes them in order with write, so traversal goes on while a slow
+ * file system takes its time. Writes go through the file offset of the
+ * descriptor, shared with whatever else writes to it (messages on stdout),
+ * so nothing is overwritten. When every buffer of the ring is waiting to be
+ * written, the translation waits for the writer : that wait is the stall
+ * time, which Report prints together with the time the writer spent writing.
+ *
+ * The buffer indexes are exchanged without a lock. A side that has to wait
+ * (the writer on an empty ring, the translation on a full one) sleeps on a
+ * condition variable until the other side moves its index.
+ *
+ * A flush of the stream does not force a write. Buffers go out when they
+ * are full, and the last one on Close.
+ *
+ *     AsyncWriter writer(1) ;          // stdout
+ *     std::ostream os(&writer) ;
+ *     translator.TranslateUclid("top", os) ;
+ *     writer.Close() ;
+ *
+*/
+#ifndef _VERIFIC_ASYNC_WRITER_H_
+#define _VERIFIC_ASYNC_WRITER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <thread>
+
+#ifdef VERIFIC_NAMESPACE
+namespace Verific { // start definitions in verific namespace
+#endif
+
+// Defaults of the constructor
+#define ASYNC_WRITER_BUFFER_SIZE    (1 << 20)
+#define ASYNC_WRITER_BUFFERS        4
+
+/* -------------------------------------------------------------------------- */
+
+class AsyncWriter : public std::streambuf
+{
+public:
+    // Write to file descriptor 'fd' (not closed), through a ring of
+    // 'num_buffers' (at least 2) of 'buffer_size' bytes
+    explicit AsyncWriter(int fd, unsigned long buffer_size = ASYNC_WRITER_BUFFER_SIZE, unsigned num_buffers = ASYNC_WRITER_BUFFERS) ;
+    virtual ~AsyncWriter() ;
+
+    // Write what is left and stop the writer. Returns 0 if a write failed.
+    unsigned Close() ;
+
+    unsigned long long NumBytes() const     { return _bytes ; }
+    unsigned long long NumBuffers() const   { return _tail.load() ; }
+    unsigned long long NumStalls() const    { return _stalls ; }
+    double StallSeconds() const             { return _stall_seconds ; }     // Waiting for a free buffer
+    double DrainSeconds() const             { return _drain_seconds ; }     // Waiting in Close
+    double WriteSeconds() const             { return _write_seconds ; }     // Writer in write
+
+    // "-- async output : ..." line
+    void Report(std::ostream &os) const ;
+
+protected:
+    virtual int_type overflow(int_type ch) ;
+    virtual int sync() ;
+
+private:
+    // Hand the buffer being filled to the writer, and take the next free one
+    unsigned HandOver() ;
+
+    // Body of the writer thread
+    void Run() ;
+
+    // Write 'size' bytes of 'data'. Returns 0 on error.
+    unsigned WriteAll(const char *data, unsigned long size) ;
+
+    // Wake the other side after moving _head or _tail
+    void Notify() ;
+
+private:
+    int                 _fd ;
+    unsigned long       _buffer_size ;
+    unsigned            _num_buffers ;
+    char               *_data ;         // _num_buffers buffers of _buffer_size bytes
+    unsigned long      *_sizes ;        // Bytes used in each buffer handed over
+    std::atomic<unsigned long long> _head ; // Buffers handed over (producer)
+    std::atomic<unsigned long long> _tail ; // Buffers written (writer)
+    std::atomic<bool>   _closing ;
+    std::atomic<int>    _error ;        // errno of the first failed write
+    std::mutex          _mutex ;        // Only to sleep on _moved
+    std::condition_variable _moved ;    // _head or _tail moved, or closing
+    std::thread         _writer ;
+    unsigned long long  _bytes ;
+    unsigned long long  _stalls ;
+    double              _stall_seconds ;
+    double              _drain_seconds ;
+    double              _write_seconds ; // Written by the writer, read after it is joined
+
+    // Prevent the compiler from implementing the following
+    AsyncWriter(const AsyncWriter &node) ;
+    AsyncWriter& operator=(const AsyncWriter &rhs) ;
+} ;
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef VERIFIC_NAMESPACE
+} // end definitions in verific namespace
+#endif
+
+#endif // #ifndef _VERIFIC_ASYNC_WRITER_H_
@@ -0,0 +1,258 @@
+/*
+ *
+ * Demanded-bits analysis of the internal signals of a module.
+ *
+*/
+
+#include "BitWidthAnalyzer.h" // BitWidthAnalyzer class definition
+#include "UclidVisitor.h"   // Widths and bit positions of identifiers
+
+#include "Array.h"          // Make dynamic array class Array available
+#include "Map.h"            // Make associated hash table class Map available
+
+#include "VeriModule.h"     // Definition of a VeriModule and VeriPrimitive
+#include "VeriId.h"         // Definitions of all identifier definition tree nodes
+#include "VeriExpression.h" // Definitions of all verilog expression tree nodes
+#include "VeriModuleItem.h" // Definitions of all verilog module item tree nodes
+#include "VeriStatement.h"  // Definitions of all verilog statement tree nodes
+#include "VeriMisc.h"       // Definitions of all extraneous verilog tree nodes (ie. range, path, strength, etc...)
+#include "veri_tokens.h"
+
+#ifdef VERIFIC_NAMESPACE
+using namespace Verific ;
+#endif
+
+// Demand for all bits of an expression
+#define ALL_BITS 0xffffffffU
+
+/*-----------------------------------------------------------------*/
+//                      Constructor / Destructor
+/*-----------------------------------------------------------------*/
+
+BitWidthAnalyzer::BitWidthAnalyzer()
+    : VeriVisitor(),
+      _demand(POINTER_HASH),
+      _module(0),
+      _collecting(0),
+      _changed(0)
+{
+}
+
+BitWidthAnalyzer::~BitWidthAnalyzer()
+{
+}
+
+/*-----------------------------------------------------------------*/
+//                            Analysis
+/*-----------------------------------------------------------------*/
+
+void BitWidthAnalyzer::Analyze(const VeriModule &module)
+{
+    _demand.Reset() ;
+    _module = &module ;
+
+    unsigned i ;
+    VeriModuleItem *item ;
+    _collecting = 1 ;
+    FOREACH_ARRAY_ITEM(module.GetModuleItems(), i, item) {
+        if (item) item->Accept(*this) ;
+    }
+    _collecting = 0 ;
+    if (!_demand.Size()) return ;
+
+    // Demands only grow, each up to the width of its signal
+    do {
+        _changed = 0 ;
+        FOREACH_ARRAY_ITEM(module.GetModuleItems(), i, item) {
+            if (item) item->Accept(*this) ;
+        }
+    } while (_changed) ;
+}
+
+unsigned BitWidthAnalyzer::NarrowWidth(const VeriIdDef *id) const
+{
+    if (!id || !_demand.GetItem(id)) return 0 ;
+    unsigned demanded = (unsigned)(unsigned long)_demand.GetValue(id) ;
+    if (!demanded) demanded = 1 ; // Never read : UCLID has no empty bit-vectors
+    return (demanded < UclidVisitor::IdWidth(id)) ? demanded : 0 ;
+}
+
+unsigned BitWidthAnalyzer::Apply(UclidVisitor &visitor, std::string *report) const
+{
+    unsigned narrowed = 0 ;
+    MapIter mi ;
+    VeriIdDef *id ;
+    FOREACH_MAP_ITEM(&_demand, mi, &id, 0) {
+        unsigned width = NarrowWidth(id) ;
+        if (!width) continue ;
+        visitor.SetModelWidth(id, width) ;
+        narrowed++ ;
+        if (report) *report = *report + "-- narrowed " + ((_module) ? _module->Name() : "") + " " + id->Name() + " " + std::to_string(UclidVisitor::IdWidth(id)) + " -> " + std::to_string(width) + "\n" ;
+    }
+    return narrowed ;
+}
+
+void BitWidthAnalyzer::Collect(const Array *ids)
+{
+    unsigned i ;
+    VeriIdDef *id ;
+    FOREACH_ARRAY_ITEM(ids, i, id) {
+        if (!id || id->IsPort() || id->IsMemory() || id->IsParam()) continue ;
+        if (UclidVisitor::IdWidth(id) < 2) continue ;
+        (void) _demand.Insert(id, (void*)0) ;
+    }
+}
+
+void BitWidthAnalyzer::Raise(const VeriIdDef *id, unsigned bits)
+{
+    if (_collecting || !id || !_demand.GetItem(id)) return ;
+    unsigned width = UclidVisitor::IdWidth(id) ;
+    if (bits > width) bits = width ;
+    if (bits <= (unsigned)(unsigned long)_demand.GetValue(id)) return ;
+    (void) _demand.Insert(id, (void*)(unsigned long)bits, 1 /* force overwrite */) ;
+    _changed = 1 ;
+}
+
+void BitWidthAnalyzer::Demand(VeriExpression *expr, unsigned bits)
+{
+    if (!expr || !bits) return ;
+
+    switch (expr->GetClassId()) {
+    case ID_VERIIDREF :
+    case ID_VERIINDEXEDID :
+    {
+        // The signal, or a constant select of it : bits from 'lo' up
+        VeriIdDef *id ;
+        unsigned lo, hi ;
+        if (!UclidVisitor::TargetBits(expr, id, lo, hi)) break ;
+        Raise(id, (bits > hi - lo) ? hi + 1 : lo + bits) ;
+        return ;
+    }
+
+    case ID_VERIBINARYOPERATOR :
+        switch (expr->OperType()) {
+        case VERI_PLUS :
+        case VERI_MIN :
+        case VERI_MUL :
+        case VERI_REDAND :
+        case VERI_REDOR :
+        case VERI_REDXOR :
+        case VERI_REDXNOR :
+            // Low bits from low bits
+            Demand(expr->GetLeft(), bits) ;
+            Demand(expr->GetRight(), bits) ;
+            return ;
+        case VERI_LSHIFT :
+        case VERI_ARITLSHIFT :
+            Demand(expr->GetLeft(), bits) ;
+            Demand(expr->GetRight(), ALL_BITS) ;
+            return ;
+        default :
+            break ;
+        }
+        break ;
+
+    case ID_VERIUNARYOPERATOR :
+        switch (expr->OperType()) {
+        case VERI_PLUS :
+        case VERI_MIN :
+        case VERI_UNARY_PLUS :
+        case VERI_UNARY_MINUS :
+        case VERI_REDNOT :
+            Demand(static_cast<VeriUnaryOperator*>(expr)->GetArg(), bits) ;
+            return ;
+        default :
+            break ;
+        }
+        break ;
+
+    case ID_VERIQUESTIONCOLON :
+    {
+        VeriQuestionColon *choice = static_cast<VeriQuestionColon*>(expr) ;
+        Demand(choice->GetIfExpr(), ALL_BITS) ;
+        Demand(choice->GetThenExpr(), bits) ;
+        Demand(choice->GetElseExpr(), bits) ;
+        return ;
+    }
+
+    default :
+        break ;
+    }
+
+    // Anything else observes all bits of what it reads
+    expr->Accept(*this) ;
+}
+
+void BitWidthAnalyzer::Assign(VeriExpression *lval, VeriExpression *value)
+{
+    if (!lval) return ;
+
+    VeriIdDef *id = lval->GetId() ;
+    unsigned lo, hi ;
+    if ((lval->GetClassId() == ID_VERIIDREF) && id && _demand.GetItem(id)) {
+        // Whole candidate : the value is observed as far as the signal is
+        Demand(value, (unsigned)(unsigned long)_demand.GetValue(id)) ;
+        return ;
+    }
+    if (UclidVisitor::TargetBits(lval, id, lo, hi)) {
+        // Ports, and partial writes : those keep their declared width
+        if (lval->GetClassId() != ID_VERIIDREF) {
+            Raise(id, ALL_BITS) ;
+            if (lval->GetIndexExpr()) lval->GetIndexExpr()->Accept(*this) ;
+        }
+        Demand(value, hi - lo + 1) ;
+        return ;
+    }
+    lval->Accept(*this) ;
+    Demand(value, ALL_BITS) ;
+}
+
+/*-----------------------------------------------------------------*/
+//                          Visit Methods
+/*-----------------------------------------------------------------*/
+
+void BitWidthAnalyzer::VERI_VISIT(VeriIdRef, node)
+{
+    // Reached outside of Demand : all bits matter
+    Raise(node.GetId(), ALL_BITS) ;
+}
+
+void BitWidthAnalyzer::VERI_VISIT(VeriDataDecl, node)
+{
+    if (_collecting && node.IsRegDecl()) Collect(node.GetIds()) ;
+    VeriVisitor::VERI_VISIT_NODE(VeriDataDecl, node) ;
+}
+
+void BitWidthAnalyzer::VERI_VISIT(VeriNetDecl, node)
+{
+    if (_collecting) Collect(node.GetIds()) ;
+    VeriVisitor::VERI_VISIT_NODE(VeriNetDecl, node) ;
+}
+
+void BitWidthAnalyzer::VERI_VISIT(VeriFunctionDecl, node)
+{
+    // Locals of functions and tasks are not declared in the model
+    if (!_collecting) VeriVisitor::VERI_VISIT_NODE(VeriFunctionDecl, node) ;
+}
+
+void BitWidthAnalyzer::VERI_VISIT(VeriTaskDecl, node)
+{
+    if (!_collecting) VeriVisitor::VERI_VISIT_NODE(VeriTaskDecl, node) ;
+}
+
+void BitWidthAnalyzer::VERI_VISIT(VeriNetRegAssign, node)
+{
+    Assign(node.GetLValExpr(), node.GetRValExpr()) ;
+}
+
+void BitWidthAnalyzer::VERI_VISIT(VeriBlockingAssign, node)
+{
+    Assign(node.GetLVal(), node.GetValue()) ;
+}
+
+void BitWidthAnalyzer::VERI_VISIT(VeriNonBlockingAssign, node)
+{
+    Assign(node.GetLVal(), node.GetValue()) ;
+}
+
+/*---------------------------------------------*/
@@ -0,0 +1,97 @@
+/*
+ *
+ * Demanded-bits analysis of the internal signals of a module.
+ *
+ * BitWidthAnalyzer finds, for every reg and net declared in a module (not
+ * a port, not a memory), how many of its low bits can ever be observed.
+ * Reads through constant bit and part-selects observe the selected bits.
+ * Sums, differences, products, bitwise operators and left shifts compute
+ * their low bits from the low bits of their operands only, so a truncated
+ * result only demands as much of its operands. Everything else (compares,
+ * right shifts, divisions, conditions, concatenations, instance and
+ * function arguments) demands all bits. A signal assigned as a whole feeds
+ * its demand back into the values assigned to it, up to a fixpoint.
+ *
+ * The upper bits of a signal that nobody demands cannot affect the model :
+ * the signal can be declared that much narrower.
+ *
+*/
+#ifndef _VERIFIC_BIT_WIDTH_ANALYZER_H_
+#define _VERIFIC_BIT_WIDTH_ANALYZER_H_
+
+#include "VeriVisitor.h"    // Visitor base class definition
+#include "Map.h"            // Make associated hash table class Map available
+
+#include <string>
+
+#ifdef VERIFIC_NAMESPACE
+namespace Verific { // start definitions in verific namespace
+#endif
+
+class VeriModule ;
+class VeriIdDef ;
+class UclidVisitor ;
+
+/* -------------------------------------------------------------------------- */
+
+class BitWidthAnalyzer : public VeriVisitor
+{
+public:
+    BitWidthAnalyzer() ;
+    virtual ~BitWidthAnalyzer() ;
+
+    // Analyze the items of 'module', generate constructs included
+    void Analyze(const VeriModule &module) ;
+
+    // Demanded bits of 'id', if fewer than its declared width. 0 otherwise.
+    unsigned NarrowWidth(const VeriIdDef *id) const ;
+
+    // Declare the narrowed signals with their demanded width in 'visitor' (see
+    // UclidVisitor::SetModelWidth). Appends a "-- narrowed <module> <name> <from> -> <to>"
+    // line for each to 'report', if given. Returns the number of signals narrowed.
+    unsigned Apply(UclidVisitor &visitor, std::string *report = 0) const ;
+
+/* ================================================================= */
+/*                         VISIT METHODS                             */
+/* ================================================================= */
+
+    virtual void VERI_VISIT(VeriIdRef, node);
+    virtual void VERI_VISIT(VeriDataDecl, node);
+    virtual void VERI_VISIT(VeriNetDecl, node);
+    virtual void VERI_VISIT(VeriFunctionDecl, node);
+    virtual void VERI_VISIT(VeriTaskDecl, node);
+    virtual void VERI_VISIT(VeriNetRegAssign, node);
+    virtual void VERI_VISIT(VeriBlockingAssign, node);
+    virtual void VERI_VISIT(VeriNonBlockingAssign, node);
+
+private:
+    // Candidate signals declared by a reg or net declaration
+    void Collect(const Array *ids) ;
+
+    // The low 'bits' bits of 'expr' are observed
+    void Demand(VeriExpression *expr, unsigned bits) ;
+
+    // 'value' is assigned to 'lval'
+    void Assign(VeriExpression *lval, VeriExpression *value) ;
+
+    // At least the low 'bits' bits of candidate 'id' are observed
+    void Raise(const VeriIdDef *id, unsigned bits) ;
+
+private:
+    Map         _demand ;       // VeriIdDef* candidate -> demanded bits
+    const VeriModule *_module ; // Module analyzed
+    unsigned    _collecting ;   // First pass : finding the candidates
+    unsigned    _changed ;      // A demand grew in this pass
+
+    // Prevent the compiler from implementing the following
+    BitWidthAnalyzer(const BitWidthAnalyzer &node) ;
+    BitWidthAnalyzer& operator=(const BitWidthAnalyzer &rhs) ;
+} ;
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef VERIFIC_NAMESPACE
+} // end definitions in verific namespace
+#endif
+
+#endif // #ifndef _VERIFIC_BIT_WIDTH_ANALYZER_H_
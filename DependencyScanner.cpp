@@ -0,0 +1,579 @@
+/*
+ *
+ * Lightweight pre-analysis dependency scanner.
+ *
+*/
+
+#include <algorithm>        // sort
+#include <cstring>          // memchr, strcmp ...
+#include <cctype>           // isalpha, etc ...
+
+#include <fcntl.h>          // open
+#include <unistd.h>         // close
+#include <dirent.h>         // opendir, readdir
+#include <sys/mman.h>       // mmap, madvise
+#include <sys/stat.h>       // stat, fstat
+
+#if defined(__SSE2__)
+#include <emmintrin.h>      // SSE2 intrinsics for the character class skips
+#endif
+
+#include "DependencyScanner.h"
+
+/*-----------------------------------------------------------------*/
+//                     Character class utilities
+/*-----------------------------------------------------------------*/
+
+static inline unsigned IsIdentStart(char c) { return std::isalpha((unsigned char)c) || (c == '_') ; }
+static inline unsigned IsIdentChar(char c)  { return std::isalnum((unsigned char)c) || (c == '_') || (c == '$') ; }
+static inline unsigned IsSpace(char c)      { return (c == ' ') || ((c >= '\t') && (c <= '\r')) ; }
+
+// Return the first character at or after 'p' that cannot be part of an identifier
+static const char *SkipIdentChars(const char *p, const char *end)
+{
+#if defined(__SSE2__)
+    // Classify 16 characters at a time : [a-zA-Z0-9_$]. Bytes >= 0x80 compare
+    // as negative and fall outside every range, so they end the identifier.
+    const __m128i lower_lo = _mm_set1_epi8('a' - 1) ;
+    const __m128i lower_hi = _mm_set1_epi8('z' + 1) ;
+    const __m128i digit_lo = _mm_set1_epi8('0' - 1) ;
+    const __m128i digit_hi = _mm_set1_epi8('9' + 1) ;
+    const __m128i case_bit = _mm_set1_epi8(0x20) ;
+    const __m128i under    = _mm_set1_epi8('_') ;
+    const __m128i dollar   = _mm_set1_epi8('$') ;
+    while (p + 16 <= end) {
+        __m128i v = _mm_loadu_si128((const __m128i *)p) ;
+        __m128i l = _mm_or_si128(v, case_bit) ;
+        __m128i is_alpha = _mm_and_si128(_mm_cmpgt_epi8(l, lower_lo), _mm_cmplt_epi8(l, lower_hi)) ;
+        __m128i is_digit = _mm_and_si128(_mm_cmpgt_epi8(v, digit_lo), _mm_cmplt_epi8(v, digit_hi)) ;
+        __m128i is_other = _mm_or_si128(_mm_cmpeq_epi8(v, under), _mm_cmpeq_epi8(v, dollar)) ;
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(is_alpha, is_digit), is_other)) ;
+        if (mask != 0xFFFF) return p + __builtin_ctz(~mask & 0xFFFF) ;
+        p += 16 ;
+    }
+#endif
+    while ((p < end) && IsIdentChar(*p)) p++ ;
+    return p ;
+}
+
+// Return the first non-white-space character at or after 'p'
+static const char *SkipSpaces(const char *p, const char *end)
+{
+#if defined(__SSE2__)
+    const __m128i space = _mm_set1_epi8(' ') ;
+    const __m128i ctrl_lo = _mm_set1_epi8('\t' - 1) ;
+    const __m128i ctrl_hi = _mm_set1_epi8('\r' + 1) ;
+    while (p + 16 <= end) {
+        __m128i v = _mm_loadu_si128((const __m128i *)p) ;
+        __m128i is_ctrl = _mm_and_si128(_mm_cmpgt_epi8(v, ctrl_lo), _mm_cmplt_epi8(v, ctrl_hi)) ;
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, space), is_ctrl)) ;
+        if (mask != 0xFFFF) return p + __builtin_ctz(~mask & 0xFFFF) ;
+        p += 16 ;
+    }
+#endif
+    while ((p < end) && IsSpace(*p)) p++ ;
+    return p ;
+}
+
+// Return the first character at or after 'p' that matters inside a parenthesized
+// list : parens, comment and string starts, directives, escapes and ':'.
+// Port connection lists make up most of a netlist, so this is the hot loop.
+static const char *SkipToParenSpecial(const char *p, const char *end)
+{
+#if defined(__SSE2__)
+    const __m128i oparen = _mm_set1_epi8('(') ;
+    const __m128i cparen = _mm_set1_epi8(')') ;
+    const __m128i slash  = _mm_set1_epi8('/') ;
+    const __m128i quote  = _mm_set1_epi8('"') ;
+    const __m128i tick   = _mm_set1_epi8('`') ;
+    const __m128i colon  = _mm_set1_epi8(':') ;
+    const __m128i escape = _mm_set1_epi8('\\') ;
+    while (p + 16 <= end) {
+        __m128i v = _mm_loadu_si128((const __m128i *)p) ;
+        __m128i hit = _mm_or_si128(_mm_cmpeq_epi8(v, oparen), _mm_cmpeq_epi8(v, cparen)) ;
+        hit = _mm_or_si128(hit, _mm_or_si128(_mm_cmpeq_epi8(v, slash), _mm_cmpeq_epi8(v, quote))) ;
+        hit = _mm_or_si128(hit, _mm_or_si128(_mm_cmpeq_epi8(v, tick), _mm_cmpeq_epi8(v, colon))) ;
+        hit = _mm_or_si128(hit, _mm_cmpeq_epi8(v, escape)) ;
+        unsigned mask = (unsigned)_mm_movemask_epi8(hit) ;
+        if (mask) return p + __builtin_ctz(mask) ;
+        p += 16 ;
+    }
+#endif
+    while (p < end) {
+        switch (*p) {
+        case '(' : case ')' : case '/' : case '"' : case '`' : case ':' : case '\\' : return p ;
+        default : p++ ;
+        }
+    }
+    return end ;
+}
+
+// Return the character after the closing '*/' of a block comment whose body starts at 'p'
+static const char *SkipBlockComment(const char *p, const char *end)
+{
+    while (p < end) {
+        const char *star = (const char *)std::memchr(p, '*', (size_t)(end - p)) ;
+        if (!star) return end ;
+        if ((star + 1 < end) && (star[1] == '/')) return star + 2 ;
+        p = star + 1 ;
+    }
+    return end ;
+}
+
+// Return the character after the closing quote of a string whose body starts at 'p'
+static const char *SkipString(const char *p, const char *end)
+{
+    while (p < end) {
+        const char *quote = (const char *)std::memchr(p, '"', (size_t)(end - p)) ;
+        if (!quote) return end ;
+        // An odd number of backslashes in front escapes the quote
+        const char *b = quote ;
+        while ((b > p) && (b[-1] == '\\')) b-- ;
+        if (((quote - b) & 1) == 0) return quote + 1 ;
+        p = quote + 1 ;
+    }
+    return end ;
+}
+
+// Return the first character of the next line, honoring '\' line continuations
+static const char *SkipDirectiveLine(const char *p, const char *end)
+{
+    while (p < end) {
+        const char *nl = (const char *)std::memchr(p, '\n', (size_t)(end - p)) ;
+        if (!nl) return end ;
+        const char *last = nl ;
+        if ((last > p) && (last[-1] == '\r')) last-- ;
+        if ((last == p) || (last[-1] != '\\')) return nl + 1 ;
+        p = nl + 1 ;
+    }
+    return end ;
+}
+
+// A token in the mapped buffer : no copies are made while lexing
+struct Word {
+    const char  *text ;
+    unsigned     len ;
+} ;
+
+static inline unsigned WordIs(const Word &w, const char *str)
+{
+    return (std::strlen(str) == w.len) && !std::memcmp(w.text, str, w.len) ;
+}
+
+// Keywords that start a design unit : the next identifier is its name
+static unsigned IsUnitKeyword(const Word &w)
+{
+    return WordIs(w, "module") || WordIs(w, "macromodule") || WordIs(w, "primitive") ||
+           WordIs(w, "interface") || WordIs(w, "program") || WordIs(w, "package") ;
+}
+
+static unsigned IsEndUnitKeyword(const Word &w)
+{
+    return WordIs(w, "endmodule") || WordIs(w, "endprimitive") || WordIs(w, "endinterface") ||
+           WordIs(w, "endprogram") || WordIs(w, "endpackage") ;
+}
+
+// Reserved words (sorted). None of these can name an instantiated module.
+static const char *keywords[] = {
+    "always", "always_comb", "always_ff", "always_latch", "and", "assert", "assign", "assume", "automatic",
+    "begin", "bit", "buf", "bufif0", "bufif1", "byte", "case", "casex", "casez", "cmos", "const", "cover",
+    "deassign", "default", "defparam", "disable", "do", "edge", "else", "end", "endcase", "endfunction",
+    "endgenerate", "endspecify", "endtable", "endtask", "enum", "event", "final", "for", "force", "foreach",
+    "forever", "fork", "function", "generate", "genvar", "highz0", "highz1", "if", "ifnone", "import",
+    "initial", "inout", "input", "int", "integer", "join", "join_any", "join_none", "large", "localparam",
+    "logic", "longint", "medium", "nand", "negedge", "nmos", "nor", "not", "notif0", "notif1", "or",
+    "output", "parameter", "pmos", "posedge", "property", "pull0", "pull1", "pulldown", "pullup", "rcmos",
+    "real", "realtime", "reg", "release", "repeat", "return", "rnmos", "rpmos", "rtran", "rtranif0",
+    "rtranif1", "scalared", "sequence", "shortint", "signed", "small", "specify", "specparam", "static",
+    "strong0", "strong1", "struct", "supply0", "supply1", "table", "task", "time", "tran", "tranif0",
+    "tranif1", "tri", "tri0", "tri1", "triand", "trior", "trireg", "typedef", "union", "unique", "unsigned",
+    "var", "vectored", "void", "wait", "wand", "weak0", "weak1", "while", "wire", "wor", "xnor", "xor"
+} ;
+
+static unsigned IsKeyword(const Word &w)
+{
+    // Binary search : keywords are short, so each probe is a single memcmp
+    int lo = 0 ;
+    int hi = (int)(sizeof(keywords) / sizeof(keywords[0])) - 1 ;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2 ;
+        const char *kw = keywords[mid] ;
+        unsigned kw_len = (unsigned)std::strlen(kw) ;
+        int cmp = std::memcmp(w.text, kw, (w.len < kw_len) ? w.len : kw_len) ;
+        if (!cmp) cmp = (int)w.len - (int)kw_len ;
+        if (!cmp) return 1 ;
+        if (cmp < 0) hi = mid - 1 ; else lo = mid + 1 ;
+    }
+    return 0 ;
+}
+
+static unsigned FileExists(const std::string &path)
+{
+    struct stat st ;
+    return (stat(path.c_str(), &st) == 0) && S_ISREG(st.st_mode) ;
+}
+
+static unsigned HasSourceExtension(const char *name)
+{
+    const char *dot = std::strrchr(name, '.') ;
+    if (!dot) return 0 ;
+    return !std::strcmp(dot, ".v") || !std::strcmp(dot, ".sv") ;
+}
+
+/*-----------------------------------------------------------------*/
+//                      Constructor / Destructor
+/*-----------------------------------------------------------------*/
+
+DependencyScanner::DependencyScanner()
+    : _files(),
+      _modules(),
+      _include_dirs(),
+      _scanned(),
+      _include_uses(),
+      _num_bytes(0)
+{
+}
+
+DependencyScanner::~DependencyScanner()
+{
+}
+
+/*-----------------------------------------------------------------*/
+//                              Scanning
+/*-----------------------------------------------------------------*/
+
+void DependencyScanner::AddIncludeDir(const char *dir)
+{
+    if (dir && *dir) _include_dirs.push_back(dir) ;
+}
+
+unsigned DependencyScanner::AddPath(const char *path)
+{
+    if (!path) return 0 ;
+    struct stat st ;
+    if (stat(path, &st) != 0) return 0 ;
+    if (S_ISDIR(st.st_mode)) return ScanDirectory(path) ;
+
+    _files.push_back(path) ;
+    return ScanFile(path, (unsigned)(_files.size() - 1), 0, 0) ;
+}
+
+unsigned DependencyScanner::ScanDirectory(const std::string &dir)
+{
+    DIR *d = opendir(dir.c_str()) ;
+    if (!d) return 0 ;
+
+    // Sort the entries so the scan (and duplicate resolution) is deterministic
+    std::vector<std::string> entries ;
+    struct dirent *entry ;
+    while ((entry = readdir(d)) != 0) {
+        if (entry->d_name[0] == '.') continue ; // ., .. and hidden entries
+        entries.push_back(entry->d_name) ;
+    }
+    closedir(d) ;
+    std::sort(entries.begin(), entries.end()) ;
+
+    unsigned result = 1 ;
+    for (unsigned i = 0; i < entries.size(); i++) {
+        std::string path = dir + "/" + entries[i] ;
+        struct stat st ;
+        if (lstat(path.c_str(), &st) != 0) continue ; // Don't follow symbolic links into loops
+        if (S_ISDIR(st.st_mode)) {
+            if (!ScanDirectory(path)) result = 0 ;
+        } else if ((S_ISREG(st.st_mode) || S_ISLNK(st.st_mode)) && HasSourceExtension(entries[i].c_str())) {
+            if (_scanned.count(path)) continue ; // Already pulled in through an `include
+            _files.push_back(path) ;
+            if (!ScanFile(path, (unsigned)(_files.size() - 1), 0, 0)) result = 0 ;
+        }
+    }
+    return result ;
+}
+
+unsigned DependencyScanner::ScanFile(const std::string &path, unsigned owner, unsigned depth, Unit *context)
+{
+    // Every file is scanned once. Units declared in an `include file belong
+    // to the first root file that included it. What an `include file
+    // instantiates outside its own units is kept, and is used by every unit
+    // it is included in.
+    if (depth > 64) return 0 ; // runaway `include recursion
+    if (!_scanned.insert(path).second) {
+        std::map<std::string, std::set<std::string> >::const_iterator it = _include_uses.find(path) ;
+        if (context && (it != _include_uses.end())) context->uses.insert(it->second.begin(), it->second.end()) ;
+        return 1 ;
+    }
+
+    int fd = open(path.c_str(), O_RDONLY) ;
+    if (fd < 0) return 0 ;
+    struct stat st ;
+    if (fstat(fd, &st) != 0) { close(fd) ; return 0 ; }
+    size_t size = (size_t)st.st_size ;
+    if (!size) { close(fd) ; return 1 ; }
+
+    void *map = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0) ;
+    close(fd) ;
+    if (map == MAP_FAILED) return 0 ;
+    (void) madvise(map, size, MADV_SEQUENTIAL) ;
+
+    const char *buf = (const char *)map ;
+    if (depth) {
+        Unit included ;
+        ScanBuffer(buf, buf + size, path, owner, depth, &included) ;
+        if (context) context->uses.insert(included.uses.begin(), included.uses.end()) ;
+        _include_uses[path].swap(included.uses) ;
+    } else {
+        ScanBuffer(buf, buf + size, path, owner, depth, context) ;
+    }
+    _num_bytes += size ;
+
+    munmap(map, size) ;
+    return 1 ;
+}
+
+std::string DependencyScanner::ResolveInclude(const std::string &name, const std::string &includer) const
+{
+    if (name.empty() || (name[0] == '/')) return name ;
+
+    // Next to the including file first, then the include directories
+    size_t slash = includer.rfind('/') ;
+    std::string local = (slash == std::string::npos) ? name : includer.substr(0, slash + 1) + name ;
+    if (FileExists(local)) return local ;
+    for (unsigned i = 0; i < _include_dirs.size(); i++) {
+        std::string candidate = _include_dirs[i] + "/" + name ;
+        if (FileExists(candidate)) return candidate ;
+    }
+    return name ;
+}
+
+void DependencyScanner::ScanBuffer(const char *p, const char *end, const std::string &path, unsigned owner, unsigned depth, Unit *context)
+{
+    // Significant tokens since the last statement boundary at paren depth 0.
+    // An instantiation looks like : IDENT [PARAMS] IDENT [RANGE] '('
+    enum { T_IDENT, T_PARAMS, T_RANGE } ;
+    const char *begin = p ;
+    int history[4] ;                // Token kinds, oldest first
+    Word history_word[4] ;          // Text of the T_IDENT entries
+    unsigned num_history = 0 ;
+
+    Unit *unit = context ;          // The enclosing design unit (0 outside)
+    unsigned expect_name = 0 ;      // Next identifier names a design unit
+    unsigned hash_pending = 0 ;     // Saw '#' : the next '(' opens a parameter list
+    unsigned in_params = 0 ;        // Paren depth 1 belongs to a parameter list
+    unsigned in_subprogram = 0 ;    // Inside a function/task header : no instantiations there
+    unsigned paren = 0 ;            // Paren depth
+    Word last_use = { 0, 0 } ;      // Last instantiated module name recorded
+
+    while (p < end) {
+        // Inside parentheses only nesting, comments, strings and pkg:: references matter
+        if (paren) p = SkipToParenSpecial(p, end) ;
+        if (p >= end) break ;
+
+        char c = *p ;
+
+        if (IsSpace(c)) { p = SkipSpaces(p, end) ; continue ; }
+
+        // Comments
+        if ((c == '/') && (p + 1 < end) && (p[1] == '/')) {
+            const char *nl = (const char *)std::memchr(p, '\n', (size_t)(end - p)) ;
+            p = (nl) ? nl + 1 : end ;
+            continue ;
+        }
+        if ((c == '/') && (p + 1 < end) && (p[1] == '*')) { p = SkipBlockComment(p + 2, end) ; continue ; }
+
+        // Strings
+        if (c == '"') { p = SkipString(p + 1, end) ; num_history = 0 ; continue ; }
+
+        // Attributes (* ... *), but not the (*) event control
+        if ((c == '(') && (p + 1 < end) && (p[1] == '*') && !((p + 2 < end) && (p[2] == ')'))) {
+            const char *q = p + 2 ;
+            while ((q + 1 < end) && !((q[0] == '*') && (q[1] == ')'))) q++ ;
+            p = (q + 1 < end) ? q + 2 : end ;
+            continue ;
+        }
+
+        // Compiler directives and macro references
+        if (c == '`') {
+            const char *q = SkipIdentChars(p + 1, end) ;
+            Word directive = { p + 1, (unsigned)(q - p - 1) } ;
+            p = q ;
+            if (WordIs(directive, "include")) {
+                p = SkipSpaces(p, end) ;
+                if ((p < end) && ((*p == '"') || (*p == '<'))) {
+                    char close = (*p == '"') ? '"' : '>' ;
+                    const char *name_end = (const char *)std::memchr(p + 1, close, (size_t)(end - p - 1)) ;
+                    if (!name_end) return ;
+                    std::string name(p + 1, name_end) ;
+                    p = name_end + 1 ;
+                    (void) ScanFile(ResolveInclude(name, path), owner, depth + 1, unit) ;
+                }
+            } else if (WordIs(directive, "define") || WordIs(directive, "undef") || WordIs(directive, "timescale")) {
+                p = SkipDirectiveLine(p, end) ;
+            }
+            num_history = 0 ;
+            continue ;
+        }
+
+        // Identifiers (simple and escaped)
+        if (IsIdentStart(c) || (c == '\\')) {
+            Word word ;
+            if (c == '\\') {
+                const char *q = p + 1 ;
+                while ((q < end) && !IsSpace(*q)) q++ ;
+                word.text = p + 1 ;
+                word.len = (unsigned)(q - p - 1) ;
+                p = q ;
+            } else {
+                const char *q = SkipIdentChars(p + 1, end) ;
+                word.text = p ;
+                word.len = (unsigned)(q - p) ;
+                p = q ;
+            }
+            if (paren) continue ; // Identifiers in port and argument lists are never declarations
+
+            if (expect_name) {
+                if (WordIs(word, "automatic") || WordIs(word, "static")) continue ; // lifetime qualifier
+                expect_name = 0 ;
+                std::string name(word.text, word.len) ;
+                if (!_modules.count(name)) _modules[name].file = owner ; // First declaration wins
+                unit = &_modules[name] ;
+                last_use.len = 0 ;
+                num_history = 0 ;
+                continue ;
+            }
+            if (c != '\\') {
+                if (IsUnitKeyword(word)) { expect_name = 1 ; num_history = 0 ; continue ; }
+                if (IsEndUnitKeyword(word)) { unit = 0 ; num_history = 0 ; continue ; }
+                if (WordIs(word, "function") || WordIs(word, "task")) in_subprogram = 1 ;
+                if (IsKeyword(word)) { num_history = 0 ; continue ; }
+            }
+            if (num_history == 4) {
+                for (unsigned k = 1; k < 4; k++) { history[k-1] = history[k] ; history_word[k-1] = history_word[k] ; }
+                num_history-- ;
+            }
+            history[num_history] = T_IDENT ;
+            history_word[num_history++] = word ;
+            continue ;
+        }
+
+        // Numbers : skip digits, base and value characters in one go
+        if (std::isdigit((unsigned char)c)) { p = SkipIdentChars(p + 1, end) ; num_history = 0 ; continue ; }
+
+        switch (c) {
+        case '#' :
+            hash_pending = (!paren && num_history && (history[num_history-1] == T_IDENT)) ;
+            p++ ;
+            continue ;
+        case '(' :
+            if (!paren) {
+                if (hash_pending) {
+                    in_params = 1 ;
+                } else {
+                    // Match IDENT [PARAMS] IDENT [RANGE] against the tail of the history
+                    int k = (int)num_history - 1 ;
+                    if ((k >= 0) && (history[k] == T_RANGE)) k-- ;
+                    if (unit && !in_subprogram && (k >= 1) && (history[k] == T_IDENT)) {
+                        k-- ;
+                        if ((k >= 1) && (history[k] == T_PARAMS)) k-- ;
+                        if ((k >= 0) && (history[k] == T_IDENT)) {
+                            // Netlists instantiate the same cell in long runs : skip repeats cheaply
+                            const Word &cell = history_word[k] ;
+                            if ((cell.len != last_use.len) || std::memcmp(cell.text, last_use.text, cell.len)) {
+                                unit->uses.insert(std::string(cell.text, cell.len)) ;
+                                last_use = cell ;
+                            }
+                        }
+                    }
+                    num_history = 0 ;
+                }
+            }
+            hash_pending = 0 ;
+            paren++ ;
+            p++ ;
+            continue ;
+        case ')' :
+            if (paren) paren-- ;
+            if (!paren) {
+                if (in_params && (num_history < 4)) {
+                    history[num_history++] = T_PARAMS ;
+                } else {
+                    num_history = 0 ;
+                }
+                in_params = 0 ;
+            }
+            p++ ;
+            continue ;
+        case '[' :
+        {
+            // Skip the whole (possibly nested) range
+            unsigned brackets = 0 ;
+            do {
+                if (*p == '[') brackets++ ;
+                else if (*p == ']') brackets-- ;
+                p++ ;
+            } while ((p < end) && brackets) ;
+            if (num_history < 4) history[num_history++] = T_RANGE ;
+            continue ;
+        }
+        case ':' :
+            if ((p + 1 < end) && (p[1] == ':')) {
+                // Package reference : the identifier right in front of 'pkg::item'
+                const char *q = p ;
+                while ((q > begin) && IsIdentChar(q[-1])) q-- ;
+                if (unit && (q < p)) unit->uses.insert(std::string(q, p)) ;
+                p += 2 ;
+                num_history = 0 ;
+                continue ;
+            }
+            break ;
+        case ';' :
+            in_subprogram = 0 ;
+            break ;
+        default :
+            break ;
+        }
+        hash_pending = 0 ;
+        if (!paren) num_history = 0 ;
+        p++ ;
+    }
+}
+
+/*-----------------------------------------------------------------*/
+//                              Closure
+/*-----------------------------------------------------------------*/
+
+void DependencyScanner::Visit(const std::string &name, std::set<std::string> &done, std::vector<const Unit*> &order) const
+{
+    if (!done.insert(name).second) return ;
+
+    // Unknown names are library cells, primitives or typedefs : nothing to analyze
+    std::map<std::string, Unit>::const_iterator it = _modules.find(name) ;
+    if (it == _modules.end()) return ;
+
+    std::set<std::string>::const_iterator use ;
+    for (use = it->second.uses.begin(); use != it->second.uses.end(); use++) {
+        Visit(*use, done, order) ;
+    }
+
+    // Post-order : packages and submodules come before their users
+    order.push_back(&it->second) ;
+}
+
+unsigned DependencyScanner::ComputeClosure(const char *top, std::vector<std::string> &files) const
+{
+    if (!top || !_modules.count(top)) return 0 ;
+
+    std::set<std::string> done ;
+    std::vector<const Unit*> order ;
+    Visit(top, done, order) ;
+
+    // A file goes where the last of its units does : after everything its units use
+    std::map<unsigned, size_t> last ;     // File -> position of its last unit in 'order'
+    for (size_t i = 0; i < order.size(); i++) last[order[i]->file] = i ;
+    std::vector<std::pair<size_t, unsigned> > placed ;
+    std::map<unsigned, size_t>::const_iterator li ;
+    for (li = last.begin(); li != last.end(); li++) placed.push_back(std::make_pair(li->second, li->first)) ;
+    std::sort(placed.begin(), placed.end()) ;
+    for (size_t i = 0; i < placed.size(); i++) files.push_back(_files[placed[i].second]) ;
+    return 1 ;
+}
+
+/*---------------------------------------------*/
@@ -0,0 +1,74 @@
+/*
+ *
+ * Lightweight pre-analysis dependency scanner.
+ *
+ * Scans Verilog source trees without Verific : files are mapped into
+ * memory and lexed just enough to find module (and package) declarations,
+ * module instantiations, package references and `include directives.
+ * From this the scanner computes the set of files reachable from a top
+ * module, so that only those files need to be handed to veri_file::Analyze.
+ *
+*/
+#ifndef _VERIFIC_DEPENDENCY_SCANNER_H_
+#define _VERIFIC_DEPENDENCY_SCANNER_H_
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+/* -------------------------------------------------------------------------- */
+
+class DependencyScanner
+{
+public:
+    DependencyScanner() ;
+    ~DependencyScanner() ;
+
+    // Directories searched for `include files that are not found next to the includer
+    void AddIncludeDir(const char *dir) ;
+
+    // Scan one file, or every .v/.sv file below a directory. Returns 0 on error.
+    unsigned AddPath(const char *path) ;
+
+    // Files (in dependency order) needed to analyze 'top'. Returns 0 if 'top' was not found.
+    unsigned ComputeClosure(const char *top, std::vector<std::string> &files) const ;
+
+    // Statistics for the report
+    unsigned long NumFiles() const      { return _files.size() ; }
+    unsigned long NumModules() const    { return _modules.size() ; }
+    unsigned long long NumBytes() const { return _num_bytes ; }
+
+private:
+    // Everything the scanner learned about one declared design unit
+    struct Unit {
+        Unit() : file(0), uses() { }
+        unsigned               file ;       // Index of the (root) file declaring it
+        std::set<std::string>  uses ;       // Instantiated modules and referenced packages
+    } ;
+
+    unsigned ScanDirectory(const std::string &dir) ;
+    // 'context' : the unit an `include directive is inside of (0 for root files and outside units)
+    unsigned ScanFile(const std::string &path, unsigned owner, unsigned depth, Unit *context) ;
+    void     ScanBuffer(const char *buf, const char *end, const std::string &path, unsigned owner, unsigned depth, Unit *context) ;
+    std::string ResolveInclude(const std::string &name, const std::string &includer) const ;
+
+    // Append the units 'name' depends on, then itself, to 'order' (each once)
+    void Visit(const std::string &name, std::set<std::string> &done, std::vector<const Unit*> &order) const ;
+
+private:
+    std::vector<std::string>        _files ;         // Root files, by index
+    std::map<std::string, Unit>     _modules ;       // Declared unit name -> unit info
+    std::vector<std::string>        _include_dirs ;  // `include search path
+    std::set<std::string>           _scanned ;       // Files already scanned (roots and includes)
+    std::map<std::string, std::set<std::string> > _include_uses ; // `include file -> what it uses outside its own units
+    unsigned long long              _num_bytes ;     // Total bytes scanned
+
+    // Prevent the compiler from implementing the following
+    DependencyScanner(const DependencyScanner &node) ;
+    DependencyScanner& operator=(const DependencyScanner &rhs) ;
+} ;
+
+/* -------------------------------------------------------------------------- */
+
+#endif // #ifndef _VERIFIC_DEPENDENCY_SCANNER_H_
@@ -0,0 +1,276 @@
+/*
+ *
+ * Persistent index of the modules of a work library.
+ *
+*/
+
+#include <cstring>          // memcpy, memset
+#include <fstream>
+
+#include "DesignIndex.h"    // DesignIndex class definition
+#include "UclidVisitor.h"   // Port widths, constant evaluation
+
+#include "Array.h"          // Make dynamic array class Array available
+#include "Map.h"            // Make associated hash table class Map available
+#include "LineFile.h"       // Source file names and line numbers
+#include "Message.h"        // Make message handlers available
+#include "Strings.h"        // A string utility/wrapper class
+
+#include "veri_file.h"      // Make Verilog reader available
+#include "VeriVisitor.h"    // Visitor base class definition
+#include "VeriModule.h"     // Definition of a VeriModule and VeriPrimitive
+#include "VeriId.h"         // Definitions of all identifier definition tree nodes
+#include "VeriExpression.h" // Definitions of all verilog expression tree nodes
+#include "VeriModuleItem.h" // Definitions of all verilog module item tree nodes
+
+#ifdef VERIFIC_NAMESPACE
+using namespace Verific ;
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+// Instantiations of a module, including those in generate constructs
+class InstanceCollector : public VeriVisitor
+{
+public:
+    InstanceCollector() : VeriVisitor(), _instances() { }
+    virtual ~InstanceCollector() { }
+
+    virtual void VERI_VISIT(VeriModuleInstantiation, node) { _instances.InsertLast(&node) ; }
+
+    const Array &Instances() const { return _instances ; }
+
+private:
+    Array _instances ;  // VeriModuleInstantiation*
+} ;
+
+/*-----------------------------------------------------------------*/
+//                      Constructor / Destructor
+/*-----------------------------------------------------------------*/
+
+DesignIndex::DesignIndex()
+    : _modules(),
+      _string_offsets(),
+      _strings(1, '\0')     // Offset 0 : the empty string
+{
+}
+
+DesignIndex::~DesignIndex()
+{
+}
+
+uint32_t DesignIndex::String(const char *str)
+{
+    if (!str || !*str) return 0 ;
+    std::map<std::string, uint32_t>::const_iterator it = _string_offsets.find(str) ;
+    if (it != _string_offsets.end()) return it->second ;
+    uint32_t offset = (uint32_t)_strings.size() ;
+    _strings.append(str) ;
+    _strings.push_back('\0') ;
+    _string_offsets[str] = offset ;
+    return offset ;
+}
+
+/*-----------------------------------------------------------------*/
+//                             Modules
+/*-----------------------------------------------------------------*/
+
+void DesignIndex::AddLibrary(const char *lib_name)
+{
+    MapIter mi ;
+    char *name ;
+    VeriModule *module ;
+    FOREACH_MAP_ITEM(veri_file::AllModules(lib_name), mi, &name, &module) {
+        if (module) AddModule(*module) ;
+    }
+}
+
+void DesignIndex::AddModule(const VeriModule &module)
+{
+    if (!module.Name()) return ;
+    Entry &entry = _modules[module.Name()] ;
+    if (entry.flags & DESIGN_INDEX_DEFINED) return ; // Added before
+    entry.flags |= DESIGN_INDEX_DEFINED ;
+    linefile_type linefile = module.Linefile() ;
+    if (linefile) {
+        entry.file = String(LineFile::GetFileName(linefile)) ;
+        entry.line = LineFile::GetLineNo(linefile) ;
+    }
+
+    unsigned i ;
+    VeriIdDef *id ;
+    FOREACH_ARRAY_ITEM(module.GetPorts(), i, id) {
+        if (!id) continue ;
+        DesignIndexPort port ;
+        memset(&port, 0, sizeof(port)) ;
+        port.name = String(id->Name()) ;
+        port.direction = (id->IsInout()) ? DESIGN_INDEX_INOUT : (id->IsOutput()) ? DESIGN_INDEX_OUTPUT : DESIGN_INDEX_INPUT ;
+        port.width = UclidVisitor::IdWidth(id) ;
+        if (id->IsSigned()) port.flags |= DESIGN_INDEX_SIGNED ;
+        if (id->IsArray()) {
+            port.flags |= DESIGN_INDEX_HAS_RANGE ;
+            port.msb = id->GetMsbOfRange() ;
+            port.lsb = id->GetLsbOfRange() ;
+        }
+        entry.ports.push_back(port) ;
+    }
+
+    FOREACH_ARRAY_ITEM(module.GetParameters(), i, id) {
+        if (!id) continue ;
+        DesignIndexParam param ;
+        memset(&param, 0, sizeof(param)) ;
+        param.name = String(id->Name()) ;
+        VeriExpression *init = id->GetInitialValue() ;
+        if (init) {
+            char *image = init->GetPrettyPrintedString() ;
+            param.image = String(image) ;
+            Strings::free(image) ;
+            long long value ;
+            if (UclidVisitor::EvalConst(init, value)) {
+                param.flags |= DESIGN_INDEX_HAS_VALUE ;
+                param.value = (uint64_t)value ;
+            }
+        }
+        entry.params.push_back(param) ;
+    }
+
+    // Sites are listed under the module instantiated, which may come later or never
+    InstanceCollector collector ;
+    const_cast<VeriModule&>(module).Accept(collector) ;
+    VeriModuleInstantiation *inst ;
+    FOREACH_ARRAY_ITEM(&collector.Instances(), i, inst) {
+        if (!inst || !inst->GetModuleName()) continue ;
+        Entry &cell = _modules[inst->GetModuleName()] ;
+        unsigned j ;
+        VeriIdDef *inst_id ;
+        FOREACH_ARRAY_ITEM(inst->GetInstances(), j, inst_id) {
+            if (!inst_id) continue ;
+            Site site ;
+            site.parent = module.Name() ;
+            site.name = String(inst_id->Name()) ;
+            site.file = 0 ;
+            site.line = 0 ;
+            linefile = inst_id->Linefile() ;
+            if (linefile) {
+                site.file = String(LineFile::GetFileName(linefile)) ;
+                site.line = LineFile::GetLineNo(linefile) ;
+            }
+            cell.sites.push_back(site) ;
+        }
+    }
+}
+
+/*-----------------------------------------------------------------*/
+//                              Output
+/*-----------------------------------------------------------------*/
+
+static uint64_t Align(uint64_t offset)
+{
+    return (offset + 7) & ~(uint64_t)7 ;
+}
+
+// Write 'size' bytes at 'offset', padding with zeros from 'written' (the bytes written so far)
+static void WriteAt(std::ostream &os, uint64_t &written, uint64_t offset, const void *data, uint64_t size)
+{
+    static const char zeros[8] = { 0 } ;
+    if (offset > written) os.write(zeros, (std::streamsize)(offset - written)) ;
+    if (size) os.write((const char*)data, (std::streamsize)size) ;
+    written = offset + size ;
+}
+
+unsigned DesignIndex::Write(std::ostream &os)
+{
+    // Module indexes follow the name order of the map
+    std::map<std::string, uint32_t> indexes ;
+    std::map<std::string, Entry>::iterator it ;
+    for (it = _modules.begin(); it != _modules.end(); ++it) {
+        uint32_t index = (uint32_t)indexes.size() ;
+        indexes[it->first] = index ;
+    }
+
+    std::vector<DesignIndexModule> modules ;
+    std::vector<DesignIndexPort> ports ;
+    std::vector<DesignIndexParam> params ;
+    std::vector<DesignIndexInstance> instances ;
+    modules.reserve(_modules.size()) ;
+    for (it = _modules.begin(); it != _modules.end(); ++it) {
+        const Entry &entry = it->second ;
+        DesignIndexModule module ;
+        memset(&module, 0, sizeof(module)) ;
+        module.name = String(it->first.c_str()) ;
+        module.file = entry.file ;
+        module.line = entry.line ;
+        module.flags = entry.flags ;
+        if ((entry.flags & DESIGN_INDEX_DEFINED) && entry.sites.empty()) module.flags |= DESIGN_INDEX_ROOT ;
+        module.first_port = (uint32_t)ports.size() ;
+        module.num_ports = (uint32_t)entry.ports.size() ;
+        ports.insert(ports.end(), entry.ports.begin(), entry.ports.end()) ;
+        module.first_param = (uint32_t)params.size() ;
+        module.num_params = (uint32_t)entry.params.size() ;
+        params.insert(params.end(), entry.params.begin(), entry.params.end()) ;
+        module.first_site = (uint32_t)instances.size() ;
+        module.num_sites = (uint32_t)entry.sites.size() ;
+        for (size_t i = 0; i < entry.sites.size(); i++) {
+            const Site &site = entry.sites[i] ;
+            DesignIndexInstance inst ;
+            memset(&inst, 0, sizeof(inst)) ;
+            inst.name = site.name ;
+            inst.parent = indexes[site.parent] ;
+            inst.cell = (uint32_t)modules.size() ;
+            inst.file = site.file ;
+            inst.line = site.line ;
+            instances.push_back(inst) ;
+        }
+        modules.push_back(module) ;
+    }
+
+    // Open addressing, at most half full
+    uint32_t num_slots = 2 ;
+    while (num_slots < 2 * modules.size()) num_slots *= 2 ;
+    std::vector<uint32_t> slots(num_slots, 0) ;
+    for (uint32_t i = 0; i < modules.size(); i++) {
+        uint32_t slot = (uint32_t)DesignIndexHash(_strings.c_str() + modules[i].name) & (num_slots - 1) ;
+        while (slots[slot]) slot = (slot + 1) & (num_slots - 1) ;
+        slots[slot] = i + 1 ;
+    }
+
+    DesignIndexHeader header ;
+    memset(&header, 0, sizeof(header)) ;
+    memcpy(header.magic, DESIGN_INDEX_MAGIC, sizeof(header.magic)) ;
+    header.version = DESIGN_INDEX_VERSION ;
+    header.byte_order = DESIGN_INDEX_BYTE_ORDER ;
+    header.num_modules = (uint32_t)modules.size() ;
+    header.num_ports = (uint32_t)ports.size() ;
+    header.num_params = (uint32_t)params.size() ;
+    header.num_instances = (uint32_t)instances.size() ;
+    header.num_slots = num_slots ;
+    header.record_sizes = (uint32_t)DESIGN_INDEX_RECORD_SIZES ;
+    header.modules = Align(sizeof(header)) ;
+    header.ports = Align(header.modules + modules.size() * sizeof(DesignIndexModule)) ;
+    header.params = Align(header.ports + ports.size() * sizeof(DesignIndexPort)) ;
+    header.instances = Align(header.params + params.size() * sizeof(DesignIndexParam)) ;
+    header.slots = Align(header.instances + instances.size() * sizeof(DesignIndexInstance)) ;
+    header.strings = Align(header.slots + slots.size() * sizeof(uint32_t)) ;
+    header.strings_size = _strings.size() ;
+
+    uint64_t written = 0 ;
+    WriteAt(os, written, 0, &header, sizeof(header)) ;
+    WriteAt(os, written, header.modules, (modules.empty()) ? 0 : &modules[0], modules.size() * sizeof(DesignIndexModule)) ;
+    WriteAt(os, written, header.ports, (ports.empty()) ? 0 : &ports[0], ports.size() * sizeof(DesignIndexPort)) ;
+    WriteAt(os, written, header.params, (params.empty()) ? 0 : &params[0], params.size() * sizeof(DesignIndexParam)) ;
+    WriteAt(os, written, header.instances, (instances.empty()) ? 0 : &instances[0], instances.size() * sizeof(DesignIndexInstance)) ;
+    WriteAt(os, written, header.slots, &slots[0], slots.size() * sizeof(uint32_t)) ;
+    WriteAt(os, written, header.strings, _strings.data(), _strings.size()) ;
+    os.flush() ;
+    return os.good() ? 1 : 0 ;
+}
+
+unsigned DesignIndex::Write(const char *file_name)
+{
+    std::ofstream os(file_name, std::ios::out | std::ios::binary | std::ios::trunc) ;
+    if (!os) {
+        Message::Error(0, "cannot open file ", file_name) ;
+        return 0 ;
+    }
+    return Write(os) ;
+}
@@ -0,0 +1,85 @@
+/*
+ *
+ * Persistent index of the modules of a work library (see DesignIndexReader.h).
+ *
+ * The index records, per module, where it is declared, its ports, its
+ * parameters and the instances of it in the other modules, and writes them
+ * in a hashed file that tools look modules up in without Verific. It is
+ * built from the library as it is after analysis and elaboration, so
+ * elaborated copies of parameterized modules are listed with their values.
+ *
+*/
+#ifndef _VERIFIC_DESIGN_INDEX_H_
+#define _VERIFIC_DESIGN_INDEX_H_
+
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "DesignIndexReader.h" // File layout
+
+#ifdef VERIFIC_NAMESPACE
+namespace Verific { // start definitions in verific namespace
+#endif
+
+class VeriModule ;
+
+/* -------------------------------------------------------------------------- */
+
+class DesignIndex
+{
+public:
+    DesignIndex() ;
+    ~DesignIndex() ;
+
+    // Add every module of library 'lib_name', or one module
+    void AddLibrary(const char *lib_name) ;
+    void AddModule(const VeriModule &module) ;
+
+    // Write the index. Returns 0 if it could not be written.
+    unsigned Write(std::ostream &os) ;
+    unsigned Write(const char *file_name) ;
+
+    unsigned long NumModules() const    { return _modules.size() ; }
+
+private:
+    // An instantiation of a module
+    struct Site {
+        std::string parent ;        // Module it is in
+        uint32_t    name ;          // Instance name (string offset)
+        uint32_t    file ;
+        uint32_t    line ;
+    } ;
+
+    // What is known of one module name
+    struct Entry {
+        Entry() : flags(0), file(0), line(0), ports(), params(), sites() { }
+        uint32_t                        flags ;     // DESIGN_INDEX_DEFINED ...
+        uint32_t                        file ;
+        uint32_t                        line ;
+        std::vector<DesignIndexPort>    ports ;
+        std::vector<DesignIndexParam>   params ;
+        std::vector<Site>               sites ;     // Instances of it
+    } ;
+
+    // Offset of 'str' in the string table (stored once)
+    uint32_t String(const char *str) ;
+
+private:
+    std::map<std::string, Entry>    _modules ;      // By name : the order of the module section
+    std::map<std::string, uint32_t> _string_offsets ;
+    std::string                     _strings ;      // String table
+
+    // Prevent the compiler from implementing the following
+    DesignIndex(const DesignIndex &node) ;
+    DesignIndex& operator=(const DesignIndex &rhs) ;
+} ;
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef VERIFIC_NAMESPACE
+} // end definitions in verific namespace
+#endif
+
+#endif // #ifndef _VERIFIC_DESIGN_INDEX_H_
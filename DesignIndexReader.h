@@ -0,0 +1,248 @@
+/*
+ *
+ * Reader of design index files (see DesignIndex).
+ *
+ * A design index lists the modules of a work library after analysis and
+ * elaboration : for each module the file and line it is declared at, its
+ * ports with direction and width, its parameters with their values, and
+ * the places it is instantiated. Modules are found by name through an open
+ * addressing hash table stored in the file, so a lookup touches a few
+ * pages of the mapped file and nothing is read or built at Open. This
+ * header needs neither Verific nor anything but POSIX.
+ *
+ * Layout (native byte order, all sections 8-byte aligned) :
+ *
+ *     DesignIndexHeader
+ *     modules   : num_modules DesignIndexModule, sorted by name
+ *     ports     : num_ports DesignIndexPort, those of each module together, in port order
+ *     params    : num_params DesignIndexParam, those of each module together
+ *     instances : num_instances DesignIndexInstance, grouped by the module instantiated
+ *     slots     : num_slots uint32_t (a power of 2), module index + 1 or 0 for an empty slot
+ *     strings   : NUL-terminated strings. Offset 0 is the empty string.
+ *
+ * A module is in slot DesignIndexHash(name) & (num_slots - 1), or in one of
+ * the slots after it (wrapping around) before the first empty one.
+ *
+ *     DesignIndexReader index ;
+ *     uint32_t m = index.Open("design.idx") ? index.FindModule("mAlu") : DESIGN_INDEX_NONE ;
+ *
+*/
+#ifndef _VERIFIC_DESIGN_INDEX_READER_H_
+#define _VERIFIC_DESIGN_INDEX_READER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define DESIGN_INDEX_MAGIC      "VDINDEX\n"     // 8 bytes, no NUL
+#define DESIGN_INDEX_VERSION    1
+#define DESIGN_INDEX_BYTE_ORDER 0x01020304
+#define DESIGN_INDEX_NONE       0xffffffffU
+
+// DesignIndexModule::flags
+#define DESIGN_INDEX_DEFINED    0x1     // Declared in the library (not only instantiated)
+#define DESIGN_INDEX_ROOT       0x2     // Not instantiated by any module of the library
+
+// DesignIndexPort::direction
+#define DESIGN_INDEX_INPUT      1
+#define DESIGN_INDEX_OUTPUT     2
+#define DESIGN_INDEX_INOUT      3
+
+// DesignIndexPort::flags and DesignIndexParam::flags
+#define DESIGN_INDEX_SIGNED     0x1
+#define DESIGN_INDEX_HAS_RANGE  0x2     // Port : 'msb' and 'lsb' hold its packed range
+#define DESIGN_INDEX_HAS_VALUE  0x4     // Parameter : 'value' holds its value
+
+/* -------------------------------------------------------------------------- */
+
+// 64-bit FNV-1a of a module name
+inline uint64_t DesignIndexHash(const char *name)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL ;
+    for (const unsigned char *p = (const unsigned char*)name; p && *p; p++) {
+        hash ^= *p ;
+        hash *= 0x100000001b3ULL ;
+    }
+    return hash ;
+}
+
+struct DesignIndexHeader
+{
+    char        magic[8] ;
+    uint32_t    version ;
+    uint32_t    byte_order ;        // DESIGN_INDEX_BYTE_ORDER, as the writer stored it
+    uint32_t    num_modules ;
+    uint32_t    num_ports ;
+    uint32_t    num_params ;
+    uint32_t    num_instances ;
+    uint32_t    num_slots ;
+    uint32_t    record_sizes ;      // Sum of the sizes of the record structs, a check of the layout
+    uint64_t    modules ;           // File offsets of the sections
+    uint64_t    ports ;
+    uint64_t    params ;
+    uint64_t    instances ;
+    uint64_t    slots ;
+    uint64_t    strings ;
+    uint64_t    strings_size ;
+} ;
+
+// Strings are string offsets. Ranges are (first, count) into the section named.
+struct DesignIndexModule
+{
+    uint32_t    name ;
+    uint32_t    file ;          // Declaring file (0 for modules that are not DEFINED)
+    uint32_t    line ;
+    uint32_t    flags ;         // DESIGN_INDEX_DEFINED ...
+    uint32_t    first_port ;
+    uint32_t    num_ports ;
+    uint32_t    first_param ;
+    uint32_t    num_params ;
+    uint32_t    first_site ;    // Instances of this module
+    uint32_t    num_sites ;
+} ;
+
+struct DesignIndexPort
+{
+    uint32_t    name ;
+    uint32_t    direction ;     // DESIGN_INDEX_INPUT ...
+    uint32_t    width ;         // In bits
+    uint32_t    flags ;
+    int32_t     msb ;
+    int32_t     lsb ;
+} ;
+
+struct DesignIndexParam
+{
+    uint32_t    name ;
+    uint32_t    image ;         // Pretty-printed value
+    uint32_t    flags ;
+    uint32_t    reserved ;
+    uint64_t    value ;         // Two's complement, if flags has DESIGN_INDEX_HAS_VALUE
+} ;
+
+struct DesignIndexInstance
+{
+    uint32_t    name ;          // Instance name
+    uint32_t    parent ;        // Index of the instantiating module
+    uint32_t    cell ;          // Index of the module instantiated
+    uint32_t    file ;
+    uint32_t    line ;
+    uint32_t    reserved ;
+} ;
+
+#define DESIGN_INDEX_RECORD_SIZES (sizeof(DesignIndexModule) + sizeof(DesignIndexPort) + sizeof(DesignIndexParam) + sizeof(DesignIndexInstance))
+
+/* -------------------------------------------------------------------------- */
+
+class DesignIndexReader
+{
+public:
+    DesignIndexReader() : _base(0), _size(0), _header(0) { }
+    ~DesignIndexReader() { Close() ; }
+
+    // Map 'file_name' into memory. Returns 0 (with nothing mapped) if it is
+    // not a design index of this version and byte order, or is truncated.
+    unsigned Open(const char *file_name) ;
+    void     Close() ;
+
+    // Module index of 'name', DESIGN_INDEX_NONE if it is not in the index
+    uint32_t FindModule(const char *name) const ;
+
+    // Records by index (no range checks : ranges come from the file itself)
+    uint32_t NumModules() const                         { return _header->num_modules ; }
+    const DesignIndexModule &Module(uint32_t i) const   { return ((const DesignIndexModule*)(_base + _header->modules))[i] ; }
+    const DesignIndexPort &Port(uint32_t i) const       { return ((const DesignIndexPort*)(_base + _header->ports))[i] ; }
+    const DesignIndexParam &Param(uint32_t i) const     { return ((const DesignIndexParam*)(_base + _header->params))[i] ; }
+    const DesignIndexInstance &Instance(uint32_t i) const { return ((const DesignIndexInstance*)(_base + _header->instances))[i] ; }
+
+    const char *String(uint32_t offset) const           { return _base + _header->strings + offset ; }
+
+private:
+    // Does the section at 'offset' of 'count' items of 'size' bytes lie in the file?
+    unsigned Fits(uint64_t offset, uint64_t count, uint64_t size) const ;
+
+private:
+    const char              *_base ;
+    size_t                   _size ;
+    const DesignIndexHeader *_header ;
+
+    // Prevent the compiler from implementing the following
+    DesignIndexReader(const DesignIndexReader &node) ;
+    DesignIndexReader& operator=(const DesignIndexReader &rhs) ;
+} ;
+
+/* -------------------------------------------------------------------------- */
+
+inline unsigned DesignIndexReader::Fits(uint64_t offset, uint64_t count, uint64_t size) const
+{
+    if ((offset % 8) || (offset > _size)) return 0 ;
+    return (count <= (_size - offset) / size) ? 1 : 0 ;
+}
+
+inline unsigned DesignIndexReader::Open(const char *file_name)
+{
+    Close() ;
+    int fd = (file_name) ? open(file_name, O_RDONLY) : -1 ;
+    if (fd < 0) return 0 ;
+    struct stat st ;
+    if ((fstat(fd, &st) != 0) || ((size_t)st.st_size < sizeof(DesignIndexHeader))) {
+        close(fd) ;
+        return 0 ;
+    }
+    void *base = mmap(0, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0) ;
+    close(fd) ; // The mapping stays
+    if (base == MAP_FAILED) return 0 ;
+    _base = (const char*)base ;
+    _size = (size_t)st.st_size ;
+
+    const DesignIndexHeader *header = (const DesignIndexHeader*)_base ;
+    unsigned ok = (memcmp(header->magic, DESIGN_INDEX_MAGIC, 8) == 0) &&
+                  (header->version == DESIGN_INDEX_VERSION) &&
+                  (header->byte_order == DESIGN_INDEX_BYTE_ORDER) &&
+                  (header->record_sizes == DESIGN_INDEX_RECORD_SIZES) &&
+                  header->num_slots && !(header->num_slots & (header->num_slots - 1)) &&
+                  (header->num_slots > header->num_modules) &&
+                  Fits(header->modules, header->num_modules, sizeof(DesignIndexModule)) &&
+                  Fits(header->ports, header->num_ports, sizeof(DesignIndexPort)) &&
+                  Fits(header->params, header->num_params, sizeof(DesignIndexParam)) &&
+                  Fits(header->instances, header->num_instances, sizeof(DesignIndexInstance)) &&
+                  Fits(header->slots, header->num_slots, sizeof(uint32_t)) &&
+                  Fits(header->strings, header->strings_size, 1) &&
+                  header->strings_size && (_base[header->strings + header->strings_size - 1] == '\0') ;
+    if (!ok) {
+        Close() ;
+        return 0 ;
+    }
+    _header = header ;
+    return 1 ;
+}
+
+inline void DesignIndexReader::Close()
+{
+    if (_base) (void) munmap((void*)_base, _size) ;
+    _base = 0 ;
+    _size = 0 ;
+    _header = 0 ;
+}
+
+inline uint32_t DesignIndexReader::FindModule(const char *name) const
+{
+    if (!_header || !name) return DESIGN_INDEX_NONE ;
+    const uint32_t *slots = (const uint32_t*)(_base + _header->slots) ;
+    uint32_t mask = _header->num_slots - 1 ;
+    // There is an empty slot (num_slots > num_modules), so this ends
+    for (uint32_t slot = (uint32_t)DesignIndexHash(name) & mask; slots[slot]; slot = (slot + 1) & mask) {
+        uint32_t index = slots[slot] - 1 ;
+        if ((index < _header->num_modules) && (strcmp(String(Module(index).name), name) == 0)) return index ;
+    }
+    return DESIGN_INDEX_NONE ;
+}
+
+/* -------------------------------------------------------------------------- */
+
+#endif // #ifndef _VERIFIC_DESIGN_INDEX_READER_H_
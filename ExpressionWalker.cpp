@@ -0,0 +1,132 @@
+/*
+ *
+ * Iterative traversal of expression trees.
+ *
+*/
+
+#include "ExpressionWalker.h"   // ExpressionWalker class definition
+
+#include "Array.h"              // Make dynamic array class Array available
+#include "VeriExpression.h"     // Definitions of all verilog expression tree nodes
+#include "veri_tokens.h"
+
+#ifdef VERIFIC_NAMESPACE
+using namespace Verific ;
+#endif
+
+/*-----------------------------------------------------------------*/
+//                      Constructor / Destructor
+/*-----------------------------------------------------------------*/
+
+ExpressionWalker::ExpressionWalker()
+    : _stack(),
+      _recursive(0)
+{
+    _stack.reserve(64) ;
+}
+
+ExpressionWalker::~ExpressionWalker()
+{
+}
+
+/*-----------------------------------------------------------------*/
+//                            Traversal
+/*-----------------------------------------------------------------*/
+
+void ExpressionWalker::Walk(VeriExpression *expr)
+{
+    if (expr) Walk(expr, expr->GetClassId()) ;
+}
+
+void ExpressionWalker::Walk(VeriExpression *expr, unsigned class_id)
+{
+    if (!expr) return ;
+
+    // Frames below 'base' belong to the walks we are nested in
+    size_t base = _stack.size() ;
+    Frame frame = { expr, class_id, 0 } ;
+    _stack.push_back(frame) ;
+
+    while (_stack.size() > base) {
+        // Step() may push and pop frames (nested walks), so no references into _stack are kept
+        size_t top = _stack.size() - 1 ;
+        frame = _stack[top] ;
+        _stack[top].step++ ;
+
+        VeriExpression *child = 0 ;
+        if (!Step(*frame.node, frame.class_id, frame.step, child)) {
+            _stack.pop_back() ;
+            continue ;
+        }
+        if (!child) continue ;
+        if (_recursive) {
+            Descend(*child) ;
+            continue ;
+        }
+
+        Frame next = { child, child->GetClassId(), 0 } ;
+        _stack.push_back(next) ;
+    }
+}
+
+void ExpressionWalker::Descend(VeriExpression &child)
+{
+    Walk(&child) ;
+}
+
+/*-----------------------------------------------------------------*/
+//                      Associative chains
+/*-----------------------------------------------------------------*/
+
+// static
+unsigned ExpressionWalker::IsAssociative(unsigned oper)
+{
+    switch (oper) {
+    case VERI_PLUS :
+    case VERI_REDAND :
+    case VERI_REDOR :
+    case VERI_REDXOR :
+    case VERI_LOGAND :
+    case VERI_LOGOR :
+        return 1 ;
+    default :
+        return 0 ;
+    }
+}
+
+// Expression is a binary 'oper' operator
+static unsigned IsOperator(const VeriExpression *expr, unsigned oper)
+{
+    return expr && (expr->GetClassId() == ID_VERIBINARYOPERATOR) && (expr->OperType() == oper) ;
+}
+
+// static
+unsigned ExpressionWalker::IsChain(const VeriExpression &expr)
+{
+    if (expr.GetClassId() != ID_VERIBINARYOPERATOR) return 0 ;
+    unsigned oper = expr.OperType() ;
+    if (!IsAssociative(oper)) return 0 ;
+    const VeriBinaryOperator &binary = static_cast<const VeriBinaryOperator&>(expr) ;
+    return IsOperator(binary.GetLeft(), oper) || IsOperator(binary.GetRight(), oper) ;
+}
+
+// static
+void ExpressionWalker::FlattenChain(VeriExpression *expr, unsigned oper, Array &operands)
+{
+    // Depth first, left operands first : right operands wait on 'pending'
+    std::vector<VeriExpression*> pending ;
+    pending.push_back(expr) ;
+    while (!pending.empty()) {
+        VeriExpression *node = pending.back() ;
+        pending.pop_back() ;
+        if (!IsOperator(node, oper)) {
+            operands.InsertLast(node) ;
+            continue ;
+        }
+        VeriBinaryOperator *binary = static_cast<VeriBinaryOperator*>(node) ;
+        pending.push_back(binary->GetRight()) ;
+        pending.push_back(binary->GetLeft()) ;
+    }
+}
+
+/*---------------------------------------------*/
@@ -0,0 +1,96 @@
+/*
+ *
+ * Iterative traversal of expression trees.
+ *
+ * Accept() based visitors recurse once per nesting level, and machine
+ * generated expressions (long operator chains, nested ?: selectors) nest
+ * deep enough to overflow the C stack. ExpressionWalker keeps the pending
+ * nodes on its own stack instead. A derived class handles every node in
+ * Step(), one event at a time : when the node is entered, and again each
+ * time one of its sub-expressions has been walked. It dispatches on the
+ * class id of the node, which is looked up once per node.
+ *
+ * Long chains of one associative operator (netlist reductions, say) are
+ * as deep as they are long. FlattenChain() lists their operands, so they
+ * can be handled as one n-ary operation.
+ *
+*/
+#ifndef _VERIFIC_EXPRESSION_WALKER_H_
+#define _VERIFIC_EXPRESSION_WALKER_H_
+
+#include <vector>
+
+#ifdef VERIFIC_NAMESPACE
+namespace Verific { // start definitions in verific namespace
+#endif
+
+class VeriExpression ;
+class Array ;
+
+/* -------------------------------------------------------------------------- */
+
+class ExpressionWalker
+{
+public:
+    ExpressionWalker() ;
+    virtual ~ExpressionWalker() ;
+
+    // Walk 'expr' and all its sub-expressions. Re-entrant : Step() may walk
+    // other expressions (through Accept(), say) before it returns.
+    void Walk(VeriExpression *expr) ;
+
+    // Walk 'expr' as a node of class 'class_id' (a visit method inherited by a
+    // derived class passes its own class, so the node is not dispatched back to it)
+    void Walk(VeriExpression *expr, unsigned class_id) ;
+
+    // Walk sub-expressions by recursion, through Descend(), instead (off by
+    // default). Only there to compare with the recursive visitors.
+    void SetRecursive(unsigned recursive) { _recursive = recursive ; }
+
+    // Number of nodes entered but not yet left
+    unsigned Depth() const { return (unsigned)_stack.size() ; }
+
+    // Operators whose chains can be regrouped freely : + & | ^ && ||
+    static unsigned IsAssociative(unsigned oper) ;
+
+    // 'expr' is a binary associative operator with an operand of the same operator
+    static unsigned IsChain(const VeriExpression &expr) ;
+
+    // Operands of the chain of 'oper' operators rooted at 'expr', left to right.
+    // Collected without recursion, whatever the shape of the chain.
+    static void FlattenChain(VeriExpression *expr, unsigned oper, Array &operands) ;
+
+protected:
+    // Event 'step' of 'node', whose class id is 'class_id' : step 0 when the
+    // node is entered, step n after the n-th request for a sub-expression.
+    // Set 'child' to walk that sub-expression next (0 : go to the next step
+    // right away). Return 0 once the node is done.
+    virtual unsigned Step(VeriExpression &node, unsigned class_id, unsigned step, VeriExpression *&child) = 0 ;
+
+    // Recursive walks : walk sub-expression 'child' before the next step of
+    // its parent, on the C stack (Walk(&child) unless a derived class says otherwise)
+    virtual void Descend(VeriExpression &child) ;
+
+private:
+    struct Frame
+    {
+        VeriExpression  *node ;
+        unsigned         class_id ;
+        unsigned         step ;     // Next event of 'node'
+    } ;
+
+    std::vector<Frame>   _stack ;   // Nodes entered, innermost last
+    unsigned             _recursive ;
+
+    // Prevent the compiler from implementing the following
+    ExpressionWalker(const ExpressionWalker &node) ;
+    ExpressionWalker& operator=(const ExpressionWalker &rhs) ;
+} ;
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef VERIFIC_NAMESPACE
+} // end definitions in verific namespace
+#endif
+
+#endif // #ifndef _VERIFIC_EXPRESSION_WALKER_H_
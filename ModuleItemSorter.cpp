@@ -0,0 +1,69 @@
+/*
+ *
+ * Sorts the items of a module by kind.
+ *
+*/
+
+#include "ModuleItemSorter.h"   // ModuleItemSorter class definition
+
+#include "VeriModule.h"         // Definition of a VeriModule and VeriPrimitive
+#include "VeriModuleItem.h"     // Definitions of all verilog module item tree nodes
+#include "VeriStatement.h"      // Definitions of all verilog statement tree nodes
+
+#ifdef VERIFIC_NAMESPACE
+using namespace Verific ;
+#endif
+
+/*-----------------------------------------------------------------*/
+//                      Constructor / Destructor
+/*-----------------------------------------------------------------*/
+
+ModuleItemSorter::ModuleItemSorter(const Array *items)
+    : _decls(), _nets(), _assigns(), _gates(), _instances(),
+      _always(), _initials(), _subprograms(), _generates(), _others()
+{
+    unsigned i ;
+    VeriModuleItem *item ;
+    FOREACH_ARRAY_ITEM(items, i, item) {
+        if (item) item->Accept(*this) ;
+    }
+}
+
+ModuleItemSorter::~ModuleItemSorter()
+{
+}
+
+unsigned ModuleItemSorter::IsStructural() const
+{
+    if (!_instances.Size() && !_gates.Size()) return 0 ;
+    return !_always.Size() && !_initials.Size() && !_subprograms.Size() && !_generates.Size() && !_others.Size() ;
+}
+
+/*-----------------------------------------------------------------*/
+//                           Visit Methods
+/*-----------------------------------------------------------------*/
+
+// None of these descend into the item : nested declarations stay with their parent
+
+void ModuleItemSorter::VERI_VISIT(VeriModuleItem, node)             { _others.InsertLast(&node) ; }
+void ModuleItemSorter::VERI_VISIT(VeriDataDecl, node)               { _decls.InsertLast(&node) ; }
+void ModuleItemSorter::VERI_VISIT(VeriNetDecl, node)                { _nets.InsertLast(&node) ; }
+void ModuleItemSorter::VERI_VISIT(VeriFunctionDecl, node)           { _subprograms.InsertLast(&node) ; }
+void ModuleItemSorter::VERI_VISIT(VeriTaskDecl, node)               { _subprograms.InsertLast(&node) ; }
+void ModuleItemSorter::VERI_VISIT(VeriDefParam, node)               { _others.InsertLast(&node) ; }
+void ModuleItemSorter::VERI_VISIT(VeriContinuousAssign, node)       { _assigns.InsertLast(&node) ; }
+void ModuleItemSorter::VERI_VISIT(VeriGateInstantiation, node)      { _gates.InsertLast(&node) ; }
+void ModuleItemSorter::VERI_VISIT(VeriModuleInstantiation, node)    { _instances.InsertLast(&node) ; }
+void ModuleItemSorter::VERI_VISIT(VeriSpecifyBlock, node)           { _others.InsertLast(&node) ; }
+void ModuleItemSorter::VERI_VISIT(VeriPathDecl, node)               { _others.InsertLast(&node) ; }
+void ModuleItemSorter::VERI_VISIT(VeriSystemTimingCheck, node)      { _others.InsertLast(&node) ; }
+void ModuleItemSorter::VERI_VISIT(VeriInitialConstruct, node)       { _initials.InsertLast(&node) ; }
+void ModuleItemSorter::VERI_VISIT(VeriAlwaysConstruct, node)        { _always.InsertLast(&node) ; }
+void ModuleItemSorter::VERI_VISIT(VeriGenerateConstruct, node)      { _generates.InsertLast(&node) ; }
+void ModuleItemSorter::VERI_VISIT(VeriGenerateConditional, node)    { _generates.InsertLast(&node) ; }
+void ModuleItemSorter::VERI_VISIT(VeriGenerateCase, node)           { _generates.InsertLast(&node) ; }
+void ModuleItemSorter::VERI_VISIT(VeriGenerateFor, node)            { _generates.InsertLast(&node) ; }
+void ModuleItemSorter::VERI_VISIT(VeriGenerateBlock, node)          { _generates.InsertLast(&node) ; }
+void ModuleItemSorter::VERI_VISIT(VeriTable, node)                  { _others.InsertLast(&node) ; }
+
+/*---------------------------------------------*/
@@ -0,0 +1,91 @@
+/*
+ *
+ * Sorts the items of a module by kind.
+ *
+ * Module items are dispatched through Accept() into one array per kind,
+ * without descending into them, so translation passes can look at all
+ * instantiations, all continuous assignments etc. of a module at once.
+ *
+*/
+#ifndef _VERIFIC_MODULE_ITEM_SORTER_H_
+#define _VERIFIC_MODULE_ITEM_SORTER_H_
+
+#include "VeriVisitor.h"    // Visitor base class definition
+#include "Array.h"          // Make dynamic array class Array available
+
+#ifdef VERIFIC_NAMESPACE
+namespace Verific { // start definitions in verific namespace
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+class ModuleItemSorter : public VeriVisitor
+{
+public:
+    explicit ModuleItemSorter(const Array *items) ;
+    virtual ~ModuleItemSorter() ;
+
+    // The items of each kind, in source order
+    const Array &DataDecls() const      { return _decls ; }         // reg, integer, parameter and io declarations
+    const Array &NetDecls() const       { return _nets ; }
+    const Array &Assigns() const        { return _assigns ; }       // VeriContinuousAssign
+    const Array &Gates() const          { return _gates ; }         // VeriGateInstantiation
+    const Array &Instances() const      { return _instances ; }     // VeriModuleInstantiation
+    const Array &Always() const         { return _always ; }
+    const Array &Initials() const       { return _initials ; }
+    const Array &Subprograms() const    { return _subprograms ; }   // functions and tasks
+    const Array &Generates() const      { return _generates ; }
+    const Array &Others() const         { return _others ; }
+
+    // Only declarations, continuous assignments and instantiations (a netlist)
+    unsigned IsStructural() const ;
+
+/* ================================================================= */
+/*                         VISIT METHODS                             */
+/* ================================================================= */
+
+    virtual void VERI_VISIT(VeriModuleItem, node);
+    virtual void VERI_VISIT(VeriDataDecl, node);
+    virtual void VERI_VISIT(VeriNetDecl, node);
+    virtual void VERI_VISIT(VeriFunctionDecl, node);
+    virtual void VERI_VISIT(VeriTaskDecl, node);
+    virtual void VERI_VISIT(VeriDefParam, node);
+    virtual void VERI_VISIT(VeriContinuousAssign, node);
+    virtual void VERI_VISIT(VeriGateInstantiation, node);
+    virtual void VERI_VISIT(VeriModuleInstantiation, node);
+    virtual void VERI_VISIT(VeriSpecifyBlock, node);
+    virtual void VERI_VISIT(VeriPathDecl, node);
+    virtual void VERI_VISIT(VeriSystemTimingCheck, node);
+    virtual void VERI_VISIT(VeriInitialConstruct, node);
+    virtual void VERI_VISIT(VeriAlwaysConstruct, node);
+    virtual void VERI_VISIT(VeriGenerateConstruct, node);
+    virtual void VERI_VISIT(VeriGenerateConditional, node);
+    virtual void VERI_VISIT(VeriGenerateCase, node);
+    virtual void VERI_VISIT(VeriGenerateFor, node);
+    virtual void VERI_VISIT(VeriGenerateBlock, node);
+    virtual void VERI_VISIT(VeriTable, node);
+
+private:
+    Array   _decls ;
+    Array   _nets ;
+    Array   _assigns ;
+    Array   _gates ;
+    Array   _instances ;
+    Array   _always ;
+    Array   _initials ;
+    Array   _subprograms ;
+    Array   _generates ;
+    Array   _others ;
+
+    // Prevent the compiler from implementing the following
+    ModuleItemSorter(const ModuleItemSorter &node) ;
+    ModuleItemSorter& operator=(const ModuleItemSorter &rhs) ;
+} ;
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef VERIFIC_NAMESPACE
+} // end definitions in verific namespace
+#endif
+
+#endif // #ifndef _VERIFIC_MODULE_ITEM_SORTER_H_
@@ -0,0 +1,227 @@
+/*
+ *
+ * Reader of binary parse tree files (see TreeExporter).
+ *
+ * A parse tree file holds the statically elaborated tree of a module
+ * hierarchy in flat, fixed-size records that are used in place : the file
+ * is mapped into memory and nodes, strings and parameters are found by index
+ * and offset. Nothing is read or built at Open, so opening takes the same
+ * time whatever the size of the design, and only the pages that are touched
+ * are ever loaded. This header needs neither Verific nor anything but POSIX.
+ *
+ * Layout (native byte order, all sections 8-byte aligned) :
+ *
+ *     ParseTreeHeader
+ *     kinds      : num_kinds uint32_t string offsets, the class names of the node kinds
+ *     nodes      : num_nodes ParseTreeNode, in depth-first order (parents before children)
+ *     modules    : num_modules uint32_t node indexes, the top module first
+ *     parameters : num_parameters ParseTreeParameter
+ *     strings    : NUL-terminated strings. Offset 0 is the empty string.
+ *
+ *     ParseTreeReader tree ;
+ *     if (!tree.Open("design.ptree")) ...
+ *     const ParseTreeNode &top = tree.Node(tree.Module(0)) ;
+ *     for (uint32_t i = top.first_child; i != PARSE_TREE_NO_NODE; i = tree.Node(i).next_sibling) ...
+ *
+ * The version is raised whenever the layout changes. Readers reject files of
+ * another version, or written with another byte order.
+ *
+*/
+#ifndef _VERIFIC_PARSE_TREE_READER_H_
+#define _VERIFIC_PARSE_TREE_READER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define PARSE_TREE_MAGIC        "VPTREE\r\n"    // 8 bytes, no NUL
+#define PARSE_TREE_VERSION      1
+#define PARSE_TREE_BYTE_ORDER   0x01020304
+#define PARSE_TREE_NO_NODE      0xffffffffU
+
+// ParseTreeNode::flags
+#define PARSE_TREE_HAS_VALUE    0x1     // 'value' holds the value of a constant
+#define PARSE_TREE_SIGNED       0x2     // ... and it is signed
+
+/* -------------------------------------------------------------------------- */
+
+struct ParseTreeHeader
+{
+    char        magic[8] ;
+    uint32_t    version ;
+    uint32_t    byte_order ;        // PARSE_TREE_BYTE_ORDER, as the writer stored it
+    uint32_t    node_size ;         // sizeof(ParseTreeNode)
+    uint32_t    parameter_size ;    // sizeof(ParseTreeParameter)
+    uint32_t    num_kinds ;
+    uint32_t    num_nodes ;
+    uint32_t    num_modules ;
+    uint32_t    num_parameters ;
+    uint64_t    kinds ;             // File offsets of the sections
+    uint64_t    nodes ;
+    uint64_t    modules ;
+    uint64_t    parameters ;
+    uint64_t    strings ;
+    uint64_t    strings_size ;
+} ;
+
+// One node of the tree. Names and file names are string offsets, links are node indexes.
+struct ParseTreeNode
+{
+    uint32_t    kind ;          // Index into the kind table
+    uint32_t    flags ;         // PARSE_TREE_HAS_VALUE ...
+    uint32_t    token ;         // Operator of operators, direction of ids, type of data types (veri_tokens.h), 0 otherwise
+    uint32_t    name ;          // Identifier, module, system call or selected name, or the image of a literal
+    uint32_t    parent ;        // PARSE_TREE_NO_NODE for modules
+    uint32_t    first_child ;
+    uint32_t    next_sibling ;
+    uint32_t    ref ;           // Declaration of a reference, module of an instantiation, or PARSE_TREE_NO_NODE
+    uint32_t    file ;          // Source file
+    uint32_t    line ;          // Source line (0 : unknown)
+    uint64_t    value ;         // Two's complement value, if flags has PARSE_TREE_HAS_VALUE
+} ;
+
+// Value of a parameter of an exported module, after elaboration
+struct ParseTreeParameter
+{
+    uint32_t    module ;        // Node of the module
+    uint32_t    id ;            // Node of the parameter identifier
+    uint32_t    name ;
+    uint32_t    image ;         // Pretty-printed value
+    uint32_t    flags ;         // PARSE_TREE_HAS_VALUE if 'value' holds it
+    uint32_t    reserved ;
+    uint64_t    value ;
+} ;
+
+/* -------------------------------------------------------------------------- */
+
+class ParseTreeReader
+{
+public:
+    ParseTreeReader() : _base(0), _size(0), _header(0) { }
+    ~ParseTreeReader() { Close() ; }
+
+    // Map 'file_name' into memory. Returns 0 (with nothing mapped) if it is
+    // not a parse tree file of this version and byte order, or is truncated.
+    unsigned Open(const char *file_name) ;
+    void     Close() ;
+    unsigned IsOpen() const                 { return (_header) ? 1 : 0 ; }
+
+    // Nodes (no range checks : indexes come from the file itself)
+    uint32_t NumNodes() const               { return _header->num_nodes ; }
+    const ParseTreeNode &Node(uint32_t index) const { return Nodes()[index] ; }
+
+    // Module roots, the top first. FindModule returns PARSE_TREE_NO_NODE if there is no such module.
+    uint32_t NumModules() const             { return _header->num_modules ; }
+    uint32_t Module(uint32_t i) const       { return Modules()[i] ; }
+    uint32_t FindModule(const char *name) const ;
+
+    uint32_t NumParameters() const          { return _header->num_parameters ; }
+    const ParseTreeParameter &Parameter(uint32_t i) const { return Parameters()[i] ; }
+
+    // Strings, by offset
+    const char *String(uint32_t offset) const { return _base + _header->strings + offset ; }
+    const char *Name(const ParseTreeNode &node) const { return String(node.name) ; }
+    const char *File(const ParseTreeNode &node) const { return String(node.file) ; }
+    const char *KindName(const ParseTreeNode &node) const { return String(Kinds()[node.kind]) ; }
+
+    // Kind index of class 'name' (such as "VeriModuleInstantiation"), or the number of kinds if it does not occur
+    uint32_t FindKind(const char *name) const ;
+
+private:
+    const uint32_t *Kinds() const           { return (const uint32_t*)(_base + _header->kinds) ; }
+    const ParseTreeNode *Nodes() const      { return (const ParseTreeNode*)(_base + _header->nodes) ; }
+    const uint32_t *Modules() const         { return (const uint32_t*)(_base + _header->modules) ; }
+    const ParseTreeParameter *Parameters() const { return (const ParseTreeParameter*)(_base + _header->parameters) ; }
+
+    // Does the section at 'offset' of 'count' items of 'size' bytes lie in the file?
+    unsigned Fits(uint64_t offset, uint64_t count, uint64_t size) const ;
+
+private:
+    const char              *_base ;
+    size_t                   _size ;
+    const ParseTreeHeader   *_header ;
+
+    // Prevent the compiler from implementing the following
+    ParseTreeReader(const ParseTreeReader &node) ;
+    ParseTreeReader& operator=(const ParseTreeReader &rhs) ;
+} ;
+
+/* -------------------------------------------------------------------------- */
+
+inline unsigned ParseTreeReader::Fits(uint64_t offset, uint64_t count, uint64_t size) const
+{
+    if ((offset % 8) || (offset > _size)) return 0 ;
+    return (count <= (_size - offset) / size) ? 1 : 0 ;
+}
+
+inline unsigned ParseTreeReader::Open(const char *file_name)
+{
+    Close() ;
+    int fd = (file_name) ? open(file_name, O_RDONLY) : -1 ;
+    if (fd < 0) return 0 ;
+    struct stat st ;
+    if ((fstat(fd, &st) != 0) || ((size_t)st.st_size < sizeof(ParseTreeHeader))) {
+        close(fd) ;
+        return 0 ;
+    }
+    void *base = mmap(0, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0) ;
+    close(fd) ; // The mapping stays
+    if (base == MAP_FAILED) return 0 ;
+    _base = (const char*)base ;
+    _size = (size_t)st.st_size ;
+
+    // Only the header is checked : the sections are not touched until used
+    const ParseTreeHeader *header = (const ParseTreeHeader*)_base ;
+    unsigned ok = (memcmp(header->magic, PARSE_TREE_MAGIC, 8) == 0) &&
+                  (header->version == PARSE_TREE_VERSION) &&
+                  (header->byte_order == PARSE_TREE_BYTE_ORDER) &&
+                  (header->node_size == sizeof(ParseTreeNode)) &&
+                  (header->parameter_size == sizeof(ParseTreeParameter)) &&
+                  Fits(header->kinds, header->num_kinds, sizeof(uint32_t)) &&
+                  Fits(header->nodes, header->num_nodes, sizeof(ParseTreeNode)) &&
+                  Fits(header->modules, header->num_modules, sizeof(uint32_t)) &&
+                  Fits(header->parameters, header->num_parameters, sizeof(ParseTreeParameter)) &&
+                  Fits(header->strings, header->strings_size, 1) &&
+                  header->strings_size && (_base[header->strings + header->strings_size - 1] == '\0') ;
+    if (!ok) {
+        Close() ;
+        return 0 ;
+    }
+    _header = header ;
+    return 1 ;
+}
+
+inline void ParseTreeReader::Close()
+{
+    if (_base) (void) munmap((void*)_base, _size) ;
+    _base = 0 ;
+    _size = 0 ;
+    _header = 0 ;
+}
+
+inline uint32_t ParseTreeReader::FindModule(const char *name) const
+{
+    if (!name) return PARSE_TREE_NO_NODE ;
+    for (uint32_t i = 0; i < NumModules(); i++) {
+        if (strcmp(Name(Node(Module(i))), name) == 0) return Module(i) ;
+    }
+    return PARSE_TREE_NO_NODE ;
+}
+
+inline uint32_t ParseTreeReader::FindKind(const char *name) const
+{
+    uint32_t i ;
+    for (i = 0; name && (i < _header->num_kinds); i++) {
+        if (strcmp(String(Kinds()[i]), name) == 0) break ;
+    }
+    return (name) ? i : _header->num_kinds ;
+}
+
+/* -------------------------------------------------------------------------- */
+
+#endif // #ifndef _VERIFIC_PARSE_TREE_READER_H_
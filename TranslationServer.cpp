@@ -0,0 +1,336 @@
+/*
+ *
+ * Translation daemon on a Unix domain socket.
+ *
+*/
+
+#include <cerrno>           // errno
+#include <climits>          // PATH_MAX
+#include <csignal>          // signal
+#include <cstdlib>          // realpath, strtoul
+#include <cstring>          // strncpy
+#include <ctime>            // time
+#include <vector>
+
+#include <poll.h>           // poll
+#include <sys/socket.h>     // socket, bind, listen, accept, recv
+#include <sys/time.h>       // timeval
+#include <sys/un.h>         // sockaddr_un
+#include <unistd.h>         // fork, read, write, close, unlink
+
+#include "TranslationServer.h" // TranslationServer class definition
+#include "UclidTranslator.h" // The translation flow
+
+#include "Array.h"          // Make dynamic array class Array available
+#include "Message.h"        // Make message handlers available
+#include "Strings.h"        // A string utility/wrapper class
+
+#ifdef VERIFIC_NAMESPACE
+using namespace Verific ;
+#endif
+
+// A client that does not finish its request in this time is dropped
+#define REQUEST_TIMEOUT_SECONDS 10
+
+// A connection whose first line is still coming in
+struct PendingRequest
+{
+    int         fd ;
+    std::string first ;     // Its first line so far
+    time_t      deadline ;  // Dropped after this
+} ;
+
+// Read what 'pending' sent so far, without blocking, up to the end of its
+// first line. Returns 1 if the line is complete, 0 if more is to come, -1 if
+// the client hung up first.
+static int ReadPending(PendingRequest &pending)
+{
+    char ch ;
+    for (;;) {
+        // One byte at a time : the rest of the request is for the child
+        ssize_t n = recv(pending.fd, &ch, 1, MSG_DONTWAIT) ;
+        if (n < 0 && errno == EINTR) continue ;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return 0 ;
+        if (n <= 0) return (pending.first.empty()) ? -1 : 1 ;
+        if (ch == '\n') return 1 ;
+        pending.first += ch ;
+    }
+}
+
+static unsigned FillAddress(const char *socket_path, struct sockaddr_un &address)
+{
+    memset(&address, 0, sizeof(address)) ;
+    address.sun_family = AF_UNIX ;
+    if (!socket_path || (strlen(socket_path) >= sizeof(address.sun_path))) {
+        Message::Error(0, "socket path too long : ", (socket_path) ? socket_path : "") ;
+        return 0 ;
+    }
+    strncpy(address.sun_path, socket_path, sizeof(address.sun_path) - 1) ;
+    return 1 ;
+}
+
+/*-----------------------------------------------------------------*/
+//                      Constructor / Destructor
+/*-----------------------------------------------------------------*/
+
+TranslationServer::TranslationServer(UclidTranslator &translator, const char *socket_path)
+    : _translator(translator),
+      _socket_path(Strings::save(socket_path)),
+      _listen_fd(-1)
+{
+}
+
+TranslationServer::~TranslationServer()
+{
+    if (_listen_fd >= 0) {
+        (void) close(_listen_fd) ;
+        (void) unlink(_socket_path) ;
+    }
+    Strings::free(_socket_path) ;
+}
+
+/*-----------------------------------------------------------------*/
+//                          Socket I/O
+/*-----------------------------------------------------------------*/
+
+// static
+unsigned TranslationServer::ReadLine(int fd, std::string &line)
+{
+    line.clear() ;
+    char ch ;
+    for (;;) {
+        ssize_t n = read(fd, &ch, 1) ;
+        if (n < 0 && errno == EINTR) continue ;
+        if (n <= 0) return line.size() ? 1 : 0 ;
+        if (ch == '\n') return 1 ;
+        line += ch ;
+    }
+}
+
+// static
+unsigned TranslationServer::WriteAll(int fd, const char *data, size_t size)
+{
+    while (size) {
+        ssize_t n = write(fd, data, size) ;
+        if (n < 0 && errno == EINTR) continue ;
+        if (n <= 0) return 0 ;
+        data += n ;
+        size -= (size_t)n ;
+    }
+    return 1 ;
+}
+
+// static
+unsigned TranslationServer::Reply(int fd, unsigned ok, const std::string &text)
+{
+    std::string header = std::string((ok) ? "ok " : "error ") + std::to_string(text.size()) + "\n" ;
+    return WriteAll(fd, header.c_str(), header.size()) && WriteAll(fd, text.c_str(), text.size()) ;
+}
+
+/*-----------------------------------------------------------------*/
+//                             Server
+/*-----------------------------------------------------------------*/
+
+unsigned TranslationServer::Run()
+{
+    struct sockaddr_un address ;
+    if (!FillAddress(_socket_path, address)) return 0 ;
+
+    _listen_fd = socket(AF_UNIX, SOCK_STREAM, 0) ;
+    if (_listen_fd < 0) {
+        Message::Error(0, "cannot create socket ", _socket_path) ;
+        return 0 ;
+    }
+    (void) unlink(_socket_path) ; // A stale socket of an earlier server
+    if (bind(_listen_fd, (struct sockaddr*)&address, sizeof(address)) || listen(_listen_fd, 64)) {
+        Message::Error(0, "cannot listen on socket ", _socket_path) ;
+        (void) close(_listen_fd) ;
+        _listen_fd = -1 ;
+        return 0 ;
+    }
+
+    // Children are not waited for : let the kernel reap them. A client
+    // that hangs up must not take the server down.
+    (void) signal(SIGCHLD, SIG_IGN) ;
+    (void) signal(SIGPIPE, SIG_IGN) ;
+    Message::Info(0, "translation server listening on ", _socket_path) ;
+
+    // First lines are read here, from every client at once, so that a slow
+    // client only delays itself. The rest of a request is read by its child.
+    std::vector<PendingRequest> pending ;
+    for (;;) {
+        std::vector<struct pollfd> polled(pending.size() + 1) ;
+        polled[0].fd = _listen_fd ;
+        polled[0].events = POLLIN ;
+        int timeout_ms = -1 ;
+        time_t now = time(0) ;
+        size_t p ;
+        for (p = 0; p < pending.size(); p++) {
+            polled[p + 1].fd = pending[p].fd ;
+            polled[p + 1].events = POLLIN ;
+            int left_ms = (pending[p].deadline > now) ? (int)(pending[p].deadline - now) * 1000 : 0 ;
+            if ((timeout_ms < 0) || (left_ms < timeout_ms)) timeout_ms = left_ms ;
+        }
+        if (poll(&polled[0], (nfds_t)polled.size(), timeout_ms) < 0) {
+            if (errno == EINTR) continue ;
+            break ;
+        }
+
+        if (polled[0].revents & POLLIN) {
+            int fd = accept(_listen_fd, 0, 0) ;
+            if (fd >= 0) {
+                PendingRequest request ;
+                request.fd = fd ;
+                request.deadline = time(0) + REQUEST_TIMEOUT_SECONDS ;
+                pending.push_back(request) ;
+            } else if (errno != EINTR && errno != ECONNABORTED && errno != EAGAIN) {
+                break ;
+            }
+        }
+
+        // The connections polled, then those accepted just now (not ready yet)
+        unsigned quit = 0 ;
+        now = time(0) ;
+        size_t kept = 0 ;
+        for (p = 0; p < pending.size(); p++) {
+            PendingRequest &request = pending[p] ;
+            int state = (p + 1 < polled.size() && polled[p + 1].revents) ? ReadPending(request) : 0 ;
+            if (!state && (request.deadline > now || p + 1 >= polled.size())) {
+                pending[kept++] = request ;
+                continue ;
+            }
+            if (state <= 0) {
+                // Hung up, or too slow
+                (void) close(request.fd) ;
+                continue ;
+            }
+            if (request.first == "quit") {
+                (void) Reply(request.fd, 1, "") ;
+                (void) close(request.fd) ;
+                quit = 1 ;
+                continue ;
+            }
+
+            pid_t pid = fork() ;
+            if (pid == 0) {
+                // Child : the libraries analyzed so far are a private copy now
+                (void) close(_listen_fd) ;
+                for (size_t q = 0; q < pending.size(); q++) {
+                    if (q != p) (void) close(pending[q].fd) ;
+                }
+                struct timeval timeout ;
+                timeout.tv_sec = REQUEST_TIMEOUT_SECONDS ;
+                timeout.tv_usec = 0 ;
+                (void) setsockopt(request.fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) ;
+                unsigned ok = Serve(request.fd, request.first) ;
+                (void) close(request.fd) ;
+                _exit((ok) ? 0 : 1) ; // Skip the destructors of the server's state
+            }
+            if (pid < 0) (void) Reply(request.fd, 0, "cannot fork") ;
+            (void) close(request.fd) ;
+        }
+        pending.resize(kept) ;
+        if (quit) break ;
+    }
+    for (size_t p = 0; p < pending.size(); p++) (void) close(pending[p].fd) ;
+    return 1 ;
+}
+
+unsigned TranslationServer::Serve(int fd, const std::string &first)
+{
+    std::string top ;
+    std::string output = "uclid" ;
+    std::string line = first ;
+    do {
+        if (line == "end") break ;
+        size_t space = line.find(' ') ;
+        std::string key = line.substr(0, space) ;
+        std::string value = (space == std::string::npos) ? std::string() : line.substr(space + 1) ;
+        if (key == "top") {
+            top = value ;
+        } else if (key == "output") {
+            output = value ;
+        } else if (key == "file") {
+            if (!_translator.Analyze(value.c_str())) {
+                (void) Reply(fd, 0, "cannot analyze " + value) ;
+                return 0 ;
+            }
+        } else if (!key.empty()) {
+            (void) Reply(fd, 0, "unknown request line : " + line) ;
+            return 0 ;
+        }
+    } while (ReadLine(fd, line)) ;
+
+    std::string text ;
+    unsigned ok ;
+    if (output == "uclid") {
+        ok = _translator.TranslateUclid(top.c_str(), text) ;
+        if (!ok) text = "cannot translate " + top ;
+    } else if (output == "pretty") {
+        ok = _translator.PrettyPrint((top.empty()) ? 0 : top.c_str(), text) ;
+        if (!ok) text = "cannot pretty-print " + top ;
+    } else {
+        ok = 0 ;
+        text = "unknown output kind " + output ;
+    }
+    return (Reply(fd, ok, text) && ok) ? 1 : 0 ;
+}
+
+/*-----------------------------------------------------------------*/
+//                             Client
+/*-----------------------------------------------------------------*/
+
+// static
+unsigned TranslationServer::Request(const char *socket_path, const Array &files, const char *top, const char *output, std::ostream &os)
+{
+    struct sockaddr_un address ;
+    if (!FillAddress(socket_path, address)) return 0 ;
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0) ;
+    if (fd < 0 || connect(fd, (struct sockaddr*)&address, sizeof(address))) {
+        Message::Error(0, "cannot connect to translation server at ", socket_path) ;
+        if (fd >= 0) (void) close(fd) ;
+        return 0 ;
+    }
+
+    // The server runs elsewhere : send absolute paths
+    std::string request ;
+    if (top) request += std::string("top ") + top + "\n" ;
+    if (output) request += std::string("output ") + output + "\n" ;
+    unsigned i ;
+    const char *file_name ;
+    FOREACH_ARRAY_ITEM(&files, i, file_name) {
+        char resolved[PATH_MAX] ;
+        request += std::string("file ") + ((realpath(file_name, resolved)) ? resolved : file_name) + "\n" ;
+    }
+    request += "end\n" ;
+
+    std::string header ;
+    if (!WriteAll(fd, request.c_str(), request.size()) || !ReadLine(fd, header)) {
+        Message::Error(0, "no reply from translation server at ", socket_path) ;
+        (void) close(fd) ;
+        return 0 ;
+    }
+    size_t space = header.find(' ') ;
+    unsigned ok = (header.compare(0, space, "ok") == 0) ? 1 : 0 ;
+    unsigned long size = (space == std::string::npos) ? 0 : strtoul(header.c_str() + space + 1, 0, 10) ;
+
+    std::string text ;
+    text.reserve(size) ;
+    char buffer[65536] ;
+    while (text.size() < size) {
+        ssize_t n = read(fd, buffer, sizeof(buffer)) ;
+        if (n < 0 && errno == EINTR) continue ;
+        if (n <= 0) break ;
+        text.append(buffer, (size_t)n) ;
+    }
+    (void) close(fd) ;
+
+    if (!ok) {
+        Message::Error(0, "translation server : ", text.c_str()) ;
+        return 0 ;
+    }
+    os << text ;
+    return (text.size() == size) ? 1 : 0 ;
+}
+
+/*---------------------------------------------*/
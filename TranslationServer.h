@@ -0,0 +1,76 @@
+/*
+ *
+ * Translation daemon on a Unix domain socket.
+ *
+ * The server analyzes the shared files (packages, cell libraries) once,
+ * then waits for requests. Each request is served by a forked child, which
+ * starts from the warm libraries, analyzes the files of the request,
+ * elaborates and translates, writes the result back and exits. A request
+ * that fails or crashes takes only its child with it, and nothing it
+ * analyzed stays behind for the next one.
+ *
+ * The protocol is text. A request is a list of lines, ended by "end" :
+ *
+ *     top <module>
+ *     output uclid|pretty
+ *     file <path>              (any number, absolute paths)
+ *     end
+ *
+ * The reply is "ok <n>" or "error <n>", a newline and n bytes : the output,
+ * or the error message. A request consisting of "quit" stops the server.
+ *
+*/
+#ifndef _VERIFIC_TRANSLATION_SERVER_H_
+#define _VERIFIC_TRANSLATION_SERVER_H_
+
+#include <ostream>
+#include <string>
+
+#include "Array.h"          // Make dynamic array class Array available
+
+#ifdef VERIFIC_NAMESPACE
+namespace Verific { // start definitions in verific namespace
+#endif
+
+class UclidTranslator ;
+
+/* -------------------------------------------------------------------------- */
+
+class TranslationServer
+{
+public:
+    TranslationServer(UclidTranslator &translator, const char *socket_path) ;
+    ~TranslationServer() ;
+
+    // Serve requests until a "quit" request. Returns 0 if the socket can not be set up.
+    unsigned Run() ;
+
+    // Client side : send a request to the server at 'socket_path' and copy
+    // its output to 'os'. Error replies go to Message::Error.
+    static unsigned Request(const char *socket_path, const Array &files, const char *top, const char *output, std::ostream &os) ;
+
+private:
+    // Serve one request in the child. Its first line was read by the server.
+    unsigned Serve(int fd, const std::string &first) ;
+
+    static unsigned ReadLine(int fd, std::string &line) ;
+    static unsigned WriteAll(int fd, const char *data, size_t size) ;
+    static unsigned Reply(int fd, unsigned ok, const std::string &text) ;
+
+private:
+    UclidTranslator &_translator ;  // With the shared files analyzed
+    char            *_socket_path ;
+    int              _listen_fd ;
+
+    // Prevent the compiler from implementing the following
+    TranslationServer(const TranslationServer &node) ;
+    TranslationServer& operator=(const TranslationServer &rhs) ;
+} ;
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef VERIFIC_NAMESPACE
+} // end definitions in verific namespace
+#endif
+
+#endif // #ifndef _VERIFIC_TRANSLATION_SERVER_H_
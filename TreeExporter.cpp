@@ -0,0 +1,511 @@
+/*
+ *
+ * Binary export of the elaborated parse tree.
+ *
+*/
+
+#include <cstring>          // memcpy, memset
+#include <fstream>
+
+#include "TreeExporter.h"   // TreeExporter class definition
+#include "UclidVisitor.h"   // Constant evaluation
+
+#include "Array.h"          // Make dynamic array class Array available
+#include "Map.h"            // Make associated hash table class Map available
+#include "Set.h"            // Make associated hash table class Set available
+#include "LineFile.h"       // Source file names and line numbers
+#include "Message.h"        // Make message handlers available
+#include "Strings.h"        // A string utility/wrapper class
+
+#include "VeriModule.h"     // Definition of a VeriModule and VeriPrimitive
+#include "VeriId.h"         // Definitions of all identifier definition tree nodes
+#include "VeriExpression.h" // Definitions of all verilog expression tree nodes
+#include "VeriModuleItem.h" // Definitions of all verilog module item tree nodes
+#include "VeriStatement.h"  // Definitions of all verilog statement tree nodes
+#include "VeriMisc.h"       // Definitions of all extraneous verilog tree nodes (ie. range, path, strength, etc...)
+#include "VeriConstVal.h"   // Definitions of parse-tree nodes representing constant values in Verilog.
+
+#ifdef VERIFIC_NAMESPACE
+using namespace Verific ;
+#endif
+
+/*-----------------------------------------------------------------*/
+//                      Constructor / Destructor
+/*-----------------------------------------------------------------*/
+
+TreeExporter::TreeExporter()
+    : VeriVisitor(),
+      _nodes(),
+      _parameters(),
+      _modules(),
+      _kinds(),
+      _strings(1, '\0'),    // Offset 0 : the empty string
+      _string_offsets(STRING_HASH),
+      _kind_indexes(STRING_HASH),
+      _declarations(POINTER_HASH),
+      _references(),
+      _stack(),
+      _file_name(0),
+      _file(0),
+      _pending(),
+      _added(POINTER_HASH)
+{
+}
+
+TreeExporter::~TreeExporter()
+{
+    MapIter mi ;
+    char *str ;
+    FOREACH_MAP_ITEM(&_string_offsets, mi, &str, 0) Strings::free(str) ;
+}
+
+/*-----------------------------------------------------------------*/
+//                             Records
+/*-----------------------------------------------------------------*/
+
+uint32_t TreeExporter::String(const char *str)
+{
+    if (!str || !*str) return 0 ;
+    // Every other string is at a positive offset
+    uint32_t offset = (uint32_t)(unsigned long)_string_offsets.GetValue(str) ;
+    if (offset) return offset ;
+    offset = (uint32_t)_strings.size() ;
+    _strings.append(str) ;
+    _strings.push_back('\0') ;
+    (void) _string_offsets.Insert(Strings::save(str), (void*)(unsigned long)offset) ;
+    return offset ;
+}
+
+uint32_t TreeExporter::Kind(const char *name)
+{
+    // Class names are literals : the map keeps them as they are
+    uint32_t index = (uint32_t)(unsigned long)_kind_indexes.GetValue(name) ;
+    if (index) return index - 1 ;
+    _kinds.push_back(String(name)) ;
+    (void) _kind_indexes.Insert(name, (void*)(unsigned long)_kinds.size()) ;
+    return (uint32_t)_kinds.size() - 1 ;
+}
+
+unsigned TreeExporter::Enter(VeriTreeNode &node, const char *kind, const char *name, unsigned token)
+{
+    if (!_stack.empty() && (_stack.back().node == &node)) return 0 ;
+
+    uint32_t index = (uint32_t)_nodes.size() ;
+    ParseTreeNode record ;
+    memset(&record, 0, sizeof(record)) ;
+    record.kind = Kind(kind) ;
+    record.token = token ;
+    record.name = String(name) ;
+    record.parent = (_stack.empty()) ? PARSE_TREE_NO_NODE : _stack.back().index ;
+    record.first_child = PARSE_TREE_NO_NODE ;
+    record.next_sibling = PARSE_TREE_NO_NODE ;
+    record.ref = PARSE_TREE_NO_NODE ;
+    linefile_type linefile = node.Linefile() ;
+    if (linefile) {
+        // Nodes come file by file : look the name up only when it changes
+        const char *file_name = LineFile::GetFileName(linefile) ;
+        if (file_name != _file_name) {
+            _file_name = file_name ;
+            _file = String(file_name) ;
+        }
+        record.file = _file ;
+        record.line = LineFile::GetLineNo(linefile) ;
+    }
+    _nodes.push_back(record) ;
+
+    if (!_stack.empty()) {
+        Frame &parent = _stack.back() ;
+        if (parent.last_child == PARSE_TREE_NO_NODE) {
+            _nodes[parent.index].first_child = index ;
+        } else {
+            _nodes[parent.last_child].next_sibling = index ;
+        }
+        parent.last_child = index ;
+    }
+    Frame frame ;
+    frame.node = &node ;
+    frame.index = index ;
+    frame.last_child = PARSE_TREE_NO_NODE ;
+    _stack.push_back(frame) ;
+    return 1 ;
+}
+
+void TreeExporter::Leave()
+{
+    _stack.pop_back() ;
+}
+
+void TreeExporter::SetValue(long long value, unsigned is_signed)
+{
+    ParseTreeNode &record = _nodes[_stack.back().index] ;
+    record.flags |= PARSE_TREE_HAS_VALUE | ((is_signed) ? PARSE_TREE_SIGNED : 0) ;
+    record.value = (uint64_t)value ;
+}
+
+void TreeExporter::Declare(const void *declaration)
+{
+    // The first record of a declaration is the one references link to
+    if (_declarations.GetValue(declaration)) return ;
+    (void) _declarations.Insert(declaration, (void*)(unsigned long)(_stack.back().index + 1)) ;
+}
+
+void TreeExporter::Refer(const void *declaration)
+{
+    if (declaration) _references.push_back(std::make_pair(_stack.back().index, declaration)) ;
+}
+
+void TreeExporter::RecordConst(VeriExpression &node, unsigned is_signed)
+{
+    long long value ;
+    if (UclidVisitor::EvalConst(&node, value)) SetValue(value, is_signed) ;
+}
+
+void TreeExporter::Instantiate(VeriModule *module)
+{
+    if (!module || _added.Get(module)) return ;
+    (void) _added.Insert(module) ;
+    _pending.InsertLast(module) ;
+}
+
+void TreeExporter::Resolve()
+{
+    // Declarations may come after their references (ports, instantiated modules)
+    for (size_t i = 0; i < _references.size(); i++) {
+        uint32_t index = (uint32_t)(unsigned long)_declarations.GetValue(_references[i].second) ;
+        if (index) _nodes[_references[i].first].ref = index - 1 ;
+    }
+    _references.clear() ;
+}
+
+/*-----------------------------------------------------------------*/
+//                             Modules
+/*-----------------------------------------------------------------*/
+
+void TreeExporter::AddHierarchy(VeriModule &top)
+{
+    Instantiate(&top) ;
+    // Modules instantiated are appended while the ones before them are added
+    for (unsigned i = 0; i < _pending.Size(); i++) {
+        VeriModule *module = (VeriModule*)_pending.At(i) ;
+        if (module) AddModule(*module) ;
+    }
+    _pending.Reset() ;
+}
+
+void TreeExporter::AddModule(VeriModule &module)
+{
+    uint32_t index = (uint32_t)_nodes.size() ;
+    module.Accept(*this) ;
+    if (_nodes.size() == index) return ;
+    _modules.push_back(index) ;
+    AddParameters(module, index) ;
+}
+
+void TreeExporter::AddParameters(const VeriModule &module, uint32_t module_node)
+{
+    unsigned i ;
+    VeriIdDef *param ;
+    FOREACH_ARRAY_ITEM(module.GetParameters(), i, param) {
+        if (!param) continue ;
+        ParseTreeParameter record ;
+        memset(&record, 0, sizeof(record)) ;
+        record.module = module_node ;
+        uint32_t id = (uint32_t)(unsigned long)_declarations.GetValue(param) ;
+        record.id = (id) ? id - 1 : PARSE_TREE_NO_NODE ;
+        record.name = String(param->Name()) ;
+        VeriExpression *init = param->GetInitialValue() ;
+        if (init) {
+            char *image = init->GetPrettyPrintedString() ;
+            record.image = String(image) ;
+            Strings::free(image) ;
+            long long value ;
+            if (UclidVisitor::EvalConst(init, value)) {
+                record.flags = PARSE_TREE_HAS_VALUE ;
+                record.value = (uint64_t)value ;
+            }
+        }
+        _parameters.push_back(record) ;
+    }
+}
+
+/*-----------------------------------------------------------------*/
+//                              Output
+/*-----------------------------------------------------------------*/
+
+static uint64_t Align(uint64_t offset)
+{
+    return (offset + 7) & ~(uint64_t)7 ;
+}
+
+// Write 'size' bytes at 'offset', padding with zeros from 'written' (the bytes written so far)
+static void WriteAt(std::ostream &os, uint64_t &written, uint64_t offset, const void *data, uint64_t size)
+{
+    static const char zeros[8] = { 0 } ;
+    if (offset > written) os.write(zeros, (std::streamsize)(offset - written)) ;
+    if (size) os.write((const char*)data, (std::streamsize)size) ;
+    written = offset + size ;
+}
+
+unsigned TreeExporter::Write(std::ostream &os)
+{
+    if ((_nodes.size() >= PARSE_TREE_NO_NODE) || (_strings.size() > 0xffffffffUL)) {
+        Message::Error(0, "parse tree too large to export") ;
+        return 0 ;
+    }
+    Resolve() ;
+
+    ParseTreeHeader header ;
+    memset(&header, 0, sizeof(header)) ;
+    memcpy(header.magic, PARSE_TREE_MAGIC, sizeof(header.magic)) ;
+    header.version = PARSE_TREE_VERSION ;
+    header.byte_order = PARSE_TREE_BYTE_ORDER ;
+    header.node_size = sizeof(ParseTreeNode) ;
+    header.parameter_size = sizeof(ParseTreeParameter) ;
+    header.num_kinds = (uint32_t)_kinds.size() ;
+    header.num_nodes = (uint32_t)_nodes.size() ;
+    header.num_modules = (uint32_t)_modules.size() ;
+    header.num_parameters = (uint32_t)_parameters.size() ;
+    header.kinds = Align(sizeof(header)) ;
+    header.nodes = Align(header.kinds + _kinds.size() * sizeof(uint32_t)) ;
+    header.modules = Align(header.nodes + _nodes.size() * sizeof(ParseTreeNode)) ;
+    header.parameters = Align(header.modules + _modules.size() * sizeof(uint32_t)) ;
+    header.strings = Align(header.parameters + _parameters.size() * sizeof(ParseTreeParameter)) ;
+    header.strings_size = _strings.size() ;
+
+    uint64_t written = 0 ;
+    WriteAt(os, written, 0, &header, sizeof(header)) ;
+    WriteAt(os, written, header.kinds, (_kinds.empty()) ? 0 : &_kinds[0], _kinds.size() * sizeof(uint32_t)) ;
+    WriteAt(os, written, header.nodes, (_nodes.empty()) ? 0 : &_nodes[0], _nodes.size() * sizeof(ParseTreeNode)) ;
+    WriteAt(os, written, header.modules, (_modules.empty()) ? 0 : &_modules[0], _modules.size() * sizeof(uint32_t)) ;
+    WriteAt(os, written, header.parameters, (_parameters.empty()) ? 0 : &_parameters[0], _parameters.size() * sizeof(ParseTreeParameter)) ;
+    WriteAt(os, written, header.strings, _strings.data(), _strings.size()) ;
+    os.flush() ;
+    return os.good() ? 1 : 0 ;
+}
+
+unsigned TreeExporter::Write(const char *file_name)
+{
+    std::ofstream os(file_name, std::ios::out | std::ios::binary | std::ios::trunc) ;
+    if (!os) {
+        Message::Error(0, "cannot open file ", file_name) ;
+        return 0 ;
+    }
+    return Write(os) ;
+}
+
+/*-----------------------------------------------------------------*/
+//                          Visit Methods
+/*-----------------------------------------------------------------*/
+
+// Record the node, then let the base visitor visit its children
+#define EXPORT_NODE(CLASS) \
+void TreeExporter::VERI_VISIT(CLASS, node) \
+{ \
+    unsigned entered = Enter(node, #CLASS) ; \
+    VeriVisitor::VERI_VISIT_NODE(CLASS, node) ; \
+    if (entered) Leave() ; \
+}
+
+// Identifier declarations : their name and direction
+#define EXPORT_ID(CLASS) \
+void TreeExporter::VERI_VISIT(CLASS, node) \
+{ \
+    unsigned entered = Enter(node, #CLASS, node.Name(), node.Dir()) ; \
+    if (entered) Declare(&node) ; \
+    VeriVisitor::VERI_VISIT_NODE(CLASS, node) ; \
+    if (entered) Leave() ; \
+}
+
+// Identifier references : their name, linked to the declaration
+#define EXPORT_REF(CLASS) \
+void TreeExporter::VERI_VISIT(CLASS, node) \
+{ \
+    unsigned entered = Enter(node, #CLASS, node.GetName()) ; \
+    if (entered) Refer(node.GetId()) ; \
+    VeriVisitor::VERI_VISIT_NODE(CLASS, node) ; \
+    if (entered) Leave() ; \
+}
+
+EXPORT_NODE(VeriTreeNode)
+
+void TreeExporter::VERI_VISIT(VeriModule, node)
+{
+    unsigned entered = Enter(node, "VeriModule", node.Name()) ;
+    if (entered) Declare(&node) ;
+    VeriVisitor::VERI_VISIT_NODE(VeriModule, node) ;
+    if (entered) Leave() ;
+}
+
+void TreeExporter::VERI_VISIT(VeriPrimitive, node)
+{
+    unsigned entered = Enter(node, "VeriPrimitive", node.Name()) ;
+    if (entered) Declare(&node) ;
+    VeriVisitor::VERI_VISIT_NODE(VeriPrimitive, node) ;
+    if (entered) Leave() ;
+}
+
+EXPORT_NODE(VeriExpression)
+EXPORT_REF(VeriIdRef)
+EXPORT_REF(VeriIndexedId)
+
+void TreeExporter::VERI_VISIT(VeriSelectedName, node)
+{
+    unsigned entered = Enter(node, "VeriSelectedName", node.GetSuffix()) ;
+    VeriVisitor::VERI_VISIT_NODE(VeriSelectedName, node) ;
+    if (entered) Leave() ;
+}
+
+EXPORT_REF(VeriIndexedMemoryId)
+EXPORT_NODE(VeriConcat)
+EXPORT_NODE(VeriMultiConcat)
+EXPORT_NODE(VeriFunctionCall)
+
+void TreeExporter::VERI_VISIT(VeriSystemFunctionCall, node)
+{
+    unsigned entered = Enter(node, "VeriSystemFunctionCall", node.GetName()) ;
+    VeriVisitor::VERI_VISIT_NODE(VeriSystemFunctionCall, node) ;
+    if (entered) Leave() ;
+}
+
+EXPORT_NODE(VeriMinTypMaxExpr)
+
+void TreeExporter::VERI_VISIT(VeriUnaryOperator, node)
+{
+    unsigned entered = Enter(node, "VeriUnaryOperator", 0, node.OperType()) ;
+    VeriVisitor::VERI_VISIT_NODE(VeriUnaryOperator, node) ;
+    if (entered) Leave() ;
+}
+
+void TreeExporter::VERI_VISIT(VeriBinaryOperator, node)
+{
+    unsigned entered = Enter(node, "VeriBinaryOperator", 0, node.OperType()) ;
+    VeriVisitor::VERI_VISIT_NODE(VeriBinaryOperator, node) ;
+    if (entered) Leave() ;
+}
+
+EXPORT_NODE(VeriQuestionColon)
+EXPORT_NODE(VeriEventExpression)
+EXPORT_NODE(VeriPortConnect)
+EXPORT_NODE(VeriPortOpen)
+EXPORT_NODE(VeriAnsiPortDecl)
+EXPORT_NODE(VeriTimingCheckEvent)
+
+void TreeExporter::VERI_VISIT(VeriDataType, node)
+{
+    unsigned entered = Enter(node, "VeriDataType", 0, node.GetType()) ;
+    VeriVisitor::VERI_VISIT_NODE(VeriDataType, node) ;
+    if (entered) Leave() ;
+}
+
+EXPORT_ID(VeriIdDef)
+EXPORT_ID(VeriVariable)
+EXPORT_ID(VeriInstId)
+EXPORT_ID(VeriModuleId)
+EXPORT_ID(VeriUdpId)
+EXPORT_ID(VeriTaskId)
+EXPORT_ID(VeriFunctionId)
+EXPORT_ID(VeriGenVarId)
+EXPORT_ID(VeriParamId)
+EXPORT_ID(VeriBlockId)
+
+EXPORT_NODE(VeriRange)
+EXPORT_NODE(VeriStrength)
+EXPORT_NODE(VeriNetRegAssign)
+EXPORT_NODE(VeriCaseItem)
+EXPORT_NODE(VeriGenerateCaseItem)
+EXPORT_NODE(VeriPath)
+EXPORT_NODE(VeriDelayOrEventControl)
+
+EXPORT_NODE(VeriModuleItem)
+EXPORT_NODE(VeriDataDecl)
+EXPORT_NODE(VeriNetDecl)
+EXPORT_NODE(VeriFunctionDecl)
+EXPORT_NODE(VeriTaskDecl)
+EXPORT_NODE(VeriDefParam)
+EXPORT_NODE(VeriContinuousAssign)
+EXPORT_NODE(VeriGateInstantiation)
+
+void TreeExporter::VERI_VISIT(VeriModuleInstantiation, node)
+{
+    unsigned entered = Enter(node, "VeriModuleInstantiation", node.GetModuleName()) ;
+    if (entered) {
+        // Elaborated : each instantiation has its own module
+        VeriModule *cell = node.GetInstantiatedModule() ;
+        Refer(cell) ;
+        Instantiate(cell) ;
+    }
+    VeriVisitor::VERI_VISIT_NODE(VeriModuleInstantiation, node) ;
+    if (entered) Leave() ;
+}
+
+EXPORT_NODE(VeriSpecifyBlock)
+EXPORT_NODE(VeriPathDecl)
+EXPORT_NODE(VeriSystemTimingCheck)
+EXPORT_NODE(VeriInitialConstruct)
+EXPORT_NODE(VeriAlwaysConstruct)
+EXPORT_NODE(VeriGenerateConstruct)
+EXPORT_NODE(VeriGenerateConditional)
+EXPORT_NODE(VeriGenerateCase)
+EXPORT_NODE(VeriGenerateFor)
+EXPORT_NODE(VeriGenerateBlock)
+EXPORT_NODE(VeriTable)
+
+EXPORT_NODE(VeriStatement)
+EXPORT_NODE(VeriBlockingAssign)
+EXPORT_NODE(VeriNonBlockingAssign)
+EXPORT_NODE(VeriGenVarAssign)
+EXPORT_NODE(VeriAssign)
+EXPORT_NODE(VeriDeAssign)
+EXPORT_NODE(VeriForce)
+EXPORT_NODE(VeriRelease)
+EXPORT_NODE(VeriTaskEnable)
+
+void TreeExporter::VERI_VISIT(VeriSystemTaskEnable, node)
+{
+    unsigned entered = Enter(node, "VeriSystemTaskEnable", node.GetName()) ;
+    VeriVisitor::VERI_VISIT_NODE(VeriSystemTaskEnable, node) ;
+    if (entered) Leave() ;
+}
+
+EXPORT_NODE(VeriDelayControlStatement)
+EXPORT_NODE(VeriEventControlStatement)
+EXPORT_NODE(VeriConditionalStatement)
+EXPORT_NODE(VeriCaseStatement)
+EXPORT_NODE(VeriForever)
+EXPORT_NODE(VeriRepeat)
+EXPORT_NODE(VeriWhile)
+EXPORT_NODE(VeriFor)
+EXPORT_NODE(VeriWait)
+EXPORT_NODE(VeriDisable)
+EXPORT_NODE(VeriEventTrigger)
+EXPORT_NODE(VeriSeqBlock)
+EXPORT_NODE(VeriParBlock)
+
+EXPORT_NODE(VeriConst)
+
+void TreeExporter::VERI_VISIT(VeriConstVal, node)
+{
+    char *image = node.Image() ;
+    unsigned entered = Enter(node, "VeriConstVal", image) ;
+    Strings::free(image) ;
+    if (entered && !node.IsString()) RecordConst(node, node.IsSigned()) ;
+    VeriVisitor::VERI_VISIT_NODE(VeriConstVal, node) ;
+    if (entered) Leave() ;
+}
+
+void TreeExporter::VERI_VISIT(VeriIntVal, node)
+{
+    unsigned entered = Enter(node, "VeriIntVal") ;
+    if (entered) SetValue(node.GetNum(), 1) ;
+    VeriVisitor::VERI_VISIT_NODE(VeriIntVal, node) ;
+    if (entered) Leave() ;
+}
+
+void TreeExporter::VERI_VISIT(VeriRealVal, node)
+{
+    char *image = node.GetPrettyPrintedString() ;
+    unsigned entered = Enter(node, "VeriRealVal", image) ;
+    Strings::free(image) ;
+    VeriVisitor::VERI_VISIT_NODE(VeriRealVal, node) ;
+    if (entered) Leave() ;
+}
@@ -0,0 +1,214 @@
+/*
+ *
+ * Binary export of the elaborated parse tree (see ParseTreeReader.h).
+ *
+ * The exporter visits every node of a module hierarchy and records it as a
+ * fixed-size ParseTreeNode, linked to its parent, first child and next
+ * sibling by index, with its class, name, operator, source location and,
+ * for literals, value. Identifier references are linked to the node that
+ * declares them and instantiations to the module they instantiate, so tools
+ * reading the file can follow them without name lookup. The parameter values
+ * of each module are listed after elaboration. Strings are stored once.
+ *
+*/
+#ifndef _VERIFIC_TREE_EXPORTER_H_
+#define _VERIFIC_TREE_EXPORTER_H_
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "VeriVisitor.h"    // Visitor base class definition
+#include "Array.h"          // Make dynamic array class Array available
+#include "Map.h"            // Make associated hash table class Map available
+#include "Set.h"            // Make associated hash table class Set available
+#include "ParseTreeReader.h" // File layout
+
+#ifdef VERIFIC_NAMESPACE
+namespace Verific { // start definitions in verific namespace
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+class TreeExporter : public VeriVisitor
+{
+public:
+    TreeExporter() ;
+    virtual ~TreeExporter() ;
+
+    // Record 'top' and every module under it (each module once), top first
+    void AddHierarchy(VeriModule &top) ;
+
+    // Write what was recorded. Returns 0 if it could not be written.
+    unsigned Write(std::ostream &os) ;
+    unsigned Write(const char *file_name) ;
+
+    unsigned long NumNodes() const      { return _nodes.size() ; }
+    unsigned long NumModules() const    { return _modules.size() ; }
+
+/* ================================================================= */
+/*                         VISIT METHODS                             */
+/* ================================================================= */
+
+    // Each records the node under the node being visited and visits its children
+    // The following class definitions can be found in VeriTreeNode.h
+    virtual void VERI_VISIT(VeriTreeNode, node);
+
+    // The following class definitions can be found in VeriModule.h
+    virtual void VERI_VISIT(VeriModule, node);
+    virtual void VERI_VISIT(VeriPrimitive, node);
+
+    // The following class definitions can be found in VeriExpression.h
+    virtual void VERI_VISIT(VeriExpression, node);
+    virtual void VERI_VISIT(VeriIdRef, node);
+    virtual void VERI_VISIT(VeriIndexedId, node);
+    virtual void VERI_VISIT(VeriSelectedName, node);
+    virtual void VERI_VISIT(VeriIndexedMemoryId, node);
+    virtual void VERI_VISIT(VeriConcat, node);
+    virtual void VERI_VISIT(VeriMultiConcat, node);
+    virtual void VERI_VISIT(VeriFunctionCall, node);
+    virtual void VERI_VISIT(VeriSystemFunctionCall, node);
+    virtual void VERI_VISIT(VeriMinTypMaxExpr, node);
+    virtual void VERI_VISIT(VeriUnaryOperator, node);
+    virtual void VERI_VISIT(VeriBinaryOperator, node);
+    virtual void VERI_VISIT(VeriQuestionColon, node);
+    virtual void VERI_VISIT(VeriEventExpression, node);
+    virtual void VERI_VISIT(VeriPortConnect, node);
+    virtual void VERI_VISIT(VeriPortOpen, node);
+    virtual void VERI_VISIT(VeriAnsiPortDecl, node);
+    virtual void VERI_VISIT(VeriTimingCheckEvent, node);
+    virtual void VERI_VISIT(VeriDataType, node);
+
+    // The following class definitions can be found in VeriId.h
+    virtual void VERI_VISIT(VeriIdDef, node);
+    virtual void VERI_VISIT(VeriVariable, node);
+    virtual void VERI_VISIT(VeriInstId, node);
+    virtual void VERI_VISIT(VeriModuleId, node);
+    virtual void VERI_VISIT(VeriUdpId, node);
+    virtual void VERI_VISIT(VeriTaskId, node);
+    virtual void VERI_VISIT(VeriFunctionId, node);
+    virtual void VERI_VISIT(VeriGenVarId, node);
+    virtual void VERI_VISIT(VeriParamId, node);
+    virtual void VERI_VISIT(VeriBlockId, node);
+
+    // The following class definitions can be found in VeriMisc.h
+    virtual void VERI_VISIT(VeriRange, node);
+    virtual void VERI_VISIT(VeriStrength, node);
+    virtual void VERI_VISIT(VeriNetRegAssign, node);
+    virtual void VERI_VISIT(VeriCaseItem, node);
+    virtual void VERI_VISIT(VeriGenerateCaseItem, node);
+    virtual void VERI_VISIT(VeriPath, node);
+    virtual void VERI_VISIT(VeriDelayOrEventControl, node);
+
+    // The following class definitions can be found in VeriModuleItem.h
+    virtual void VERI_VISIT(VeriModuleItem, node);
+    virtual void VERI_VISIT(VeriDataDecl, node);
+    virtual void VERI_VISIT(VeriNetDecl, node);
+    virtual void VERI_VISIT(VeriFunctionDecl, node);
+    virtual void VERI_VISIT(VeriTaskDecl, node);
+    virtual void VERI_VISIT(VeriDefParam, node);
+    virtual void VERI_VISIT(VeriContinuousAssign, node);
+    virtual void VERI_VISIT(VeriGateInstantiation, node);
+    virtual void VERI_VISIT(VeriModuleInstantiation, node);
+    virtual void VERI_VISIT(VeriSpecifyBlock, node);
+    virtual void VERI_VISIT(VeriPathDecl, node);
+    virtual void VERI_VISIT(VeriSystemTimingCheck, node);
+    virtual void VERI_VISIT(VeriInitialConstruct, node);
+    virtual void VERI_VISIT(VeriAlwaysConstruct, node);
+    virtual void VERI_VISIT(VeriGenerateConstruct, node);
+    virtual void VERI_VISIT(VeriGenerateConditional, node);
+    virtual void VERI_VISIT(VeriGenerateCase, node);
+    virtual void VERI_VISIT(VeriGenerateFor, node);
+    virtual void VERI_VISIT(VeriGenerateBlock, node);
+    virtual void VERI_VISIT(VeriTable, node);
+
+    // The following class definitions can be found in VeriStatement.h
+    virtual void VERI_VISIT(VeriStatement, node);
+    virtual void VERI_VISIT(VeriBlockingAssign, node);
+    virtual void VERI_VISIT(VeriNonBlockingAssign, node);
+    virtual void VERI_VISIT(VeriGenVarAssign, node);
+    virtual void VERI_VISIT(VeriAssign, node);
+    virtual void VERI_VISIT(VeriDeAssign, node);
+    virtual void VERI_VISIT(VeriForce, node);
+    virtual void VERI_VISIT(VeriRelease, node);
+    virtual void VERI_VISIT(VeriTaskEnable, node);
+    virtual void VERI_VISIT(VeriSystemTaskEnable, node);
+    virtual void VERI_VISIT(VeriDelayControlStatement, node);
+    virtual void VERI_VISIT(VeriEventControlStatement, node);
+    virtual void VERI_VISIT(VeriConditionalStatement, node);
+    virtual void VERI_VISIT(VeriCaseStatement, node);
+    virtual void VERI_VISIT(VeriForever, node);
+    virtual void VERI_VISIT(VeriRepeat, node);
+    virtual void VERI_VISIT(VeriWhile, node);
+    virtual void VERI_VISIT(VeriFor, node);
+    virtual void VERI_VISIT(VeriWait, node);
+    virtual void VERI_VISIT(VeriDisable, node);
+    virtual void VERI_VISIT(VeriEventTrigger, node);
+    virtual void VERI_VISIT(VeriSeqBlock, node);
+    virtual void VERI_VISIT(VeriParBlock, node);
+
+    // The following class definitions can be found in VeriConstVal.h
+    virtual void VERI_VISIT(VeriConst, node);
+    virtual void VERI_VISIT(VeriConstVal, node);
+    virtual void VERI_VISIT(VeriIntVal, node);
+    virtual void VERI_VISIT(VeriRealVal, node);
+private:
+    // A node being visited
+    struct Frame {
+        const VeriTreeNode *node ;
+        uint32_t            index ;         // Of its record
+        uint32_t            last_child ;    // Last child recorded under it
+    } ;
+
+    // Start a record for 'node' under the current node, and make it current.
+    // Returns 0 if 'node' is the current node already (a visit of one of its base classes).
+    unsigned Enter(VeriTreeNode &node, const char *kind, const char *name = 0, unsigned token = 0) ;
+    void     Leave() ;
+
+    // Of the current node
+    void     SetValue(long long value, unsigned is_signed) ;
+    void     Declare(const void *declaration) ;     // Later references (and instantiations) link to it
+    void     Refer(const void *declaration) ;       // Link to the declaration, once it is recorded
+
+    // Constants, and the modules instantiated (to be added after this one)
+    void     RecordConst(VeriExpression &node, unsigned is_signed) ;
+    void     Instantiate(VeriModule *module) ;
+
+    void     AddModule(VeriModule &module) ;
+    void     AddParameters(const VeriModule &module, uint32_t module_node) ;
+
+    // Offset of 'str' in the string table (stored once), and index of a kind
+    uint32_t String(const char *str) ;
+    uint32_t Kind(const char *name) ;
+
+    // Fill in the 'ref' field of the references recorded
+    void     Resolve() ;
+
+private:
+    std::vector<ParseTreeNode>      _nodes ;
+    std::vector<ParseTreeParameter> _parameters ;
+    std::vector<uint32_t>           _modules ;      // Root node of each module, in order
+    std::vector<uint32_t>           _kinds ;        // String offset of each kind name
+    std::string                     _strings ;      // String table
+    Map                             _string_offsets ; // char* string -> offset + 1
+    Map                             _kind_indexes ; // char* class name -> kind index + 1
+    Map                             _declarations ; // VeriIdDef* or VeriModule* -> node index + 1
+    std::vector<std::pair<uint32_t, const void*> > _references ; // node index, declaration it refers to
+    std::vector<Frame>              _stack ;        // Nodes being visited, innermost last
+    const char                     *_file_name ;    // Source file of the last node recorded ...
+    uint32_t                        _file ;         // ... and its string offset
+    Array                           _pending ;      // VeriModule* instantiated, not added yet
+    Set                             _added ;        // VeriModule* added or pending
+
+    // Prevent the compiler from implementing the following
+    TreeExporter(const TreeExporter &node) ;
+    TreeExporter& operator=(const TreeExporter &rhs) ;
+} ;
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef VERIFIC_NAMESPACE
+} // end definitions in verific namespace
+#endif
+
+#endif // #ifndef _VERIFIC_TREE_EXPORTER_H_
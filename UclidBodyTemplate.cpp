@@ -0,0 +1,92 @@
+/*
+ *
+ * Loop bodies as templates over the loop index.
+ *
+*/
+
+#include <cctype>           // isdigit
+#include <cstdlib>          // strtoll
+
+#include "UclidBodyTemplate.h" // UclidBodyTemplate class definition
+
+#ifdef VERIFIC_NAMESPACE
+using namespace Verific ;
+#endif
+
+/*-----------------------------------------------------------------*/
+//                      Constructor / Destructor
+/*-----------------------------------------------------------------*/
+
+UclidBodyTemplate::UclidBodyTemplate()
+    : _texts(),
+      _coefs(),
+      _offsets()
+{
+}
+
+UclidBodyTemplate::~UclidBodyTemplate()
+{
+}
+
+/*-----------------------------------------------------------------*/
+//                            Templates
+/*-----------------------------------------------------------------*/
+
+unsigned UclidBodyTemplate::Fit(const std::string &body0, long long v0, const std::string &body1, long long v1)
+{
+    if (v0 == v1) return 0 ;
+    std::vector<std::string> texts1 ;
+    std::vector<long long> numbers0, numbers1 ;
+    Split(body0, _texts, numbers0) ;
+    Split(body1, texts1, numbers1) ;
+    if ((texts1 != _texts) || (numbers0.size() != numbers1.size())) return 0 ;
+
+    for (size_t k = 0; k < numbers0.size(); k++) {
+        long long delta = numbers1[k] - numbers0[k] ;
+        if (delta % (v1 - v0)) return 0 ;
+        long long coef = delta / (v1 - v0) ;
+        _coefs.push_back(coef) ;
+        _offsets.push_back(numbers0[k] - coef * v0) ;
+    }
+    return 1 ;
+}
+
+unsigned UclidBodyTemplate::Instantiate(long long v, std::string &body) const
+{
+    body.clear() ;
+    for (size_t k = 0; k < _coefs.size(); k++) {
+        long long number = _coefs[k] * v + _offsets[k] ;
+        if (number < 0) return 0 ;
+        body += _texts[k] ;
+        body += std::to_string(number) ;
+    }
+    body += _texts.back() ;
+    return 1 ;
+}
+
+// static
+void UclidBodyTemplate::Split(const std::string &text, std::vector<std::string> &texts, std::vector<long long> &numbers)
+{
+    std::string piece ;
+    size_t i = 0 ;
+    while (i < text.size()) {
+        size_t j = i ;
+        while ((j < text.size()) && isdigit((unsigned char)text[j])) j++ ;
+        if (j == i) {
+            piece += text[i++] ;
+            continue ;
+        }
+        size_t length = j - i ;
+        if ((length > 18) || ((length > 1) && (text[i] == '0'))) {
+            piece.append(text, i, length) ;
+        } else {
+            texts.push_back(piece) ;
+            piece.clear() ;
+            numbers.push_back(strtoll(text.c_str() + i, 0, 10)) ;
+        }
+        i = j ;
+    }
+    texts.push_back(piece) ;
+}
+
+/*---------------------------------------------*/
@@ -0,0 +1,55 @@
+/*
+ *
+ * Loop bodies as templates over the loop index.
+ *
+ * Most loop bodies only differ per iteration in numbers that follow the
+ * index : bit positions, constants, names of generate blocks. The UCLID
+ * text of such a body is a template with every number in it an affine
+ * function of the index, number = coef * index + offset. It is fitted on
+ * the text of two iterations, then instantiated for the others, so a loop
+ * body is translated a few times instead of once per iteration.
+ *
+*/
+#ifndef _VERIFIC_UCLID_BODY_TEMPLATE_H_
+#define _VERIFIC_UCLID_BODY_TEMPLATE_H_
+
+#include <string>
+#include <vector>
+
+#ifdef VERIFIC_NAMESPACE
+namespace Verific { // start definitions in verific namespace
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+class UclidBodyTemplate
+{
+public:
+    UclidBodyTemplate() ;
+    ~UclidBodyTemplate() ;
+
+    // Fit the template on the bodies for index 'v0' and 'v1'. Returns 0 if
+    // the two bodies do not differ in their numbers only, or not affinely.
+    unsigned Fit(const std::string &body0, long long v0, const std::string &body1, long long v1) ;
+
+    // Body for index 'v'. Returns 0 if a number would come out negative.
+    unsigned Instantiate(long long v, std::string &body) const ;
+
+private:
+    // Split 'text' into the numbers in it and the texts around them. Numbers
+    // that would not print back the same (leading zeros, too long) stay text.
+    static void Split(const std::string &text, std::vector<std::string> &texts, std::vector<long long> &numbers) ;
+
+private:
+    std::vector<std::string>    _texts ;    // Text before each number, and after the last
+    std::vector<long long>      _coefs ;
+    std::vector<long long>      _offsets ;
+} ;
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef VERIFIC_NAMESPACE
+} // end definitions in verific namespace
+#endif
+
+#endif // #ifndef _VERIFIC_UCLID_BODY_TEMPLATE_H_
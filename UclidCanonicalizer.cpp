@@ -0,0 +1,390 @@
+/*
+ *
+ * Canonical form and content hashes of emitted UCLID5 modules.
+ *
+*/
+
+#include <algorithm>        // std::sort
+#include <cctype>           // isalnum, isdigit, isspace
+#include <map>
+#include <set>
+
+#include "UclidCanonicalizer.h" // UclidCanonicalizer class definition
+#include "UclidModel.h"     // UclidModule, the items of a module
+
+#ifdef VERIFIC_NAMESPACE
+using namespace Verific ;
+#endif
+
+// 64-bit FNV-1a
+#define FNV_OFFSET_BASIS    0xcbf29ce484222325ULL
+#define FNV_PRIME           0x100000001b3ULL
+
+static unsigned IsNameChar(char ch)
+{
+    return (isalnum((unsigned char)ch) || (ch == '_')) ? 1 : 0 ;
+}
+
+// 'line' with its white space collapsed (none inside parentheses and
+// brackets or before a comma) and its bit-vector literals without leading zeros
+static std::string Normalize(const std::string &line)
+{
+    std::string out ;
+    out.reserve(line.size()) ;
+    size_t i = 0 ;
+    while (i < line.size()) {
+        char ch = line[i] ;
+        if (isspace((unsigned char)ch)) {
+            while ((i < line.size()) && isspace((unsigned char)line[i])) i++ ;
+            if (out.empty() || (i == line.size())) continue ;
+            char last = out[out.size() - 1] ;
+            char next = line[i] ;
+            if ((last == '(') || (last == '[') || (next == ')') || (next == ']') || (next == ',')) continue ;
+            out += ' ' ;
+            continue ;
+        }
+        if (isdigit((unsigned char)ch) && (out.empty() || !IsNameChar(out[out.size() - 1]))) {
+            size_t start = i ;
+            while ((i < line.size()) && IsNameChar(line[i])) i++ ;
+            std::string word = line.substr(start, i - start) ;
+            size_t suffix = word.find("bv") ;
+            if ((suffix != std::string::npos) && suffix) {
+                size_t zeros = 0 ;
+                while ((zeros + 1 < suffix) && (word[zeros] == '0')) zeros++ ;
+                word.erase(0, zeros) ;
+            }
+            out += word ;
+            continue ;
+        }
+        out += ch ;
+        i++ ;
+    }
+    return out ;
+}
+
+// The lines of 'text' (an item), normalized, without blank lines and
+// comments. Statements keep the tabs the emitter indented them with.
+static void Lines(const std::string &text, unsigned indented, std::vector<std::string> &lines)
+{
+    size_t start = 0 ;
+    while (start < text.size()) {
+        size_t end = text.find('\n', start) ;
+        if (end == std::string::npos) end = text.size() ;
+        size_t tabs = start ;
+        while ((tabs < end) && (text[tabs] == '\t')) tabs++ ;
+        std::string line = Normalize(text.substr(tabs, end - tabs)) ;
+        if (!line.empty() && (line.compare(0, 2, "//") != 0)) lines.push_back(((indented) ? text.substr(start, tabs - start) : std::string()) + line) ;
+        start = end + 1 ;
+    }
+}
+
+// Is the word ending at 'end' of 'text' a name of the module? Literals and
+// the formals of instance connections ('a : (x)') are not.
+static unsigned IsModuleName(const std::string &text, size_t start, size_t end)
+{
+    if (isdigit((unsigned char)text[start])) return 0 ;
+    return (text.compare(end, 4, " : (") == 0) ? 0 : 1 ;
+}
+
+// The names of the module in 'text', as Replace sees them
+static void ModuleNames(const std::string &text, std::vector<std::string> &names)
+{
+    size_t i = 0 ;
+    while (i < text.size()) {
+        if (!IsNameChar(text[i])) {
+            i++ ;
+            continue ;
+        }
+        size_t start = i ;
+        while ((i < text.size()) && IsNameChar(text[i])) i++ ;
+        if (IsModuleName(text, start, i)) names.push_back(text.substr(start, i - start)) ;
+    }
+}
+
+// 'text' with the names of the module that are keys of 'names' replaced by their values
+static std::string Replace(const std::string &text, const std::map<std::string, std::string> &names)
+{
+    std::string out ;
+    out.reserve(text.size()) ;
+    size_t i = 0 ;
+    while (i < text.size()) {
+        if (!IsNameChar(text[i])) {
+            out += text[i++] ;
+            continue ;
+        }
+        size_t start = i ;
+        while ((i < text.size()) && IsNameChar(text[i])) i++ ;
+        std::string word = text.substr(start, i - start) ;
+        std::map<std::string, std::string>::const_iterator ni = (IsModuleName(text, start, i)) ? names.find(word) : names.end() ;
+        out += (ni != names.end()) ? ni->second : word ;
+    }
+    return out ;
+}
+
+// Rank the 'internal' names by how they are declared and used in 'units' (the
+// lines and statements of the module), not by what they are called : 'r<rank>'
+// for each, with '_' appended while another name of the module is the same.
+// The signature of a name is the sorted list of the units it appears in, with
+// itself as '@' and every internal name as '$'. Names with the same signature
+// are told apart by name.
+static void Rank(const std::vector<std::string> &internal, const std::vector<const std::string*> &units, std::map<std::string, std::string> &ranks)
+{
+    std::map<std::string, std::string> erased ;
+    size_t n ;
+    for (n = 0; n < internal.size(); n++) erased[internal[n]] = "$" ;
+
+    std::map<std::string, std::vector<std::string> > appearances ;
+    std::set<std::string> taken ;   // The other names : ports, cells, functions
+    for (size_t u = 0; u < units.size(); u++) {
+        std::vector<std::string> names ;
+        ModuleNames(*units[u], names) ;
+        std::set<std::string> seen ;
+        for (n = 0; n < names.size(); n++) {
+            std::map<std::string, std::string>::iterator ei = erased.find(names[n]) ;
+            if (ei == erased.end()) (void) taken.insert(names[n]) ;
+            if ((ei == erased.end()) || !seen.insert(names[n]).second) continue ;
+            ei->second = "@" ;
+            appearances[names[n]].push_back(Replace(*units[u], erased)) ;
+            ei->second = "$" ;
+        }
+    }
+
+    std::vector<std::pair<std::string, std::string> > signatures ;
+    std::map<std::string, std::string>::const_iterator ei ;
+    for (ei = erased.begin(); ei != erased.end(); ei++) {
+        std::vector<std::string> &texts = appearances[ei->first] ;
+        std::sort(texts.begin(), texts.end()) ;
+        std::string signature ;
+        for (size_t t = 0; t < texts.size(); t++) signature += texts[t] + "\n" ;
+        signatures.push_back(std::make_pair(signature, ei->first)) ;
+    }
+    std::sort(signatures.begin(), signatures.end()) ;
+    for (size_t r = 0; r < signatures.size(); r++) {
+        std::string rank = "r" + std::to_string(r) ;
+        while (taken.count(rank)) rank += "_" ;
+        ranks[signatures[r].second] = rank ;
+    }
+}
+
+// Sort 'lines' by their text with the internal names ranked
+static void SortRanked(std::vector<std::string> &lines, const std::map<std::string, std::string> &ranks)
+{
+    std::vector<std::pair<std::string, std::string> > keyed ;
+    size_t l ;
+    for (l = 0; l < lines.size(); l++) keyed.push_back(std::make_pair(Replace(lines[l], ranks), lines[l])) ;
+    std::sort(keyed.begin(), keyed.end()) ;
+    for (l = 0; l < lines.size(); l++) lines[l] = keyed[l].second ;
+}
+
+// A define and the names it reads
+struct UclidDefine
+{
+    std::string                 name ;
+    std::string                 line ;
+    std::vector<std::string>    uses ;
+} ;
+
+// A statement item of the next block, and the signals it assigns
+struct UclidStatement
+{
+    std::string                 text ;
+    std::string                 key ;       // Its text with the internal names ranked
+    std::vector<std::string>    assigns ;
+
+    bool operator<(const UclidStatement &other) const { return key < other.key ; }
+} ;
+
+/*-----------------------------------------------------------------*/
+//                      Constructor / Destructor
+/*-----------------------------------------------------------------*/
+
+UclidCanonicalizer::UclidCanonicalizer()
+    : _module_name(),
+      _hash(FNV_OFFSET_BASIS),
+      _cells()
+{
+}
+
+UclidCanonicalizer::~UclidCanonicalizer()
+{
+}
+
+/*-----------------------------------------------------------------*/
+//                          Canonical form
+/*-----------------------------------------------------------------*/
+
+std::string UclidCanonicalizer::Canonicalize(const UclidModule &module)
+{
+    _module_name = module.name ;
+    _cells.clear() ;
+
+    // Sort the items of the module into its sections
+    std::vector<std::string> ports, vars, inits, instances, others ;
+    std::vector<UclidDefine> defines ;
+    std::vector<UclidStatement> statements ;
+    std::vector<std::string> internal ;     // Names of the vars, parameters, defines and instances
+    for (size_t n = 0; n < module.items.size(); n++) {
+        const UclidItem &item = module.items[n] ;
+        switch (item.kind) {
+        case UclidItem::ITEM_INPUT :
+        case UclidItem::ITEM_OUTPUT :
+            Lines(item.text, 0, ports) ;
+            break ;
+        case UclidItem::ITEM_PARAMETER :
+            Lines(item.init, 0, inits) ;
+            // Declared as a var as well
+            // fall through
+        case UclidItem::ITEM_VAR :
+            Lines(item.text, 0, vars) ;
+            internal.push_back(item.name) ;
+            break ;
+        case UclidItem::ITEM_DEFINE : {
+            UclidDefine define ;
+            define.name = item.name ;
+            std::vector<std::string> lines ;
+            Lines(item.text, 0, lines) ;
+            for (size_t l = 0; l < lines.size(); l++) define.line += ((l) ? " " : "") + lines[l] ;
+            define.uses = item.uses ;
+            defines.push_back(define) ;
+            internal.push_back(item.name) ;
+            break ;
+        }
+        case UclidItem::ITEM_INSTANCE :
+            Lines(item.text, 0, instances) ;
+            internal.push_back(item.name) ;
+            _cells.push_back(item.cell) ;
+            break ;
+        case UclidItem::ITEM_STEP :
+        case UclidItem::ITEM_STATEMENT : {
+            UclidStatement statement ;
+            std::vector<std::string> lines ;
+            Lines(item.text, 1, lines) ;
+            for (size_t l = 0; l < lines.size(); l++) statement.text += lines[l] + "\n" ;
+            statement.assigns = item.defines ;
+            if (!statement.text.empty()) statements.push_back(statement) ;
+            break ;
+        }
+        case UclidItem::ITEM_COMMENT :
+            break ;
+        default :
+            Lines(item.text, 0, others) ;
+            break ;
+        }
+    }
+
+    // Everything is sorted on its text with the internal names ranked, so that renaming one changes no order
+    std::vector<const std::string*> units ;
+    size_t i, d, s ;
+    for (i = 0; i < ports.size(); i++) units.push_back(&ports[i]) ;
+    for (i = 0; i < vars.size(); i++) units.push_back(&vars[i]) ;
+    for (i = 0; i < inits.size(); i++) units.push_back(&inits[i]) ;
+    for (d = 0; d < defines.size(); d++) units.push_back(&defines[d].line) ;
+    for (i = 0; i < instances.size(); i++) units.push_back(&instances[i]) ;
+    for (i = 0; i < others.size(); i++) units.push_back(&others[i]) ;
+    for (s = 0; s < statements.size(); s++) units.push_back(&statements[s].text) ;
+    std::map<std::string, std::string> ranks ;
+    Rank(internal, units, ranks) ;
+
+    std::sort(ports.begin(), ports.end()) ;
+    SortRanked(vars, ranks) ;
+    SortRanked(inits, ranks) ;
+    SortRanked(instances, ranks) ;
+    std::sort(_cells.begin(), _cells.end()) ;
+    _cells.erase(std::unique(_cells.begin(), _cells.end()), _cells.end()) ;
+
+    // Defines : each after the defines it reads, the smallest ranked text first
+    std::map<std::string, size_t> define_index ;
+    std::vector<std::string> define_keys ;
+    for (d = 0; d < defines.size(); d++) define_keys.push_back(Replace(defines[d].line, ranks)) ;
+    for (d = 0; d < defines.size(); d++) define_index[defines[d].name] = d ;
+    std::vector<unsigned> waiting(defines.size(), 0) ;
+    std::vector<std::vector<size_t> > readers(defines.size()) ;
+    for (d = 0; d < defines.size(); d++) {
+        std::set<size_t> read ;
+        for (size_t u = 0; u < defines[d].uses.size(); u++) {
+            std::map<std::string, size_t>::const_iterator di = define_index.find(defines[d].uses[u]) ;
+            if ((di == define_index.end()) || (di->second == d) || !read.insert(di->second).second) continue ;
+            readers[di->second].push_back(d) ;
+            waiting[d]++ ;
+        }
+    }
+    std::set<std::pair<std::string, size_t> > ready ;
+    for (d = 0; d < defines.size(); d++) if (!waiting[d]) (void) ready.insert(std::make_pair(define_keys[d], d)) ;
+    std::vector<size_t> define_order ;
+    std::vector<unsigned> placed(defines.size(), 0) ;
+    while (!ready.empty()) {
+        size_t first = ready.begin()->second ;
+        ready.erase(ready.begin()) ;
+        define_order.push_back(first) ;
+        placed[first] = 1 ;
+        for (size_t r = 0; r < readers[first].size(); r++) {
+            size_t reader = readers[first][r] ;
+            if (!--waiting[reader]) (void) ready.insert(std::make_pair(define_keys[reader], reader)) ;
+        }
+    }
+    // Defines in a loop (UCLID rejects those anyway) stay in their order
+    for (d = 0; d < defines.size(); d++) if (!placed[d]) define_order.push_back(d) ;
+
+    // Statements may only trade places if no two of them assign the same signal
+    std::set<std::string> assigned ;
+    unsigned independent = 1 ;
+    for (s = 0; independent && (s < statements.size()); s++) {
+        std::set<std::string> own(statements[s].assigns.begin(), statements[s].assigns.end()) ;
+        std::set<std::string>::const_iterator ni ;
+        for (ni = own.begin(); ni != own.end(); ni++) {
+            if (!assigned.insert(*ni).second) independent = 0 ;
+        }
+    }
+    if (independent) {
+        for (s = 0; s < statements.size(); s++) statements[s].key = Replace(statements[s].text, ranks) ;
+        std::stable_sort(statements.begin(), statements.end()) ;
+    }
+
+    // Assemble
+    std::string canonical = "module " + _module_name + " {\n" ;
+    for (i = 0; i < ports.size(); i++) canonical += ports[i] + "\n" ;
+    for (i = 0; i < vars.size(); i++) canonical += vars[i] + "\n" ;
+    if (!inits.empty()) {
+        canonical += "init {\n" ;
+        for (i = 0; i < inits.size(); i++) canonical += "\t" + inits[i] + "\n" ;
+        canonical += "}\n" ;
+    }
+    for (i = 0; i < define_order.size(); i++) canonical += defines[define_order[i]].line + "\n" ;
+    for (i = 0; i < instances.size(); i++) canonical += instances[i] + "\n" ;
+    for (i = 0; i < others.size(); i++) canonical += others[i] + "\n" ;
+    if (!statements.empty()) {
+        canonical += "next {\n" ;
+        for (s = 0; s < statements.size(); s++) canonical += statements[s].text ;
+        canonical += "}\n" ;
+    }
+    canonical += "}\n" ;
+
+    // The internal names are written as their ranks
+    canonical = Replace(canonical, ranks) ;
+    _hash = Combine(FNV_OFFSET_BASIS, canonical) ;
+    return canonical ;
+}
+
+// static
+unsigned long long UclidCanonicalizer::Combine(unsigned long long hash, const std::string &text)
+{
+    for (size_t i = 0; i < text.size(); i++) {
+        hash ^= (unsigned char)text[i] ;
+        hash *= FNV_PRIME ;
+    }
+    return hash ;
+}
+
+// static
+std::string UclidCanonicalizer::HexImage(unsigned long long hash)
+{
+    static const char digits[] = "0123456789abcdef" ;
+    std::string image(16, '0') ;
+    for (int i = 15; i >= 0; i--) {
+        image[(size_t)i] = digits[hash & 0xf] ;
+        hash >>= 4 ;
+    }
+    return image ;
+}
+
+/*---------------------------------------------*/
@@ -0,0 +1,74 @@
+/*
+ *
+ * Canonical form and content hashes of emitted UCLID5 modules.
+ *
+ * UclidCanonicalizer takes one module as UclidEmitter builds it (see
+ * UclidModel) and returns its text in a canonical form : comments and blank
+ * lines dropped, white space collapsed, bit-vector literals without leading
+ * zeros. Declarations that do not depend on each other are sorted : ports,
+ * vars, init assignments and instances by their text, defines in dependency
+ * order. The statements of the next block are sorted too, unless two of them
+ * assign the same signal.
+ *
+ * The internal vars, parameters, defines and instances are ranked by how
+ * they are declared and used, not by name, and renamed after their ranks
+ * (r0, r1 ...). Everything is sorted on its text with the internal names
+ * renamed.
+ *
+ * The hash of a module is a 64-bit FNV-1a hash of its canonical text :
+ * renaming an internal signal changes neither the text nor the hash (see
+ * canonical_check.cpp). The cone hash of a module adds the cone hashes of
+ * the cells it instantiates.
+ *
+*/
+#ifndef _VERIFIC_UCLID_CANONICALIZER_H_
+#define _VERIFIC_UCLID_CANONICALIZER_H_
+
+#include <string>
+#include <vector>
+
+#ifdef VERIFIC_NAMESPACE
+namespace Verific { // start definitions in verific namespace
+#endif
+
+struct UclidModule ;
+
+/* -------------------------------------------------------------------------- */
+
+class UclidCanonicalizer
+{
+public:
+    UclidCanonicalizer() ;
+    ~UclidCanonicalizer() ;
+
+    // The canonical text of 'module'
+    std::string Canonicalize(const UclidModule &module) ;
+
+    // Of the module canonicalized last : its name, its hash and the cells it instantiates (sorted, once each)
+    const std::string &ModuleName() const               { return _module_name ; }
+    unsigned long long Hash() const                     { return _hash ; }
+    const std::vector<std::string> &Cells() const       { return _cells ; }
+
+    // FNV-1a hash of 'text', continuing from 'hash'
+    static unsigned long long Combine(unsigned long long hash, const std::string &text) ;
+
+    // 'hash' as 16 hex digits
+    static std::string HexImage(unsigned long long hash) ;
+
+private:
+    std::string                 _module_name ;
+    unsigned long long          _hash ;
+    std::vector<std::string>    _cells ;
+
+    // Prevent the compiler from implementing the following
+    UclidCanonicalizer(const UclidCanonicalizer &node) ;
+    UclidCanonicalizer& operator=(const UclidCanonicalizer &rhs) ;
+} ;
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef VERIFIC_NAMESPACE
+} // end definitions in verific namespace
+#endif
+
+#endif // #ifndef _VERIFIC_UCLID_CANONICALIZER_H_
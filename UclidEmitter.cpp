@@ -0,0 +1,1455 @@
+/*
+ *
+ * UCLID5 model emission for statically elaborated Verilog modules.
+ *
+*/
+
+#include <algorithm>        // std::sort
+#include <map>
+#include <vector>
+#include <cctype>           // isdigit
+#include <cstdlib>          // strtoll, strtoul
+
+#include "UclidEmitter.h"   // UclidEmitter class definition
+#include "UclidVisitor.h"   // Expression translation
+#include "UclidStmtVisitor.h" // Statement translation
+#include "ModuleItemSorter.h" // Module items by kind
+#include "AlwaysClassifier.h" // Sequential and combinational always constructs
+#include "BitWidthAnalyzer.h" // Narrowing of internal signals
+#include "UclidSymbolTable.h" // UCLID names of identifiers
+#include "UclidBodyTemplate.h" // Loop bodies as templates over the index
+
+#include "Array.h"          // Make dynamic array class Array available
+#include "Map.h"            // Make associated hash table class Map available
+#include "Set.h"            // Make associated hash table class Set available
+#include "Message.h"        // Make message handlers available
+#include "Strings.h"        // A string utility/wrapper class
+
+#include "VeriModule.h"     // Definition of a VeriModule and VeriPrimitive
+#include "VeriId.h"         // Definitions of all identifier definition tree nodes
+#include "VeriExpression.h" // Definitions of all verilog expression tree nodes
+#include "VeriModuleItem.h" // Definitions of all verilog module item tree nodes
+#include "VeriStatement.h"  // Definitions of all verilog statement tree nodes
+#include "VeriMisc.h"       // Definitions of all extraneous verilog tree nodes (ie. range, path, strength, etc...)
+#include "VeriVisitor.h"    // Visitor base class definition
+#include "veri_tokens.h"
+
+#ifdef VERIFIC_NAMESPACE
+using namespace Verific ;
+#endif
+
+// Generate loops running longer than this are cut off
+#define MAX_GENERATE_ITERATIONS 1000000
+
+/*-----------------------------------------------------------------*/
+//                          Cell templates
+/*-----------------------------------------------------------------*/
+
+struct UclidEmitter::CellTemplate
+{
+    CellTemplate() : names(), prefixes(), widths(), outputs() { }
+
+    std::vector<std::string>    names ;     // Formal port names, in declaration order
+    std::vector<std::string>    prefixes ;  // "<formal> : (" for each port
+    std::vector<unsigned>       widths ;    // Port widths
+    std::vector<unsigned>       outputs ;   // Port is an output (or inout)
+} ;
+
+/*-----------------------------------------------------------------*/
+//                            Sections
+/*-----------------------------------------------------------------*/
+
+// The items of a module (or generate body), by the part of the module they go to
+struct UclidEmitter::Section
+{
+    Section() : decls(), instances(), steps(), drivers(), statements() { }
+
+    // Append the parts of 'other' to the parts of this section
+    void Append(const Section &other) ;
+
+    // Every string in the section, in order : the fields a template of a
+    // generate loop body is fitted on (see SectionTemplate)
+    void Fields(std::vector<std::string*> &fields) ;
+
+    // Are the parts as long, and their items of the same kinds with as many
+    // names, so that the fields of the two sections line up?
+    unsigned SameShape(const Section &other) const ;
+
+    // Same shape, and the same strings?
+    unsigned Same(Section &other) ;
+
+    // Append the names the section declares to 'names'
+    void Declared(std::vector<std::string> &names) const ;
+
+    UclidItems      decls ;         // Vars and defines
+    UclidItems      instances ;
+    UclidItems      steps ;         // 'next (inst) ;' steps
+    std::string     drivers ;       // Serialized drivers, one "name\twidth\tlo\thi\tvalue\n" line each
+    UclidItems      statements ;    // Statements of always constructs
+} ;
+
+static void AppendItems(UclidItems &items, const UclidItems &more)
+{
+    items.insert(items.end(), more.begin(), more.end()) ;
+}
+
+void UclidEmitter::Section::Append(const Section &other)
+{
+    AppendItems(decls, other.decls) ;
+    AppendItems(instances, other.instances) ;
+    AppendItems(steps, other.steps) ;
+    drivers += other.drivers ;
+    AppendItems(statements, other.statements) ;
+}
+
+static void ItemFields(UclidItems &items, std::vector<std::string*> &fields)
+{
+    for (size_t i = 0; i < items.size(); i++) {
+        UclidItem &item = items[i] ;
+        fields.push_back(&item.name) ;
+        fields.push_back(&item.cell) ;
+        fields.push_back(&item.text) ;
+        fields.push_back(&item.init) ;
+        for (size_t j = 0; j < item.defines.size(); j++) fields.push_back(&item.defines[j]) ;
+        for (size_t j = 0; j < item.uses.size(); j++) fields.push_back(&item.uses[j]) ;
+    }
+}
+
+void UclidEmitter::Section::Fields(std::vector<std::string*> &fields)
+{
+    ItemFields(decls, fields) ;
+    ItemFields(instances, fields) ;
+    ItemFields(steps, fields) ;
+    fields.push_back(&drivers) ;
+    ItemFields(statements, fields) ;
+}
+
+static unsigned SameItemShape(const UclidItems &a, const UclidItems &b)
+{
+    if (a.size() != b.size()) return 0 ;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].kind != b[i].kind) return 0 ;
+        if (a[i].defines.size() != b[i].defines.size()) return 0 ;
+        if (a[i].uses.size() != b[i].uses.size()) return 0 ;
+    }
+    return 1 ;
+}
+
+unsigned UclidEmitter::Section::SameShape(const Section &other) const
+{
+    return SameItemShape(decls, other.decls) && SameItemShape(instances, other.instances) &&
+           SameItemShape(steps, other.steps) && SameItemShape(statements, other.statements) ;
+}
+
+unsigned UclidEmitter::Section::Same(Section &other)
+{
+    if (!SameShape(other)) return 0 ;
+    std::vector<std::string*> mine, theirs ;
+    Fields(mine) ;
+    other.Fields(theirs) ;
+    for (size_t f = 0; f < mine.size(); f++) {
+        if (*mine[f] != *theirs[f]) return 0 ;
+    }
+    return 1 ;
+}
+
+void UclidEmitter::Section::Declared(std::vector<std::string> &names) const
+{
+    for (size_t i = 0; i < decls.size(); i++) names.push_back(decls[i].name) ;
+    for (size_t i = 0; i < instances.size(); i++) {
+        if (instances[i].kind == UclidItem::ITEM_INSTANCE) names.push_back(instances[i].name) ;
+    }
+}
+
+// A generate loop body as a template over the loop index : one template
+// per field of the body (see UclidBodyTemplate), on its items as they are
+struct UclidEmitter::SectionTemplate
+{
+    SectionTemplate() : shape(), fields() { }
+
+    // Fit the template on the bodies for index 'v0' and 'v1'. Returns 0 if
+    // they are not of the same shape, or a field does not fit.
+    unsigned Fit(Section &body0, long long v0, Section &body1, long long v1) ;
+
+    // Body for index 'v'. Returns 0 if a number would come out negative.
+    unsigned Instantiate(long long v, Section &body) const ;
+
+    Section                         shape ;
+    std::vector<UclidBodyTemplate>  fields ;
+} ;
+
+unsigned UclidEmitter::SectionTemplate::Fit(Section &body0, long long v0, Section &body1, long long v1)
+{
+    if (!body0.SameShape(body1)) return 0 ;
+    std::vector<std::string*> fields0, fields1 ;
+    body0.Fields(fields0) ;
+    body1.Fields(fields1) ;
+    fields.assign(fields0.size(), UclidBodyTemplate()) ;
+    for (size_t f = 0; f < fields0.size(); f++) {
+        if (!fields[f].Fit(*fields0[f], v0, *fields1[f], v1)) return 0 ;
+    }
+    shape = body0 ;
+    return 1 ;
+}
+
+unsigned UclidEmitter::SectionTemplate::Instantiate(long long v, Section &body) const
+{
+    body = shape ;
+    std::vector<std::string*> texts ;
+    body.Fields(texts) ;
+    for (size_t f = 0; f < texts.size(); f++) {
+        if (!fields[f].Instantiate(v, *texts[f])) return 0 ;
+    }
+    return 1 ;
+}
+
+/*-----------------------------------------------------------------*/
+//                          Signal drivers
+/*-----------------------------------------------------------------*/
+
+// Bits [lo, hi] of a signal, driven by 'value'
+struct UclidDriver
+{
+    unsigned        lo, hi ;
+    std::string     value ;
+} ;
+
+// All drivers of one signal
+struct UclidDriven
+{
+    std::string                 name ;
+    unsigned                    width ;
+    std::vector<UclidDriver>    drivers ;
+} ;
+
+static bool DriverBelow(const UclidDriver &a, const UclidDriver &b) { return a.lo < b.lo ; }
+
+// Width of an assignment target (0 if we cannot translate it)
+static unsigned LvalWidth(VeriExpression *lval, const UclidVisitor &visitor)
+{
+    if (lval && (lval->GetClassId() == ID_VERICONCAT)) {
+        unsigned width = 0 ;
+        unsigned i ;
+        VeriExpression *expr ;
+        FOREACH_ARRAY_ITEM(static_cast<VeriConcat*>(lval)->GetExpressions(), i, expr) {
+            unsigned w = LvalWidth(expr, visitor) ;
+            if (!w) return 0 ;
+            width += w ;
+        }
+        return width ;
+    }
+    VeriIdDef *id ;
+    unsigned lo, hi ;
+    return UclidVisitor::TargetBits(lval, id, lo, hi, &visitor) ? (hi - lo + 1) : 0 ;
+}
+
+// Record that 'lval' is driven by bits [offset + width(lval) - 1 : offset] of the
+// 'total' bit wide 'value'. Concatenations are split, their last element takes the low bits.
+// Drivers are serialized into 'drivers' as "name\twidth\tlo\thi\tvalue\n" lines.
+static unsigned AddDrivers(std::string &drivers, const UclidVisitor &visitor, VeriExpression *lval, const std::string &value, unsigned total, unsigned offset)
+{
+    if (lval && (lval->GetClassId() == ID_VERICONCAT)) {
+        unsigned used = 0 ;
+        unsigned i ;
+        VeriExpression *expr ;
+        FOREACH_ARRAY_ITEM_BACK(static_cast<VeriConcat*>(lval)->GetExpressions(), i, expr) {
+            unsigned w = AddDrivers(drivers, visitor, expr, value, total, offset + used) ;
+            if (!w) return 0 ;
+            used += w ;
+        }
+        return used ;
+    }
+
+    VeriIdDef *id ;
+    unsigned lo, hi ;
+    if (!UclidVisitor::TargetBits(lval, id, lo, hi, &visitor)) {
+        if (lval) lval->Warning("assignment target is not translated to UCLID") ;
+        return 0 ;
+    }
+    unsigned width = hi - lo + 1 ;
+
+    // Narrowed signals are only driven as a whole : keep their low bits
+    unsigned model_width = visitor.ModelWidth(id) ;
+    unsigned driven = width ;
+    if (model_width < UclidVisitor::IdWidth(id)) {
+        driven = model_width ;
+        hi = model_width - 1 ;
+    }
+
+    drivers += visitor.NameOf(id) ;
+    drivers += "\t" + std::to_string(model_width) + "\t" + std::to_string(lo) + "\t" + std::to_string(hi) + "\t" ;
+    if ((offset == 0) && (driven == total)) {
+        drivers += value ;
+    } else {
+        drivers += "(" + value + ")[" + std::to_string(offset + driven - 1) + ":" + std::to_string(offset) + "]" ;
+    }
+    drivers += "\n" ;
+    return width ;
+}
+
+/*-----------------------------------------------------------------*/
+//                      Constructor / Destructor
+/*-----------------------------------------------------------------*/
+
+UclidEmitter::UclidEmitter(std::ostream &os)
+    : _os(os),
+      _cells(STRING_HASH),
+      _emitted(STRING_HASH),
+      _symbols(),
+      _scope(),
+      _liveness(),
+      _prune(1),
+      _prune_report(0),
+      _narrow(1),
+      _narrow_report(0),
+      _canonicalizer(),
+      _canonical(0),
+      _hashes(0),
+      _cones(),
+      _modules(0),
+      _unroll_limit(0),
+      _inline_limit(0),
+      _inline_report(0),
+      _uf_operators(0),
+      _uf_min_width(0),
+      _uf_lemmas(0),
+      _uf_report(0),
+      _black_boxes(),
+      _black_box_functions(0),
+      _black_box_report(0)
+{
+}
+
+UclidEmitter::~UclidEmitter()
+{
+    _os.flush() ;
+
+    MapIter mi ;
+    char *name ;
+    CellTemplate *cell ;
+    FOREACH_MAP_ITEM(&_cells, mi, &name, &cell) {
+        Strings::free(name) ;
+        delete cell ;
+    }
+    SetIter si ;
+    FOREACH_SET_ITEM(&_emitted, si, &name) Strings::free(name) ;
+}
+
+/*-----------------------------------------------------------------*/
+//                          Emission
+/*-----------------------------------------------------------------*/
+
+void UclidEmitter::EmitModule(const VeriModule &module)
+{
+    // Keep the port template of every emitted module : its instances may
+    // be emitted after the module itself has been unloaded.
+    (void) RecordCell(module) ;
+
+    UclidVisitor visitor(_symbols, module.Name()) ;
+    if (_inline_limit) visitor.SetInlineLimit(_inline_limit) ;
+    visitor.SetUninterpreted(_uf_operators, _uf_min_width, _uf_lemmas) ;
+    UclidModule model ;
+    model.name = UclidSymbolTable::Legalize(module.Name()) ;
+    model.items = TranslateParameters(module, visitor) ;
+    AppendItems(model.items, TranslatePorts(module, visitor)) ;
+    if (IsBlackBox(module)) {
+        // Ports only : nothing inside is translated
+        AppendItems(model.items, TranslateBlackBox(module, visitor)) ;
+    } else {
+        if (_narrow) {
+            BitWidthAnalyzer widths ;
+            widths.Analyze(module) ;
+            std::string narrowed ;
+            (void) widths.Apply(visitor, &narrowed) ;
+            if (_narrow_report) *_narrow_report << narrowed ;
+        }
+
+        Section section ;
+        _scope = "" ;
+        TranslateItems(module.GetModuleItems(), visitor, section) ;
+
+        AppendItems(model.items, visitor.UninterpretedDecls()) ;
+        AppendItems(model.items, visitor.FunctionDefines()) ;
+        AppendItems(model.items, section.decls) ;
+        AppendItems(model.items, section.instances) ;
+        AppendItems(model.items, section.steps) ;
+        AppendItems(model.items, TranslateDrivers(section.drivers)) ;
+        AppendItems(model.items, section.statements) ;
+        if (_inline_report) *_inline_report << visitor.FunctionReport(module.Name()) ;
+        if (_uf_report) *_uf_report << visitor.UninterpretedReport(module.Name()) ;
+    }
+
+    if (_prune) {
+        std::string removed ;
+        _liveness.Prune(model, removed) ;
+        if (_prune_report) *_prune_report << removed ;
+    }
+    if (_modules) _modules->push_back(model) ;
+
+    std::string text ;
+    if (_canonical) {
+        text = _canonicalizer.Canonicalize(model) ;
+
+        // The cone hash follows the cells down, by name where they are not known
+        unsigned long long cone = _canonicalizer.Hash() ;
+        const std::vector<std::string> &cells = _canonicalizer.Cells() ;
+        for (size_t c = 0; c < cells.size(); c++) {
+            std::map<std::string, unsigned long long>::const_iterator known = _cones.find(cells[c]) ;
+            cone = UclidCanonicalizer::Combine(cone, cells[c]) ;
+            if (known != _cones.end()) cone = UclidCanonicalizer::Combine(cone, UclidCanonicalizer::HexImage(known->second)) ;
+        }
+        const char *name = _canonicalizer.ModuleName().c_str() ;
+        (void) _cones.insert(std::make_pair(std::string(name), cone)) ;
+        if (_hashes) *_hashes << name << " " << UclidCanonicalizer::HexImage(_canonicalizer.Hash()) << " " << UclidCanonicalizer::HexImage(cone) << std::endl ;
+    } else if (!_modules) {
+        text = model.Render() ;
+    }
+    if (!_modules) _os << text << std::flush ;
+
+    // The identifiers of the module may be deleted from here on (streaming)
+    _symbols.CloseScope(module.Name()) ;
+}
+
+// Instantiations in 'items', including those inside generate constructs
+static void CollectInstances(const Array *items, Array &instances) ;
+
+static void CollectGenerate(VeriModuleItem *item, Array &instances)
+{
+    if (!item) return ;
+    switch (item->GetClassId()) {
+    case ID_VERIGENERATECONSTRUCT :
+        CollectInstances(static_cast<VeriGenerateConstruct*>(item)->GetItems(), instances) ;
+        break ;
+    case ID_VERIGENERATEBLOCK :
+        CollectInstances(static_cast<VeriGenerateBlock*>(item)->GetItems(), instances) ;
+        break ;
+    case ID_VERIGENERATEFOR :
+        CollectInstances(static_cast<VeriGenerateFor*>(item)->GetItems(), instances) ;
+        break ;
+    case ID_VERIGENERATECONDITIONAL :
+        CollectGenerate(static_cast<VeriGenerateConditional*>(item)->GetThenItem(), instances) ;
+        CollectGenerate(static_cast<VeriGenerateConditional*>(item)->GetElseItem(), instances) ;
+        break ;
+    case ID_VERIGENERATECASE :
+    {
+        unsigned i ;
+        VeriGenerateCaseItem *ci ;
+        FOREACH_ARRAY_ITEM(static_cast<VeriGenerateCase*>(item)->GetCaseItems(), i, ci) {
+            if (ci) CollectGenerate(ci->GetItem(), instances) ;
+        }
+        break ;
+    }
+    default :
+    {
+        Array single(1) ;
+        single.InsertLast(item) ;
+        CollectInstances(&single, instances) ;
+        break ;
+    }
+    }
+}
+
+static void CollectInstances(const Array *items, Array &instances)
+{
+    ModuleItemSorter sorted(items) ;
+    instances.Append(&sorted.Instances()) ;
+    unsigned i ;
+    VeriModuleItem *item ;
+    FOREACH_ARRAY_ITEM(&sorted.Generates(), i, item) CollectGenerate(item, instances) ;
+}
+
+void UclidEmitter::EmitHierarchy(const VeriModule &top)
+{
+    if (_emitted.Get(top.Name())) return ;
+    (void) _emitted.Insert(Strings::save(top.Name())) ;
+
+    // UCLID needs the instantiated modules declared first. A black box needs none.
+    if (IsBlackBox(top)) {
+        EmitModule(top) ;
+        return ;
+    }
+    Array instances ;
+    CollectInstances(top.GetModuleItems(), instances) ;
+    unsigned i ;
+    VeriModuleInstantiation *inst ;
+    FOREACH_ARRAY_ITEM(&instances, i, inst) {
+        VeriModule *cell = inst->GetInstantiatedModule() ;
+        if (cell) EmitHierarchy(*cell) ;
+    }
+    EmitModule(top) ;
+}
+
+UclidItems UclidEmitter::TranslateParameters(const VeriModule &module, UclidVisitor &visitor) const
+{
+    UclidItems sparam ;
+
+    unsigned i ;
+    VeriIdDef *param ;
+    FOREACH_ARRAY_ITEM(module.GetParameters(), i, param) {
+        if (!param || !param->GetInitialValue()) continue ;
+        char *image = param->GetInitialValue()->GetPrettyPrintedString() ;
+        std::string val = image ;
+        Strings::free(image) ;
+        const char *name = visitor.NameOf(param) ;
+        if (param->IsArray()) {
+            // Sized value : the width is everything before the base quote
+            std::string rang ;
+            unsigned app = 0 ;
+            for (unsigned j = 0; j < val.length(); j++) {
+                char ch = val[j] ;
+                if (ch != '\'') {
+                    rang = rang + ch ;
+                } else {
+                    app = j ;
+                    break ;
+                }
+            }
+            UclidItem item(UclidItem::ITEM_PARAMETER, name, std::string("var ") + name + " : " + "bv" + rang + " ;\n") ;
+            item.init = std::string("\t") + name + " = " + val.substr(app+2) + "bv" + rang + " ;\n" ;
+            sparam.push_back(item) ;
+        } else {
+            UclidItem item(UclidItem::ITEM_PARAMETER, name, std::string("var ") + name + " : " + "integer ;\n") ;
+            item.init = std::string("\t") + name + " = " + val + " ;\n" ;
+            sparam.push_back(item) ;
+        }
+    }
+    return sparam ;
+}
+
+UclidItems UclidEmitter::TranslatePorts(const VeriModule &module, UclidVisitor &visitor) const
+{
+    UclidItems spor ;
+
+    unsigned i ;
+    VeriIdDef *po ;
+    FOREACH_ARRAY_ITEM(module.GetPorts(), i, po) {
+        if (!po) continue ;
+        std::string width = std::to_string(UclidVisitor::IdWidth(po)) ;
+        const char *name = visitor.NameOf(po) ;
+        UclidItem item((po->IsInput()) ? UclidItem::ITEM_INPUT : UclidItem::ITEM_OUTPUT, name, std::string((po->IsInput()) ? "input " : "output ") + name + " : " + "bv" + width + " ;\n") ;
+        spor.push_back(item) ;
+    }
+    return spor ;
+}
+
+void UclidEmitter::TranslateItems(const Array *items, UclidVisitor &visitor, Section &section)
+{
+    ModuleItemSorter sorted(items) ;
+
+    // Regs of combinational always constructs hold no state : they become defines
+    Map combinational(POINTER_HASH) ;
+    Set defined(POINTER_HASH) ;
+    ClassifyAlways(sorted, combinational, defined) ;
+
+    AppendItems(section.decls, TranslateDecls(sorted, visitor, defined)) ;
+    AppendItems(section.decls, TranslateCombinational(sorted, visitor, combinational, defined, section.statements)) ;
+    AppendItems(section.instances, TranslateInstances(sorted, visitor, section.steps)) ;
+    section.drivers += TranslateAssigns(sorted, visitor) ;
+    AppendItems(section.statements, TranslateAlways(sorted, visitor, combinational, section.decls)) ;
+
+    MapIter mi ;
+    AlwaysClassifier *kind ;
+    FOREACH_MAP_ITEM(&combinational, mi, 0, &kind) delete kind ;
+
+    unsigned i ;
+    VeriModuleItem *item ;
+    FOREACH_ARRAY_ITEM(&sorted.Generates(), i, item) TranslateGenerate(*item, visitor, section) ;
+}
+
+const char *UclidEmitter::DeclareName(const VeriIdDef &id, UclidVisitor &visitor) const
+{
+    // Inside generate blocks the name is prefixed with the block (and iteration)
+    if (!_scope.empty()) visitor.SetName(&id, (_scope + UclidSymbolTable::Legalize(id.Name())).c_str()) ;
+    return visitor.NameOf(&id) ;
+}
+
+UclidItems UclidEmitter::TranslateDecls(const ModuleItemSorter &items, UclidVisitor &visitor, const Set &defined) const
+{
+    UclidItems sdecl ;
+
+    unsigned i ;
+    VeriModuleItem *item ;
+    FOREACH_ARRAY_ITEM(&items.DataDecls(), i, item) {
+        if (!item->IsRegDecl()) continue ;
+
+        unsigned j ;
+        VeriIdDef *id ;
+        FOREACH_ARRAY_ITEM(item->GetIds(), j, id) {
+            // 'output reg' ports are already declared as outputs
+            if (!id || id->IsPort()) continue ;
+            std::string type = "bv" + std::to_string(visitor.ModelWidth(id)) ;
+            if (id->IsMemory()) {
+                // Memories are arrays from address to word
+                long long lowest ;
+                unsigned address_width = UclidVisitor::AddressWidth(id, lowest) ;
+                if (!address_width) {
+                    id->Warning("memory %s has more than one unpacked dimension and is not translated to UCLID", id->Name()) ;
+                    continue ;
+                }
+                type = "[bv" + std::to_string(address_width) + "]" + type ;
+            }
+            const char *name = DeclareName(*id, visitor) ;
+            if (defined.Get(id)) continue ; // See TranslateCombinational
+            sdecl.push_back(UclidItem(UclidItem::ITEM_VAR, name, std::string("var ") + name + " : " + type + " ;\n")) ;
+        }
+    }
+
+    FOREACH_ARRAY_ITEM(&items.NetDecls(), i, item) {
+        unsigned j ;
+        VeriIdDef *id ;
+        FOREACH_ARRAY_ITEM(item->GetIds(), j, id) {
+            if (!id || id->IsPort()) continue ;
+            const char *name = DeclareName(*id, visitor) ;
+            sdecl.push_back(UclidItem(UclidItem::ITEM_VAR, name, std::string("var ") + name + " : " + "bv" + std::to_string(visitor.ModelWidth(id)) + " ;\n")) ;
+        }
+    }
+    return sdecl ;
+}
+
+/*-----------------------------------------------------------------*/
+//                           Instances
+/*-----------------------------------------------------------------*/
+
+const UclidEmitter::CellTemplate *UclidEmitter::RecordCell(const VeriModule &module)
+{
+    CellTemplate *cell = (CellTemplate*)_cells.GetValue(module.Name()) ;
+    if (cell) return cell ;
+
+    cell = new CellTemplate ;
+    unsigned i ;
+    VeriIdDef *port ;
+    FOREACH_ARRAY_ITEM(module.GetPorts(), i, port) {
+        if (!port) continue ;
+        cell->names.push_back(port->Name()) ;
+        cell->prefixes.push_back(std::string(_symbols.Name(_symbols.Intern(port, module.Name()))) + " : (") ;
+        cell->widths.push_back(UclidVisitor::IdWidth(port)) ;
+        cell->outputs.push_back((port->IsOutput() || port->IsInout()) ? 1 : 0) ;
+    }
+    (void) _cells.Insert(Strings::save(module.Name()), cell) ;
+    return cell ;
+}
+
+const UclidEmitter::CellTemplate *UclidEmitter::GetCell(const VeriModuleInstantiation &inst)
+{
+    CellTemplate *cell = (CellTemplate*)_cells.GetValue(inst.GetModuleName()) ;
+    if (cell) return cell ;
+    VeriModule *module = inst.GetInstantiatedModule() ;
+    return (module) ? RecordCell(*module) : 0 ;
+}
+
+UclidItems UclidEmitter::TranslateInstances(const ModuleItemSorter &items, UclidVisitor &visitor, UclidItems &next)
+{
+    // Group the instantiations by cell, in order of first appearance
+    Map groups(STRING_HASH) ;
+    Array order ;
+    unsigned i ;
+    VeriModuleInstantiation *mi ;
+    FOREACH_ARRAY_ITEM(&items.Instances(), i, mi) {
+        Array *group = (Array*)groups.GetValue(mi->GetModuleName()) ;
+        if (!group) {
+            group = new Array(2) ;
+            (void) groups.Insert(mi->GetModuleName(), group) ;
+            order.InsertLast(mi->GetModuleName()) ;
+        }
+        group->InsertLast(mi) ;
+    }
+
+    UclidItems sinst ;
+    const char *cell_name ;
+    FOREACH_ARRAY_ITEM(&order, i, cell_name) {
+        Array *group = (Array*)groups.GetValue(cell_name) ;
+        std::string cell_type = UclidSymbolTable::Legalize(cell_name) ;
+
+        // The port order of the cell is resolved once for all its instances
+        const CellTemplate *cell = GetCell(*(VeriModuleInstantiation*)group->GetFirst()) ;
+        unsigned num_ports = (cell) ? (unsigned)cell->names.size() : 0 ;
+
+        UclidItems sgroup ;
+        unsigned count = 0 ;
+        unsigned j ;
+        FOREACH_ARRAY_ITEM(group, j, mi) {
+            unsigned k ;
+            VeriInstId *inst ;
+            FOREACH_ARRAY_ITEM(mi->GetInstances(), k, inst) {
+                if (!inst) continue ;
+                if (inst->GetRange()) {
+                    inst->Warning("instance array %s is not translated to UCLID", inst->Name()) ;
+                    continue ;
+                }
+
+                std::string inst_name = DeclareName(*inst, visitor) ;
+                UclidItem item(UclidItem::ITEM_INSTANCE, inst_name, "instance ") ;
+                item.cell = cell_type ;
+                std::string &line = item.text ;
+                line += inst_name ;
+                line += " : " ;
+                line += cell_type ;
+                line += "(" ;
+                unsigned num_connected = 0 ;
+                unsigned p ;
+                VeriExpression *pc ;
+                FOREACH_ARRAY_ITEM(inst->GetPortConnects(), p, pc) {
+                    if (!pc) continue ;
+                    unsigned pos = p ;
+                    VeriExpression *actual = pc ;
+                    const char *formal = 0 ;
+                    if (pc->GetClassId() == ID_VERIPORTCONNECT) {
+                        formal = pc->GetNamedFormal() ;
+                        actual = pc->GetConnection() ;
+                        // Netlists connect in declaration order : try that position first
+                        if (formal && !((pos < num_ports) && (cell->names[pos] == formal))) {
+                            for (pos = 0; pos < num_ports; pos++) if (cell->names[pos] == formal) break ;
+                        }
+                    }
+                    if (!actual || (actual->GetClassId() == ID_VERIPORTOPEN)) continue ;
+
+                    std::string prefix ;
+                    unsigned width = 0 ;
+                    unsigned is_input = 1, is_output = 1 ; // Unknown for ports the cell does not have
+                    if (pos < num_ports) {
+                        is_output = cell->outputs[pos] ;
+                        is_input = !is_output ;
+                        prefix = cell->prefixes[pos] ;
+                        width = cell->widths[pos] ;
+                        if (cell->outputs[pos] && (actual->GetClassId() != ID_VERIIDREF)) {
+                            actual->Warning("output %s of instance %s should connect to a signal in UCLID", cell->names[pos].c_str(), inst->Name()) ;
+                        }
+                    } else if (formal) {
+                        prefix = UclidSymbolTable::Legalize(formal) + " : (" ;
+                    } else {
+                        inst->Warning("cannot resolve port %d of instance %s", (int)p + 1, inst->Name()) ;
+                        continue ;
+                    }
+
+                    UclidTerm term = visitor.Translate(actual, width) ;
+                    std::string value = (width) ? UclidVisitor::AsBv(term, width) : term.text ;
+                    if (num_connected++) line += ", " ;
+                    line += prefix ;
+                    line += value ;
+                    line += ")" ;
+                    if (is_output) UclidItem::Names(value, item.defines) ;
+                    if (is_input) UclidItem::Names(value, item.uses) ;
+                }
+                line += ") ;\n" ;
+                sgroup.push_back(item) ;
+                next.push_back(UclidItem(UclidItem::ITEM_STEP, inst_name, "\tnext (" + inst_name + ") ;\n")) ;
+                count++ ;
+            }
+        }
+        sinst.push_back(UclidItem(UclidItem::ITEM_COMMENT, "", "// cell " + cell_type + " : " + std::to_string(count) + " instances\n")) ;
+        AppendItems(sinst, sgroup) ;
+        delete group ;
+    }
+    return sinst ;
+}
+
+/*-----------------------------------------------------------------*/
+//                 Continuous assignments and gates
+/*-----------------------------------------------------------------*/
+
+std::string UclidEmitter::TranslateAssigns(const ModuleItemSorter &items, UclidVisitor &visitor) const
+{
+    // All drivers of a signal are collected first (TranslateDrivers) :
+    // UCLID wants one assignment per signal, even if its bits are driven
+    // separately, or from different generate blocks.
+    std::string drivers = "" ;
+
+    unsigned i, j ;
+    VeriContinuousAssign *assign ;
+    FOREACH_ARRAY_ITEM(&items.Assigns(), i, assign) {
+        VeriNetRegAssign *nra ;
+        FOREACH_ARRAY_ITEM(assign->GetNetAssigns(), j, nra) {
+            if (!nra) continue ;
+            unsigned width = LvalWidth(nra->GetLValExpr(), visitor) ;
+            if (!width) {
+                nra->Warning("assignment target is not translated to UCLID") ;
+                continue ;
+            }
+            UclidTerm term = visitor.Translate(nra->GetRValExpr(), width) ;
+            (void) AddDrivers(drivers, visitor, nra->GetLValExpr(), UclidVisitor::AsBv(term, width), width, 0) ;
+        }
+    }
+
+    VeriGateInstantiation *gate ;
+    FOREACH_ARRAY_ITEM(&items.Gates(), i, gate) {
+        const char *op = 0 ;
+        unsigned invert = 0 ;
+        switch (gate->GetInstType()) {
+        case VERI_NAND : invert = 1 ; // fall through
+        case VERI_AND :  op = " & " ; break ;
+        case VERI_NOR :  invert = 1 ; // fall through
+        case VERI_OR :   op = " | " ; break ;
+        case VERI_XNOR : invert = 1 ; // fall through
+        case VERI_XOR :  op = " ^ " ; break ;
+        case VERI_NOT :  invert = 1 ; // fall through
+        case VERI_BUF :  break ;
+        default :
+            gate->Warning("gate primitive is not translated to UCLID") ;
+            continue ;
+        }
+
+        VeriInstId *inst ;
+        FOREACH_ARRAY_ITEM(gate->GetInstances(), j, inst) {
+            Array *ports = (inst) ? inst->GetPortConnects() : 0 ;
+            if (!ports || (ports->Size() < 2)) continue ;
+            if (inst->GetRange()) {
+                inst->Warning("instance array %s is not translated to UCLID", inst->Name()) ;
+                continue ;
+            }
+
+            unsigned k ;
+            VeriExpression *port ;
+            std::string value = "" ;
+            if (op) {
+                // and/or/xor : one output, then the inputs
+                FOREACH_ARRAY_ITEM(ports, k, port) {
+                    if (!k) continue ;
+                    if (k > 1) value += op ;
+                    value += UclidVisitor::AsBv(visitor.Translate(port, 1), 1) ;
+                }
+                if (invert) value = "~(" + value + ")" ;
+                (void) AddDrivers(drivers, visitor, (VeriExpression*)ports->At(0), value, 1, 0) ;
+            } else {
+                // buf/not : the outputs, then one input
+                value = UclidVisitor::AsBv(visitor.Translate((VeriExpression*)ports->GetLast(), 1), 1) ;
+                if (invert) value = "~" + value ;
+                FOREACH_ARRAY_ITEM(ports, k, port) {
+                    if (k + 1 < ports->Size()) (void) AddDrivers(drivers, visitor, port, value, 1, 0) ;
+                }
+            }
+        }
+    }
+    return drivers ;
+}
+
+// static
+UclidItems UclidEmitter::TranslateDrivers(const std::string &drivers)
+{
+    // Group the serialized drivers by signal, in order of first appearance
+    Map signals(STRING_HASH) ;
+    Array order ;
+    size_t start = 0 ;
+    while (start < drivers.size()) {
+        size_t end = drivers.find('\n', start) ;
+        if (end == std::string::npos) end = drivers.size() ;
+        size_t f1 = drivers.find('\t', start) ;
+        size_t f2 = drivers.find('\t', f1 + 1) ;
+        size_t f3 = drivers.find('\t', f2 + 1) ;
+        size_t f4 = drivers.find('\t', f3 + 1) ;
+        if ((f4 == std::string::npos) || (f4 > end)) break ;
+
+        std::string name = drivers.substr(start, f1 - start) ;
+        UclidDriven *signal = (UclidDriven*)signals.GetValue(name.c_str()) ;
+        if (!signal) {
+            signal = new UclidDriven ;
+            signal->name = name ;
+            signal->width = (unsigned)strtoul(drivers.c_str() + f1 + 1, 0, 10) ;
+            (void) signals.Insert(signal->name.c_str(), signal) ;
+            order.InsertLast(signal) ;
+        }
+        UclidDriver driver ;
+        driver.lo = (unsigned)strtoul(drivers.c_str() + f2 + 1, 0, 10) ;
+        driver.hi = (unsigned)strtoul(drivers.c_str() + f3 + 1, 0, 10) ;
+        driver.value = drivers.substr(f4 + 1, end - f4 - 1) ;
+        signal->drivers.push_back(driver) ;
+        start = end + 1 ;
+    }
+
+    // One primed assignment per signal. Bits nobody drives keep their value.
+    UclidItems sassign ;
+    unsigned i ;
+    UclidDriven *signal ;
+    FOREACH_ARRAY_ITEM(&order, i, signal) {
+        std::vector<UclidDriver> &sorted = signal->drivers ;
+        std::sort(sorted.begin(), sorted.end(), DriverBelow) ;
+
+        const std::string &name = signal->name ;
+        std::string value = "" ;
+        unsigned top = signal->width ; // Bits [top-1:...] still to cover
+        unsigned pieces = 0 ;
+        for (unsigned k = (unsigned)sorted.size(); k-- != 0; ) {
+            const UclidDriver &driver = sorted[k] ;
+            if (driver.hi >= top) {
+                Message::Warning(0, name.c_str(), " has multiple drivers, only one is translated to UCLID") ;
+                continue ;
+            }
+            if (driver.hi + 1 < top) {
+                value += (pieces++ ? " ++ " : "") + name + "[" + std::to_string(top - 1) + ":" + std::to_string(driver.hi + 1) + "]" ;
+            }
+            value += (pieces++ ? " ++ " : "") + driver.value ;
+            top = driver.lo ;
+        }
+        if (top) value += (pieces++ ? " ++ " : "") + name + "[" + std::to_string(top - 1) + ":0]" ;
+        sassign.push_back(UclidItem::Assign(name, value)) ;
+        delete signal ;
+    }
+    return sassign ;
+}
+
+/*-----------------------------------------------------------------*/
+//                        Always constructs
+/*-----------------------------------------------------------------*/
+
+// The combinational constructs of 'always' in an order where each comes
+// after the constructs computing the 'defined' regs it reads. Constructs
+// that read each other in a loop (and those reading them) are not in 'order'.
+static void OrderCombinational(const Array &always, const Map &combinational, const Set &defined, Array &order)
+{
+    Map owner(POINTER_HASH) ;   // VeriIdDef* of 'defined' -> VeriAlwaysConstruct*
+    unsigned i, j ;
+    VeriAlwaysConstruct *construct ;
+    VeriIdDef *id ;
+    FOREACH_ARRAY_ITEM(&always, i, construct) {
+        AlwaysClassifier *kind = (AlwaysClassifier*)combinational.GetValue(construct) ;
+        if (!kind) continue ;
+        FOREACH_ARRAY_ITEM(&kind->Targets(), j, id) {
+            if (defined.Get(id)) (void) owner.Insert(id, construct) ;
+        }
+    }
+
+    Set done(POINTER_HASH) ;
+    unsigned progress = 1 ;
+    while (progress) {
+        progress = 0 ;
+        FOREACH_ARRAY_ITEM(&always, i, construct) {
+            AlwaysClassifier *kind = (AlwaysClassifier*)combinational.GetValue(construct) ;
+            if (!kind || done.Get(construct)) continue ;
+            unsigned ready = 1 ;
+            SetIter si ;
+            FOREACH_SET_ITEM(&kind->Reads(), si, &id) {
+                VeriAlwaysConstruct *from = (VeriAlwaysConstruct*)owner.GetValue(id) ;
+                if (from && (from != construct) && !done.Get(from)) ready = 0 ;
+            }
+            if (!ready) continue ;
+            (void) done.Insert(construct) ;
+            order.InsertLast(construct) ;
+            progress = 1 ;
+        }
+    }
+}
+
+// static
+void UclidEmitter::ClassifyAlways(const ModuleItemSorter &items, Map &combinational, Set &defined)
+{
+    // Number of always constructs assigning each identifier
+    Map writers(POINTER_HASH) ;     // VeriIdDef* -> count
+    Array classifiers(items.Always().Size()) ;
+    unsigned i, j ;
+    VeriAlwaysConstruct *always ;
+    VeriIdDef *id ;
+    FOREACH_ARRAY_ITEM(&items.Always(), i, always) {
+        AlwaysClassifier *kind = new AlwaysClassifier(*always) ;
+        classifiers.InsertLast(kind) ;
+        FOREACH_ARRAY_ITEM(&kind->Targets(), j, id) {
+            unsigned long count = (unsigned long)writers.GetValue(id) ;
+            (void) writers.Insert(id, (void*)(count + 1), 1 /* force overwrite */) ;
+        }
+    }
+
+    // Regs declared among the items, other than ports ('output reg' stays an output)
+    Set local(POINTER_HASH) ;
+    VeriModuleItem *item ;
+    FOREACH_ARRAY_ITEM(&items.DataDecls(), i, item) {
+        if (!item->IsRegDecl()) continue ;
+        FOREACH_ARRAY_ITEM(item->GetIds(), j, id) {
+            if (id && !id->IsPort() && !id->IsMemory()) (void) local.Insert(id) ;
+        }
+    }
+
+    FOREACH_ARRAY_ITEM(&items.Always(), i, always) {
+        AlwaysClassifier *kind = (AlwaysClassifier*)classifiers.At(i) ;
+        unsigned shared = 0 ;
+        FOREACH_ARRAY_ITEM(&kind->Targets(), j, id) {
+            if ((unsigned long)writers.GetValue(id) > 1) shared = 1 ;
+        }
+        if (shared || (kind->GetKind() != AlwaysClassifier::ALWAYS_COMBINATIONAL)) {
+            delete kind ;
+            continue ;
+        }
+        (void) combinational.Insert(always, kind) ;
+        FOREACH_ARRAY_ITEM(&kind->Targets(), j, id) {
+            if (local.Get(id)) (void) defined.Insert(id) ;
+        }
+    }
+
+    // Combinational loops keep their regs as state
+    Array order ;
+    OrderCombinational(items.Always(), combinational, defined, order) ;
+    if (order.Size() == combinational.Size()) return ;
+    Set ordered(POINTER_HASH) ;
+    FOREACH_ARRAY_ITEM(&order, i, always) (void) ordered.Insert(always) ;
+    FOREACH_ARRAY_ITEM(&items.Always(), i, always) {
+        AlwaysClassifier *kind = (AlwaysClassifier*)combinational.GetValue(always) ;
+        if (!kind || ordered.Get(always)) continue ;
+        always->Warning("always construct is part of a combinational loop, kept as state in UCLID") ;
+        FOREACH_ARRAY_ITEM(&kind->Targets(), j, id) (void) defined.Remove(id) ;
+        (void) combinational.Remove(always) ;
+        delete kind ;
+    }
+}
+
+UclidItems UclidEmitter::TranslateCombinational(const ModuleItemSorter &items, UclidVisitor &visitor, Map &combinational, Set &defined, UclidItems &next) const
+{
+    UclidItems vars ;
+    UclidItems defines ;
+    UclidItems assigns ;
+
+    UclidStmtVisitor statements(visitor) ;
+    if (_unroll_limit) statements.SetUnrollLimit(_unroll_limit) ;
+    unsigned i, j ;
+    VeriAlwaysConstruct *always ;
+    VeriIdDef *id ;
+    unsigned failed = 1 ;
+    while (failed) {
+        // A construct that can not be evaluated keeps its regs as vars. The
+        // constructs evaluated before it may call their defines : start over.
+        failed = 0 ;
+        defines.clear() ;
+        assigns.clear() ;
+
+        // Reads of a computed reg call its define
+        Array order ;
+        OrderCombinational(items.Always(), combinational, defined, order) ;
+        FOREACH_ARRAY_ITEM(&order, i, always) {
+            AlwaysClassifier *kind = (AlwaysClassifier*)combinational.GetValue(always) ;
+            FOREACH_ARRAY_ITEM(&kind->Targets(), j, id) {
+                if (defined.Get(id)) visitor.SetValue(id, std::string(visitor.NameOf(id)) + "()") ;
+            }
+        }
+
+        FOREACH_ARRAY_ITEM(&order, i, always) {
+            AlwaysClassifier *kind = (AlwaysClassifier*)combinational.GetValue(always) ;
+            // Values shared by the iterations of loops go to defines of their own
+            UclidStmtVisitor::Values values ;
+            UclidItems shared ;
+            unsigned ok = statements.Evaluate(always->GetStmt(), values, &shared) ;
+            FOREACH_ARRAY_ITEM(&kind->Targets(), j, id) {
+                if (values.find(id) == values.end()) ok = 0 ;
+                // Evaluate leaves the values of the block bound
+                if (defined.Get(id)) {
+                    visitor.SetValue(id, std::string(visitor.NameOf(id)) + "()") ;
+                } else {
+                    visitor.ClearValue(id) ;
+                }
+            }
+            if (!ok) {
+                always->Warning("always construct is not computed in UCLID, kept as state") ;
+                FOREACH_ARRAY_ITEM(&kind->Targets(), j, id) {
+                    if (!defined.Get(id)) continue ;
+                    visitor.ClearValue(id) ;
+                    (void) defined.Remove(id) ;
+                    const char *name = visitor.NameOf(id) ;
+                    vars.push_back(UclidItem(UclidItem::ITEM_VAR, name, std::string("var ") + name + " : bv" + std::to_string(visitor.ModelWidth(id)) + " ;\n")) ;
+                }
+                (void) combinational.Remove(always) ;
+                delete kind ;
+                failed = 1 ;
+                break ;
+            }
+
+            AppendItems(defines, shared) ;
+            FOREACH_ARRAY_ITEM(&kind->Targets(), j, id) {
+                std::string name = visitor.NameOf(id) ;
+                if (defined.Get(id)) {
+                    defines.push_back(UclidItem::Define(name, "", visitor.ModelWidth(id), values[id])) ;
+                } else {
+                    assigns.push_back(UclidItem::Assign(name, values[id])) ;
+                }
+            }
+        }
+    }
+    AppendItems(next, assigns) ;
+    AppendItems(vars, defines) ;
+    return vars ;
+}
+
+UclidItems UclidEmitter::TranslateAlways(const ModuleItemSorter &items, UclidVisitor &visitor, const Map &combinational, UclidItems &decls) const
+{
+    UclidItems salways ;
+
+    UclidStmtVisitor statements(visitor) ;
+    if (_unroll_limit) statements.SetUnrollLimit(_unroll_limit) ;
+    unsigned i ;
+    VeriAlwaysConstruct *always ;
+    FOREACH_ARRAY_ITEM(&items.Always(), i, always) {
+        if (combinational.GetValue(always)) continue ; // See TranslateCombinational
+
+        // One next-state expression per assigned signal, where the block allows it
+        UclidStmtVisitor::Values values ;
+        if (statements.EvaluateNext(always->GetStmt(), values, decls)) {
+            AlwaysClassifier block(*always) ;
+            unsigned j ;
+            VeriIdDef *id ;
+            FOREACH_ARRAY_ITEM(&block.Targets(), j, id) {
+                UclidStmtVisitor::Values::const_iterator vi = values.find(id) ;
+                if (vi == values.end()) continue ;
+                salways.push_back(UclidItem::Assign(visitor.NameOf(id), vi->second)) ;
+            }
+            continue ;
+        }
+
+        // The statements of the construct go together, with what they assign
+        UclidItem item(UclidItem::ITEM_STATEMENT, "", statements.Translate(always->GetStmt(), 1)) ;
+        if (item.text.empty()) continue ;
+        const std::vector<const VeriIdDef*> &targets = statements.Targets() ;
+        for (size_t t = 0; t < targets.size(); t++) item.defines.push_back(visitor.NameOf(targets[t])) ;
+        UclidItem::Names(item.text, item.uses) ;
+        salways.push_back(item) ;
+    }
+    return salways ;
+}
+
+/*-----------------------------------------------------------------*/
+//                       Generate constructs
+/*-----------------------------------------------------------------*/
+
+void UclidEmitter::TranslateGenerate(VeriModuleItem &item, UclidVisitor &visitor, Section &section)
+{
+    switch (item.GetClassId()) {
+    case ID_VERIGENERATECONSTRUCT :
+        TranslateItems(static_cast<VeriGenerateConstruct&>(item).GetItems(), visitor, section) ;
+        break ;
+    case ID_VERIGENERATEBLOCK :
+    {
+        VeriGenerateBlock &block = static_cast<VeriGenerateBlock&>(item) ;
+        if (block.GetBlockId()) {
+            TranslateScope(block.GetItems(), _scope + UclidSymbolTable::Legalize(block.GetBlockId()->Name()) + "_", visitor, section) ;
+        } else {
+            TranslateItems(block.GetItems(), visitor, section) ;
+        }
+        break ;
+    }
+    case ID_VERIGENERATECONDITIONAL :
+    {
+        VeriGenerateConditional &cond = static_cast<VeriGenerateConditional&>(item) ;
+        long long value ;
+        if (!UclidVisitor::EvalConst(cond.GetIfExpr(), value, &visitor)) {
+            item.Warning("generate if condition is not constant, not translated to UCLID") ;
+            break ;
+        }
+        VeriModuleItem *chosen = (value) ? cond.GetThenItem() : cond.GetElseItem() ;
+        if (chosen) TranslateGenerate(*chosen, visitor, section) ;
+        break ;
+    }
+    case ID_VERIGENERATECASE :
+    {
+        VeriGenerateCase &gen_case = static_cast<VeriGenerateCase&>(item) ;
+        long long value ;
+        if (!UclidVisitor::EvalConst(gen_case.GetCondition(), value, &visitor)) {
+            item.Warning("generate case expression is not constant, not translated to UCLID") ;
+            break ;
+        }
+        // First item that matches, else the default
+        VeriModuleItem *chosen = 0, *fallback = 0 ;
+        unsigned i, j ;
+        VeriGenerateCaseItem *ci ;
+        FOREACH_ARRAY_ITEM(gen_case.GetCaseItems(), i, ci) {
+            if (!ci) continue ;
+            if (!ci->GetConditions() || !ci->GetConditions()->Size()) {
+                if (!fallback) fallback = ci->GetItem() ;
+                continue ;
+            }
+            VeriExpression *label ;
+            FOREACH_ARRAY_ITEM(ci->GetConditions(), j, label) {
+                long long label_value ;
+                if (UclidVisitor::EvalConst(label, label_value, &visitor) && (label_value == value)) break ;
+            }
+            if (j < ci->GetConditions()->Size()) {
+                chosen = ci->GetItem() ;
+                break ;
+            }
+        }
+        if (!chosen) chosen = fallback ;
+        if (chosen) TranslateGenerate(*chosen, visitor, section) ;
+        break ;
+    }
+    case ID_VERIGENERATEFOR :
+        TranslateGenerateFor(static_cast<VeriGenerateFor&>(item), visitor, section) ;
+        break ;
+    default :
+    {
+        // A single item as the branch of a generate if or case
+        Array single(1) ;
+        single.InsertLast(&item) ;
+        TranslateItems(&single, visitor, section) ;
+        break ;
+    }
+    }
+}
+
+void UclidEmitter::TranslateScope(const Array *items, const std::string &scope, UclidVisitor &visitor, Section &section)
+{
+    std::string saved = _scope ;
+    _scope = scope ;
+    TranslateItems(items, visitor, section) ;
+    _scope = saved ;
+
+    // The block names are only valid inside the block
+    ModuleItemSorter sorted(items) ;
+    unsigned i, j ;
+    VeriModuleItem *item ;
+    VeriIdDef *id ;
+    FOREACH_ARRAY_ITEM(&sorted.DataDecls(), i, item) {
+        FOREACH_ARRAY_ITEM(item->GetIds(), j, id) {
+            visitor.ClearName(id) ;
+            visitor.ClearValue(id) ;
+        }
+    }
+    FOREACH_ARRAY_ITEM(&sorted.NetDecls(), i, item) {
+        FOREACH_ARRAY_ITEM(item->GetIds(), j, id) visitor.ClearName(id) ;
+    }
+}
+
+void UclidEmitter::TranslateIteration(VeriGenerateFor &loop, UclidVisitor &visitor, const VeriIdDef *genvar, long long value, unsigned template_index, Section &body)
+{
+    std::string block = (loop.GetBlockId()) ? UclidSymbolTable::Legalize(loop.GetBlockId()->Name()) : "genblk" ;
+    std::string index = (value < 0) ? "n" + std::to_string(-value) : std::to_string(value) ;
+
+    visitor.BindGenvar(genvar, value, template_index) ;
+    TranslateScope(loop.GetItems(), _scope + block + "_" + index + "_", visitor, body) ;
+    visitor.UnbindGenvar(genvar) ;
+}
+
+void UclidEmitter::TranslateGenerateFor(VeriGenerateFor &loop, UclidVisitor &visitor, Section &section)
+{
+    VeriModuleItem *initial = loop.GetInitial() ;
+    VeriModuleItem *repetition = loop.GetRepetition() ;
+    if (!initial || (initial->GetClassId() != ID_VERIGENVARASSIGN) ||
+        !repetition || (repetition->GetClassId() != ID_VERIGENVARASSIGN)) {
+        loop.Warning("generate loop is not translated to UCLID") ;
+        return ;
+    }
+    VeriGenVarAssign *init = static_cast<VeriGenVarAssign*>(initial) ;
+    VeriGenVarAssign *step = static_cast<VeriGenVarAssign*>(repetition) ;
+    VeriIdDef *genvar = init->GetId() ;
+
+    // Values the genvar takes
+    std::vector<long long> values ;
+    long long value ;
+    if (!genvar || !UclidVisitor::EvalConst(init->GetValue(), value, &visitor)) {
+        loop.Warning("generate loop start is not constant, not translated to UCLID") ;
+        return ;
+    }
+    for (;;) {
+        visitor.BindGenvar(genvar, value, 0) ;
+        long long condition ;
+        if (!UclidVisitor::EvalConst(loop.GetCondition(), condition, &visitor)) {
+            loop.Warning("generate loop condition is not constant, not translated to UCLID") ;
+            break ;
+        }
+        if (!condition) break ;
+        if (values.size() >= MAX_GENERATE_ITERATIONS) {
+            loop.Warning("generate loop stopped after %d iterations", MAX_GENERATE_ITERATIONS) ;
+            break ;
+        }
+        values.push_back(value) ;
+        if (!UclidVisitor::EvalConst(step->GetValue(), value, &visitor)) {
+            loop.Warning("generate loop step is not constant, not translated to UCLID") ;
+            break ;
+        }
+    }
+    visitor.UnbindGenvar(genvar) ;
+
+    size_t num = values.size() ;
+    std::vector<Section> bodies(num) ;
+    std::vector<unsigned> done(num, 0) ;
+
+    // Most loop bodies only differ per iteration in numbers that follow the
+    // index : bit positions, constants, and the block name. Translate the
+    // first and last iterations, fit a template over the index on them, and
+    // check it against a third one. If the body depends on the index any
+    // other way (a generate if on it, say) every iteration is translated.
+    if (num >= 4) {
+        unsigned outer = visitor.NonAffine() ;
+        visitor.SetNonAffine(0) ;
+        size_t probes[3] = { 0, num - 1, num / 2 } ;
+        for (unsigned k = 0; k < 3; k++) {
+            TranslateIteration(loop, visitor, genvar, values[probes[k]], 1, bodies[probes[k]]) ;
+            done[probes[k]] = 1 ;
+        }
+        unsigned inner = visitor.NonAffine() ;
+
+        long long lowest = (values[0] < values[num - 1]) ? values[0] : values[num - 1] ;
+        long long highest = (values[0] < values[num - 1]) ? values[num - 1] : values[0] ;
+        unsigned in_range = 1 ;
+        for (size_t i = 0; i < num; i++) if ((values[i] < lowest) || (values[i] > highest)) in_range = 0 ;
+
+        SectionTemplate body ;
+        Section middle ;
+        if (!inner && in_range && body.Fit(bodies[0], values[0], bodies[num - 1], values[num - 1]) &&
+            body.Instantiate(values[num / 2], middle) && middle.Same(bodies[num / 2])) {
+            // Numbers are affine in the index, and non-negative at both ends : they are between.
+            // The names an instantiated iteration declares are taken in the module, as
+            // TranslateIteration would have taken them. Where one is taken already, the
+            // iteration is translated.
+            for (size_t i = 0; i < num; i++) {
+                if (done[i] || !body.Instantiate(values[i], bodies[i])) continue ;
+                std::vector<std::string> names ;
+                bodies[i].Declared(names) ;
+                done[i] = visitor.ClaimNames(names) ;
+            }
+        }
+        visitor.SetNonAffine(outer | inner) ;
+    }
+
+    for (size_t i = 0; i < num; i++) {
+        if (!done[i]) {
+            bodies[i] = Section() ; // Drop what the template made of it
+            TranslateIteration(loop, visitor, genvar, values[i], 0, bodies[i]) ;
+        }
+        section.Append(bodies[i]) ;
+        bodies[i] = Section() ;
+    }
+}
+
+/*-----------------------------------------------------------------*/
+//                           Black boxes
+/*-----------------------------------------------------------------*/
+
+// What a module and the modules under it hold, per instance
+struct LogicSize
+{
+    LogicSize() : state_bits(0), operators(0) { }
+
+    unsigned long long  state_bits ;    // Bits of regs and memories
+    unsigned long long  operators ;     // Operator nodes
+} ;
+
+// Counts the logic of a module. Generate loops count once.
+class LogicCounter : public VeriVisitor
+{
+public:
+    explicit LogicCounter(std::map<const VeriModule*, LogicSize> &sizes) : VeriVisitor(), _sizes(sizes), _size() { }
+    virtual ~LogicCounter() { }
+
+    // Size of 'module', counted once per module in 'sizes'
+    static LogicSize Count(const VeriModule &module, std::map<const VeriModule*, LogicSize> &sizes)
+    {
+        std::map<const VeriModule*, LogicSize>::const_iterator it = sizes.find(&module) ;
+        if (it != sizes.end()) return it->second ;
+        sizes[&module] = LogicSize() ; // Instantiated inside itself : counted as nothing
+        LogicCounter counter(sizes) ;
+        const_cast<VeriModule&>(module).Accept(counter) ;
+        sizes[&module] = counter._size ;
+        return counter._size ;
+    }
+
+    virtual void VERI_VISIT(VeriVariable, node)
+    {
+        if (node.IsReg()) _size.state_bits += (unsigned long long)UclidVisitor::IdWidth(&node) * Words(node) ;
+        VeriVisitor::VERI_VISIT_NODE(VeriVariable, node) ;
+    }
+    virtual void VERI_VISIT(VeriUnaryOperator, node)
+    {
+        _size.operators++ ;
+        VeriVisitor::VERI_VISIT_NODE(VeriUnaryOperator, node) ;
+    }
+    virtual void VERI_VISIT(VeriBinaryOperator, node)
+    {
+        _size.operators++ ;
+        VeriVisitor::VERI_VISIT_NODE(VeriBinaryOperator, node) ;
+    }
+    virtual void VERI_VISIT(VeriQuestionColon, node)
+    {
+        _size.operators++ ;
+        VeriVisitor::VERI_VISIT_NODE(VeriQuestionColon, node) ;
+    }
+    virtual void VERI_VISIT(VeriModuleInstantiation, node)
+    {
+        VeriModule *cell = node.GetInstantiatedModule() ;
+        if (cell && node.GetInstances()) {
+            LogicSize size = Count(*cell, _sizes) ;
+            _size.state_bits += size.state_bits * node.GetInstances()->Size() ;
+            _size.operators += size.operators * node.GetInstances()->Size() ;
+        }
+        VeriVisitor::VERI_VISIT_NODE(VeriModuleInstantiation, node) ;
+    }
+
+private:
+    // Words of a memory, 1 for any other reg
+    static unsigned long long Words(const VeriIdDef &id)
+    {
+        VeriRange *range = id.GetDimensions() ;
+        long long left, right ;
+        if (!range || !UclidVisitor::EvalConst(range->GetLeft(), left) || !UclidVisitor::EvalConst(range->GetRight(), right)) return 1 ;
+        return (unsigned long long)((left > right) ? left - right : right - left) + 1 ;
+    }
+
+private:
+    std::map<const VeriModule*, LogicSize> &_sizes ;
+    LogicSize _size ;
+} ;
+
+// static
+unsigned UclidEmitter::GlobMatch(const char *pattern, const char *name)
+{
+    if (!pattern || !name) return 0 ;
+    const char *star = 0 ;      // Last '*' seen, and where its match ends in 'name'
+    const char *resume = 0 ;
+    while (*name) {
+        if ((*pattern == '?') || (*pattern == *name)) {
+            pattern++ ;
+            name++ ;
+        } else if (*pattern == '*') {
+            star = pattern++ ;
+            resume = name ;
+        } else if (star) {
+            // Let the last '*' take one more character
+            pattern = star + 1 ;
+            name = ++resume ;
+        } else {
+            return 0 ;
+        }
+    }
+    while (*pattern == '*') pattern++ ;
+    return (*pattern) ? 0 : 1 ;
+}
+
+unsigned UclidEmitter::IsBlackBox(const VeriModule &module) const
+{
+    const char *original = module.GetOriginalModuleName() ;
+    for (size_t p = 0; p < _black_boxes.size(); p++) {
+        if (GlobMatch(_black_boxes[p].c_str(), module.Name())) return 1 ;
+        if (original && GlobMatch(_black_boxes[p].c_str(), original)) return 1 ;
+    }
+    return 0 ;
+}
+
+UclidItems UclidEmitter::TranslateBlackBox(const VeriModule &module, UclidVisitor &visitor) const
+{
+    UclidItems sfun, snext ;
+    std::string args = "", formals = "" ;
+
+    unsigned i ;
+    VeriIdDef *po ;
+    FOREACH_ARRAY_ITEM(module.GetPorts(), i, po) {
+        if (!po || !po->IsInput()) continue ;
+        const char *name = visitor.NameOf(po) ;
+        args = args + ((args.empty()) ? "" : ", ") + name ;
+        formals = formals + ((formals.empty()) ? "" : ", ") + name + " : bv" + std::to_string(UclidVisitor::IdWidth(po)) ;
+    }
+    FOREACH_ARRAY_ITEM(module.GetPorts(), i, po) {
+        if (!po || po->IsInput()) continue ;
+        const char *name = visitor.NameOf(po) ;
+        std::string width = std::to_string(UclidVisitor::IdWidth(po)) ;
+        if (_black_box_functions && !args.empty()) {
+            std::string function = std::string("bb_") + name ;
+            sfun.push_back(UclidItem(UclidItem::ITEM_FUNCTION, function, "function " + function + "(" + formals + ") : bv" + width + " ;\n")) ;
+            snext.push_back(UclidItem::Assign(name, function + "(" + args + ")")) ;
+        } else {
+            UclidItem havoc(UclidItem::ITEM_STATEMENT, "", std::string("\thavoc ") + name + " ;\n") ;
+            havoc.defines.push_back(name) ;
+            snext.push_back(havoc) ;
+        }
+    }
+
+    if (_black_box_report) {
+        std::map<const VeriModule*, LogicSize> sizes ;
+        LogicSize size = LogicCounter::Count(module, sizes) ;
+        *_black_box_report << "-- black box " << module.Name() << " : " << size.state_bits << " state bits, " << size.operators << " operators per instance not translated" << std::endl ;
+    }
+    AppendItems(sfun, snext) ;
+    return sfun ;
+}
+
+/*---------------------------------------------*/
@@ -0,0 +1,217 @@
+/*
+ *
+ * UCLID5 model emission for statically elaborated Verilog modules.
+ *
+ * The emitter walks a VeriModule and writes the UCLID declarations
+ * for its parameters, ports, registers and nets to an output stream,
+ * followed by its instances, continuous assignments and always blocks.
+ * Memories become UCLID arrays from address to word. Generate constructs
+ * are expanded, with the declarations of each generate block (and loop
+ * iteration) renamed after the block.
+ *
+ * Instances are emitted grouped by the cell they instantiate. The port
+ * order and widths of every cell are resolved once into a template and
+ * kept after the cell module itself is gone, so structural netlists with
+ * many instances of a few cells do not repeat that work per instance.
+ *
+ * Functions are defined once per module, after the ports, where their
+ * body allows it (see UclidVisitor).
+ *
+ * Internal signals whose upper bits are never observed are declared narrower
+ * (see BitWidthAnalyzer). Each module is translated into items (see
+ * UclidModel) that know what they declare, assign and read, and is pruned
+ * of the signals and parameters that cannot reach its outputs (see
+ * UclidLiveness) before it is written.
+ * In canonical mode it is written in canonical form, and its content hashes
+ * are listed in a sidecar stream (see UclidCanonicalizer).
+ *
+ * Modules matching a black box pattern are emitted as their ports only :
+ * their outputs change freely, or as uninterpreted functions of their
+ * inputs, and the modules they instantiate are not emitted for them.
+ *
+*/
+#ifndef _VERIFIC_UCLID_EMITTER_H_
+#define _VERIFIC_UCLID_EMITTER_H_
+
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "Map.h"            // Make associated hash table class Map available
+#include "Set.h"            // Make associated hash table class Set available
+#include "UclidSymbolTable.h" // UCLID names of identifiers
+#include "UclidModel.h"     // Items of emitted modules
+#include "UclidLiveness.h"  // Dead signal elimination
+#include "UclidCanonicalizer.h" // Canonical form and content hashes
+
+#ifdef VERIFIC_NAMESPACE
+namespace Verific { // start definitions in verific namespace
+#endif
+
+class VeriModule ;
+class VeriModuleItem ;
+class VeriModuleInstantiation ;
+class VeriGenerateFor ;
+class VeriIdDef ;
+class Array ;
+class ModuleItemSorter ;
+class UclidVisitor ;
+
+/* -------------------------------------------------------------------------- */
+
+class UclidEmitter
+{
+public:
+    explicit UclidEmitter(std::ostream &os) ;
+    ~UclidEmitter() ;
+
+    // Emit one complete 'module <name> { ... }' block for this module
+    void EmitModule(const VeriModule &module) ;
+
+    // Emit 'top' and, before it, every module it instantiates (each module once)
+    void EmitHierarchy(const VeriModule &top) ;
+
+    // Dead signal elimination (on by default). What is removed is listed in 'report', if given.
+    void SetPruning(unsigned prune, std::ostream *report = 0) { _prune = prune ; _prune_report = report ; }
+    unsigned long NumPruned() const     { return _liveness.NumRemoved() ; }
+
+    // Narrowing of internal signals to the bits that are observed (on by default, see
+    // BitWidthAnalyzer). The signals narrowed are listed in 'report', if given.
+    void SetNarrowing(unsigned narrow, std::ostream *report = 0) { _narrow = narrow ; _narrow_report = report ; }
+
+    // Canonical output (off by default). A "<module> <hash> <cone hash>" line
+    // is written to 'hashes' for each module, if given. The cone hash covers
+    // the cells the module instantiates, as far as they were emitted before it.
+    void SetCanonical(unsigned canonical, std::ostream *hashes = 0) { _canonical = canonical ; _hashes = hashes ; }
+
+    // Append the modules, pruned, to 'modules' in the order they are emitted
+    // instead of writing them (see UclidPartitioner). Hashes are still written.
+    void SetModules(std::vector<UclidModule> *modules) { _modules = modules ; }
+
+    // Loop iterations unrolled per always block, at most (0 : the default, see UclidStmtVisitor)
+    void SetUnrollLimit(unsigned limit) { _unroll_limit = limit ; }
+
+    // Functions whose value is at most 'limit' characters long are inlined, the
+    // others defined once per module (0 : the default, see UclidVisitor). How
+    // the calls of each function were translated is listed in 'report', if given.
+    void SetInlining(unsigned limit, std::ostream *report = 0) { _inline_limit = limit ; _inline_report = report ; }
+
+    // Multiplications, divisions and modulo operations ('operators' : UCLID_UF_MUL ...)
+    // at least 'min_width' bits wide become uninterpreted functions, with lemmas
+    // if 'lemmas' is set (see UclidVisitor::SetUninterpreted). Their applications
+    // are counted in 'report', if given.
+    void SetUninterpreted(unsigned operators, unsigned min_width, unsigned lemmas, std::ostream *report = 0) { _uf_operators = operators ; _uf_min_width = min_width ; _uf_lemmas = lemmas ; _uf_report = report ; }
+
+    // Modules whose name (or the name of the module they were elaborated from)
+    // matches one of 'patterns' ('*' and '?' wildcards) are black boxes. Their
+    // outputs are havoced each step, or with 'functions' set, are uninterpreted
+    // functions of their inputs. The state bits and operators that are not
+    // translated are listed in 'report', if given.
+    void SetBlackBoxes(const std::vector<std::string> &patterns, unsigned functions, std::ostream *report = 0) { _black_boxes = patterns ; _black_box_functions = functions ; _black_box_report = report ; }
+    unsigned IsBlackBox(const VeriModule &module) const ;
+
+    // Does 'name' match 'pattern' ('*' : any characters, '?' : one)?
+    static unsigned GlobMatch(const char *pattern, const char *name) ;
+
+private:
+    // Port order, directions and widths of an instantiated cell
+    struct CellTemplate ;
+
+    // Items of a list of module items, before they are assembled into a module
+    struct Section ;
+
+    // A generate loop body as a template over the loop index
+    struct SectionTemplate ;
+
+    // Each of these returns the items of one declaration section
+    UclidItems TranslateParameters(const VeriModule &module, UclidVisitor &visitor) const ;
+    UclidItems TranslatePorts(const VeriModule &module, UclidVisitor &visitor) const ;
+
+    // Function declarations and next statements of a black box, which read its inputs only
+    UclidItems TranslateBlackBox(const VeriModule &module, UclidVisitor &visitor) const ;
+
+    // Translate module (or generate body) items into 'section'
+    void TranslateItems(const Array *items, UclidVisitor &visitor, Section &section) ;
+
+    // UCLID name of a declared identifier. Inside generate blocks it is renamed per block.
+    const char *DeclareName(const VeriIdDef &id, UclidVisitor &visitor) const ;
+
+    // Combinational always constructs among 'items' (VeriAlwaysConstruct* ->
+    // AlwaysClassifier*, in 'combinational') and the regs declared in 'items'
+    // they compute ('defined'). Blocks that share a target with another
+    // always construct, or depend on each other in a loop, are left out.
+    static void ClassifyAlways(const ModuleItemSorter &items, Map &combinational, Set &defined) ;
+
+    // Register and net declarations. 'defined' regs get no 'var'.
+    UclidItems TranslateDecls(const ModuleItemSorter &items, UclidVisitor &visitor, const Set &defined) const ;
+
+    // Defines of the 'defined' regs. Primed assignments of the other targets
+    // of the combinational constructs are appended to 'next'. A construct that
+    // can not be evaluated is dropped from 'combinational', its regs declared as vars.
+    UclidItems TranslateCombinational(const ModuleItemSorter &items, UclidVisitor &visitor, Map &combinational, Set &defined, UclidItems &next) const ;
+
+    // Instance declarations, grouped per cell. Appends the 'next (inst) ;' steps to 'next'.
+    UclidItems TranslateInstances(const ModuleItemSorter &items, UclidVisitor &visitor, UclidItems &next) ;
+
+    // Drivers of continuous assignments and gate primitives (serialized, see AddDrivers)
+    std::string TranslateAssigns(const ModuleItemSorter &items, UclidVisitor &visitor) const ;
+
+    // Statements of the always constructs, except the 'combinational' ones :
+    // one primed assignment per signal where the construct can be put in SSA
+    // form (see UclidStmtVisitor::EvaluateNext), whose defines go to 'decls'
+    UclidItems TranslateAlways(const ModuleItemSorter &items, UclidVisitor &visitor, const Map &combinational, UclidItems &decls) const ;
+
+    // Generate constructs. Loops are translated through a template of their
+    // body over the loop index where possible, unrolled otherwise.
+    void TranslateGenerate(VeriModuleItem &item, UclidVisitor &visitor, Section &section) ;
+    void TranslateGenerateFor(VeriGenerateFor &loop, UclidVisitor &visitor, Section &section) ;
+    void TranslateIteration(VeriGenerateFor &loop, UclidVisitor &visitor, const VeriIdDef *genvar, long long value, unsigned template_index, Section &body) ;
+    void TranslateScope(const Array *items, const std::string &scope, UclidVisitor &visitor, Section &section) ;
+
+    // One primed assignment per driven signal
+    static UclidItems TranslateDrivers(const std::string &drivers) ;
+
+    // Template for a cell : from the cache, or resolved from the instantiated module
+    const CellTemplate *GetCell(const VeriModuleInstantiation &inst) ;
+    const CellTemplate *RecordCell(const VeriModule &module) ;
+
+private:
+    std::ostream    &_os ;          // Model output stream
+    Map              _cells ;       // char* cell name -> CellTemplate*
+    Set              _emitted ;     // char* names of the modules emitted by EmitHierarchy
+    UclidSymbolTable _symbols ;     // UCLID names of all identifiers of the design
+    std::string      _scope ;       // Name prefix of the generate block being translated
+    UclidLiveness    _liveness ;    // Prunes each module before it is written
+    unsigned         _prune ;
+    std::ostream    *_prune_report ; // Lists what was pruned
+    unsigned         _narrow ;
+    std::ostream    *_narrow_report ; // Lists what was narrowed
+    UclidCanonicalizer _canonicalizer ;
+    unsigned         _canonical ;
+    std::ostream    *_hashes ;      // Sidecar of content hashes
+    std::map<std::string, unsigned long long> _cones ; // Module name -> cone hash (emitted canonically)
+    std::vector<UclidModule> *_modules ; // Modules kept instead of written
+    unsigned         _unroll_limit ;
+    unsigned         _inline_limit ;
+    std::ostream    *_inline_report ; // Lists the calls of each function
+    unsigned         _uf_operators ;
+    unsigned         _uf_min_width ;
+    unsigned         _uf_lemmas ;
+    std::ostream    *_uf_report ;   // Lists the applications of each function
+    std::vector<std::string> _black_boxes ; // Module name patterns
+    unsigned         _black_box_functions ;
+    std::ostream    *_black_box_report ; // Lists what black boxes leave out
+
+    // Prevent the compiler from implementing the following
+    UclidEmitter(const UclidEmitter &node) ;
+    UclidEmitter& operator=(const UclidEmitter &rhs) ;
+} ;
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef VERIFIC_NAMESPACE
+} // end definitions in verific namespace
+#endif
+
+#endif // #ifndef _VERIFIC_UCLID_EMITTER_H_
@@ -0,0 +1,203 @@
+/*
+ *
+ * Dead signal and parameter elimination for emitted UCLID5 modules.
+ *
+*/
+
+#include <set>
+#include <vector>
+
+#include "UclidLiveness.h"  // UclidLiveness class definition
+#include "UclidModel.h"     // UclidModule, the items of a module
+
+#include "Array.h"          // Make dynamic array class Array available
+#include "Map.h"            // Make associated hash table class Map available
+
+#ifdef VERIFIC_NAMESPACE
+using namespace Verific ;
+#endif
+
+// What an item of the module means for liveness
+struct UclidUnit
+{
+    enum Kind { UNIT_KEEP, UNIT_ROOT, UNIT_VAR, UNIT_DEFINE, UNIT_STATEMENT, UNIT_INSTANCE } ;
+
+    UclidUnit() : kind(UNIT_KEEP), defines(), uses(), live(0) { }
+
+    Kind                        kind ;
+    std::vector<std::string>    defines ;   // Names it declares or assigns
+    std::vector<std::string>    uses ;      // Names it reads
+    unsigned                    live ;
+} ;
+
+/*-----------------------------------------------------------------*/
+//                      Constructor / Destructor
+/*-----------------------------------------------------------------*/
+
+UclidLiveness::UclidLiveness()
+    : _num_removed(0)
+{
+}
+
+UclidLiveness::~UclidLiveness()
+{
+}
+
+/*-----------------------------------------------------------------*/
+//                             Pruning
+/*-----------------------------------------------------------------*/
+
+// Mark the units that are live from the roots
+static void Propagate(std::vector<UclidUnit> &units)
+{
+    // Units computing each name
+    Map computed(STRING_HASH) ;     // char* name -> Array* of unit indexes
+    size_t u ;
+    for (u = 0; u < units.size(); u++) {
+        UclidUnit &unit = units[u] ;
+        for (size_t d = 0; d < unit.defines.size(); d++) {
+            Array *list = (Array*)computed.GetValue(unit.defines[d].c_str()) ;
+            if (!list) {
+                list = new Array(2) ;
+                (void) computed.Insert(unit.defines[d].c_str(), list) ;
+            }
+            list->InsertLast((void*)(unsigned long)u) ;
+        }
+    }
+
+    // Propagate from the roots
+    Map live(STRING_HASH) ;         // char* name -> 1
+    std::vector<const char*> work ;
+    for (u = 0; u < units.size(); u++) {
+        if (units[u].kind != UclidUnit::UNIT_ROOT) continue ;
+        units[u].live = 1 ;
+        for (size_t n = 0; n < units[u].uses.size(); n++) work.push_back(units[u].uses[n].c_str()) ;
+    }
+    while (!work.empty()) {
+        const char *name = work.back() ;
+        work.pop_back() ;
+        if (live.GetValue(name)) continue ;
+        (void) live.Insert(name, (void*)1) ;
+
+        Array *list = (Array*)computed.GetValue(name) ;
+        unsigned i ;
+        void *index ;
+        FOREACH_ARRAY_ITEM(list, i, index) {
+            UclidUnit &unit = units[(size_t)(unsigned long)index] ;
+            if (unit.live) continue ;
+            unit.live = 1 ;
+            // A statement kept whole keeps all it assigns
+            for (size_t n = 0; n < unit.uses.size(); n++) work.push_back(unit.uses[n].c_str()) ;
+            for (size_t n = 0; n < unit.defines.size(); n++) work.push_back(unit.defines[n].c_str()) ;
+        }
+    }
+
+    MapIter mi ;
+    Array *list ;
+    FOREACH_MAP_ITEM(&computed, mi, 0, &list) delete list ;
+}
+
+// One unit per item of 'module', in order. Without 'targets', ports, instances
+// and instance steps are roots. With them, only the output ports they name
+// are : an instance computes the signals on the outputs of its cell from
+// those on its inputs, and its step goes with it.
+static void ItemUnits(const UclidModule &module, const std::set<std::string> *targets, std::vector<UclidUnit> &units)
+{
+    units.resize(module.items.size()) ;
+    for (size_t i = 0; i < module.items.size(); i++) {
+        const UclidItem &item = module.items[i] ;
+        UclidUnit &unit = units[i] ;
+        switch (item.kind) {
+        case UclidItem::ITEM_INPUT :
+        case UclidItem::ITEM_OUTPUT :
+            if (targets && ((item.kind == UclidItem::ITEM_INPUT) || !targets->count(item.name))) break ;
+            unit.kind = UclidUnit::UNIT_ROOT ;
+            unit.uses.push_back(item.name) ;
+            break ;
+        case UclidItem::ITEM_PARAMETER :
+        case UclidItem::ITEM_VAR :
+            unit.kind = UclidUnit::UNIT_VAR ;
+            unit.defines.push_back(item.name) ;
+            break ;
+        case UclidItem::ITEM_DEFINE :
+            unit.kind = UclidUnit::UNIT_DEFINE ;
+            unit.defines.push_back(item.name) ;
+            unit.uses = item.uses ;
+            break ;
+        case UclidItem::ITEM_INSTANCE :
+            if (!targets) {
+                unit.kind = UclidUnit::UNIT_ROOT ;
+                unit.uses = item.uses ;
+                unit.uses.insert(unit.uses.end(), item.defines.begin(), item.defines.end()) ;
+                break ;
+            }
+            unit.kind = UclidUnit::UNIT_INSTANCE ;
+            unit.defines.push_back(item.name) ;
+            unit.defines.insert(unit.defines.end(), item.defines.begin(), item.defines.end()) ;
+            unit.uses.push_back(item.name) ;
+            unit.uses.insert(unit.uses.end(), item.uses.begin(), item.uses.end()) ;
+            break ;
+        case UclidItem::ITEM_STEP :
+            if (!targets) {
+                unit.kind = UclidUnit::UNIT_ROOT ;
+                break ;
+            }
+            // Defines the instance, so that it is live with it
+            unit.kind = UclidUnit::UNIT_STATEMENT ;
+            unit.defines.push_back(item.name) ;
+            unit.uses.push_back(item.name) ;
+            break ;
+        case UclidItem::ITEM_STATEMENT :
+            unit.kind = (item.defines.empty()) ? UclidUnit::UNIT_ROOT : UclidUnit::UNIT_STATEMENT ;
+            unit.defines = item.defines ;
+            unit.uses = item.uses ;
+            break ;
+        default :
+            // Functions, axioms, comments : always there
+            break ;
+        }
+    }
+}
+
+void UclidLiveness::Prune(UclidModule &module, std::string &report, const std::set<std::string> *targets)
+{
+    std::vector<UclidUnit> units ;
+    ItemUnits(module, targets, units) ;
+    Propagate(units) ;
+
+    size_t kept = 0 ;
+    for (size_t u = 0; u < units.size(); u++) {
+        const UclidItem &item = module.items[u] ;
+        if ((units[u].kind == UclidUnit::UNIT_KEEP) || units[u].live) {
+            if (kept != u) module.items[kept] = item ;
+            kept++ ;
+            continue ;
+        }
+        const char *kind = 0 ;
+        if (item.kind == UclidItem::ITEM_PARAMETER) kind = "parameter" ;
+        if (item.kind == UclidItem::ITEM_VAR) kind = "var" ;
+        if (item.kind == UclidItem::ITEM_DEFINE) kind = "define" ;
+        if (item.kind == UclidItem::ITEM_INSTANCE) kind = "instance" ;
+        if (!kind) continue ;
+        report += "-- removed " + module.name + " " + kind + " " + item.name + "\n" ;
+        _num_removed++ ;
+    }
+    module.items.resize(kept) ;
+}
+
+unsigned long UclidLiveness::Cone(const UclidModule &module, const std::string &target, std::vector<unsigned long> &cone) const
+{
+    std::set<std::string> targets ;
+    targets.insert(target) ;
+    std::vector<UclidUnit> units ;
+    ItemUnits(module, &targets, units) ;
+    Propagate(units) ;
+
+    cone.clear() ;
+    for (size_t u = 0; u < units.size(); u++) {
+        if (units[u].live && (units[u].kind != UclidUnit::UNIT_ROOT)) cone.push_back((unsigned long)u) ;
+    }
+    return cone.size() ;
+}
+
+/*---------------------------------------------*/
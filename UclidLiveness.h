@@ -0,0 +1,68 @@
+/*
+ *
+ * Dead signal and parameter elimination for emitted UCLID5 modules.
+ *
+ * UclidLiveness takes one module as UclidEmitter builds it (see UclidModel) and
+ * removes the vars, defines and parameters that cannot affect an output of
+ * the module, with the init and next assignments that only feed them.
+ * Ports, instances and instance steps are the roots : everything they read
+ * is live, and so is everything read by what computes a live signal. A
+ * top-level statement of the next block that assigns a live signal stays
+ * whole, with all the signals it assigns.
+ *
+ * What is removed is listed in a report, one "-- removed <module> <kind>
+ * <name>" line each.
+ *
+ * Given target outputs, only those are roots : the module is cut down to
+ * their cones, instances included (see UclidPartitioner). An instance
+ * computes the signals on the outputs of its cell from those on its inputs,
+ * as the emitter connected them.
+ *
+*/
+#ifndef _VERIFIC_UCLID_LIVENESS_H_
+#define _VERIFIC_UCLID_LIVENESS_H_
+
+#include <set>
+#include <string>
+#include <vector>
+
+#ifdef VERIFIC_NAMESPACE
+namespace Verific { // start definitions in verific namespace
+#endif
+
+struct UclidModule ;
+
+/* -------------------------------------------------------------------------- */
+
+class UclidLiveness
+{
+public:
+    UclidLiveness() ;
+    ~UclidLiveness() ;
+
+    // Remove the dead items of 'module' (as UclidEmitter built it). Report lines for them are appended to 'report'.
+    // With 'targets', only the output ports they name are roots, and instances feeding none of them go too.
+    void Prune(UclidModule &module, std::string &report, const std::set<std::string> *targets = 0) ;
+
+    // Indexes of the items of 'module' in the cone of output 'target'
+    // (in item order, the same for each target). Returns their number.
+    unsigned long Cone(const UclidModule &module, const std::string &target, std::vector<unsigned long> &cone) const ;
+
+    // Items removed so far
+    unsigned long NumRemoved() const    { return _num_removed ; }
+
+private:
+    unsigned long _num_removed ;
+
+    // Prevent the compiler from implementing the following
+    UclidLiveness(const UclidLiveness &node) ;
+    UclidLiveness& operator=(const UclidLiveness &rhs) ;
+} ;
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef VERIFIC_NAMESPACE
+} // end definitions in verific namespace
+#endif
+
+#endif // #ifndef _VERIFIC_UCLID_LIVENESS_H_
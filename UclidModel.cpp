@@ -0,0 +1,121 @@
+/*
+ *
+ * Structured form of an emitted UCLID5 module.
+ *
+*/
+
+#include <cctype>           // isalnum, isalpha, isdigit
+
+#include "UclidModel.h"     // UclidItem and UclidModule definitions
+
+#ifdef VERIFIC_NAMESPACE
+using namespace Verific ;
+#endif
+
+/*-----------------------------------------------------------------*/
+//                              Items
+/*-----------------------------------------------------------------*/
+
+// UCLID keywords, which can not be used as identifiers
+static const char *uclid_keywords[] = {
+    "assert", "assume", "axiom", "boolean", "call", "case", "const", "control",
+    "default", "define", "else", "ensures", "enum", "esac", "exists", "false",
+    "for", "forall", "function", "grammar", "havoc", "history", "if", "in",
+    "init", "input", "instance", "integer", "invariant", "module", "modifies",
+    "next", "old", "output", "procedure", "property", "range", "record",
+    "requires", "returns", "sharedvar", "synthesis", "then", "true", "type",
+    "var", "while", 0
+} ;
+
+// static
+unsigned UclidItem::IsKeyword(const std::string &name)
+{
+    for (unsigned i = 0; uclid_keywords[i]; i++) {
+        if (name == uclid_keywords[i]) return 1 ;
+    }
+    // Bit-vector type names : bv1, bv32 ...
+    if ((name.size() > 2) && (name[0] == 'b') && (name[1] == 'v')) {
+        for (size_t i = 2; i < name.size(); i++) if (!isdigit((unsigned char)name[i])) return 0 ;
+        return 1 ;
+    }
+    return 0 ;
+}
+
+// static
+UclidItem UclidItem::Define(const std::string &name, const std::string &formals, unsigned width, const std::string &value)
+{
+    UclidItem item(ITEM_DEFINE, name, "define " + name + "(" + formals + ") : bv" + std::to_string(width) + " = " + value + " ;\n") ;
+    Names(value, item.uses) ;
+    return item ;
+}
+
+// static
+UclidItem UclidItem::Assign(const std::string &name, const std::string &value)
+{
+    UclidItem item(ITEM_STATEMENT, "", "\t" + name + "' = " + value + " ;\n") ;
+    item.defines.push_back(name) ;
+    Names(value, item.uses) ;
+    return item ;
+}
+
+// static
+void UclidItem::Names(const std::string &text, std::vector<std::string> &names)
+{
+    size_t i = 0 ;
+    while (i < text.size()) {
+        unsigned char ch = (unsigned char)text[i] ;
+        if (isdigit(ch)) {
+            // Literal, with its bv suffix
+            while ((i < text.size()) && (isalnum((unsigned char)text[i]) || (text[i] == '_'))) i++ ;
+            continue ;
+        }
+        if (!isalpha(ch) && (ch != '_')) {
+            i++ ;
+            continue ;
+        }
+        size_t start = i ;
+        while ((i < text.size()) && (isalnum((unsigned char)text[i]) || (text[i] == '_'))) i++ ;
+        std::string name = text.substr(start, i - start) ;
+        if (!IsKeyword(name)) names.push_back(name) ; // No identifier is (see UclidSymbolTable::Legalize)
+    }
+}
+
+/*-----------------------------------------------------------------*/
+//                             Modules
+/*-----------------------------------------------------------------*/
+
+std::string UclidModule::Render() const
+{
+    std::string decls, inits, body, next ;
+    for (size_t i = 0; i < items.size(); i++) {
+        const UclidItem &item = items[i] ;
+        if (item.kind == UclidItem::ITEM_PARAMETER) {
+            decls += item.text ;
+            inits += item.init ;
+        } else if (item.IsNext()) {
+            next += item.text ;
+        } else {
+            body += item.text ;
+        }
+    }
+
+    std::string text = "module " + name + " {\n" ;
+    text += decls ;
+    if (!inits.empty()) text += "init {\n" + inits + "}\n" ;
+    text += body ;
+    if (!next.empty()) text += "next {\n" + next + "}\n" ;
+    text += "}\n" ;
+    return text ;
+}
+
+void UclidModule::Cells(std::vector<std::string> &cells) const
+{
+    for (size_t i = 0; i < items.size(); i++) {
+        if (items[i].kind != UclidItem::ITEM_INSTANCE) continue ;
+        size_t c ;
+        for (c = 0; c < cells.size(); c++) if (cells[c] == items[i].cell) break ;
+        if (c == cells.size()) cells.push_back(items[i].cell) ;
+    }
+}
+
+/*---------------------------------------------*/
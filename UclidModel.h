@@ -0,0 +1,95 @@
+/*
+ *
+ * Structured form of an emitted UCLID5 module.
+ *
+ * UclidEmitter translates a module into a list of items : its parameters,
+ * ports and declarations, its instances, and the statements of its next
+ * block. Each item carries its text together with the names it declares or
+ * assigns and the names it reads, so that the passes over emitted modules
+ * (UclidLiveness, UclidCanonicalizer, UclidPartitioner) work on what the
+ * emitter knew rather than recovering it from the text. Render assembles the
+ * items into the module text.
+ *
+*/
+#ifndef _VERIFIC_UCLID_MODEL_H_
+#define _VERIFIC_UCLID_MODEL_H_
+
+#include <string>
+#include <vector>
+
+#ifdef VERIFIC_NAMESPACE
+namespace Verific { // start definitions in verific namespace
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+struct UclidItem
+{
+    enum Kind {
+        ITEM_INPUT,         // 'input x : bv8 ;'
+        ITEM_OUTPUT,        // 'output y : bv8 ;'
+        ITEM_PARAMETER,     // 'var p : bv8 ;', with its assignment in the init block
+        ITEM_VAR,           // 'var r : bv8 ;'
+        ITEM_FUNCTION,      // 'function f(x : bv8, y : bv8) : bv8 ;'
+        ITEM_AXIOM,         // 'axiom forall (x : bv8) :: ... ;'
+        ITEM_DEFINE,        // 'define d() : bv8 = ... ;'
+        ITEM_COMMENT,       // '// ...'
+        ITEM_INSTANCE,      // 'instance u : cell(a : (x), b : (y)) ;'
+        ITEM_STEP,          // 'next (u) ;' in the next block
+        ITEM_STATEMENT      // Any other statement of the next block
+    } ;
+
+    UclidItem() : kind(ITEM_COMMENT), name(), cell(), text(), init(), defines(), uses() { }
+    UclidItem(Kind k, const std::string &n, const std::string &t) : kind(k), name(n), cell(), text(t), init(), defines(), uses() { }
+
+    Kind                        kind ;
+    std::string                 name ;      // Name it declares. Step : the instance it steps.
+    std::string                 cell ;      // Instance : the module it instantiates
+    std::string                 text ;      // Its lines, indented, each ended by a newline
+    std::string                 init ;      // Parameter : its line of the init block
+    std::vector<std::string>    defines ;   // Signals it assigns. Instance : those on the outputs of its cell.
+    std::vector<std::string>    uses ;      // Names it reads. Instance : those on the inputs of its cell.
+
+    // Is it a statement of the next block?
+    unsigned IsNext() const     { return ((kind == ITEM_STEP) || (kind == ITEM_STATEMENT)) ? 1 : 0 ; }
+
+    // 'define <name>(<formals>) : bv<width> = <value> ;', and the statement
+    // '<name>' = <value> ;' of the next block
+    static UclidItem Define(const std::string &name, const std::string &formals, unsigned width, const std::string &value) ;
+    static UclidItem Assign(const std::string &name, const std::string &value) ;
+
+    // Append the names read in the UCLID expression (or statements) 'text' to
+    // 'names' : its identifiers, without literals, keywords and types
+    static void Names(const std::string &text, std::vector<std::string> &names) ;
+
+    // Is 'name' a UCLID keyword or bit-vector type (bv8), which no identifier can be?
+    static unsigned IsKeyword(const std::string &name) ;
+} ;
+
+// Items in the order they are written
+typedef std::vector<UclidItem> UclidItems ;
+
+/* -------------------------------------------------------------------------- */
+
+struct UclidModule
+{
+    UclidModule() : name(), items() { }
+
+    std::string                 name ;
+    UclidItems                  items ;     // In the order the emitter wrote them
+
+    // The module text : parameters and the init block (if any), the other
+    // declarations and instances in order, then the next block
+    std::string Render() const ;
+
+    // Cells it instantiates, once each, in order of first instance
+    void Cells(std::vector<std::string> &cells) const ;
+} ;
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef VERIFIC_NAMESPACE
+} // end definitions in verific namespace
+#endif
+
+#endif // #ifndef _VERIFIC_UCLID_MODEL_H_
@@ -0,0 +1,265 @@
+/*
+ *
+ * Partitioning of a UCLID5 model by the outputs of its top module.
+ *
+*/
+
+#include <algorithm>        // std::sort, std::set_union
+#include <cerrno>
+#include <fstream>
+#include <iterator>         // std::back_inserter
+#include <map>
+
+#include <sys/stat.h>       // mkdir
+
+#include "UclidPartitioner.h" // UclidPartitioner class definition
+
+#include "Message.h"        // Make message handlers available
+
+#ifdef VERIFIC_NAMESPACE
+using namespace Verific ;
+#endif
+
+// Threshold of SetOverlap, in percent
+#define PARTITION_OVERLAP   50
+
+// Larger cones first, then in target order
+struct ConeOrder
+{
+    explicit ConeOrder(const std::vector<std::vector<unsigned long> > &cones) : _cones(cones) { }
+    bool operator()(size_t a, size_t b) const
+    {
+        if (_cones[a].size() != _cones[b].size()) return _cones[a].size() > _cones[b].size() ;
+        return a < b ;
+    }
+    const std::vector<std::vector<unsigned long> > &_cones ;
+} ;
+
+/*-----------------------------------------------------------------*/
+//                      Constructor / Destructor
+/*-----------------------------------------------------------------*/
+
+UclidPartitioner::UclidPartitioner()
+    : _modules(),
+      _top(),
+      _partitions(),
+      _liveness(),
+      _overlap(PARTITION_OVERLAP),
+      _max_partitions(0)
+{
+}
+
+UclidPartitioner::~UclidPartitioner()
+{
+}
+
+/*-----------------------------------------------------------------*/
+//                             Modules
+/*-----------------------------------------------------------------*/
+
+unsigned long UclidPartitioner::Split(const std::vector<UclidModule> &modules)
+{
+    _modules.clear() ;
+    _top = UclidModule() ;
+    if (modules.empty()) return 0 ;
+
+    // The cells are written as they are, the top is cut down for each partition
+    for (size_t m = 0; m + 1 < modules.size(); m++) {
+        Module module ;
+        module.name = modules[m].name ;
+        module.text = modules[m].Render() ;
+        modules[m].Cells(module.cells) ;
+        _modules.push_back(module) ;
+    }
+    _top = modules.back() ;
+    return modules.size() ;
+}
+
+/*-----------------------------------------------------------------*/
+//                            Partitions
+/*-----------------------------------------------------------------*/
+
+// static
+unsigned long UclidPartitioner::Shared(const std::vector<unsigned long> &a, const std::vector<unsigned long> &b)
+{
+    unsigned long shared = 0 ;
+    size_t i = 0, j = 0 ;
+    while ((i < a.size()) && (j < b.size())) {
+        if (a[i] < b[j]) {
+            i++ ;
+        } else if (b[j] < a[i]) {
+            j++ ;
+        } else {
+            shared++ ;
+            i++ ;
+            j++ ;
+        }
+    }
+    return shared ;
+}
+
+// static
+void UclidPartitioner::Merge(Part &into, const Part &from)
+{
+    into.targets.insert(into.targets.end(), from.targets.begin(), from.targets.end()) ;
+    std::vector<unsigned long> cone ;
+    std::set_union(into.cone.begin(), into.cone.end(), from.cone.begin(), from.cone.end(), std::back_inserter(cone)) ;
+    into.cone.swap(cone) ;
+}
+
+unsigned UclidPartitioner::Overlaps(unsigned long shared, unsigned long a, unsigned long b) const
+{
+    unsigned long smaller = (a < b) ? a : b ;
+    // An empty cone (a constant output) goes anywhere
+    if (!smaller) return 1 ;
+    return (shared * 100 >= (unsigned long)_overlap * smaller) ? 1 : 0 ;
+}
+
+unsigned UclidPartitioner::Partition(const std::vector<UclidModule> &modules, const std::vector<std::string> &targets)
+{
+    _partitions.clear() ;
+    if (!Split(modules)) {
+        Message::Error(0, "no module to partition") ;
+        return 0 ;
+    }
+
+    // The outputs of the top
+    std::vector<std::string> outputs ;
+    for (size_t i = 0; i < _top.items.size(); i++) {
+        if (_top.items[i].kind == UclidItem::ITEM_OUTPUT) outputs.push_back(_top.items[i].name) ;
+    }
+    std::vector<std::string> names = (targets.empty()) ? outputs : targets ;
+    for (size_t t = 0; t < names.size(); t++) {
+        if (std::find(outputs.begin(), outputs.end(), names[t]) != outputs.end()) continue ;
+        Message::Error(0, "target is not an output of the top module : ", names[t].c_str()) ;
+        return 0 ;
+    }
+
+    // Largest cones first : the smaller ones join them
+    std::vector<std::vector<unsigned long> > cones(names.size()) ;
+    std::vector<size_t> order ;
+    for (size_t t = 0; t < names.size(); t++) {
+        (void) _liveness.Cone(_top, names[t], cones[t]) ;
+        order.push_back(t) ;
+    }
+    std::sort(order.begin(), order.end(), ConeOrder(cones)) ;
+
+    for (size_t o = 0; o < order.size(); o++) {
+        Part part ;
+        part.targets.push_back(names[order[o]]) ;
+        part.cone = cones[order[o]] ;
+
+        size_t best = _partitions.size() ;
+        unsigned long best_shared = 0 ;
+        for (size_t p = 0; p < _partitions.size(); p++) {
+            unsigned long shared = Shared(part.cone, _partitions[p].cone) ;
+            if (!Overlaps(shared, part.cone.size(), _partitions[p].cone.size())) continue ;
+            if ((best == _partitions.size()) || (shared > best_shared)) {
+                best = p ;
+                best_shared = shared ;
+            }
+        }
+        if (best < _partitions.size()) {
+            Merge(_partitions[best], part) ;
+        } else {
+            _partitions.push_back(part) ;
+        }
+    }
+
+    // Too many : merge the pair sharing the largest part of the smaller cone
+    while (_max_partitions && (_partitions.size() > _max_partitions)) {
+        size_t into = 0, from = 1 ;
+        double best = -1.0 ;
+        for (size_t a = 0; a < _partitions.size(); a++) {
+            for (size_t b = a + 1; b < _partitions.size(); b++) {
+                unsigned long smaller = std::min(_partitions[a].cone.size(), _partitions[b].cone.size()) ;
+                double ratio = (smaller) ? (double)Shared(_partitions[a].cone, _partitions[b].cone) / (double)smaller : 1.0 ;
+                if (ratio > best) {
+                    best = ratio ;
+                    into = a ;
+                    from = b ;
+                }
+            }
+        }
+        Merge(_partitions[into], _partitions[from]) ;
+        _partitions.erase(_partitions.begin() + (long)from) ;
+    }
+
+    for (size_t p = 0; p < _partitions.size(); p++) _partitions[p].model = BuildModel(_partitions[p]) ;
+    return 1 ;
+}
+
+std::string UclidPartitioner::BuildModel(const Part &part)
+{
+    UclidModule top = _top ;
+    std::set<std::string> targets(part.targets.begin(), part.targets.end()) ;
+    std::string removed ;
+    _liveness.Prune(top, removed, &targets) ;
+
+    // The cells still instantiated, and the cells under them
+    std::map<std::string, size_t> index ;
+    for (size_t m = 0; m < _modules.size(); m++) index[_modules[m].name] = m ;
+    std::vector<char> needed(_modules.size(), 0) ;
+    std::vector<std::string> work ;
+    top.Cells(work) ;
+    while (!work.empty()) {
+        std::map<std::string, size_t>::const_iterator it = index.find(work.back()) ;
+        work.pop_back() ;
+        if ((it == index.end()) || needed[it->second]) continue ;
+        needed[it->second] = 1 ;
+        const std::vector<std::string> &cells = _modules[it->second].cells ;
+        work.insert(work.end(), cells.begin(), cells.end()) ;
+    }
+
+    std::string model ;
+    for (size_t m = 0; m < _modules.size(); m++) {
+        if (needed[m]) model += _modules[m].text ;
+    }
+    return model + top.Render() ;
+}
+
+/*-----------------------------------------------------------------*/
+//                              Output
+/*-----------------------------------------------------------------*/
+
+std::string UclidPartitioner::FileName(unsigned p) const
+{
+    std::string top = (_top.name.empty()) ? std::string("model") : _top.name ;
+    return top + "_" + std::to_string(p) + ".ucl" ;
+}
+
+unsigned UclidPartitioner::Write(const char *dir, std::ostream *report) const
+{
+    std::string path = (dir && *dir) ? dir : "." ;
+    if ((mkdir(path.c_str(), 0777) != 0) && (errno != EEXIST)) {
+        Message::Error(0, "cannot create directory ", path.c_str()) ;
+        return 0 ;
+    }
+    path += "/" ;
+
+    std::string manifest_name = path + "manifest" ;
+    std::ofstream manifest(manifest_name.c_str()) ;
+    if (!manifest) {
+        Message::Error(0, "cannot open file ", manifest_name.c_str()) ;
+        return 0 ;
+    }
+    for (unsigned p = 0; p < NumPartitions(); p++) {
+        std::string file_name = path + FileName(p) ;
+        std::ofstream os(file_name.c_str()) ;
+        if (!os) {
+            Message::Error(0, "cannot open file ", file_name.c_str()) ;
+            return 0 ;
+        }
+        os << _partitions[p].model ;
+        if (!os.good()) return 0 ;
+
+        std::string targets ;
+        for (size_t t = 0; t < _partitions[p].targets.size(); t++) targets += " " + _partitions[p].targets[t] ;
+        manifest << FileName(p) << " " << ConeSize(p) << targets << "\n" ;
+        if (report) *report << "-- partition " << FileName(p) << " : " << _partitions[p].targets.size() << " targets, " << ConeSize(p) << " items in their cones" << std::endl ;
+    }
+    manifest.flush() ;
+    return manifest.good() ? 1 : 0 ;
+}
+
+/*---------------------------------------------*/
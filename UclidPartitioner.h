@@ -0,0 +1,111 @@
+/*
+ *
+ * Partitioning of a UCLID5 model by the outputs of its top module.
+ *
+ * Properties are checked against a model one after the other. The
+ * partitioner splits a model, as UclidEmitter builds it (see
+ * UclidEmitter::SetModules), into models that can be solved in parallel. The target outputs of the top module are
+ * grouped by their fan-in cones (see UclidLiveness::Cone) : a target joins
+ * the partition whose cone shares the largest part of its own, if that part
+ * reaches the overlap threshold, and starts a partition otherwise. Each
+ * partition is a self-contained model : the top cut down to the cones of its
+ * targets, preceded by the modules that are still instantiated. Logic in the
+ * cones of several partitions is copied into each of them.
+ *
+ * A manifest lists the models, one "<file> <cone items> <target> ..." line
+ * per partition.
+ *
+*/
+#ifndef _VERIFIC_UCLID_PARTITIONER_H_
+#define _VERIFIC_UCLID_PARTITIONER_H_
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "UclidLiveness.h"  // Cones and pruning
+#include "UclidModel.h"     // Modules as UclidEmitter builds them
+
+#ifdef VERIFIC_NAMESPACE
+namespace Verific { // start definitions in verific namespace
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+class UclidPartitioner
+{
+public:
+    UclidPartitioner() ;
+    ~UclidPartitioner() ;
+
+    // Targets go together when their cones share 'percent' % of the smaller one (default 50)
+    void SetOverlap(unsigned percent)       { _overlap = percent ; }
+
+    // At most 'max' partitions (0 : no limit). Beyond that, the partitions that overlap most are merged.
+    void SetMaxPartitions(unsigned max)     { _max_partitions = max ; }
+
+    // Split the model of 'modules' (the top module last) for the outputs
+    // 'targets' of its top module, or all of them if there are none. Returns 0
+    // if there is no module, or a target is not an output of the top.
+    unsigned Partition(const std::vector<UclidModule> &modules, const std::vector<std::string> &targets) ;
+
+    unsigned NumPartitions() const                          { return (unsigned)_partitions.size() ; }
+    const std::string &Model(unsigned p) const              { return _partitions[p].model ; }
+    const std::vector<std::string> &Targets(unsigned p) const { return _partitions[p].targets ; }
+    unsigned long ConeSize(unsigned p) const                { return _partitions[p].cone.size() ; }
+
+    // File name of partition 'p' : <top>_<p>.ucl
+    std::string FileName(unsigned p) const ;
+
+    // Write the models and 'manifest' into directory 'dir' (created if need be).
+    // A line per partition goes to 'report', if given. Returns 0 on error.
+    unsigned Write(const char *dir, std::ostream *report = 0) const ;
+
+private:
+    // A module under the top, its text and the cells it instantiates
+    struct Module {
+        std::string                 name ;
+        std::string                 text ;
+        std::vector<std::string>    cells ;
+    } ;
+
+    // A set of targets, the union of their cones and its model
+    struct Part {
+        std::vector<std::string>    targets ;
+        std::vector<unsigned long>  cone ;      // Sorted indexes of items of the top module
+        std::string                 model ;
+    } ;
+
+    // Keep the cells of 'modules' as text, and the top as items. Returns the number of modules.
+    unsigned long Split(const std::vector<UclidModule> &modules) ;
+
+    // Items two sorted cones share
+    static unsigned long Shared(const std::vector<unsigned long> &a, const std::vector<unsigned long> &b) ;
+    static void Merge(Part &into, const Part &from) ;
+
+    // Do cones sharing 'shared' items, of sizes 'a' and 'b', overlap enough?
+    unsigned Overlaps(unsigned long shared, unsigned long a, unsigned long b) const ;
+
+    // The top cut down to the cones of 'part', after the modules it needs
+    std::string BuildModel(const Part &part) ;
+
+private:
+    std::vector<Module> _modules ;      // In model order : cells before the modules instantiating them
+    UclidModule         _top ;
+    std::vector<Part>   _partitions ;
+    UclidLiveness       _liveness ;
+    unsigned            _overlap ;
+    unsigned            _max_partitions ;
+
+    // Prevent the compiler from implementing the following
+    UclidPartitioner(const UclidPartitioner &node) ;
+    UclidPartitioner& operator=(const UclidPartitioner &rhs) ;
+} ;
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef VERIFIC_NAMESPACE
+} // end definitions in verific namespace
+#endif
+
+#endif // #ifndef _VERIFIC_UCLID_PARTITIONER_H_
@@ -0,0 +1,937 @@
+/*
+ *
+ * Translation of Verilog procedural statements into UCLID5 statements.
+ *
+*/
+
+#include <algorithm>            // std::find
+
+#include "UclidStmtVisitor.h"   // UclidStmtVisitor class definition
+#include "UclidVisitor.h"       // Expression translation
+#include "AlwaysClassifier.h"   // Full case statements
+#include "UclidBodyTemplate.h"  // Loop bodies as templates over the loop variable
+#include "UclidModel.h"         // Items of shared defines
+
+#include "Array.h"          // Make dynamic array class Array available
+
+#include "VeriId.h"         // Definitions of all identifier definition tree nodes
+#include "VeriExpression.h" // Definitions of all verilog expression tree nodes
+#include "VeriStatement.h"  // Definitions of all verilog statement tree nodes
+#include "VeriMisc.h"       // Definitions of all extraneous verilog tree nodes (ie. range, path, strength, etc...)
+#include "veri_tokens.h"
+
+#ifdef VERIFIC_NAMESPACE
+using namespace Verific ;
+#endif
+
+// In EvaluateNext, values of blocking assignments longer than this are shared through a define
+#define SSA_SHARE_LENGTH 64
+
+// Default unroll budget : loop iterations per always block
+#define UNROLL_LIMIT 4096
+
+// The signals a loop body reads, and those it writes as a whole
+class LoopAccesses : public VeriVisitor
+{
+public:
+    LoopAccesses() : VeriVisitor(), _reads(), _writes(), _partial(0) { }
+    virtual ~LoopAccesses() { }
+
+    // In statement mode each copy of the body reads the current state, and a
+    // partial write keeps the other bits of the current state. Copies are only
+    // right if no copy reads, or writes part of, what another one writes.
+    unsigned Independent() const
+    {
+        if (_partial) return 0 ;
+        std::set<const VeriIdDef*>::const_iterator it ;
+        for (it = _reads.begin(); it != _reads.end(); it++) {
+            if (_writes.count(*it)) return 0 ;
+        }
+        return 1 ;
+    }
+
+    virtual void VERI_VISIT(VeriIdRef, node)
+    {
+        VeriIdDef *id = node.GetId() ;
+        if (!id || id->IsParam() || id->IsGenVar() || id->IsFunction() || id->IsTask()) return ;
+        (void) _reads.insert(id) ;
+    }
+    virtual void VERI_VISIT(VeriBlockingAssign, node)
+    {
+        Target(node.GetLVal()) ;
+        if (node.GetValue()) node.GetValue()->Accept(*this) ;
+    }
+    virtual void VERI_VISIT(VeriNonBlockingAssign, node)
+    {
+        Target(node.GetLVal()) ;
+        if (node.GetValue()) node.GetValue()->Accept(*this) ;
+    }
+    virtual void VERI_VISIT(VeriFor, node)
+    {
+        // The variable of a nested loop is folded into constants
+        if (node.GetCondition()) node.GetCondition()->Accept(*this) ;
+        if (node.GetStmt()) node.GetStmt()->Accept(*this) ;
+    }
+
+private:
+    void Target(VeriExpression *lval)
+    {
+        if (!lval) return ;
+        if (lval->GetClassId() == ID_VERICONCAT) {
+            unsigned i ;
+            VeriExpression *expr ;
+            FOREACH_ARRAY_ITEM(static_cast<VeriConcat*>(lval)->GetExpressions(), i, expr) Target(expr) ;
+        } else if ((lval->GetClassId() == ID_VERIIDREF) && lval->GetId()) {
+            (void) _writes.insert(lval->GetId()) ;
+        } else {
+            _partial = 1 ; // Bits, parts and memory words
+        }
+    }
+
+private:
+    std::set<const VeriIdDef*> _reads ;
+    std::set<const VeriIdDef*> _writes ;
+    unsigned _partial ;
+} ;
+
+// See LoopAccesses::Independent
+static unsigned IndependentIterations(VeriStatement *body)
+{
+    if (!body) return 1 ;
+    LoopAccesses accesses ;
+    body->Accept(accesses) ;
+    return accesses.Independent() ;
+}
+
+/*-----------------------------------------------------------------*/
+//                      Constructor / Destructor
+/*-----------------------------------------------------------------*/
+
+UclidStmtVisitor::UclidStmtVisitor(UclidVisitor &expressions)
+    : _expressions(expressions),
+      _text(),
+      _targets(),
+      _level(0),
+      _ssa(0),
+      _defines(0),
+      _deferred(),
+      _bound(),
+      _constants(),
+      _loop_depth(0),
+      _unroll_limit(UNROLL_LIMIT),
+      _unrolled(0),
+      _shared_formals(),
+      _shared_actuals()
+{
+}
+
+UclidStmtVisitor::~UclidStmtVisitor()
+{
+}
+
+/*-----------------------------------------------------------------*/
+//                          Utilities
+/*-----------------------------------------------------------------*/
+
+std::string UclidStmtVisitor::Translate(VeriStatement *stmt, unsigned level)
+{
+    _text = "" ;
+    _targets.clear() ;
+    _level = level ;
+    _unrolled = 0 ;
+    if (stmt) stmt->Accept(*this) ;
+    return _text ;
+}
+
+std::string UclidStmtVisitor::CaseCondition(const UclidTerm &sel, const Array *conditions)
+{
+    unsigned sel_width = (sel.is_bool) ? 1 : sel.width ;
+    std::string cond = "" ;
+    unsigned j ;
+    VeriExpression *expr ;
+    FOREACH_ARRAY_ITEM(conditions, j, expr) {
+        UclidTerm item = _expressions.Translate(expr, sel_width) ;
+        unsigned width = (item.is_literal || item.is_bool || (item.width < sel_width)) ? sel_width : item.width ;
+        if (j) cond += " || " ;
+        cond += "(" + UclidVisitor::AsBv(sel, width) + " == " + UclidVisitor::AsBv(item, width) + ")" ;
+    }
+    return "(" + cond + ")" ;
+}
+
+void UclidStmtVisitor::Line(const std::string &text)
+{
+    _text.append(_level, '\t') ;
+    _text += text ;
+    _text += "\n" ;
+}
+
+void UclidStmtVisitor::Target(const VeriIdDef *id)
+{
+    if (std::find(_targets.begin(), _targets.end(), id) == _targets.end()) _targets.push_back(id) ;
+}
+
+void UclidStmtVisitor::Block(VeriStatement *stmt)
+{
+    _level++ ;
+    if (stmt) stmt->Accept(*this) ;
+    _level-- ;
+}
+
+void UclidStmtVisitor::Unsupported(const VeriTreeNode &node, const char *what)
+{
+    node.Warning("%s is not translated to UCLID, ignored", what) ;
+}
+
+unsigned UclidStmtVisitor::TargetWidth(VeriExpression *lval) const
+{
+    if (lval && (lval->GetClassId() == ID_VERICONCAT)) {
+        unsigned width = 0 ;
+        unsigned i ;
+        VeriExpression *expr ;
+        FOREACH_ARRAY_ITEM(static_cast<VeriConcat*>(lval)->GetExpressions(), i, expr) {
+            unsigned w = TargetWidth(expr) ;
+            if (!w) return 0 ;
+            width += w ;
+        }
+        return width ;
+    }
+    VeriIdDef *id ;
+    unsigned lo, hi ;
+    return UclidVisitor::TargetBits(lval, id, lo, hi, &_expressions) ? (hi - lo + 1) : 0 ;
+}
+
+void UclidStmtVisitor::Assign(VeriExpression *lval, VeriExpression *value)
+{
+    if (!lval || !value) return ;
+    VeriIdDef *id = lval->GetId() ;
+
+    // Word of a memory : array update
+    if (id && id->IsMemory() && (lval->GetClassId() == ID_VERIINDEXEDID)) {
+        std::string address ;
+        if (!_expressions.TranslateAddress(id, lval->GetIndexExpr(), address)) {
+            Unsupported(*lval, "memory write") ;
+            return ;
+        }
+        unsigned width = UclidVisitor::IdWidth(id) ;
+        UclidTerm term = _expressions.Translate(value, width) ;
+        std::string name = _expressions.NameOf(id) ;
+        Line(name + "' = " + name + "[" + address + " -> " + UclidVisitor::AsBv(term, width) + "] ;") ;
+        Target(id) ;
+        return ;
+    }
+
+    // Single bit at a variable position : mask it out and or the new bit in
+    if (id && (lval->GetClassId() == ID_VERIINDEXEDID) && lval->GetIndexExpr() && !lval->GetIndexExpr()->IsRange()) {
+        long long index ;
+        if (!UclidVisitor::EvalConst(lval->GetIndexExpr(), index, &_expressions)) {
+            unsigned width = UclidVisitor::IdWidth(id) ;
+            long long base = UclidVisitor::BitPosition(id, 0) ;
+            if (UclidVisitor::BitPosition(id, 1) != base + 1) {
+                Unsupported(*lval, "variable bit write into an ascending range") ;
+                return ;
+            }
+            UclidTerm position = _expressions.Translate(lval->GetIndexExpr()) ;
+            std::string amount = UclidVisitor::AsBv(position, width) ;
+            if (base) amount = "(" + amount + " - " + UclidVisitor::Literal((unsigned long long)(-base), width).text + ")" ;
+            std::string bit = UclidVisitor::AsBv(_expressions.Translate(value, 1), 1) ;
+            if (width > 1) bit = "bv_zero_extend(" + std::to_string(width - 1) + ", " + bit + ")" ;
+            std::string name = _expressions.NameOf(id) ;
+            Line(name + "' = (" + name + " & ~bv_left_shift(" + UclidVisitor::Literal(1, width).text + ", " + amount + ")) | bv_left_shift(" + bit + ", " + amount + ") ;") ;
+            Target(id) ;
+            return ;
+        }
+    }
+
+    unsigned width = TargetWidth(lval) ;
+    if (!width) {
+        Unsupported(*lval, "assignment target") ;
+        return ;
+    }
+    UclidTerm term = _expressions.Translate(value, width) ;
+    (void) AssignBits(lval, UclidVisitor::AsBv(term, width), width, 0) ;
+}
+
+unsigned UclidStmtVisitor::AssignBits(VeriExpression *lval, const std::string &value, unsigned total, unsigned offset)
+{
+    if (lval && (lval->GetClassId() == ID_VERICONCAT)) {
+        // The last element of the concatenation takes the low bits
+        unsigned used = 0 ;
+        unsigned i ;
+        VeriExpression *expr ;
+        FOREACH_ARRAY_ITEM_BACK(static_cast<VeriConcat*>(lval)->GetExpressions(), i, expr) {
+            unsigned w = AssignBits(expr, value, total, offset + used) ;
+            if (!w) return 0 ;
+            used += w ;
+        }
+        return used ;
+    }
+
+    VeriIdDef *id ;
+    unsigned lo, hi ;
+    if (!UclidVisitor::TargetBits(lval, id, lo, hi, &_expressions)) return 0 ;
+    unsigned width = hi - lo + 1 ;
+    unsigned id_width = UclidVisitor::IdWidth(id) ;
+    std::string name = _expressions.NameOf(id) ;
+
+    // Narrowed signals are only written as a whole : keep their low bits
+    unsigned model_width = _expressions.ModelWidth(id) ;
+    if (model_width < id_width) {
+        std::string bits = "(" + value + ")[" + std::to_string(offset + model_width - 1) + ":" + std::to_string(offset) + "]" ;
+        Line(name + "' = " + bits + " ;") ;
+        Target(id) ;
+        return width ;
+    }
+
+    std::string bits = value ;
+    if ((offset != 0) || (width != total)) bits = "(" + value + ")[" + std::to_string(offset + width - 1) + ":" + std::to_string(offset) + "]" ;
+
+    // Bits outside the target keep their value
+    if (hi + 1 < id_width) bits = name + "[" + std::to_string(id_width - 1) + ":" + std::to_string(hi + 1) + "] ++ " + bits ;
+    if (lo) bits = bits + " ++ " + name + "[" + std::to_string(lo - 1) + ":0]" ;
+
+    Line(name + "' = " + bits + " ;") ;
+    Target(id) ;
+    return width ;
+}
+
+/*-----------------------------------------------------------------*/
+//                     Combinational Evaluation
+/*-----------------------------------------------------------------*/
+
+unsigned UclidStmtVisitor::Evaluate(VeriStatement *stmt, Values &values, UclidItems *shared)
+{
+    UclidItems *saved = _defines ;
+    if (shared) _defines = shared ;
+    _unrolled = 0 ;
+    unsigned ok = Execute(stmt, values) ;
+    _defines = saved ;
+
+    // Loop variables are only constant within the block
+    RestoreConstants(Constants()) ;
+    return ok ;
+}
+
+unsigned UclidStmtVisitor::Evaluate(const Array *stmts, Values &values, UclidItems *shared)
+{
+    UclidItems *saved = _defines ;
+    if (shared) _defines = shared ;
+    _unrolled = 0 ;
+    unsigned ok = 1 ;
+    unsigned i ;
+    VeriStatement *stmt ;
+    FOREACH_ARRAY_ITEM(stmts, i, stmt) {
+        if (ok) ok = Execute(stmt, values) ;
+    }
+    _defines = saved ;
+    RestoreConstants(Constants()) ;
+    return ok ;
+}
+
+unsigned UclidStmtVisitor::Execute(VeriStatement *stmt, Values &values)
+{
+    if (!stmt) return 1 ;
+
+    unsigned i ;
+    VeriStatement *sub ;
+    switch (stmt->GetClassId()) {
+    case ID_VERISEQBLOCK :
+        FOREACH_ARRAY_ITEM(static_cast<VeriSeqBlock*>(stmt)->GetStatements(), i, sub) {
+            if (!Execute(sub, values)) return 0 ;
+        }
+        return 1 ;
+
+    case ID_VERIPARBLOCK :
+        FOREACH_ARRAY_ITEM(static_cast<VeriParBlock*>(stmt)->GetStatements(), i, sub) {
+            if (!Execute(sub, values)) return 0 ;
+        }
+        return 1 ;
+
+    case ID_VERIBLOCKINGASSIGN :
+    {
+        VeriBlockingAssign *assign = static_cast<VeriBlockingAssign*>(stmt) ;
+        return ExecuteAssign(assign->GetLVal(), assign->GetValue(), 1, values) ;
+    }
+
+    case ID_VERINONBLOCKINGASSIGN :
+    {
+        VeriNonBlockingAssign *assign = static_cast<VeriNonBlockingAssign*>(stmt) ;
+        return ExecuteAssign(assign->GetLVal(), assign->GetValue(), 0, values) ;
+    }
+
+    case ID_VERICONDITIONALSTATEMENT :
+    {
+        VeriConditionalStatement *cond = static_cast<VeriConditionalStatement*>(stmt) ;
+        std::string test = UclidVisitor::AsBool(_expressions.Translate(cond->GetIfExpr())) ;
+        Constants before = _constants ;
+        Values then_values = values ;
+        Values else_values = values ;
+        if (!Execute(cond->GetThenStmt(), then_values)) return 0 ;
+        Constants common = _constants ;
+        RestoreConstants(before) ;
+        Bind(values) ;
+        if (!Execute(cond->GetElseStmt(), else_values)) return 0 ;
+        KeepCommon(common) ;
+        RestoreConstants(common) ;
+        if (_ssa) Complete(values, then_values, else_values) ;
+        Merge(test, then_values, else_values, values) ;
+        Bind(values) ;
+        return 1 ;
+    }
+
+    case ID_VERICASESTATEMENT :
+    {
+        VeriCaseStatement *case_stmt = static_cast<VeriCaseStatement*>(stmt) ;
+        Array *items = case_stmt->GetCaseItems() ;
+        if (!items || !items->Size()) return 1 ;
+        UclidTerm sel = _expressions.Translate(case_stmt->GetCondition()) ;
+
+        // Without a match : the default item. A full case without one ends
+        // in its last item, anything else leaves the values as they were.
+        VeriCaseItem *fallback = 0 ;
+        VeriCaseItem *item ;
+        FOREACH_ARRAY_ITEM(items, i, item) {
+            if (item && !item->GetConditions()) fallback = item ;
+        }
+        if (!fallback && AlwaysClassifier::FullCase(*case_stmt)) {
+            FOREACH_ARRAY_ITEM_BACK(items, i, item) {
+                if (item) break ;
+            }
+            fallback = item ;
+        }
+        Constants before = _constants ;
+        Values result = values ;
+        if (fallback) {
+            if (!Execute(fallback->GetStmt(), result)) return 0 ;
+            Bind(values) ;
+        }
+        Constants common = _constants ;
+
+        // Priority case : fold the items from the last one up
+        FOREACH_ARRAY_ITEM_BACK(items, i, item) {
+            if (!item || !item->GetConditions() || (item == fallback)) continue ;
+            std::string test = CaseCondition(sel, item->GetConditions()) ;
+            RestoreConstants(before) ;
+            Values item_values = values ;
+            if (!Execute(item->GetStmt(), item_values)) return 0 ;
+            KeepCommon(common) ;
+            Bind(values) ;
+            if (_ssa) Complete(values, item_values, result) ;
+            Values merged ;
+            Merge(test, item_values, result, merged) ;
+            result.swap(merged) ;
+        }
+        RestoreConstants(common) ;
+        values.swap(result) ;
+        Bind(values) ;
+        return 1 ;
+    }
+
+    case ID_VERIFOR :
+    case ID_VERIREPEAT :
+    case ID_VERIWHILE :
+        return ExecuteLoop(stmt, values) ;
+
+    case ID_VERIEVENTCONTROLSTATEMENT :
+        // The event control of the construct : one evaluation of its body
+        return Execute(static_cast<VeriEventControlStatement*>(stmt)->GetStmt(), values) ;
+
+    case ID_VERISYSTEMTASKENABLE :
+    case ID_VERINULLSTATEMENT :
+        return 1 ;
+
+    default :
+        return 0 ;
+    }
+}
+
+unsigned UclidStmtVisitor::ExecuteAssign(VeriExpression *lval, VeriExpression *value, unsigned blocking, Values &values)
+{
+    if (!lval || !value) return 0 ;
+    VeriIdDef *id = lval->GetId() ;
+    if (!id || id->IsMemory()) return 0 ;
+
+    // Loop variables : constant where they are assigned a constant
+    long long constant ;
+    unsigned folded = 0 ;
+    if (blocking && (lval->GetClassId() == ID_VERIIDREF) && (UclidVisitor::IsInteger(id) || _constants.count(id))) {
+        if (UclidVisitor::EvalConst(value, constant, &_expressions)) {
+            BindConstant(id, constant) ;
+            if (UclidVisitor::IsInteger(id)) return 1 ;
+            folded = 1 ;
+        } else {
+            // Integers are not in the model : their value must be known
+            if (UclidVisitor::IsInteger(id)) return 0 ;
+            _expressions.UnbindGenvar(id) ;
+            (void) _constants.erase(id) ;
+        }
+    }
+
+    unsigned id_width = UclidVisitor::IdWidth(id) ;
+    std::string text ;
+    if (folded) {
+        text = UclidVisitor::Literal((unsigned long long)_constants[id], _expressions.ModelWidth(id)).text ;
+    } else if (lval->GetClassId() == ID_VERIIDREF) {
+        text = UclidVisitor::AsBv(_expressions.Translate(value, id_width), _expressions.ModelWidth(id)) ;
+    } else {
+        // Constant bit or part-select : the other bits keep their value so far
+        unsigned lo, hi ;
+        if (!UclidVisitor::TargetBits(lval, id, lo, hi, &_expressions) || (_expressions.ModelWidth(id) < id_width)) return 0 ;
+        unsigned width = hi - lo + 1 ;
+        text = UclidVisitor::AsBv(_expressions.Translate(value, width), width) ;
+        if (width < id_width) {
+            Values::const_iterator vi = values.find(id) ;
+            std::string current = (vi != values.end()) ? vi->second : std::string(_expressions.NameOf(id)) ;
+            // Read twice below : do not let repeated writes double its size
+            if (_defines && (current.size() > SSA_SHARE_LENGTH)) current = Share(id, current) ;
+            if (vi != values.end()) current = "(" + current + ")" ;
+            if (hi + 1 < id_width) text = current + "[" + std::to_string(id_width - 1) + ":" + std::to_string(hi + 1) + "] ++ " + text ;
+            if (lo) text = text + " ++ " + current + "[" + std::to_string(lo - 1) + ":0]" ;
+        }
+    }
+
+    // Later reads in the block see the assigned value
+    values[id] = text ;
+    if (_ssa) {
+        // Nonblocking : reads in the block keep seeing the current state
+        if (!blocking) (void) _deferred.insert(id) ;
+        Bind(values) ;
+    } else if (_loop_depth) {
+        Bind(values) ;
+    } else {
+        _expressions.SetValue(id, text) ;
+    }
+    return 1 ;
+}
+
+unsigned UclidStmtVisitor::ExecuteLoop(VeriStatement *stmt, Values &values)
+{
+    VeriStatement *body = static_cast<VeriLoop*>(stmt)->GetStmt() ;
+    VeriFor *for_loop = (stmt->GetClassId() == ID_VERIFOR) ? static_cast<VeriFor*>(stmt) : 0 ;
+
+    unsigned i ;
+    VeriModuleItem *item ;
+    FOREACH_ARRAY_ITEM((for_loop) ? for_loop->GetInitials() : 0, i, item) {
+        if (!item || (item->GetClassId() != ID_VERIBLOCKINGASSIGN)) return 0 ;
+        VeriBlockingAssign *init = static_cast<VeriBlockingAssign*>(item) ;
+        VeriIdDef *id = (init->GetLVal() && (init->GetLVal()->GetClassId() == ID_VERIIDREF)) ? init->GetLVal()->GetId() : 0 ;
+        long long value ;
+        if (!id || !UclidVisitor::EvalConst(init->GetValue(), value, &_expressions)) return 0 ;
+        BindConstant(id, value) ;
+        if (!ExecuteAssign(init->GetLVal(), init->GetValue(), 1, values)) return 0 ;
+    }
+
+    // A repeat runs a constant number of times. The condition of the other
+    // loops must turn constant false on the constant values of their variables.
+    long long count = 0 ;
+    if (!for_loop && (stmt->GetClassId() == ID_VERIREPEAT) && !UclidVisitor::EvalConst(static_cast<VeriRepeat*>(stmt)->GetCondition(), count, &_expressions)) return 0 ;
+
+    unsigned ok = 1 ;
+    _loop_depth++ ;
+    for (long long n = 0; ok; n++) {
+        long long condition = 0 ;
+        if (stmt->GetClassId() == ID_VERIREPEAT) {
+            condition = (n < count) ;
+        } else if (!UclidVisitor::EvalConst((for_loop) ? for_loop->GetCondition() : static_cast<VeriWhile*>(stmt)->GetCondition(), condition, &_expressions)) {
+            ok = 0 ;
+            break ;
+        }
+        if (!condition) break ;
+        if (++_unrolled > _unroll_limit) {
+            stmt->Warning("%s loop runs over the unroll budget of %u iterations, not translated to UCLID", (for_loop) ? "for" : ((stmt->GetClassId() == ID_VERIREPEAT) ? "repeat" : "while"), _unroll_limit) ;
+            ok = 0 ;
+            break ;
+        }
+        ok = Execute(body, values) ;
+        FOREACH_ARRAY_ITEM((for_loop) ? for_loop->GetRepetitions() : 0, i, item) {
+            if (!ok) break ;
+            if (!item || (item->GetClassId() != ID_VERIBLOCKINGASSIGN)) ok = 0 ;
+            else ok = ExecuteAssign(static_cast<VeriBlockingAssign*>(item)->GetLVal(), static_cast<VeriBlockingAssign*>(item)->GetValue(), 1, values) ;
+        }
+    }
+    _loop_depth-- ;
+    return ok ;
+}
+
+unsigned UclidStmtVisitor::EvaluateNext(VeriStatement *stmt, Values &values, UclidItems &defines)
+{
+    size_t mark = defines.size() ;
+    _ssa = 1 ;
+    unsigned ok = Evaluate(stmt, values, &defines) ;
+    _ssa = 0 ;
+
+    // The values inside the block are not seen outside of it
+    std::set<const VeriIdDef*>::const_iterator bi ;
+    for (bi = _bound.begin(); bi != _bound.end(); bi++) _expressions.ClearValue(*bi) ;
+    _bound.clear() ;
+    _deferred.clear() ;
+
+    if (!ok) {
+        values.clear() ;
+        defines.resize(mark) ;
+    }
+    return ok ;
+}
+
+void UclidStmtVisitor::BindConstant(const VeriIdDef *id, long long value)
+{
+    unsigned width = UclidVisitor::IdWidth(id) ;
+    if (width < 64) {
+        // Wrap around, as the variable would
+        unsigned long long mask = (1ULL << width) - 1 ;
+        unsigned long long bits = (unsigned long long)value & mask ;
+        if (UclidVisitor::IsInteger(id) && (bits >> (width - 1))) bits |= ~mask ;
+        value = (long long)bits ;
+    }
+    _expressions.BindGenvar(id, value, 0) ;
+    _constants[id] = value ;
+}
+
+void UclidStmtVisitor::RestoreConstants(const Constants &constants)
+{
+    Constants::const_iterator ci ;
+    for (ci = _constants.begin(); ci != _constants.end(); ci++) {
+        if (!constants.count(ci->first)) _expressions.UnbindGenvar(ci->first) ;
+    }
+    _constants = constants ;
+    for (ci = _constants.begin(); ci != _constants.end(); ci++) _expressions.BindGenvar(ci->first, ci->second, 0) ;
+}
+
+void UclidStmtVisitor::KeepCommon(Constants &common) const
+{
+    Constants::iterator ci = common.begin() ;
+    while (ci != common.end()) {
+        Constants::const_iterator now = _constants.find(ci->first) ;
+        if ((now != _constants.end()) && (now->second == ci->second)) {
+            ci++ ;
+            continue ;
+        }
+        common.erase(ci++) ;
+    }
+}
+
+std::string UclidStmtVisitor::Share(const VeriIdDef *id, const std::string &value)
+{
+    // Readers call the define instead of repeating the value
+    std::string name = _expressions.NewName((std::string(_expressions.NameOf(id)) + "_ssa").c_str()) ;
+    _defines->push_back(UclidItem::Define(name, _shared_formals, _expressions.ModelWidth(id), value)) ;
+    return name + "(" + _shared_actuals + ")" ;
+}
+
+void UclidStmtVisitor::Bind(Values &values)
+{
+    if (_ssa) {
+        // Values bound inside a branch are not seen after it
+        std::set<const VeriIdDef*>::iterator bi = _bound.begin() ;
+        while (bi != _bound.end()) {
+            if (values.count(*bi) && !_deferred.count(*bi)) {
+                bi++ ;
+                continue ;
+            }
+            _expressions.ClearValue(*bi) ;
+            _bound.erase(bi++) ;
+        }
+    }
+
+    Values::iterator vi ;
+    for (vi = values.begin(); vi != values.end(); vi++) {
+        if (_ssa && _deferred.count(vi->first)) continue ;
+        if (_defines && (_ssa || _loop_depth) && (vi->second.size() > SSA_SHARE_LENGTH)) vi->second = Share(vi->first, vi->second) ;
+        if (_ssa) (void) _bound.insert(vi->first) ;
+        _expressions.SetValue(vi->first, vi->second) ;
+    }
+}
+
+void UclidStmtVisitor::Complete(const Values &base, Values &then_values, Values &else_values) const
+{
+    Values *sides[2] = { &then_values, &else_values } ;
+    for (unsigned k = 0; k < 2; k++) {
+        Values &one = *sides[k] ;
+        Values &other = *sides[1 - k] ;
+        Values::const_iterator vi ;
+        for (vi = one.begin(); vi != one.end(); vi++) {
+            if (other.count(vi->first)) continue ;
+            Values::const_iterator bi = base.find(vi->first) ;
+            other[vi->first] = (bi != base.end()) ? bi->second : std::string(_expressions.NameOf(vi->first)) ;
+        }
+    }
+}
+
+// static
+void UclidStmtVisitor::Merge(const std::string &cond, const Values &then_values, const Values &else_values, Values &values)
+{
+    values.clear() ;
+    Values::const_iterator vi ;
+    for (vi = then_values.begin(); vi != then_values.end(); vi++) {
+        Values::const_iterator ei = else_values.find(vi->first) ;
+        if (ei == else_values.end()) continue ;
+        values[vi->first] = (vi->second == ei->second) ? vi->second : "(if (" + cond + ") then " + vi->second + " else " + ei->second + ")" ;
+    }
+}
+
+/*-----------------------------------------------------------------*/
+//        Visit Methods : Class details in VeriStatement.h
+/*-----------------------------------------------------------------*/
+
+void UclidStmtVisitor::VERI_VISIT(VeriStatement, node)
+{
+    Unsupported(node, "statement") ;
+}
+
+void UclidStmtVisitor::VERI_VISIT(VeriBlockingAssign, node)
+{
+    // Both kinds of assignment update the next state : reads see the current state
+    if (node.GetControl()) node.Warning("intra-assignment timing control is ignored") ;
+    Assign(node.GetLVal(), node.GetValue()) ;
+}
+
+void UclidStmtVisitor::VERI_VISIT(VeriNonBlockingAssign, node)
+{
+    if (node.GetControl()) node.Warning("intra-assignment timing control is ignored") ;
+    Assign(node.GetLVal(), node.GetValue()) ;
+}
+
+void UclidStmtVisitor::VERI_VISIT(VeriGenVarAssign, node)           { Unsupported(node, "genvar assignment") ; }
+void UclidStmtVisitor::VERI_VISIT(VeriAssign, node)                 { Unsupported(node, "procedural continuous assignment") ; }
+void UclidStmtVisitor::VERI_VISIT(VeriDeAssign, node)               { Unsupported(node, "deassign") ; }
+void UclidStmtVisitor::VERI_VISIT(VeriForce, node)                  { Unsupported(node, "force") ; }
+void UclidStmtVisitor::VERI_VISIT(VeriRelease, node)                { Unsupported(node, "release") ; }
+void UclidStmtVisitor::VERI_VISIT(VeriTaskEnable, node)             { Unsupported(node, "task call") ; }
+void UclidStmtVisitor::VERI_VISIT(VeriForever, node)                { Unsupported(node, "forever loop") ; }
+void UclidStmtVisitor::VERI_VISIT(VeriWait, node)                   { Unsupported(node, "wait") ; }
+void UclidStmtVisitor::VERI_VISIT(VeriDisable, node)                { Unsupported(node, "disable") ; }
+void UclidStmtVisitor::VERI_VISIT(VeriEventTrigger, node)           { Unsupported(node, "event trigger") ; }
+
+void UclidStmtVisitor::VERI_VISIT(VeriSystemTaskEnable, node)
+{
+    // $display and friends only matter to simulation
+}
+
+void UclidStmtVisitor::VERI_VISIT(VeriDelayControlStatement, node)
+{
+    if (node.GetStmt()) node.GetStmt()->Accept(*this) ;
+}
+
+void UclidStmtVisitor::VERI_VISIT(VeriEventControlStatement, node)
+{
+    // One UCLID step is one activation of the block, whatever the events
+    if (node.GetStmt()) node.GetStmt()->Accept(*this) ;
+}
+
+void UclidStmtVisitor::VERI_VISIT(VeriRepeat, node)
+{
+    long long count ;
+    if (!UclidVisitor::EvalConst(node.GetCondition(), count, &_expressions)) {
+        Unsupported(node, "repeat loop with a count that is not constant") ;
+        return ;
+    }
+    if (count <= 0) return ;
+    if (_unrolled + count > _unroll_limit) {
+        node.Warning("repeat loop runs over the unroll budget of %u iterations, not translated to UCLID", _unroll_limit) ;
+        return ;
+    }
+    if ((count > 1) && !IndependentIterations(node.GetStmt())) {
+        Unsupported(node, "repeat loop whose iterations build on each other") ;
+        return ;
+    }
+    _unrolled += (unsigned)count ;
+
+    // The body does not depend on the iteration, and the copies would assign
+    // the same values again : translate it once
+    if (node.GetStmt()) node.GetStmt()->Accept(*this) ;
+}
+
+void UclidStmtVisitor::VERI_VISIT(VeriWhile, node)
+{
+    long long condition ;
+    if (UclidVisitor::EvalConst(node.GetCondition(), condition, &_expressions) && !condition) return ;
+    Unsupported(node, "while loop") ;
+}
+
+void UclidStmtVisitor::VERI_VISIT(VeriFor, node)
+{
+    const VeriIdDef *var = 0 ;
+    std::vector<long long> indexes ;
+    long long end_value = 0 ;
+    if (!LoopIndexes(node, var, indexes, end_value)) return ;
+
+    size_t num = indexes.size() ;
+    if ((num > 1) && !IndependentIterations(node.GetStmt())) {
+        Unsupported(node, "for loop whose iterations build on each other") ;
+        return ;
+    }
+    std::vector<std::string> bodies(num) ;
+    std::vector<unsigned> done(num, 0) ;
+
+    // As for generate loops (see UclidEmitter::TranslateGenerateFor) : the
+    // first, last and middle iterations are translated, the others are
+    // instantiated from the template fitted on them if it predicts the middle one
+    if (num >= 4) {
+        unsigned outer = _expressions.NonAffine() ;
+        _expressions.SetNonAffine(0) ;
+        size_t probes[3] = { 0, num - 1, num / 2 } ;
+        for (unsigned k = 0; k < 3; k++) {
+            bodies[probes[k]] = TranslateIteration(node.GetStmt(), var, indexes[probes[k]], 1) ;
+            done[probes[k]] = 1 ;
+        }
+        unsigned inner = _expressions.NonAffine() ;
+
+        long long lowest = (indexes[0] < indexes[num - 1]) ? indexes[0] : indexes[num - 1] ;
+        long long highest = (indexes[0] < indexes[num - 1]) ? indexes[num - 1] : indexes[0] ;
+        unsigned in_range = 1 ;
+        for (size_t i = 0; i < num; i++) if ((indexes[i] < lowest) || (indexes[i] > highest)) in_range = 0 ;
+
+        UclidBodyTemplate body ;
+        std::string middle ;
+        if (!inner && in_range && body.Fit(bodies[0], indexes[0], bodies[num - 1], indexes[num - 1]) &&
+            body.Instantiate(indexes[num / 2], middle) && (middle == bodies[num / 2])) {
+            for (size_t i = 0; i < num; i++) {
+                if (!done[i]) done[i] = body.Instantiate(indexes[i], bodies[i]) ;
+            }
+        }
+        _expressions.SetNonAffine(outer | inner) ;
+    }
+
+    for (size_t i = 0; i < num; i++) {
+        if (!done[i]) bodies[i] = TranslateIteration(node.GetStmt(), var, indexes[i], 0) ;
+        _text += bodies[i] ;
+        std::string().swap(bodies[i]) ;
+    }
+
+    // A loop variable that is a signal of the model ends on its end_value value
+    if (!UclidVisitor::IsInteger(var)) {
+        unsigned width = _expressions.ModelWidth(var) ;
+        Line(std::string(_expressions.NameOf(var)) + "' = " + UclidVisitor::Literal((unsigned long long)end_value, width).text + " ;") ;
+        Target(var) ;
+    }
+}
+
+unsigned UclidStmtVisitor::LoopIndexes(VeriFor &loop, const VeriIdDef *&var, std::vector<long long> &indexes, long long &end_value)
+{
+    Array *initials = loop.GetInitials() ;
+    Array *repetitions = loop.GetRepetitions() ;
+    VeriModuleItem *initial = (initials && (initials->Size() == 1)) ? (VeriModuleItem*)initials->At(0) : 0 ;
+    VeriModuleItem *repetition = (repetitions && (repetitions->Size() == 1)) ? (VeriModuleItem*)repetitions->At(0) : 0 ;
+    if (!initial || (initial->GetClassId() != ID_VERIBLOCKINGASSIGN) ||
+        !repetition || (repetition->GetClassId() != ID_VERIBLOCKINGASSIGN)) {
+        Unsupported(loop, "for loop") ;
+        return 0 ;
+    }
+    VeriBlockingAssign *init = static_cast<VeriBlockingAssign*>(initial) ;
+    VeriBlockingAssign *step = static_cast<VeriBlockingAssign*>(repetition) ;
+    var = (init->GetLVal() && (init->GetLVal()->GetClassId() == ID_VERIIDREF)) ? init->GetLVal()->GetId() : 0 ;
+    if (!var || !step->GetLVal() || (step->GetLVal()->GetId() != var)) {
+        Unsupported(loop, "for loop") ;
+        return 0 ;
+    }
+
+    long long value ;
+    if (!UclidVisitor::EvalConst(init->GetValue(), value, &_expressions)) {
+        loop.Warning("for loop start is not constant, not translated to UCLID") ;
+        return 0 ;
+    }
+    unsigned ok = 1 ;
+    for (;;) {
+        BindConstant(var, value) ;
+        value = _constants[var] ;
+        long long condition ;
+        if (!UclidVisitor::EvalConst(loop.GetCondition(), condition, &_expressions)) {
+            loop.Warning("for loop condition is not constant, not translated to UCLID") ;
+            ok = 0 ;
+            break ;
+        }
+        if (!condition) break ;
+        if (_unrolled + indexes.size() >= _unroll_limit) {
+            loop.Warning("for loop runs over the unroll budget of %u iterations, not translated to UCLID", _unroll_limit) ;
+            ok = 0 ;
+            break ;
+        }
+        indexes.push_back(value) ;
+        if (!UclidVisitor::EvalConst(step->GetValue(), value, &_expressions)) {
+            loop.Warning("for loop step is not constant, not translated to UCLID") ;
+            ok = 0 ;
+            break ;
+        }
+    }
+    end_value = value ;
+    RestoreConstants(Constants()) ;
+    if (ok) _unrolled += (unsigned)indexes.size() ;
+    return ok ;
+}
+
+std::string UclidStmtVisitor::TranslateIteration(VeriStatement *body, const VeriIdDef *var, long long value, unsigned template_index)
+{
+    std::string saved = _text ;
+    _text = "" ;
+    _expressions.BindGenvar(var, value, template_index) ;
+    if (body) body->Accept(*this) ;
+    _expressions.UnbindGenvar(var) ;
+    std::string text = _text ;
+    _text = saved ;
+    return text ;
+}
+
+void UclidStmtVisitor::VERI_VISIT(VeriConditionalStatement, node)
+{
+    UclidTerm cond = _expressions.Translate(node.GetIfExpr()) ;
+    Line("if (" + UclidVisitor::AsBool(cond) + ") {") ;
+    Block(node.GetThenStmt()) ;
+    if (node.GetElseStmt()) {
+        Line("} else {") ;
+        Block(node.GetElseStmt()) ;
+    }
+    Line("}") ;
+}
+
+void UclidStmtVisitor::VERI_VISIT(VeriCaseStatement, node)
+{
+    if (!node.GetCaseItems() || !node.GetCaseItems()->Size()) return ;
+    if (node.GetCaseStyle() != VERI_CASE) node.Warning("casex/casez items are compared exactly in UCLID") ;
+
+    // Priority case : the first matching item wins
+    UclidTerm sel = _expressions.Translate(node.GetCondition()) ;
+
+    Line("case") ;
+    _level++ ;
+    VeriCaseItem *default_item = 0 ;
+    unsigned i ;
+    VeriCaseItem *ci ;
+    FOREACH_ARRAY_ITEM(node.GetCaseItems(), i, ci) {
+        if (!ci) continue ;
+        if (!ci->GetConditions()) {
+            default_item = ci ;
+            continue ;
+        }
+        std::string cond = CaseCondition(sel, ci->GetConditions()) ;
+        Line(cond + " : {") ;
+        Block(ci->GetStmt()) ;
+        Line("}") ;
+    }
+    if (default_item) {
+        Line("default : {") ;
+        Block(default_item->GetStmt()) ;
+        Line("}") ;
+    }
+    _level-- ;
+    Line("esac") ;
+}
+
+void UclidStmtVisitor::VERI_VISIT(VeriSeqBlock, node)
+{
+    unsigned i ;
+    VeriStatement *stmt ;
+    FOREACH_ARRAY_ITEM(node.GetStatements(), i, stmt) {
+        if (stmt) stmt->Accept(*this) ;
+    }
+}
+
+void UclidStmtVisitor::VERI_VISIT(VeriParBlock, node)
+{
+    // All branches run within the step : same as a sequential block here
+    unsigned i ;
+    VeriStatement *stmt ;
+    FOREACH_ARRAY_ITEM(node.GetStatements(), i, stmt) {
+        if (stmt) stmt->Accept(*this) ;
+    }
+}
+
+/*---------------------------------------------*/
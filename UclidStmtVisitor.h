@@ -0,0 +1,216 @@
+/*
+ *
+ * Translation of Verilog procedural statements into UCLID5 statements.
+ *
+ * UclidStmtVisitor turns the statement of an always construct into the
+ * statements of a UCLID 'next' block. One UCLID step is one evaluation of
+ * the block : assignments become primed assignments, if and case become
+ * nested if statements, and writes to memories become array updates.
+ *
+ * Where the block allows it, EvaluateNext turns it into static single
+ * assignment form instead : one next-state expression per assigned signal,
+ * with if-then-else terms at the joins of if and case statements. Values
+ * that later statements read, and that are long enough to be worth it, are
+ * shared through defines rather than copied into every reader.
+ *
+ * Procedural for, repeat and while loops with a constant trip count are
+ * unrolled, with the loop variable folded into a constant in each iteration.
+ * In SSA form each iteration is evaluated on the values the one before it
+ * left, so the body is evaluated once per iteration. In statement mode the
+ * body of a for loop is translated for a few iterations only and the others
+ * are instantiated from a template over the loop variable (see
+ * UclidBodyTemplate) where its text allows it. There each copy of the body
+ * reads the current state, so a loop is only translated there if no
+ * iteration reads, or writes part of, a signal that the loop writes. The
+ * iterations unrolled per always block are bounded by an unroll budget.
+ *
+*/
+#ifndef _VERIFIC_UCLID_STMT_VISITOR_H_
+#define _VERIFIC_UCLID_STMT_VISITOR_H_
+
+#include "VeriVisitor.h"    // Visitor base class definition
+#include "UclidModel.h"     // Items of emitted modules
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#ifdef VERIFIC_NAMESPACE
+namespace Verific { // start definitions in verific namespace
+#endif
+
+class UclidVisitor ;
+struct UclidTerm ;
+class VeriIdDef ;
+class Array ;
+
+/* -------------------------------------------------------------------------- */
+
+class UclidStmtVisitor : public VeriVisitor
+{
+public:
+    explicit UclidStmtVisitor(UclidVisitor &expressions) ;
+    virtual ~UclidStmtVisitor() ;
+
+    // UCLID text of 'stmt', indented 'level' tabs
+    std::string Translate(VeriStatement *stmt, unsigned level) ;
+
+    // Signals the statements of the last Translate assign, once each
+    const std::vector<const VeriIdDef*> &Targets() const { return _targets ; }
+
+    // Loop iterations unrolled per always block, at most (default 4096)
+    void SetUnrollLimit(unsigned limit)     { _unroll_limit = limit ; }
+
+    // UCLID value of each identifier a combinational block assigns
+    typedef std::map<const VeriIdDef*, std::string> Values ;
+
+    // Execute 'stmt' symbolically, adding to 'values' what the identifiers it
+    // assigns hold at its end : if and case become if-then-else terms. Values
+    // are bound in the expression visitor while the block is evaluated, and
+    // are left bound. Loops are unrolled, and long values they compute are
+    // shared through defines appended to 'shared', if given. Returns 0 on
+    // statements that have no such value (see AlwaysClassifier), and on loops
+    // over the unroll budget.
+    unsigned Evaluate(VeriStatement *stmt, Values &values, UclidItems *shared = 0) ;
+
+    // Evaluate the statements 'stmts' (of a function body) in sequence
+    unsigned Evaluate(const Array *stmts, Values &values, UclidItems *shared = 0) ;
+
+    // The defines of shared values take these arguments, and are called with
+    // them : inside a function body, its ports ("a : bv8, b : bv8" and "a, b")
+    void SetSharedArguments(const std::string &formals, const std::string &actuals) { _shared_formals = formals ; _shared_actuals = actuals ; }
+
+    // Next-state value of each identifier the always construct 'stmt' assigns.
+    // Reads see the values of earlier blocking assignments, and the current
+    // state otherwise. Signals assigned on some paths only keep their value on
+    // the others. The defines introduced for shared values are appended to
+    // 'defines'. Returns 0 (and no values) where Evaluate would.
+    unsigned EvaluateNext(VeriStatement *stmt, Values &values, UclidItems &defines) ;
+
+/* ================================================================= */
+/*                         VISIT METHODS                             */
+/* ================================================================= */
+
+    // The following class definitions can be found in VeriStatement.h
+    virtual void VERI_VISIT(VeriStatement, node);
+    virtual void VERI_VISIT(VeriBlockingAssign, node);
+    virtual void VERI_VISIT(VeriNonBlockingAssign, node);
+    virtual void VERI_VISIT(VeriGenVarAssign, node);
+    virtual void VERI_VISIT(VeriAssign, node);
+    virtual void VERI_VISIT(VeriDeAssign, node);
+    virtual void VERI_VISIT(VeriForce, node);
+    virtual void VERI_VISIT(VeriRelease, node);
+    virtual void VERI_VISIT(VeriTaskEnable, node);
+    virtual void VERI_VISIT(VeriSystemTaskEnable, node);
+    virtual void VERI_VISIT(VeriDelayControlStatement, node);
+    virtual void VERI_VISIT(VeriEventControlStatement, node);
+    virtual void VERI_VISIT(VeriConditionalStatement, node);
+    virtual void VERI_VISIT(VeriCaseStatement, node);
+    virtual void VERI_VISIT(VeriForever, node);
+    virtual void VERI_VISIT(VeriRepeat, node);
+    virtual void VERI_VISIT(VeriWhile, node);
+    virtual void VERI_VISIT(VeriFor, node);
+    virtual void VERI_VISIT(VeriWait, node);
+    virtual void VERI_VISIT(VeriDisable, node);
+    virtual void VERI_VISIT(VeriEventTrigger, node);
+    virtual void VERI_VISIT(VeriSeqBlock, node);
+    virtual void VERI_VISIT(VeriParBlock, node);
+
+private:
+    // Values of the integers (and other loop variables) that are constant
+    // where the block is being evaluated
+    typedef std::map<const VeriIdDef*, long long> Constants ;
+
+    // Evaluate 'stmt', for Evaluate
+    unsigned Execute(VeriStatement *stmt, Values &values) ;
+
+    // Unroll the loop 'stmt' (for, repeat or while) into 'values'
+    unsigned ExecuteLoop(VeriStatement *stmt, Values &values) ;
+
+    // Assignment of 'value' to 'lval', for Execute
+    unsigned ExecuteAssign(VeriExpression *lval, VeriExpression *value, unsigned blocking, Values &values) ;
+
+    // Loop variable 'id' holds 'value' (wrapped to its width) from now on
+    void BindConstant(const VeriIdDef *id, long long value) ;
+
+    // Make 'constants' the constant values (of the loop variables) : after a
+    // branch, what was constant before it. KeepCommon drops from 'common' the
+    // values that differ from the current ones.
+    void RestoreConstants(const Constants &constants) ;
+    void KeepCommon(Constants &common) const ;
+
+    // Values of the variable of for loop 'loop', in iteration order. Warns and
+    // returns 0 if they are not constant or exceed the budget left.
+    unsigned LoopIndexes(VeriFor &loop, const VeriIdDef *&var, std::vector<long long> &indexes, long long &end_value) ;
+
+    // Statement text of one iteration of the body of a for loop
+    std::string TranslateIteration(VeriStatement *body, const VeriIdDef *var, long long value, unsigned template_index) ;
+
+    // A define holding 'value' of 'id', for values that are read more than once
+    std::string Share(const VeriIdDef *id, const std::string &value) ;
+
+    // Append one line at the current level
+    void Line(const std::string &text) ;
+
+    // 'id' is assigned by the statements being translated
+    void Target(const VeriIdDef *id) ;
+
+    // Translate a nested statement into a '{ ... }' block
+    void Block(VeriStatement *stmt) ;
+
+    // Primed assignment of 'value' to 'lval'
+    void Assign(VeriExpression *lval, VeriExpression *value) ;
+
+    // Assign bits [offset + width(lval) - 1 : offset] of the 'total' bit 'value' to 'lval'
+    unsigned AssignBits(VeriExpression *lval, const std::string &value, unsigned total, unsigned offset) ;
+
+    // Condition of a case item, as a UCLID boolean
+    std::string CaseCondition(const UclidTerm &sel, const Array *conditions) ;
+
+    // Bind 'values' in the expression visitor. In EvaluateNext and in loops,
+    // long values are moved into defines first. In EvaluateNext nonblocking
+    // ones are not bound.
+    void Bind(Values &values) ;
+
+    // 'values' after an if : 'cond' picks 'then_values' or 'else_values'.
+    // Identifiers assigned on one side only have no value after it.
+    static void Merge(const std::string &cond, const Values &then_values, const Values &else_values, Values &values) ;
+
+    // In EvaluateNext : give the identifiers assigned on one side only their
+    // value from before the branch ('base', or the current state) on the other
+    void Complete(const Values &base, Values &then_values, Values &else_values) const ;
+
+    // Width of an assignment target (0 if we cannot translate it)
+    unsigned TargetWidth(VeriExpression *lval) const ;
+
+    void Unsupported(const VeriTreeNode &node, const char *what) ;
+
+private:
+    UclidVisitor    &_expressions ; // Translates the expressions
+    std::string      _text ;        // Translated statements so far
+    std::vector<const VeriIdDef*> _targets ; // Assigned by them
+    unsigned         _level ;       // Indentation of the current statement
+    unsigned         _ssa ;         // In EvaluateNext
+    UclidItems      *_defines ;     // Defines of shared values (EvaluateNext)
+    std::set<const VeriIdDef*> _deferred ;  // Assigned by nonblocking assignments (EvaluateNext)
+    std::set<const VeriIdDef*> _bound ;     // Bound in the expression visitor (EvaluateNext)
+    Constants        _constants ;   // Loop variables bound to a constant (Evaluate)
+    unsigned         _loop_depth ;  // Loops being unrolled (Evaluate)
+    unsigned         _unroll_limit ;
+    unsigned         _unrolled ;    // Iterations unrolled in the block so far
+    std::string      _shared_formals ; // See SetSharedArguments
+    std::string      _shared_actuals ;
+
+    // Prevent the compiler from implementing the following
+    UclidStmtVisitor(const UclidStmtVisitor &node) ;
+    UclidStmtVisitor& operator=(const UclidStmtVisitor &rhs) ;
+} ;
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef VERIFIC_NAMESPACE
+} // end definitions in verific namespace
+#endif
+
+#endif // #ifndef _VERIFIC_UCLID_STMT_VISITOR_H_
@@ -0,0 +1,159 @@
+/*
+ *
+ * Interned UCLID names for Verilog identifiers.
+ *
+*/
+
+#include <cctype>           // isalnum, isdigit
+#include <cstring>          // strcmp
+
+#include "UclidSymbolTable.h" // UclidSymbolTable class definition
+#include "UclidModel.h"     // UCLID keywords
+
+#include "Array.h"          // Make dynamic array class Array available
+#include "Map.h"            // Make associated hash table class Map available
+#include "Set.h"            // Make associated hash table class Set available
+#include "Strings.h"        // A string utility/wrapper class
+
+#include "VeriId.h"         // Definitions of all identifier definition tree nodes
+
+#ifdef VERIFIC_NAMESPACE
+using namespace Verific ;
+#endif
+
+// Names already taken in one module, and the identifiers interned there
+struct UclidSymbolTable::Scope
+{
+    Scope() : used(STRING_HASH), ids() { }
+
+    Set     used ;      // char* UCLID names (owned by _names)
+    Array   ids ;       // VeriIdDef* interned in this scope
+} ;
+
+/*-----------------------------------------------------------------*/
+//                      Constructor / Destructor
+/*-----------------------------------------------------------------*/
+
+UclidSymbolTable::UclidSymbolTable()
+    : _names(256),
+      _symbols(POINTER_HASH),
+      _scopes(STRING_HASH)
+{
+    _names.InsertLast(Strings::save("")) ; // Symbol 0 : none
+}
+
+UclidSymbolTable::~UclidSymbolTable()
+{
+    unsigned i ;
+    char *name ;
+    FOREACH_ARRAY_ITEM(&_names, i, name) Strings::free(name) ;
+
+    MapIter mi ;
+    char *scope_name ;
+    Scope *scope ;
+    FOREACH_MAP_ITEM(&_scopes, mi, &scope_name, &scope) {
+        Strings::free(scope_name) ;
+        delete scope ;
+    }
+}
+
+/*-----------------------------------------------------------------*/
+//                            Symbols
+/*-----------------------------------------------------------------*/
+
+UclidSymbolTable::Scope *UclidSymbolTable::GetScope(const char *scope)
+{
+    if (!scope) scope = "" ;
+    Scope *s = (Scope*)_scopes.GetValue(scope) ;
+    if (s) return s ;
+    s = new Scope ;
+    (void) _scopes.Insert(Strings::save(scope), s) ;
+    return s ;
+}
+
+unsigned UclidSymbolTable::Lookup(const VeriIdDef *id) const
+{
+    return (unsigned)(unsigned long)_symbols.GetValue(id) ;
+}
+
+unsigned UclidSymbolTable::Intern(const VeriIdDef *id, const char *scope, const char *name)
+{
+    if (!id) return 0 ;
+    unsigned symbol = Lookup(id) ;
+    if (symbol) return symbol ;
+
+    symbol = NewSymbol(scope, (name) ? name : id->Name()) ;
+    (void) _symbols.Insert(id, (void*)(unsigned long)symbol) ;
+    GetScope(scope)->ids.InsertLast(id) ;
+    return symbol ;
+}
+
+unsigned UclidSymbolTable::NewSymbol(const char *scope, const char *name)
+{
+    Scope *s = GetScope(scope) ;
+
+    // Mangled names may meet : number the later ones
+    std::string legal = Legalize(name) ;
+    std::string unique = legal ;
+    for (unsigned n = 1; s->used.Get(unique.c_str()); n++) unique = legal + "_" + std::to_string(n) ;
+
+    char *saved = Strings::save(unique.c_str()) ;
+    _names.InsertLast(saved) ;
+    (void) s->used.Insert(saved) ;
+    return _names.Size() - 1 ;
+}
+
+unsigned UclidSymbolTable::IsUsed(const char *scope, const char *name) const
+{
+    Scope *s = (Scope*)_scopes.GetValue((scope) ? scope : "") ;
+    return (s && name && s->used.Get(name)) ? 1 : 0 ;
+}
+
+unsigned UclidSymbolTable::Claim(const char *scope, const char *name)
+{
+    if (!name || IsUsed(scope, name)) return 0 ;
+    char *saved = Strings::save(name) ;
+    _names.InsertLast(saved) ;
+    (void) GetScope(scope)->used.Insert(saved) ;
+    return _names.Size() - 1 ;
+}
+
+void UclidSymbolTable::CloseScope(const char *scope)
+{
+    if (!scope) scope = "" ;
+    MapItem *item = _scopes.GetItem(scope) ;
+    if (!item) return ;
+
+    Scope *s = (Scope*)item->Value() ;
+    char *scope_name = (char*)item->Key() ;
+    unsigned i ;
+    VeriIdDef *id ;
+    FOREACH_ARRAY_ITEM(&s->ids, i, id) (void) _symbols.Remove(id) ;
+
+    (void) _scopes.Remove(scope) ;
+    Strings::free(scope_name) ;
+    delete s ;
+}
+
+// static
+std::string UclidSymbolTable::Legalize(const char *name)
+{
+    if (!name) name = "" ;
+
+    // Escaped identifier : \name followed by white space
+    if (*name == '\\') name++ ;
+    size_t length = strlen(name) ;
+    while (length && isspace((unsigned char)name[length - 1])) length-- ;
+
+    std::string legal ;
+    legal.reserve(length + 1) ;
+    if (!length || isdigit((unsigned char)name[0])) legal += "_" ;
+    for (size_t i = 0; i < length; i++) {
+        char ch = name[i] ;
+        legal += (isalnum((unsigned char)ch) || (ch == '_')) ? ch : '_' ;
+    }
+    if (UclidItem::IsKeyword(legal)) legal = "_" + legal ;
+    return legal ;
+}
+
+/*---------------------------------------------*/
@@ -0,0 +1,87 @@
+/*
+ *
+ * Interned UCLID names for Verilog identifiers.
+ *
+ * Every VeriIdDef that reaches the UCLID output is given a dense symbol
+ * number the first time it is seen. The symbol holds the UCLID name of the
+ * identifier : Verilog names are legalized (escaped identifiers, UCLID
+ * keywords) and made unique within their module, so mangling never makes
+ * two identifiers collide. Names are stored once, and looked up by symbol.
+ *
+*/
+#ifndef _VERIFIC_UCLID_SYMBOL_TABLE_H_
+#define _VERIFIC_UCLID_SYMBOL_TABLE_H_
+
+#include <string>
+
+#include "Array.h"          // Make dynamic array class Array available
+#include "Map.h"            // Make associated hash table class Map available
+
+#ifdef VERIFIC_NAMESPACE
+namespace Verific { // start definitions in verific namespace
+#endif
+
+class VeriIdDef ;
+
+/* -------------------------------------------------------------------------- */
+
+class UclidSymbolTable
+{
+public:
+    UclidSymbolTable() ;
+    ~UclidSymbolTable() ;
+
+    // Symbol of 'id', declared in module 'scope'. Interned on first use, under
+    // 'name' if given, else under the name of 'id'.
+    unsigned Intern(const VeriIdDef *id, const char *scope, const char *name = 0) ;
+
+    // Symbol of 'id' if it is interned, 0 otherwise
+    unsigned Lookup(const VeriIdDef *id) const ;
+
+    // A new symbol in 'scope' that is not bound to an identifier (a signal
+    // of one generate block iteration, say)
+    unsigned NewSymbol(const char *scope, const char *name) ;
+
+    // Is the UCLID name 'name' taken in 'scope'?
+    unsigned IsUsed(const char *scope, const char *name) const ;
+
+    // A new symbol in 'scope' named 'name' as is, for a name made without
+    // NewSymbol (in an instantiated loop body, say). Returns 0 if it is taken.
+    unsigned Claim(const char *scope, const char *name) ;
+
+    // UCLID name of a symbol
+    const char *Name(unsigned symbol) const { return (symbol < _names.Size()) ? (const char*)_names.At(symbol) : "" ; }
+
+    // Number of symbols (symbol 0 is never used)
+    unsigned Size() const { return _names.Size() ; }
+
+    // The identifiers of 'scope' are about to be deleted : forget them.
+    // Their symbols and names stay valid.
+    void CloseScope(const char *scope) ;
+
+    // 'name' as a UCLID identifier : escaped identifiers lose their escape,
+    // other characters are replaced, keywords are prefixed
+    static std::string Legalize(const char *name) ;
+
+private:
+    struct Scope ;
+
+    Scope *GetScope(const char *scope) ;
+
+private:
+    Array   _names ;        // symbol -> char* UCLID name
+    Map     _symbols ;      // VeriIdDef* -> symbol
+    Map     _scopes ;       // char* module name -> Scope*
+
+    // Prevent the compiler from implementing the following
+    UclidSymbolTable(const UclidSymbolTable &node) ;
+    UclidSymbolTable& operator=(const UclidSymbolTable &rhs) ;
+} ;
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef VERIFIC_NAMESPACE
+} // end definitions in verific namespace
+#endif
+
+#endif // #ifndef _VERIFIC_UCLID_SYMBOL_TABLE_H_
@@ -0,0 +1,235 @@
+/*
+ *
+ * The analyze, elaborate and translate flow as a library.
+ *
+*/
+
+#include <sstream>          // istringstream, ostringstream
+
+#include "UclidTranslator.h" // UclidTranslator class definition
+#include "UclidEmitter.h"   // UCLID model emission
+#include "UclidPartitioner.h" // Partitioning by outputs
+#include "Visitor.h"        // PrettyPrintVisitor
+#include "TreeExporter.h"   // Binary parse tree export
+#include "DesignIndex.h"    // Persistent design index
+
+#include "Map.h"            // Make associated hash table class Map available
+#include "Message.h"        // Make message handlers available
+#include "Strings.h"        // A string utility/wrapper class
+#include "VerificStream.h"  // verific_istream
+
+#include "veri_file.h"      // Make Verilog reader available
+#include "VeriModule.h"     // Definition of a VeriModule and VeriPrimitive
+
+#ifdef VERIFIC_NAMESPACE
+using namespace Verific ;
+#endif
+
+UclidTranslator *UclidTranslator::_active = 0 ;
+
+/*-----------------------------------------------------------------*/
+//                      Constructor / Destructor
+/*-----------------------------------------------------------------*/
+
+UclidTranslator::UclidTranslator(const char *work_lib)
+    : _work_lib(Strings::save((work_lib) ? work_lib : "work")),
+      _buffers(STRING_HASH),
+      _prune(1),
+      _prune_report(0),
+      _narrow(1),
+      _narrow_report(0),
+      _canonical(0),
+      _hashes(0),
+      _unroll_limit(0),
+      _inline_limit(0),
+      _inline_report(0),
+      _uf_operators(0),
+      _uf_min_width(0),
+      _uf_lemmas(0),
+      _uf_report(0),
+      _black_boxes(),
+      _black_box_functions(0),
+      _black_box_report(0),
+      _overlap(0),
+      _max_partitions(0),
+      _partition_report(0)
+{
+    _active = this ;
+    veri_file::RegisterFlexStreamCallBack(OpenBuffer) ;
+}
+
+UclidTranslator::~UclidTranslator()
+{
+    if (_active == this) {
+        _active = 0 ;
+        veri_file::RegisterFlexStreamCallBack(0) ;
+    }
+    ClearBuffers() ;
+    Strings::free(_work_lib) ;
+}
+
+/*-----------------------------------------------------------------*/
+//                          Sources
+/*-----------------------------------------------------------------*/
+
+// static
+verific_stream *UclidTranslator::OpenBuffer(const char *file_name)
+{
+    std::string *text = (_active && file_name) ? (std::string*)_active->_buffers.GetValue(file_name) : 0 ;
+    if (!text) return 0 ; // Not in memory : Verific reads the file
+    return new verific_istream(new std::istringstream(*text)) ;
+}
+
+void UclidTranslator::AddBuffer(const char *name, const std::string &text)
+{
+    if (!name) return ;
+    std::string *old_text = (std::string*)_buffers.GetValue(name) ;
+    if (old_text) {
+        *old_text = text ;
+        return ;
+    }
+    (void) _buffers.Insert(Strings::save(name), new std::string(text)) ;
+}
+
+unsigned UclidTranslator::Analyze(const char *name, unsigned vlog_mode)
+{
+    if (!name) return 0 ;
+    _active = this ;
+    return veri_file::Analyze(name, vlog_mode, _work_lib) ;
+}
+
+unsigned UclidTranslator::AnalyzeBuffer(const char *name, const std::string &text, unsigned vlog_mode)
+{
+    AddBuffer(name, text) ;
+    return Analyze(name, vlog_mode) ;
+}
+
+void UclidTranslator::ClearBuffers()
+{
+    MapIter mi ;
+    char *name ;
+    std::string *text ;
+    FOREACH_MAP_ITEM(&_buffers, mi, &name, &text) {
+        Strings::free(name) ;
+        delete text ;
+    }
+    _buffers.Reset() ;
+}
+
+void UclidTranslator::Reset()
+{
+    veri_file::RemoveAllModules(_work_lib) ;
+    ClearBuffers() ;
+}
+
+/*-----------------------------------------------------------------*/
+//                            Output
+/*-----------------------------------------------------------------*/
+
+unsigned UclidTranslator::TranslateUclid(const char *top, std::ostream &os)
+{
+    return Emit(top, os, 0) ;
+}
+
+unsigned UclidTranslator::Emit(const char *top, std::ostream &os, std::vector<UclidModule> *modules)
+{
+    if (!top || !veri_file::GetModule(top, 1, _work_lib)) {
+        Message::Error(0, "top level module not found : ", (top) ? top : "") ;
+        return 0 ;
+    }
+    if (!veri_file::ElaborateStatic(top, _work_lib)) return 0 ;
+    VeriModule *top_module = veri_file::GetModule(top, 1, _work_lib) ;
+    if (!top_module) return 0 ;
+
+    UclidEmitter emitter(os) ;
+    Configure(emitter) ;
+    emitter.SetModules(modules) ;
+    emitter.EmitHierarchy(*top_module) ;
+    return os.good() ? 1 : 0 ;
+}
+
+void UclidTranslator::Configure(UclidEmitter &emitter) const
+{
+    emitter.SetPruning(_prune, _prune_report) ;
+    emitter.SetNarrowing(_narrow, _narrow_report) ;
+    emitter.SetCanonical(_canonical, _hashes) ;
+    emitter.SetUnrollLimit(_unroll_limit) ;
+    emitter.SetInlining(_inline_limit, _inline_report) ;
+    emitter.SetUninterpreted(_uf_operators, _uf_min_width, _uf_lemmas, _uf_report) ;
+    emitter.SetBlackBoxes(_black_boxes, _black_box_functions, _black_box_report) ;
+}
+
+unsigned UclidTranslator::TranslateUclid(const char *top, std::string &model)
+{
+    std::ostringstream os ;
+    unsigned ok = TranslateUclid(top, os) ;
+    model = os.str() ;
+    return ok ;
+}
+
+unsigned UclidTranslator::TranslatePartitions(const char *top, const std::vector<std::string> &targets, const char *dir)
+{
+    // The modules are kept as the emitter built them : nothing goes to the stream
+    std::vector<UclidModule> modules ;
+    std::ostringstream none ;
+    if (!Emit(top, none, &modules)) return 0 ;
+
+    UclidPartitioner partitioner ;
+    if (_overlap) partitioner.SetOverlap(_overlap) ;
+    partitioner.SetMaxPartitions(_max_partitions) ;
+    if (!partitioner.Partition(modules, targets)) return 0 ;
+    return partitioner.Write(dir, _partition_report) ;
+}
+
+unsigned UclidTranslator::ExportTree(const char *top, const char *file_name)
+{
+    if (!top || !veri_file::GetModule(top, 1, _work_lib)) {
+        Message::Error(0, "top level module not found : ", (top) ? top : "") ;
+        return 0 ;
+    }
+    if (!veri_file::ElaborateStatic(top, _work_lib)) return 0 ;
+    VeriModule *top_module = veri_file::GetModule(top, 1, _work_lib) ;
+    if (!top_module) return 0 ;
+
+    TreeExporter exporter ;
+    exporter.AddHierarchy(*top_module) ;
+    return exporter.Write(file_name) ;
+}
+
+unsigned UclidTranslator::WriteIndex(const char *file_name)
+{
+    DesignIndex index ;
+    index.AddLibrary(_work_lib) ;
+    return index.Write(file_name) ;
+}
+
+unsigned UclidTranslator::PrettyPrint(const char *module_name, std::ostream &os)
+{
+    PrettyPrintVisitor printer(os) ;
+    if (module_name) {
+        VeriModule *module = veri_file::GetModule(module_name, 1, _work_lib) ;
+        if (!module) {
+            Message::Error(0, "module not found : ", module_name) ;
+            return 0 ;
+        }
+        module->Accept(printer) ;
+    } else {
+        MapIter mi ;
+        char *name ;
+        VeriModule *module ;
+        FOREACH_MAP_ITEM(veri_file::AllModules(_work_lib), mi, &name, &module) {
+            if (module) module->Accept(printer) ;
+        }
+    }
+    return (printer.IsFileGood() && os.good()) ? 1 : 0 ;
+}
+
+unsigned UclidTranslator::PrettyPrint(const char *module_name, std::string &text)
+{
+    std::ostringstream os ;
+    unsigned ok = PrettyPrint(module_name, os) ;
+    text = os.str() ;
+    return ok ;
+}
+
+/*---------------------------------------------*/
@@ -0,0 +1,153 @@
+/*
+ *
+ * The analyze, elaborate and translate flow as a library.
+ *
+ * UclidTranslator takes Verilog from files or from memory and returns the
+ * pretty-printed design or its UCLID model in a stream or a string, so one
+ * long-lived process can translate many snippets without starting the
+ * command line tool or writing files. Sources in memory are registered
+ * under a file name and read through Verific's stream callback; they can
+ * also be `include-d by name.
+ *
+ * Verific keeps its libraries process-wide, so only one translator should
+ * be in use at a time. Reset() empties the work library between snippets.
+ *
+ *     UclidTranslator translator ;
+ *     std::string model ;
+ *     if (translator.AnalyzeBuffer("snippet.v", text) && translator.TranslateUclid("top", model)) ...
+ *     translator.Reset() ;
+ *
+*/
+#ifndef _VERIFIC_UCLID_TRANSLATOR_H_
+#define _VERIFIC_UCLID_TRANSLATOR_H_
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "Map.h"            // Make associated hash table class Map available
+#include "veri_file.h"      // Verilog analysis modes
+
+#ifdef VERIFIC_NAMESPACE
+namespace Verific { // start definitions in verific namespace
+#endif
+
+class verific_stream ;
+class UclidEmitter ;
+struct UclidModule ;
+
+/* -------------------------------------------------------------------------- */
+
+class UclidTranslator
+{
+public:
+    explicit UclidTranslator(const char *work_lib = "work") ;
+    ~UclidTranslator() ;
+
+    // Make 'text' the contents of file 'name' (replacing earlier text of that name)
+    void AddBuffer(const char *name, const std::string &text) ;
+
+    // Analyze file 'name' into the work library : from memory if it was
+    // added with AddBuffer, from the file system otherwise
+    unsigned Analyze(const char *name, unsigned vlog_mode = veri_file::VERILOG_2K) ;
+
+    // AddBuffer and Analyze in one
+    unsigned AnalyzeBuffer(const char *name, const std::string &text, unsigned vlog_mode = veri_file::VERILOG_2K) ;
+
+    // Elaborate module 'top' and write the UCLID model of its hierarchy
+    unsigned TranslateUclid(const char *top, std::ostream &os) ;
+    unsigned TranslateUclid(const char *top, std::string &model) ;
+
+    // Dead signal elimination in TranslateUclid (on by default), see UclidLiveness
+    void SetPruning(unsigned prune, std::ostream *report = 0) { _prune = prune ; _prune_report = report ; }
+
+    // Narrowing of internal signals in TranslateUclid (on by default), see BitWidthAnalyzer
+    void SetNarrowing(unsigned narrow, std::ostream *report = 0) { _narrow = narrow ; _narrow_report = report ; }
+
+    // Canonical output of TranslateUclid (off by default), with content hashes in 'hashes', see UclidCanonicalizer
+    void SetCanonical(unsigned canonical, std::ostream *hashes = 0) { _canonical = canonical ; _hashes = hashes ; }
+
+    // Unroll budget of procedural loops in TranslateUclid (0 : the default), see UclidStmtVisitor
+    void SetUnrollLimit(unsigned limit) { _unroll_limit = limit ; }
+
+    // Inlining of function calls in TranslateUclid (0 : the default limit), see UclidEmitter::SetInlining
+    void SetInlining(unsigned limit, std::ostream *report = 0) { _inline_limit = limit ; _inline_report = report ; }
+
+    // Arithmetic operators abstracted by TranslateUclid, see UclidEmitter::SetUninterpreted
+    void SetUninterpreted(unsigned operators, unsigned min_width, unsigned lemmas, std::ostream *report = 0) { _uf_operators = operators ; _uf_min_width = min_width ; _uf_lemmas = lemmas ; _uf_report = report ; }
+
+    // Modules emitted as black boxes by TranslateUclid, see UclidEmitter::SetBlackBoxes
+    void SetBlackBoxes(const std::vector<std::string> &patterns, unsigned functions, std::ostream *report = 0) { _black_boxes = patterns ; _black_box_functions = functions ; _black_box_report = report ; }
+
+    // Give 'emitter' the settings above, for callers that drive an emitter themselves
+    void Configure(UclidEmitter &emitter) const ;
+
+    // Elaborate module 'top' and write one model per partition of its outputs
+    // 'targets' (all outputs if empty) into directory 'dir', with a manifest (see UclidPartitioner)
+    unsigned TranslatePartitions(const char *top, const std::vector<std::string> &targets, const char *dir) ;
+
+    // Overlap threshold (percent, 0 : the default) and maximum number (0 : no limit) of partitions
+    void SetPartitioning(unsigned overlap, unsigned max_partitions, std::ostream *report = 0) { _overlap = overlap ; _max_partitions = max_partitions ; _partition_report = report ; }
+
+    // Pretty-print module 'module_name', or every module of the work library if it is 0
+    unsigned PrettyPrint(const char *module_name, std::ostream &os) ;
+    unsigned PrettyPrint(const char *module_name, std::string &text) ;
+
+    // Elaborate module 'top' and write the tree of its hierarchy to 'file_name',
+    // in the binary format of ParseTreeReader.h (see TreeExporter)
+    unsigned ExportTree(const char *top, const char *file_name) ;
+
+    // Write the design index (see DesignIndex) of the work library as it is now
+    unsigned WriteIndex(const char *file_name) ;
+
+    // Remove all modules from the work library and forget the buffers
+    void Reset() ;
+
+    const char *WorkLib() const { return _work_lib ; }
+
+private:
+    // Elaborate module 'top' and emit its hierarchy to 'os', or into 'modules' if given (see UclidEmitter::SetModules)
+    unsigned Emit(const char *top, std::ostream &os, std::vector<UclidModule> *modules) ;
+
+    // Verific's stream callback : the buffer of 'file_name', if there is one
+    static verific_stream *OpenBuffer(const char *file_name) ;
+
+    void ClearBuffers() ;
+
+private:
+    char    *_work_lib ;
+    Map      _buffers ;     // char* file name -> std::string* contents
+    unsigned _prune ;
+    std::ostream *_prune_report ; // Lists what was pruned
+    unsigned _narrow ;
+    std::ostream *_narrow_report ; // Lists what was narrowed
+    unsigned _canonical ;
+    std::ostream *_hashes ;     // Sidecar of content hashes
+    unsigned _unroll_limit ;
+    unsigned _inline_limit ;
+    std::ostream *_inline_report ; // Lists the calls of each function
+    unsigned _uf_operators ;
+    unsigned _uf_min_width ;
+    unsigned _uf_lemmas ;
+    std::ostream *_uf_report ; // Lists the applications of each function
+    std::vector<std::string> _black_boxes ; // Module name patterns
+    unsigned _black_box_functions ;
+    std::ostream *_black_box_report ; // Lists what black boxes leave out
+    unsigned _overlap ;
+    unsigned _max_partitions ;
+    std::ostream *_partition_report ; // Lists the partitions
+
+    static UclidTranslator *_active ;   // Translator OpenBuffer reads from
+
+    // Prevent the compiler from implementing the following
+    UclidTranslator(const UclidTranslator &node) ;
+    UclidTranslator& operator=(const UclidTranslator &rhs) ;
+} ;
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef VERIFIC_NAMESPACE
+} // end definitions in verific namespace
+#endif
+
+#endif // #ifndef _VERIFIC_UCLID_TRANSLATOR_H_
@@ -0,0 +1,1313 @@
+/*
+ *
+ * Translation of Verilog expressions into UCLID5 terms.
+ *
+*/
+
+#include <algorithm>        // std::find
+#include <cstring>          // strcmp ...
+#include <vector>
+
+#include "UclidVisitor.h"   // UclidVisitor class definition
+#include "ExpressionWalker.h" // Associative operator chains
+#include "UclidSymbolTable.h" // UCLID names of identifiers
+#include "UclidStmtVisitor.h" // Function bodies
+#include "UclidModel.h"     // Items of defines and declarations
+
+#include "Array.h"          // Make dynamic array class Array available
+#include "Map.h"            // Make associated hash table class Map available
+#include "Set.h"            // Make associated hash table class Set available
+#include "Strings.h"        // A string utility/wrapper class
+
+#include "VeriId.h"         // Definitions of all identifier definition tree nodes
+#include "VeriExpression.h" // Definitions of all verilog expression tree nodes
+#include "VeriModuleItem.h" // Definitions of all verilog module item tree nodes
+#include "VeriStatement.h"  // Definitions of all verilog statement tree nodes
+#include "VeriMisc.h"       // Definitions of all extraneous verilog tree nodes (ie. range, path, strength, etc...)
+#include "VeriConstVal.h"   // Definitions of parse-tree nodes representing constant values in Verilog.
+#include "veri_tokens.h"
+
+#ifdef VERIFIC_NAMESPACE
+using namespace Verific ;
+#endif
+
+#define GET_BIT(S,B) ((S)?(((S)[(B)/8]>>(B)%8)&1):0)
+
+// Functions whose value is at most this long are inlined at their calls
+#define FUNCTION_INLINE_LIMIT 64
+
+// How the calls of a function are translated
+#define FUNCTION_NEW        0   // Not called yet
+#define FUNCTION_DEFINED    1   // Calls of its define
+#define FUNCTION_INLINED    2   // Its value, with the arguments in place of its ports
+#define FUNCTION_FAILED     3   // Its body can not be translated
+
+/*-----------------------------------------------------------------*/
+//                          Utility Methods
+/*-----------------------------------------------------------------*/
+
+static std::string Num(unsigned long long n) { return std::to_string(n) ; }
+
+// Number of bits needed to hold 'value'
+static unsigned MinBits(unsigned long long value)
+{
+    unsigned n = 1 ;
+    while (value >>= 1) n++ ;
+    return n ;
+}
+
+// Width an operand contributes to its operator. Unsized literals adapt to
+// the other operand instead of forcing everything to 32 bits.
+static unsigned OperandWidth(const UclidTerm &term)
+{
+    if (term.is_bool) return 1 ;
+    if (term.is_literal) return MinBits(term.value) ;
+    return term.width ;
+}
+
+static unsigned Max(unsigned a, unsigned b) { return (a > b) ? a : b ; }
+
+// UCLID spelling of a context-determined binary operator (0 if not one)
+static const char *ArithOperator(unsigned oper)
+{
+    switch (oper) {
+    case VERI_PLUS :    return "+" ;
+    case VERI_MIN :     return "-" ;
+    case VERI_MUL :     return "*" ;
+    case VERI_DIV :     return "/" ;
+    case VERI_MODULUS : return "%" ;
+    case VERI_REDAND :  return "&" ;
+    case VERI_REDOR :   return "|" ;
+    case VERI_REDXOR :  return "^" ;
+    default :           return 0 ;
+    }
+}
+
+// UCLID spelling of a (unsigned) relational operator (0 if not one)
+static const char *CompareOperator(unsigned oper)
+{
+    switch (oper) {
+    case VERI_LOGEQ :
+    case VERI_CASEEQ :  return "==" ;
+    case VERI_LOGNEQ :
+    case VERI_CASENEQ : return "!=" ;
+    case VERI_LT :      return "<_u" ;
+    case VERI_LEQ :     return "<=_u" ;
+    case VERI_GT :      return ">_u" ;
+    case VERI_GEQ :     return ">=_u" ;
+    default :           return 0 ;
+    }
+}
+
+// Fold a binary operator over constants. Returns 0 if the operator can't be folded.
+static unsigned FoldBinary(unsigned oper, long long l, long long r, long long &result)
+{
+    switch (oper) {
+    case VERI_PLUS :      result = l + r ; break ;
+    case VERI_MIN :       result = l - r ; break ;
+    case VERI_MUL :       result = l * r ; break ;
+    case VERI_DIV :       if (!r) return 0 ; result = l / r ; break ;
+    case VERI_MODULUS :   if (!r) return 0 ; result = l % r ; break ;
+    case VERI_REDAND :    result = l & r ; break ;
+    case VERI_REDOR :     result = l | r ; break ;
+    case VERI_REDXOR :    result = l ^ r ; break ;
+    case VERI_LSHIFT :
+    case VERI_ARITLSHIFT : result = (r >= 0 && r < 64) ? (long long)((unsigned long long)l << r) : 0 ; break ;
+    case VERI_RSHIFT :    result = (r >= 0 && r < 64) ? (long long)((unsigned long long)l >> r) : 0 ; break ;
+    case VERI_ARITRSHIFT : result = (r >= 0 && r < 64) ? (l >> r) : ((l < 0) ? -1 : 0) ; break ;
+    case VERI_LOGAND :    result = (l && r) ; break ;
+    case VERI_LOGOR :     result = (l || r) ; break ;
+    case VERI_LOGEQ :
+    case VERI_CASEEQ :    result = (l == r) ; break ;
+    case VERI_LOGNEQ :
+    case VERI_CASENEQ :   result = (l != r) ; break ;
+    case VERI_LT :        result = (l < r) ; break ;
+    case VERI_LEQ :       result = (l <= r) ; break ;
+    case VERI_GT :        result = (l > r) ; break ;
+    case VERI_GEQ :       result = (l >= r) ; break ;
+    case VERI_POWER :
+    {
+        if (r < 0) return 0 ;
+        result = 1 ;
+        for (long long i = 0; i < r; i++) result *= l ;
+        break ;
+    }
+    default : return 0 ;
+    }
+    return 1 ;
+}
+
+/*-----------------------------------------------------------------*/
+//                            Functions
+/*-----------------------------------------------------------------*/
+
+struct UclidVisitor::Function
+{
+    Function() : id(0), decl(0), formals(), locals(), ports(), port_names(), self_contained(1), strategy(FUNCTION_NEW), busy(0), defined_calls(0), inlined_calls(0) { }
+
+    const VeriIdDef                 *id ;
+    VeriFunctionDecl                *decl ;
+    std::vector<const VeriIdDef*>    formals ;  // Input ports, in order
+    std::vector<const VeriIdDef*>    locals ;   // The other variables it declares
+    std::string                      ports ;    // "a : bv8, b : bv8" : the arguments of its define
+    std::string                      port_names ; // "a, b"
+    unsigned                         self_contained ; // Refers to nothing but its ports, locals, constants and such functions
+    unsigned                         strategy ; // FUNCTION_*
+    unsigned                         busy ;     // Its body is being translated
+    unsigned long                    defined_calls ;
+    unsigned long                    inlined_calls ;
+} ;
+
+// Identifiers a function body refers to, other than its own
+class FunctionReferences : public VeriVisitor
+{
+public:
+    explicit FunctionReferences(const Set &own) : _own(own), _external(0), _callees() { }
+    virtual ~FunctionReferences() { }
+
+    unsigned External() const           { return _external ; }
+    const Array &Callees() const        { return _callees ; }   // VeriIdDef* of the functions it calls
+
+    virtual void VERI_VISIT(VeriIdRef, node)
+    {
+        VeriIdDef *id = node.GetId() ;
+        if (!id || _own.Get(id) || id->IsParam() || id->IsGenVar()) return ;
+        _external = 1 ;
+    }
+
+    virtual void VERI_VISIT(VeriFunctionCall, node)
+    {
+        VeriIdDef *id = (node.GetFunctionName()) ? node.GetFunctionName()->GetId() : 0 ;
+        if (id) _callees.InsertLast(id) ;
+        unsigned i ;
+        VeriExpression *arg ;
+        FOREACH_ARRAY_ITEM(node.GetArgs(), i, arg) {
+            if (arg) arg->Accept(*this) ;
+        }
+    }
+
+private:
+    const Set   &_own ;
+    unsigned     _external ;
+    Array        _callees ;
+} ;
+
+UclidVisitor::Function *UclidVisitor::GetFunction(const VeriIdDef *function_id)
+{
+    if (!function_id) return 0 ;
+    Function *function = (Function*)_functions.GetValue(function_id) ;
+    if (function) return function ;
+    VeriModuleItem *item = function_id->GetModuleItem() ;
+    if (!item || (item->GetClassId() != ID_VERIFUNCTIONDECL)) return 0 ;
+
+    function = new Function ;
+    function->id = function_id ;
+    function->decl = static_cast<VeriFunctionDecl*>(item) ;
+    (void) _functions.Insert(function_id, function) ;
+    _function_order.InsertLast(function) ;
+
+    Set own(POINTER_HASH) ;
+    (void) own.Insert(function_id) ;
+    unsigned i, j ;
+    VeriIdDef *id ;
+    FOREACH_ARRAY_ITEM(function->decl->GetPorts(), i, id) {
+        if (!id) continue ;
+        // Functions only take inputs
+        if (!id->IsInput()) function->strategy = FUNCTION_FAILED ;
+        function->formals.push_back(id) ;
+        (void) own.Insert(id) ;
+        if (i) {
+            function->ports += ", " ;
+            function->port_names += ", " ;
+        }
+        function->ports = function->ports + NameOf(id) + " : bv" + Num(IdWidth(id)) ;
+        function->port_names += NameOf(id) ;
+    }
+    VeriModuleItem *decl ;
+    FOREACH_ARRAY_ITEM(function->decl->GetDeclarations(), i, decl) {
+        FOREACH_ARRAY_ITEM((decl) ? decl->GetIds() : 0, j, id) {
+            if (!id || !own.Insert(id)) continue ;
+            function->locals.push_back(id) ;
+        }
+    }
+
+    FunctionReferences references(own) ;
+    VeriStatement *stmt ;
+    FOREACH_ARRAY_ITEM(function->decl->GetStatements(), i, stmt) {
+        if (stmt) stmt->Accept(references) ;
+    }
+    function->self_contained = !references.External() ;
+    FOREACH_ARRAY_ITEM(&references.Callees(), i, id) {
+        Function *callee = GetFunction(id) ;
+        if (!callee || !callee->self_contained) function->self_contained = 0 ;
+    }
+    return function ;
+}
+
+unsigned UclidVisitor::EvaluateFunction(Function &function, const std::vector<std::string> *actuals, std::string &value, UclidItems *shared)
+{
+    // Locals, and the result, hold zero until they are assigned (X in Verilog)
+    UclidStmtVisitor::Values values ;
+    values[function.id] = Literal(0, IdWidth(function.id)).text ;
+    size_t i ;
+    for (i = 0; i < function.locals.size(); i++) {
+        if (!IsInteger(function.locals[i])) values[function.locals[i]] = Literal(0, IdWidth(function.locals[i])).text ;
+    }
+    UclidStmtVisitor::Values::const_iterator vi ;
+    for (vi = values.begin(); vi != values.end(); vi++) SetValue(vi->first, vi->second) ;
+    for (i = 0; actuals && (i < function.formals.size()); i++) SetValue(function.formals[i], (*actuals)[i]) ;
+
+    UclidStmtVisitor statements(*this) ;
+    statements.SetSharedArguments(function.ports, function.port_names) ;
+
+    function.busy = 1 ;
+    unsigned ok = statements.Evaluate(function.decl->GetStatements(), values, shared) ;
+    function.busy = 0 ;
+
+    // Only its own variables may be assigned : the rest would be a side effect
+    for (vi = values.begin(); vi != values.end(); vi++) {
+        if ((vi->first != function.id) &&
+            (std::find(function.locals.begin(), function.locals.end(), vi->first) == function.locals.end()) &&
+            (std::find(function.formals.begin(), function.formals.end(), vi->first) == function.formals.end())) ok = 0 ;
+        ClearValue(vi->first) ;
+    }
+    for (i = 0; i < function.formals.size(); i++) ClearValue(function.formals[i]) ;
+
+    vi = values.find(function.id) ;
+    if (!ok || (vi == values.end())) return 0 ;
+    value = vi->second ;
+    return 1 ;
+}
+
+std::string UclidVisitor::FunctionReport(const char *module) const
+{
+    std::string report = "" ;
+    unsigned i ;
+    Function *function ;
+    FOREACH_ARRAY_ITEM(&_function_order, i, function) {
+        report = report + "-- function " + ((module) ? module : "") + " " + function->id->Name() + " : " ;
+        switch (function->strategy) {
+        case FUNCTION_DEFINED : report += "defined" ; break ;
+        case FUNCTION_INLINED : report += "inlined" ; break ;
+        case FUNCTION_FAILED :  report += "not translated" ; break ;
+        default :               report += "not called" ; break ;
+        }
+        report = report + ", " + Num(function->defined_calls) + " calls to its define, " + Num(function->inlined_calls) + " inlined\n" ;
+    }
+    return report ;
+}
+
+/*-----------------------------------------------------------------*/
+//                     Uninterpreted functions
+/*-----------------------------------------------------------------*/
+
+const char *UclidVisitor::Uninterpreted(unsigned oper, unsigned width)
+{
+    const char *kind = 0 ;
+    unsigned flag = 0 ;
+    switch (oper) {
+    case VERI_MUL :     kind = "mul" ; flag = UCLID_UF_MUL ; break ;
+    case VERI_DIV :     kind = "div" ; flag = UCLID_UF_DIV ; break ;
+    case VERI_MODULUS : kind = "mod" ; flag = UCLID_UF_MOD ; break ;
+    default :           return 0 ;
+    }
+    if (!(_uf_operators & flag) || (width < _uf_min_width)) return 0 ;
+
+    std::string key = std::string(kind) + "_" + Num(width) ;
+    std::map<std::string, std::pair<std::string, unsigned long> >::iterator it = _uf_functions.find(key) ;
+    if (it == _uf_functions.end()) {
+        // One function per operator and width, shared by all its applications in the module
+        std::string name = NewName(("uf_" + key).c_str()) ;
+        std::string bv = "bv" + Num(width) ;
+        std::string zero = "0" + bv, one = "1" + bv ;
+        std::string x1 = name + "(x, " + one + ")" ;
+        std::vector<std::string> axioms ;
+        if (_uf_lemmas) {
+            switch (oper) {
+            case VERI_MUL :
+                axioms.push_back("forall (x : " + bv + ", y : " + bv + ") :: " + name + "(x, y) == " + name + "(y, x)") ;
+                axioms.push_back("forall (x : " + bv + ") :: " + name + "(x, " + zero + ") == " + zero) ;
+                axioms.push_back("forall (x : " + bv + ") :: " + x1 + " == x") ;
+                break ;
+            case VERI_DIV :
+                axioms.push_back("forall (x : " + bv + ") :: " + x1 + " == x") ;
+                break ;
+            default :
+                axioms.push_back("forall (x : " + bv + ") :: " + x1 + " == " + zero) ;
+                break ;
+            }
+        }
+        _uf_decls.push_back(UclidItem(UclidItem::ITEM_FUNCTION, name, "function " + name + "(x : " + bv + ", y : " + bv + ") : " + bv + " ;\n")) ;
+        for (size_t a = 0; a < axioms.size(); a++) {
+            UclidItem axiom(UclidItem::ITEM_AXIOM, "", "axiom " + axioms[a] + " ;\n") ;
+            UclidItem::Names(axioms[a], axiom.uses) ;
+            _uf_decls.push_back(axiom) ;
+        }
+        it = _uf_functions.insert(std::make_pair(key, std::make_pair(name, 0UL))).first ;
+        _uf_order.push_back(key) ;
+    }
+    it->second.second++ ;
+    return it->second.first.c_str() ;
+}
+
+std::string UclidVisitor::UninterpretedReport(const char *module) const
+{
+    std::string report = "" ;
+    for (size_t i = 0; i < _uf_order.size(); i++) {
+        std::map<std::string, std::pair<std::string, unsigned long> >::const_iterator it = _uf_functions.find(_uf_order[i]) ;
+        report = report + "-- uninterpreted " + ((module) ? module : "") + " " + it->second.first + " : " + Num(it->second.second) + " applications\n" ;
+    }
+    return report ;
+}
+
+/*-----------------------------------------------------------------*/
+//                     Constant expression evaluation
+/*-----------------------------------------------------------------*/
+
+// Evaluates literals, parameters, genvars and operators over them. Anything
+// else (or any x/z bit) makes the expression non-constant. Values that depend
+// on a template genvar are tracked, to detect non-affine uses of the loop index.
+class ConstEvaluator : public VeriVisitor
+{
+public:
+    // Genvars and loop variables are those 'visitor' binds, if given
+    explicit ConstEvaluator(const UclidVisitor *visitor) : _visitor(visitor), _value(0), _genvar(0), _node(0) { }
+    virtual ~ConstEvaluator() { }
+
+    unsigned Evaluate(const VeriExpression *expr, long long &value)
+    {
+        unsigned genvar ;
+        return Evaluate(expr, value, genvar) ;
+    }
+
+    unsigned Evaluate(const VeriExpression *expr, long long &value, unsigned &genvar)
+    {
+        if (!expr) return 0 ;
+        _node = 0 ;
+        _genvar = 0 ;
+        const_cast<VeriExpression*>(expr)->Accept(*this) ;
+        if (_node != expr) return 0 ; // Not handled below, or not constant
+        value = _value ;
+        genvar = _genvar ;
+        return 1 ;
+    }
+
+    virtual void VERI_VISIT(VeriIntVal, node)
+    {
+        _value = node.GetNum() ;
+        _node = &node ;
+    }
+
+    virtual void VERI_VISIT(VeriConstVal, node)
+    {
+        unsigned size = node.Size(0) ;
+        if (size > 64) return ;
+        unsigned long long value = 0 ;
+        unsigned i = size ;
+        while (i-- != 0) {
+            if (GET_BIT(node.GetXValue(),i) || GET_BIT(node.GetZValue(),i)) return ;
+            value = (value << 1) | (unsigned long long)GET_BIT(node.GetValue(),i) ;
+        }
+        _value = (long long)value ;
+        _node = &node ;
+    }
+
+    virtual void VERI_VISIT(VeriIdRef, node)
+    {
+        VeriIdDef *id = node.GetId() ;
+        if (!id) return ;
+        long long value ;
+        unsigned genvar = 0 ;
+        if (_visitor && _visitor->GenvarValue(id, value)) {
+            // Genvar, or the variable of a procedural loop being unrolled
+            genvar = _visitor->IsTemplateGenvar(id) ;
+        } else if (id->IsGenVar() || !id->IsParam() || !Evaluate(id->GetInitialValue(), value, genvar)) {
+            return ;
+        }
+        _value = value ;
+        _genvar = genvar ;
+        _node = &node ;
+    }
+
+    virtual void VERI_VISIT(VeriUnaryOperator, node)
+    {
+        long long arg ;
+        unsigned genvar ;
+        if (!Evaluate(node.GetArg(), arg, genvar)) return ;
+        switch (node.OperType()) {
+        case VERI_PLUS :    _value = arg ; break ;
+        case VERI_MIN :     _value = -arg ; break ;
+        case VERI_REDNOT :  _value = ~arg ; if (genvar) _visitor->SetNonAffine(1) ; break ;
+        case VERI_LOGNOT :  _value = !arg ; if (genvar) _visitor->SetNonAffine(1) ; break ;
+        default :           return ;
+        }
+        _genvar = genvar ;
+        _node = &node ;
+    }
+
+    virtual void VERI_VISIT(VeriBinaryOperator, node)
+    {
+        long long l, r ;
+        unsigned lg, rg ;
+        if (!Evaluate(node.GetLeft(), l, lg) || !Evaluate(node.GetRight(), r, rg)) return ;
+        if (!FoldBinary(node.OperType(), l, r, _value)) return ;
+        // Sums, differences and scaling keep the value affine in the loop index
+        unsigned oper = node.OperType() ;
+        if ((lg || rg) && !((oper == VERI_PLUS) || (oper == VERI_MIN) || ((oper == VERI_MUL) && !(lg && rg)))) _visitor->SetNonAffine(1) ;
+        _genvar = lg || rg ;
+        _node = &node ;
+    }
+
+    virtual void VERI_VISIT(VeriQuestionColon, node)
+    {
+        long long c, value ;
+        unsigned cg, genvar ;
+        if (!Evaluate(node.GetIfExpr(), c, cg)) return ;
+        if (cg) _visitor->SetNonAffine(1) ;
+        if (!Evaluate(c ? node.GetThenExpr() : node.GetElseExpr(), value, genvar)) return ;
+        _value = value ;
+        _genvar = genvar ;
+        _node = &node ;
+    }
+
+private:
+    const UclidVisitor      *_visitor ; // Binds the genvars, 0 if none are
+    long long                _value ;   // Value of '_node'
+    unsigned                 _genvar ;  // '_value' depends on a template genvar (only with '_visitor')
+    const VeriExpression    *_node ;    // Expression '_value' belongs to
+} ;
+
+/*-----------------------------------------------------------------*/
+//                      Constructor / Destructor
+/*-----------------------------------------------------------------*/
+
+UclidVisitor::UclidVisitor(UclidSymbolTable &symbols, const char *scope)
+    : _term(),
+      _context(0),
+      _node(0),
+      _symbols(symbols),
+      _scope((scope) ? scope : ""),
+      _names(POINTER_HASH),
+      _values(POINTER_HASH),
+      _widths(POINTER_HASH),
+      _functions(POINTER_HASH),
+      _function_order(),
+      _function_defines(),
+      _inline_limit(FUNCTION_INLINE_LIMIT),
+      _uf_operators(0),
+      _uf_min_width(0),
+      _uf_lemmas(0),
+      _uf_functions(),
+      _uf_order(),
+      _uf_decls(),
+      _genvars(POINTER_HASH),
+      _template_genvars(POINTER_HASH),
+      _non_affine(0)
+{
+}
+
+UclidVisitor::~UclidVisitor()
+{
+    MapIter mi ;
+    std::string *value ;
+    FOREACH_MAP_ITEM(&_values, mi, 0, &value) delete value ;
+    unsigned i ;
+    Function *function ;
+    FOREACH_ARRAY_ITEM(&_function_order, i, function) delete function ;
+}
+
+/*-----------------------------------------------------------------*/
+//                              Names
+/*-----------------------------------------------------------------*/
+
+void UclidVisitor::SetName(const VeriIdDef *id, const char *name)
+{
+    unsigned symbol = _symbols.NewSymbol(_scope.c_str(), name) ;
+    (void) _names.Insert(id, (void*)(unsigned long)symbol, 1 /* force overwrite */) ;
+}
+
+void UclidVisitor::ClearName(const VeriIdDef *id)
+{
+    (void) _names.Remove(id) ;
+}
+
+const char *UclidVisitor::NewName(const char *name)
+{
+    return _symbols.Name(_symbols.NewSymbol(_scope.c_str(), name)) ;
+}
+
+unsigned UclidVisitor::ClaimNames(const std::vector<std::string> &names)
+{
+    for (size_t i = 0; i < names.size(); i++) {
+        if (_symbols.IsUsed(_scope.c_str(), names[i].c_str())) return 0 ;
+    }
+    for (size_t i = 0; i < names.size(); i++) {
+        if (!_symbols.Claim(_scope.c_str(), names[i].c_str())) return 0 ; // Twice in 'names'
+    }
+    return 1 ;
+}
+
+void UclidVisitor::SetValue(const VeriIdDef *id, const std::string &value)
+{
+    ClearValue(id) ;
+    (void) _values.Insert(id, new std::string(value)) ;
+}
+
+void UclidVisitor::ClearValue(const VeriIdDef *id)
+{
+    std::string *value = (std::string*)_values.GetValue(id) ;
+    if (!value) return ;
+    (void) _values.Remove(id) ;
+    delete value ;
+}
+
+void UclidVisitor::BindGenvar(const VeriIdDef *genvar, long long value, unsigned template_index)
+{
+    (void) _genvars.Insert(genvar, (void*)(long)value, 1 /* force overwrite */) ;
+    if (template_index) (void) _template_genvars.Insert(genvar) ;
+    else (void) _template_genvars.Remove(genvar) ;
+}
+
+void UclidVisitor::UnbindGenvar(const VeriIdDef *genvar)
+{
+    (void) _genvars.Remove(genvar) ;
+    (void) _template_genvars.Remove(genvar) ;
+}
+
+unsigned UclidVisitor::GenvarValue(const VeriIdDef *genvar, long long &value) const
+{
+    MapItem *item = _genvars.GetItem(genvar) ;
+    if (!item) return 0 ;
+    value = (long long)(long)item->Value() ;
+    return 1 ;
+}
+
+unsigned UclidVisitor::IsTemplateGenvar(const VeriIdDef *genvar) const
+{
+    return (_template_genvars.Get(genvar)) ? 1 : 0 ;
+}
+
+void UclidVisitor::SetModelWidth(const VeriIdDef *id, unsigned width)
+{
+    (void) _widths.Insert(id, (void*)(unsigned long)width, 1 /* force overwrite */) ;
+}
+
+unsigned UclidVisitor::ModelWidth(const VeriIdDef *id) const
+{
+    unsigned width = (unsigned)(unsigned long)_widths.GetValue(id) ;
+    return (width) ? width : IdWidth(id) ;
+}
+
+const char *UclidVisitor::NameOf(const VeriIdDef *id) const
+{
+    if (!id) return "" ;
+    unsigned symbol = (unsigned)(unsigned long)_names.GetValue(id) ;
+    if (!symbol) symbol = _symbols.Intern(id, _scope.c_str()) ;
+    return _symbols.Name(symbol) ;
+}
+
+/*-----------------------------------------------------------------*/
+//                          Term Utilities
+/*-----------------------------------------------------------------*/
+
+// static
+UclidTerm UclidVisitor::Literal(unsigned long long value, unsigned width)
+{
+    UclidTerm term ;
+    term.width = (width) ? width : 1 ;
+    term.is_literal = 1 ;
+    term.value = (term.width >= 64) ? value : (value & ((1ULL << term.width) - 1)) ;
+    term.text = Num(term.value) + "bv" + Num(term.width) ;
+    return term ;
+}
+
+// static
+std::string UclidVisitor::AsBv(const UclidTerm &term, unsigned width)
+{
+    if (!width) width = 1 ;
+    if (term.is_bool) return "(if (" + term.text + ") then 1bv" + Num(width) + " else 0bv" + Num(width) + ")" ;
+    if (term.is_literal) return Literal(term.value, width).text ;
+    if (term.width == width) return term.text ;
+    if (term.width < width) return "bv_zero_extend(" + Num(width - term.width) + ", " + term.text + ")" ;
+    return "(" + term.text + ")[" + Num(width - 1) + ":0]" ;
+}
+
+// static
+std::string UclidVisitor::AsBool(const UclidTerm &term)
+{
+    if (term.is_bool) return term.text ;
+    if (term.is_literal) return (term.value) ? "true" : "false" ;
+    return "(" + term.text + " != 0bv" + Num(term.width) + ")" ;
+}
+
+// static
+unsigned UclidVisitor::PackedRange(const VeriIdDef *id, int &msb, int &lsb)
+{
+    if (!id) return 0 ;
+    if (id->IsMemory()) {
+        // The range of an element : the packed dimension of the data type
+        VeriDataType *data_type = id->GetDataType() ;
+        VeriRange *range = (data_type) ? data_type->GetDimensions() : 0 ;
+        long long left, right ;
+        if (!range || !EvalConst(range->GetLeft(), left) || !EvalConst(range->GetRight(), right)) return 0 ;
+        msb = (int)left ;
+        lsb = (int)right ;
+        return 1 ;
+    }
+    if (!id->IsArray()) return 0 ;
+    msb = id->GetMsbOfRange() ;
+    lsb = id->GetLsbOfRange() ;
+    return 1 ;
+}
+
+// static
+unsigned UclidVisitor::IsInteger(const VeriIdDef *id)
+{
+    return (id && id->GetDataType() && (id->GetDataType()->GetType() == VERI_INTEGER)) ? 1 : 0 ;
+}
+
+// static
+unsigned UclidVisitor::IdWidth(const VeriIdDef *id)
+{
+    if (!id) return 1 ;
+    if (id->IsParam()) return 32 ;
+    if (IsInteger(id)) return 32 ;
+    int msb, lsb ;
+    if (!PackedRange(id, msb, lsb)) return 1 ;
+    return (unsigned)((msb > lsb) ? (msb - lsb) : (lsb - msb)) + 1 ;
+}
+
+// static
+long long UclidVisitor::BitPosition(const VeriIdDef *id, long long index)
+{
+    int msb, lsb ;
+    if (!PackedRange(id, msb, lsb)) return index ;
+    return (msb >= lsb) ? (index - lsb) : (lsb - index) ;
+}
+
+// static
+unsigned UclidVisitor::AddressWidth(const VeriIdDef *memory, long long &lowest)
+{
+    // One unpacked dimension only : that maps onto a single UCLID array
+    VeriRange *range = (memory && memory->IsMemory()) ? memory->GetDimensions() : 0 ;
+    if (!range || range->GetNext()) return 0 ;
+    long long left, right ;
+    if (!EvalConst(range->GetLeft(), left) || !EvalConst(range->GetRight(), right)) return 0 ;
+    lowest = (left < right) ? left : right ;
+    unsigned long long depth = (unsigned long long)(((left < right) ? right : left) - lowest) + 1 ;
+    return MinBits(depth - 1) ;
+}
+
+// static
+unsigned UclidVisitor::EvalConst(const VeriExpression *expr, long long &value, const UclidVisitor *visitor)
+{
+    ConstEvaluator evaluator(visitor) ;
+    return evaluator.Evaluate(expr, value) ;
+}
+
+UclidTerm UclidVisitor::Translate(VeriExpression *expr, unsigned context_width)
+{
+    unsigned saved_context = _context ;
+    _context = context_width ;
+    _node = 0 ;
+    if (expr) expr->Accept(*this) ;
+    if (expr && (_node != expr)) Unsupported(*expr, "expression") ;
+    UclidTerm result = _term ;
+    _context = saved_context ;
+    return result ;
+}
+
+void UclidVisitor::Unsupported(const VeriTreeNode &node, const char *what)
+{
+    node.Warning("%s is not translated to UCLID, using zero", what) ;
+    _term = Literal(0, (_context) ? _context : 1) ;
+    _node = &node ;
+}
+
+/*-----------------------------------------------------------------*/
+//        Visit Methods : Class details in VeriExpression.h
+/*-----------------------------------------------------------------*/
+
+void UclidVisitor::VERI_VISIT(VeriExpression, node)
+{
+    Unsupported(node, "expression") ;
+}
+
+void UclidVisitor::VERI_VISIT(VeriIdRef, node)
+{
+    VeriIdDef *id = node.GetId() ;
+
+    // Elaborated parameters are constants : use their value
+    if (id && id->IsParam() && id->GetInitialValue()) {
+        long long value ;
+        if (EvalConst(id->GetInitialValue(), value, this)) {
+            _term = Literal((unsigned long long)value, IdWidth(id)) ;
+            if (!id->IsArray()) _term.width = 32 ;
+        } else {
+            _term = Translate(id->GetInitialValue(), _context) ;
+        }
+        _node = &node ;
+        return ;
+    }
+
+    // Generate or procedural loop index : the value of the iteration being translated
+    long long index ;
+    if (id && GenvarValue(id, index)) {
+        _term = Literal((unsigned long long)index, (id->IsGenVar()) ? 32 : ModelWidth(id)) ;
+        _node = &node ;
+        return ;
+    }
+    if (id && id->IsGenVar()) {
+        Unsupported(node, "genvar outside its generate loop") ;
+        return ;
+    }
+
+    UclidTerm term ;
+    const std::string *value = (id) ? (const std::string*)_values.GetValue(id) : 0 ;
+    term.text = (value) ? *value : (id) ? std::string(NameOf(id)) : UclidSymbolTable::Legalize(node.GetName()) ;
+    term.width = ModelWidth(id) ;
+    _term = term ;
+    _node = &node ;
+}
+
+// static
+unsigned UclidVisitor::TargetBits(VeriExpression *lval, VeriIdDef *&id, unsigned &lo, unsigned &hi, const UclidVisitor *visitor)
+{
+    if (!lval) return 0 ;
+    id = lval->GetId() ;
+    if (!id || id->IsMemory()) return 0 ;
+
+    if (lval->GetClassId() == ID_VERIIDREF) {
+        lo = 0 ;
+        hi = IdWidth(id) - 1 ;
+        return 1 ;
+    }
+    if (lval->GetClassId() != ID_VERIINDEXEDID) return 0 ;
+
+    VeriExpression *index = lval->GetIndexExpr() ;
+    long long left, right ;
+    if (!index) return 0 ;
+    if (index->IsRange()) {
+        VeriRange *range = static_cast<VeriRange*>(index) ;
+        if (!EvalConst(range->GetLeft(), left, visitor) || !EvalConst(range->GetRight(), right, visitor)) return 0 ;
+        if (range->GetPartSelectToken() == VERI_PARTSELECT_UP) right = left + right - 1 ;
+        if (range->GetPartSelectToken() == VERI_PARTSELECT_DOWN) right = left - right + 1 ;
+    } else {
+        if (!EvalConst(index, left, visitor)) return 0 ;
+        right = left ;
+    }
+    long long l = BitPosition(id, left) ;
+    long long r = BitPosition(id, right) ;
+    if ((l < 0) || (r < 0)) return 0 ;
+    lo = (unsigned)((l < r) ? l : r) ;
+    hi = (unsigned)((l < r) ? r : l) ;
+    return 1 ;
+}
+
+unsigned UclidVisitor::TranslateAddress(const VeriIdDef *memory, VeriExpression *index, std::string &address)
+{
+    long long lowest = 0 ;
+    unsigned width = AddressWidth(memory, lowest) ;
+    if (!width || !index || index->IsRange()) return 0 ;
+
+    long long value ;
+    if (EvalConst(index, value, this)) {
+        address = Literal((unsigned long long)(value - lowest), width).text ;
+        return 1 ;
+    }
+
+    // Rebase the index on the lowest word, in a width that holds both
+    UclidTerm term = Translate(index) ;
+    unsigned w = Max(width, OperandWidth(term)) ;
+    std::string text = AsBv(term, w) ;
+    if (lowest) text = "(" + text + " - " + Literal((unsigned long long)lowest, w).text + ")" ;
+    address = (w == width) ? text : "(" + text + ")[" + Num(width - 1) + ":0]" ;
+    return 1 ;
+}
+
+unsigned UclidVisitor::SelectBits(const UclidTerm &prefix, const VeriIdDef *id, VeriExpression *index, UclidTerm &term)
+{
+    if (!index) return 0 ;
+
+    // Extract directly from names only, anything else is parenthesized
+    std::string base = (prefix.text.find_first_of("[( ") == std::string::npos) ? prefix.text : "(" + prefix.text + ")" ;
+
+    long long left, right ;
+    if (index->IsRange()) {
+        VeriRange *range = static_cast<VeriRange*>(index) ;
+        long long lo, hi ;
+        if ((range->GetPartSelectToken() == VERI_PARTSELECT_UP) || (range->GetPartSelectToken() == VERI_PARTSELECT_DOWN)) {
+            // base +: width / base -: width
+            long long width ;
+            if (!EvalConst(range->GetRight(), width, this) || (width <= 0)) return 0 ;
+            if (!EvalConst(range->GetLeft(), left, this)) {
+                // Variable base : shift the selected bits down to position 0
+                UclidTerm start = Translate(range->GetLeft()) ;
+                std::string amount = AsBv(start, prefix.width) ;
+                if (range->GetPartSelectToken() == VERI_PARTSELECT_DOWN) amount = "(" + amount + " - " + Literal((unsigned long long)width - 1, prefix.width).text + ")" ;
+                term.text = "bv_l_right_shift(" + prefix.text + ", " + amount + ")[" + Num((unsigned long long)width - 1) + ":0]" ;
+                term.width = (unsigned)width ;
+                return 1 ;
+            }
+            right = (range->GetPartSelectToken() == VERI_PARTSELECT_UP) ? left + width - 1 : left - width + 1 ;
+        } else if (!EvalConst(range->GetLeft(), left, this) || !EvalConst(range->GetRight(), right, this)) {
+            return 0 ;
+        }
+        lo = BitPosition(id, left) ;
+        hi = BitPosition(id, right) ;
+        if (lo > hi) { long long tmp = lo ; lo = hi ; hi = tmp ; }
+        term.text = base + "[" + Num((unsigned long long)hi) + ":" + Num((unsigned long long)lo) + "]" ;
+        term.width = (unsigned)(hi - lo + 1) ;
+    } else if (EvalConst(index, left, this)) {
+        long long pos = BitPosition(id, left) ;
+        term.text = base + "[" + Num((unsigned long long)pos) + ":" + Num((unsigned long long)pos) + "]" ;
+        term.width = 1 ;
+    } else {
+        // Variable bit-select : shift the bit down to position 0
+        UclidTerm bit = Translate(index) ;
+        std::string amount = AsBv(bit, prefix.width) ;
+        int msb, lsb ;
+        if (PackedRange(id, msb, lsb)) {
+            if ((msb >= lsb) && lsb) amount = "(" + amount + " - " + Literal((unsigned long long)lsb, prefix.width).text + ")" ;
+            if (msb < lsb) amount = "(" + Literal((unsigned long long)lsb, prefix.width).text + " - " + amount + ")" ;
+        }
+        term.text = "bv_l_right_shift(" + prefix.text + ", " + amount + ")[0:0]" ;
+        term.width = 1 ;
+    }
+    return 1 ;
+}
+
+void UclidVisitor::VERI_VISIT(VeriIndexedId, node)
+{
+    VeriIdDef *id = node.GetId() ;
+    UclidTerm term ;
+
+    if (id && id->IsMemory()) {
+        // Word of a memory : array select
+        std::string address ;
+        if (!TranslateAddress(id, node.GetIndexExpr(), address)) { Unsupported(node, "memory address") ; return ; }
+        term.text = std::string(NameOf(id)) + "[" + address + "]" ;
+        term.width = IdWidth(id) ;
+    } else {
+        UclidTerm prefix = Translate(node.GetPrefix()) ;
+        if (!SelectBits(prefix, id, node.GetIndexExpr(), term)) { Unsupported(node, "bit-select") ; return ; }
+    }
+    _term = term ;
+    _node = &node ;
+}
+
+void UclidVisitor::VERI_VISIT(VeriIndexedMemoryId, node)
+{
+    // mem[address] followed by a bit or part-select of the word
+    VeriIdDef *id = node.GetId() ;
+    Array *indexes = node.GetIndexes() ;
+    if (!id || !id->IsMemory() || !indexes || (indexes->Size() > 2)) { Unsupported(node, "multi-dimensional select") ; return ; }
+
+    UclidTerm word ;
+    std::string address ;
+    if (!TranslateAddress(id, (VeriExpression*)indexes->At(0), address)) { Unsupported(node, "memory address") ; return ; }
+    word.text = std::string(NameOf(id)) + "[" + address + "]" ;
+    word.width = IdWidth(id) ;
+
+    UclidTerm term = word ;
+    if ((indexes->Size() == 2) && !SelectBits(word, id, (VeriExpression*)indexes->At(1), term)) { Unsupported(node, "bit-select") ; return ; }
+    _term = term ;
+    _node = &node ;
+}
+
+void UclidVisitor::VERI_VISIT(VeriConcat, node)
+{
+    // Operands of a concatenation are self-determined
+    UclidTerm term ;
+    unsigned i ;
+    VeriExpression *expr ;
+    FOREACH_ARRAY_ITEM(node.GetExpressions(), i, expr) {
+        if (!expr) continue ;
+        UclidTerm part = Translate(expr) ;
+        unsigned width = (part.is_bool) ? 1 : part.width ;
+        if (term.width) term.text += " ++ " ;
+        term.text += AsBv(part, width) ;
+        term.width += width ;
+    }
+    if (!term.width) { Unsupported(node, "empty concatenation") ; return ; }
+    term.text = "(" + term.text + ")" ;
+    _term = term ;
+    _node = &node ;
+}
+
+void UclidVisitor::VERI_VISIT(VeriMultiConcat, node)
+{
+    long long repeat ;
+    if (!EvalConst(node.GetRepeat(), repeat, this) || (repeat <= 0)) { Unsupported(node, "replication count") ; return ; }
+
+    // Translate the inner concatenation once, then repeat its text
+    UclidTerm inner ;
+    unsigned i ;
+    VeriExpression *expr ;
+    FOREACH_ARRAY_ITEM(node.GetExpressions(), i, expr) {
+        if (!expr) continue ;
+        UclidTerm part = Translate(expr) ;
+        unsigned width = (part.is_bool) ? 1 : part.width ;
+        if (inner.width) inner.text += " ++ " ;
+        inner.text += AsBv(part, width) ;
+        inner.width += width ;
+    }
+    if (!inner.width) { Unsupported(node, "empty concatenation") ; return ; }
+
+    UclidTerm term ;
+    for (long long n = 0; n < repeat; n++) {
+        if (n) term.text += " ++ " ;
+        term.text += inner.text ;
+    }
+    term.text = "(" + term.text + ")" ;
+    term.width = inner.width * (unsigned)repeat ;
+    _term = term ;
+    _node = &node ;
+}
+
+void UclidVisitor::VERI_VISIT(VeriFunctionCall, node)
+{
+    const VeriIdDef *id = (node.GetFunctionName()) ? node.GetFunctionName()->GetId() : 0 ;
+    Function *function = GetFunction(id) ;
+    size_t num_args = (node.GetArgs()) ? node.GetArgs()->Size() : 0 ;
+    if (!function || (function->strategy == FUNCTION_FAILED) || (num_args != function->formals.size())) {
+        Unsupported(node, "function call") ;
+        return ;
+    }
+    if (function->busy) {
+        Unsupported(node, "recursive function call") ;
+        return ;
+    }
+
+    // Arguments, sized to the ports
+    std::vector<std::string> actuals ;
+    unsigned i ;
+    VeriExpression *arg ;
+    FOREACH_ARRAY_ITEM(node.GetArgs(), i, arg) {
+        unsigned width = IdWidth(function->formals[i]) ;
+        actuals.push_back(AsBv(Translate(arg, width), width)) ;
+    }
+
+    // On its first call, a self-contained function is defined once, unless
+    // its value is short enough for its calls to be cheaper than a define
+    if (function->strategy == FUNCTION_NEW) {
+        function->strategy = FUNCTION_INLINED ;
+        std::string value ;
+        UclidItems shared ;
+        if (!function->self_contained) {
+            // Reads module signals : their values differ from call to call
+        } else if (!EvaluateFunction(*function, 0, value, &shared)) {
+            function->strategy = FUNCTION_FAILED ;
+        } else if (!shared.empty() || (value.size() > _inline_limit)) {
+            _function_defines.insert(_function_defines.end(), shared.begin(), shared.end()) ;
+            _function_defines.push_back(UclidItem::Define(NameOf(id), function->ports, IdWidth(id), value)) ;
+            function->strategy = FUNCTION_DEFINED ;
+        }
+    }
+
+    UclidTerm term ;
+    term.width = IdWidth(id) ;
+    if (function->strategy == FUNCTION_DEFINED) {
+        term.text = std::string(NameOf(id)) + "(" ;
+        for (size_t k = 0; k < actuals.size(); k++) term.text += ((k) ? ", " : "") + actuals[k] ;
+        term.text += ")" ;
+        function->defined_calls++ ;
+    } else if ((function->strategy == FUNCTION_INLINED) && EvaluateFunction(*function, &actuals, term.text, 0)) {
+        function->inlined_calls++ ;
+    } else {
+        function->strategy = FUNCTION_FAILED ;
+        Unsupported(node, "function call") ;
+        return ;
+    }
+    _term = term ;
+    _node = &node ;
+}
+
+void UclidVisitor::VERI_VISIT(VeriSystemFunctionCall, node)
+{
+    // $signed / $unsigned only change the interpretation of the bits
+    const char *name = node.GetName() ;
+    if (name && (!std::strcmp(name, "signed") || !std::strcmp(name, "unsigned")) && node.GetArgs() && (node.GetArgs()->Size() == 1)) {
+        _term = Translate((VeriExpression*)node.GetArgs()->At(0), _context) ;
+        _node = &node ;
+        return ;
+    }
+    Unsupported(node, "system function call") ;
+}
+
+void UclidVisitor::VERI_VISIT(VeriUnaryOperator, node)
+{
+    unsigned oper = node.OperType() ;
+    UclidTerm term ;
+
+    // Reduction and logical operators are self-determined, the others take the context width
+    UclidTerm arg = Translate(node.GetArg(), (oper == VERI_REDNOT || oper == VERI_MIN || oper == VERI_PLUS) ? _context : 0) ;
+    unsigned width = (arg.is_bool) ? 1 : arg.width ;
+
+    switch (oper) {
+    case VERI_PLUS :
+        term = arg ;
+        break ;
+    case VERI_MIN :
+        width = Max(_context, OperandWidth(arg)) ;
+        term.text = "(" + Literal(0, width).text + " - " + AsBv(arg, width) + ")" ;
+        term.width = width ;
+        break ;
+    case VERI_REDNOT :
+        width = Max(_context, OperandWidth(arg)) ;
+        term.text = "~" + AsBv(arg, width) ;
+        term.width = width ;
+        break ;
+    case VERI_LOGNOT :
+        term.text = "!" + AsBool(arg) ;
+        term.is_bool = 1 ;
+        break ;
+    case VERI_REDOR :
+        term.text = AsBool(arg) ;
+        term.is_bool = 1 ;
+        break ;
+    case VERI_REDNOR :
+        term.text = "!" + AsBool(arg) ;
+        term.is_bool = 1 ;
+        break ;
+    case VERI_REDAND :
+        term.text = "(" + AsBv(arg, width) + " == ~" + Literal(0, width).text + ")" ;
+        term.is_bool = 1 ;
+        break ;
+    case VERI_REDNAND :
+        term.text = "(" + AsBv(arg, width) + " != ~" + Literal(0, width).text + ")" ;
+        term.is_bool = 1 ;
+        break ;
+    case VERI_REDXOR :
+    case VERI_REDXNOR :
+    {
+        std::string bits = AsBv(arg, width) ;
+        for (unsigned i = 0; i < width; i++) {
+            if (i) term.text += " ^ " ;
+            term.text += bits + "[" + Num(i) + ":" + Num(i) + "]" ;
+        }
+        term.text = (oper == VERI_REDXNOR) ? "~(" + term.text + ")" : "(" + term.text + ")" ;
+        term.width = 1 ;
+        break ;
+    }
+    default :
+        Unsupported(node, "unary operator") ;
+        return ;
+    }
+    _term = term ;
+    _node = &node ;
+}
+
+void UclidVisitor::VERI_VISIT(VeriBinaryOperator, node)
+{
+    unsigned oper = node.OperType() ;
+    UclidTerm term ;
+
+    // a + b + c ... : one n-ary operation, emitted as a balanced tree
+    if (ExpressionWalker::IsChain(node)) {
+        TranslateChain(node) ;
+        return ;
+    }
+
+    // Fold constant operands right away
+    long long value ;
+    if (EvalConst(&node, value, this)) {
+        _term = Literal((unsigned long long)value, Max(_context, 32)) ;
+        _node = &node ;
+        return ;
+    }
+
+    const char *arith = ArithOperator(oper) ;
+    const char *compare = CompareOperator(oper) ;
+
+    if (arith || (oper == VERI_REDXNOR)) {
+        // Context-determined : both operands are sized to the widest of them and the context
+        UclidTerm l = Translate(node.GetLeft(), _context) ;
+        UclidTerm r = Translate(node.GetRight(), _context) ;
+        unsigned width = Max(_context, Max(OperandWidth(l), OperandWidth(r))) ;
+        const char *function = Uninterpreted(oper, width) ;
+        if (function) {
+            term.text = std::string(function) + "(" + AsBv(l, width) + ", " + AsBv(r, width) + ")" ;
+        } else if (arith) {
+            term.text = "(" + AsBv(l, width) + " " + arith + " " + AsBv(r, width) + ")" ;
+        } else {
+            term.text = "~(" + AsBv(l, width) + " ^ " + AsBv(r, width) + ")" ;
+        }
+        term.width = width ;
+    } else if (compare) {
+        // Operands are sized to each other, the result is a boolean
+        UclidTerm l = Translate(node.GetLeft()) ;
+        UclidTerm r = Translate(node.GetRight()) ;
+        if (l.is_bool && r.is_bool && ((oper == VERI_LOGEQ) || (oper == VERI_LOGNEQ) || (oper == VERI_CASEEQ) || (oper == VERI_CASENEQ))) {
+            term.text = "(" + l.text + " " + compare + " " + r.text + ")" ;
+        } else {
+            unsigned width = Max(OperandWidth(l), OperandWidth(r)) ;
+            term.text = "(" + AsBv(l, width) + " " + compare + " " + AsBv(r, width) + ")" ;
+        }
+        term.is_bool = 1 ;
+    } else if ((oper == VERI_LOGAND) || (oper == VERI_LOGOR)) {
+        UclidTerm l = Translate(node.GetLeft()) ;
+        UclidTerm r = Translate(node.GetRight()) ;
+        term.text = "(" + AsBool(l) + ((oper == VERI_LOGAND) ? " && " : " || ") + AsBool(r) + ")" ;
+        term.is_bool = 1 ;
+    } else if ((oper == VERI_LSHIFT) || (oper == VERI_ARITLSHIFT) || (oper == VERI_RSHIFT) || (oper == VERI_ARITRSHIFT)) {
+        // The shifted operand takes the context width, the amount is self-determined
+        UclidTerm l = Translate(node.GetLeft(), _context) ;
+        UclidTerm r = Translate(node.GetRight()) ;
+        unsigned width = Max(_context, OperandWidth(l)) ;
+        const char *func = (oper == VERI_RSHIFT) ? "bv_l_right_shift" : ((oper == VERI_ARITRSHIFT) ? "bv_a_right_shift" : "bv_left_shift") ;
+        term.text = std::string(func) + "(" + AsBv(l, width) + ", " + AsBv(r, width) + ")" ;
+        term.width = width ;
+    } else {
+        Unsupported(node, "binary operator") ;
+        return ;
+    }
+    _term = term ;
+    _node = &node ;
+}
+
+// Combine 'parts' pairwise with 'oper', halving their number each round
+static std::string BalancedTerm(std::vector<std::string> &parts, const char *oper)
+{
+    while (parts.size() > 1) {
+        size_t num = 0 ;
+        for (size_t i = 0; i < parts.size(); i += 2) {
+            if (i + 1 < parts.size()) {
+                parts[num++] = "(" + parts[i] + " " + oper + " " + parts[i + 1] + ")" ;
+            } else {
+                parts[num++] = parts[i] ;
+            }
+        }
+        parts.resize(num) ;
+    }
+    return (parts.empty()) ? std::string() : parts[0] ;
+}
+
+void UclidVisitor::TranslateChain(VeriExpression &node)
+{
+    unsigned oper = node.OperType() ;
+    unsigned logical = (oper == VERI_LOGAND) || (oper == VERI_LOGOR) ;
+
+    Array operands(8) ;
+    ExpressionWalker::FlattenChain(&node, oper, operands) ;
+
+    // Context-determined : all operands of the chain are sized to the widest of them and the context
+    std::vector<UclidTerm> terms ;
+    terms.reserve(operands.Size()) ;
+    unsigned width = _context ;
+    unsigned constant = 1 ;
+    unsigned i ;
+    VeriExpression *operand ;
+    FOREACH_ARRAY_ITEM(&operands, i, operand) {
+        terms.push_back(Translate(operand, (logical) ? 0 : _context)) ;
+        width = Max(width, OperandWidth(terms.back())) ;
+        if (!terms.back().is_literal) constant = 0 ;
+    }
+
+    long long value ;
+    if (constant && EvalConst(&node, value, this)) {
+        _term = Literal((unsigned long long)value, Max(_context, 32)) ;
+        _node = &node ;
+        return ;
+    }
+
+    std::vector<std::string> parts ;
+    parts.reserve(terms.size()) ;
+    for (size_t k = 0; k < terms.size(); k++) {
+        parts.push_back((logical) ? AsBool(terms[k]) : AsBv(terms[k], width)) ;
+    }
+
+    UclidTerm term ;
+    if (logical) {
+        term.text = BalancedTerm(parts, (oper == VERI_LOGAND) ? "&&" : "||") ;
+        term.is_bool = 1 ;
+    } else {
+        term.text = BalancedTerm(parts, ArithOperator(oper)) ;
+        term.width = width ;
+    }
+    _term = term ;
+    _node = &node ;
+}
+
+void UclidVisitor::VERI_VISIT(VeriQuestionColon, node)
+{
+    UclidTerm cond = Translate(node.GetIfExpr()) ;
+    UclidTerm then_term = Translate(node.GetThenExpr(), _context) ;
+    UclidTerm else_term = Translate(node.GetElseExpr(), _context) ;
+
+    UclidTerm term ;
+    if (then_term.is_bool && else_term.is_bool) {
+        term.text = "(if (" + AsBool(cond) + ") then " + then_term.text + " else " + else_term.text + ")" ;
+        term.is_bool = 1 ;
+    } else {
+        unsigned width = Max(_context, Max(OperandWidth(then_term), OperandWidth(else_term))) ;
+        term.text = "(if (" + AsBool(cond) + ") then " + AsBv(then_term, width) + " else " + AsBv(else_term, width) + ")" ;
+        term.width = width ;
+    }
+    _term = term ;
+    _node = &node ;
+}
+
+void UclidVisitor::VERI_VISIT(VeriPortConnect, node)
+{
+    _term = Translate(node.GetConnection(), _context) ;
+    _node = &node ;
+}
+
+void UclidVisitor::VERI_VISIT(VeriPortOpen, node)
+{
+    // Open port : an empty term, callers leave the port unconnected
+    _term = UclidTerm() ;
+    _node = &node ;
+}
+
+/*-----------------------------------------------------------------*/
+//        Visit Methods : Class details in VeriConstVal.h
+/*-----------------------------------------------------------------*/
+
+void UclidVisitor::VERI_VISIT(VeriConstVal, node)
+{
+    // UCLID has no x or z : those bits translate to 0
+    unsigned size = node.Size(0) ;
+    if (!size) size = 1 ;
+
+    if (size <= 64) {
+        unsigned long long value = 0 ;
+        unsigned i = size ;
+        while (i-- != 0) value = (value << 1) | (unsigned long long)GET_BIT(node.GetValue(),i) ;
+        _term = Literal(value, size) ;
+        _node = &node ;
+        return ;
+    }
+
+    // Wide constants : concatenate 64 bit chunks, MSB first
+    UclidTerm term ;
+    unsigned hi = size ;
+    while (hi) {
+        unsigned lo = (hi > 64) ? hi - 64 : 0 ;
+        unsigned long long chunk = 0 ;
+        unsigned i = hi ;
+        while (i-- != lo) chunk = (chunk << 1) | (unsigned long long)GET_BIT(node.GetValue(),i) ;
+        if (term.width) term.text += " ++ " ;
+        term.text += Literal(chunk, hi - lo).text ;
+        term.width += hi - lo ;
+        hi = lo ;
+    }
+    term.text = "(" + term.text + ")" ;
+    _term = term ;
+    _node = &node ;
+}
+
+void UclidVisitor::VERI_VISIT(VeriIntVal, node)
+{
+    // Unsized : 32 bits, but the literal adapts to the width of its context
+    _term = Literal((unsigned long long)(long long)node.GetNum(), Max(_context, 32)) ;
+    _node = &node ;
+}
+
+void UclidVisitor::VERI_VISIT(VeriRealVal, node)
+{
+    Unsupported(node, "real constant") ;
+}
+
+/*---------------------------------------------*/
@@ -0,0 +1,250 @@
+/*
+ *
+ * Translation of Verilog expressions into UCLID5 terms.
+ *
+ * UclidVisitor walks an expression tree and builds the equivalent UCLID
+ * term. Verilog is loosely typed where UCLID is not, so every term carries
+ * its bit width and whether it is a boolean, and operands are extended or
+ * truncated explicitly following the Verilog sizing rules.
+ *
+ * Function calls are translated through the body of the function. A
+ * function that only refers to its ports, its locals and constants is
+ * defined once per module, as a define taking its ports, and called by name.
+ * Short ones, and those that read module signals, are inlined instead.
+ *
+ * Multiplications, divisions and modulo operations can be abstracted into
+ * applications of uninterpreted functions, one per operator and width,
+ * declared once per module.
+ *
+*/
+#ifndef _VERIFIC_UCLID_VISITOR_H_
+#define _VERIFIC_UCLID_VISITOR_H_
+
+#include "VeriVisitor.h"    // Visitor base class definition
+#include "Array.h"          // Make dynamic array class Array available
+#include "Map.h"            // Make associated hash table class Map available
+#include "Set.h"            // Make associated hash table class Set available
+#include "UclidModel.h"     // Items of emitted modules
+
+#include <map>
+#include <string>
+#include <vector>
+
+#ifdef VERIFIC_NAMESPACE
+namespace Verific { // start definitions in verific namespace
+#endif
+
+class VeriIdDef ;
+class UclidSymbolTable ;
+
+// Operators UclidVisitor::SetUninterpreted abstracts
+#define UCLID_UF_MUL    0x1     // *
+#define UCLID_UF_DIV    0x2     // /
+#define UCLID_UF_MOD    0x4     // %
+
+/* -------------------------------------------------------------------------- */
+
+// A translated expression
+struct UclidTerm
+{
+    UclidTerm() : text(), width(0), is_bool(0), is_literal(0), value(0) { }
+
+    std::string         text ;          // UCLID text of the term
+    unsigned            width ;         // Bit width (bit-vector terms)
+    unsigned            is_bool ;       // Term is a UCLID boolean
+    unsigned            is_literal ;    // Term is a constant that fits 'value'
+    unsigned long long  value ;         // Constant value (is_literal only)
+} ;
+
+/* -------------------------------------------------------------------------- */
+
+class UclidVisitor : public VeriVisitor
+{
+public:
+    // Identifiers are named through 'symbols', as declared in module 'scope'
+    UclidVisitor(UclidSymbolTable &symbols, const char *scope) ;
+    virtual ~UclidVisitor() ;
+
+    // Translate 'expr'. 'context_width' is the width imposed by the enclosing
+    // expression or assignment target (0 : self-determined).
+    UclidTerm Translate(VeriExpression *expr, unsigned context_width = 0) ;
+
+    // Render a term as a bit-vector of exactly 'width' bits, or as a boolean
+    static std::string AsBv(const UclidTerm &term, unsigned width) ;
+    static std::string AsBool(const UclidTerm &term) ;
+
+    // Constant terms
+    static UclidTerm Literal(unsigned long long value, unsigned width) ;
+
+    // Declared bit width of an identifier
+    static unsigned IdWidth(const VeriIdDef *id) ;
+
+    // Integer variables : loop counters and the like, not declared in the model
+    static unsigned IsInteger(const VeriIdDef *id) ;
+
+    // Width an identifier is declared with in the model : narrower than its
+    // declared width when its upper bits are never observed (see BitWidthAnalyzer).
+    // Only signals that are assigned as a whole are narrowed.
+    void SetModelWidth(const VeriIdDef *id, unsigned width) ;
+    unsigned ModelWidth(const VeriIdDef *id) const ;
+
+    // Bit position (LSB = 0) of Verilog index 'index' in an identifier declared [msb:lsb]
+    static long long BitPosition(const VeriIdDef *id, long long index) ;
+
+    // Signal and bits [lo, hi] an assignment to an identifier or a constant bit or
+    // part-select writes. Returns 0 for anything else (memory words included).
+    // The index is evaluated with the genvars 'visitor' binds, if given.
+    static unsigned TargetBits(VeriExpression *lval, VeriIdDef *&id, unsigned &lo, unsigned &hi, const UclidVisitor *visitor = 0) ;
+
+    // Memories : address bits of the single unpacked dimension of 'memory' and
+    // its lowest index. Returns 0 if 'memory' does not map onto a UCLID array.
+    static unsigned AddressWidth(const VeriIdDef *memory, long long &lowest) ;
+
+    // UCLID array index for 'index' into 'memory'. Returns 0 if not translatable.
+    unsigned TranslateAddress(const VeriIdDef *memory, VeriExpression *index, std::string &address) ;
+
+    // Evaluate a constant expression (literals and parameters, and the genvars
+    // 'visitor' binds if given). Returns 0 if not constant.
+    static unsigned EvalConst(const VeriExpression *expr, long long &value, const UclidVisitor *visitor = 0) ;
+
+    // UCLID name of an identifier (its interned symbol). Declarations inside
+    // generate blocks are given a new symbol per block (and iteration) with SetName.
+    const char *NameOf(const VeriIdDef *id) const ;
+    void SetName(const VeriIdDef *id, const char *name) ;
+    void ClearName(const VeriIdDef *id) ;
+
+    // A new UCLID name in the module, based on 'name', for a define the translation introduces
+    const char *NewName(const char *name) ;
+
+    // Take all of 'names' in the module as they are, for declarations made
+    // without SetName or NewName. Returns 0 (and takes none) if one is taken.
+    unsigned ClaimNames(const std::vector<std::string> &names) ;
+
+    // Term text to use for an identifier instead of its name : the define
+    // computing a combinational reg, or its value within an always block
+    void SetValue(const VeriIdDef *id, const std::string &value) ;
+    void ClearValue(const VeriIdDef *id) ;
+
+    // Value of a genvar while the body of its generate loop is translated, or
+    // of the variable of a procedural loop while the loop is unrolled.
+    // 'template_index' : the body is being turned into a template over it.
+    void BindGenvar(const VeriIdDef *genvar, long long value, unsigned template_index) ;
+    void UnbindGenvar(const VeriIdDef *genvar) ;
+    unsigned GenvarValue(const VeriIdDef *genvar, long long &value) const ;
+    unsigned IsTemplateGenvar(const VeriIdDef *genvar) const ;
+
+    // Set once the value of a template genvar went through a non-affine
+    // operation (comparison, division, bitwise ...) in a constant expression.
+    // Constant evaluation sets it on a const visitor.
+    void SetNonAffine(unsigned flag) const      { _non_affine = flag ; }
+    unsigned NonAffine() const                  { return _non_affine ; }
+
+    // Functions whose value translates to at most 'limit' characters are
+    // inlined at their calls rather than defined (default 64)
+    void SetInlineLimit(unsigned limit)         { _inline_limit = limit ; }
+
+    // Defines of the functions called so far, each after the ones it calls
+    const UclidItems &FunctionDefines() const   { return _function_defines ; }
+
+    // One "-- function <module> <name> : ..." line per function called, with
+    // the number of calls that went to its define and that were inlined
+    std::string FunctionReport(const char *module) const ;
+
+    // Operators in 'operators' (UCLID_UF_MUL ...) at least 'min_width' bits
+    // wide become uninterpreted functions, such as 'uf_mul_16(a, b)'. With
+    // 'lemmas', axioms keep their identities (x * 1 == x, commutativity ...).
+    void SetUninterpreted(unsigned operators, unsigned min_width, unsigned lemmas) { _uf_operators = operators ; _uf_min_width = min_width ; _uf_lemmas = lemmas ; }
+
+    // Declarations (and lemmas) of the uninterpreted functions applied so far
+    const UclidItems &UninterpretedDecls() const { return _uf_decls ; }
+
+    // One "-- uninterpreted <module> <function> : <n> applications" line per function
+    std::string UninterpretedReport(const char *module) const ;
+
+/* ================================================================= */
+/*                         VISIT METHODS                             */
+/* ================================================================= */
+
+    // The following class definitions can be found in VeriExpression.h
+    virtual void VERI_VISIT(VeriExpression, node);
+    virtual void VERI_VISIT(VeriIdRef, node);
+    virtual void VERI_VISIT(VeriIndexedId, node);
+    virtual void VERI_VISIT(VeriIndexedMemoryId, node);
+    virtual void VERI_VISIT(VeriConcat, node);
+    virtual void VERI_VISIT(VeriMultiConcat, node);
+    virtual void VERI_VISIT(VeriFunctionCall, node);
+    virtual void VERI_VISIT(VeriSystemFunctionCall, node);
+    virtual void VERI_VISIT(VeriUnaryOperator, node);
+    virtual void VERI_VISIT(VeriBinaryOperator, node);
+    virtual void VERI_VISIT(VeriQuestionColon, node);
+    virtual void VERI_VISIT(VeriPortConnect, node);
+    virtual void VERI_VISIT(VeriPortOpen, node);
+
+    // The following class definitions can be found in VeriConstVal.h
+    virtual void VERI_VISIT(VeriConstVal, node);
+    virtual void VERI_VISIT(VeriIntVal, node);
+    virtual void VERI_VISIT(VeriRealVal, node);
+
+private:
+    // Declared [msb:lsb] of an identifier (of the words, for memories). Returns 0 for scalars.
+    static unsigned PackedRange(const VeriIdDef *id, int &msb, int &lsb) ;
+
+    // Bit or part-select 'index' of 'prefix', a value of 'id'. Returns 0 if not translatable.
+    unsigned SelectBits(const UclidTerm &prefix, const VeriIdDef *id, VeriExpression *index, UclidTerm &term) ;
+
+    // Chain of one associative operator (see ExpressionWalker::IsChain)
+    void TranslateChain(VeriExpression &node) ;
+
+    // A function, its ports and how its calls are translated
+    struct Function ;
+
+    // The function declared by 'function_id' (0 if it is not a function we know the body of)
+    Function *GetFunction(const VeriIdDef *function_id) ;
+
+    // Value of 'function' : with its ports bound to 'actuals' (inlined), or
+    // left as the names of its ports (its define, with the shared values of
+    // its body in 'shared'). Returns 0 if the body can not be evaluated.
+    unsigned EvaluateFunction(Function &function, const std::vector<std::string> *actuals, std::string &value, UclidItems *shared) ;
+
+    // Uninterpreted function for 'oper' on 'width' bits, declared on first use.
+    // Returns 0 if the operator is translated as it is.
+    const char *Uninterpreted(unsigned oper, unsigned width) ;
+
+    // Term for an expression we cannot translate : reported, and replaced by zero
+    void Unsupported(const VeriTreeNode &node, const char *what) ;
+
+private:
+    UclidTerm       _term ;         // Result of the last visited expression
+    unsigned        _context ;      // Context width of the expression being visited
+    const VeriTreeNode *_node ;     // Expression '_term' was produced for
+    UclidSymbolTable &_symbols ;    // Design-wide UCLID names
+    std::string     _scope ;        // Module the translated expressions are in
+    Map             _names ;        // VeriIdDef* -> symbol, where not the interned symbol of the id
+    Map             _values ;       // VeriIdDef* -> std::string*, see SetValue
+    Map             _widths ;       // VeriIdDef* -> narrowed width, see SetModelWidth
+    Map             _functions ;    // VeriIdDef* -> Function*, of the functions called
+    Array           _function_order ; // Function*, in order of first call
+    UclidItems      _function_defines ;
+    unsigned        _inline_limit ;
+    unsigned        _uf_operators ;
+    unsigned        _uf_min_width ;
+    unsigned        _uf_lemmas ;
+    std::map<std::string, std::pair<std::string, unsigned long> > _uf_functions ; // "<op>_<width>" -> name, applications
+    std::vector<std::string> _uf_order ; // Keys of _uf_functions, in order of first use
+    UclidItems      _uf_decls ;
+    Map             _genvars ;      // VeriIdDef* -> value, see BindGenvar
+    Set             _template_genvars ; // VeriIdDef* the body is turned into a template over
+    mutable unsigned _non_affine ;  // See SetNonAffine
+
+    // Prevent the compiler from implementing the following
+    UclidVisitor(const UclidVisitor &node) ;
+    UclidVisitor& operator=(const UclidVisitor &rhs) ;
+} ;
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef VERIFIC_NAMESPACE
+} // end definitions in verific namespace
+#endif
+
+#endif // #ifndef _VERIFIC_UCLID_VISITOR_H_
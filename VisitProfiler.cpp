@@ -0,0 +1,187 @@
+/*
+ *
+ * Optional per-node-class profiling of the visitors.
+ *
+*/
+
+#include "VisitProfiler.h"  // VisitProfiler class definition
+
+#ifdef VISIT_PROFILE
+
+#include <algorithm>        // std::sort
+#include <cstdio>           // snprintf
+#include <ctime>            // clock_gettime
+#include <vector>
+
+#include "Map.h"            // Make associated hash table class Map available
+#include "Strings.h"        // A string utility/wrapper class
+
+#ifdef VERIFIC_NAMESPACE
+using namespace Verific ;
+#endif
+
+// Totals of one node class or module
+struct VisitStats
+{
+    VisitStats() : name(0), calls(0), inclusive(0), exclusive(0), bytes(0), active(0) { }
+
+    const char          *name ;
+    unsigned long long   calls ;
+    unsigned long long   inclusive ;    // ns, nested visits of the same class counted once
+    unsigned long long   exclusive ;    // ns
+    unsigned long long   bytes ;        // written by the node itself
+    unsigned             active ;       // frames of this class being visited
+} ;
+
+// A node being visited
+struct VisitFrame
+{
+    VisitStats          *stats ;
+    unsigned long long   start ;        // ns
+    unsigned long long   start_bytes ;
+    unsigned long long   child_time ;   // inclusive ns of the nodes visited from this one
+    unsigned long long   child_bytes ;
+} ;
+
+static Map                      *class_stats = 0 ;      // char* node class -> VisitStats*
+static Map                      *module_stats = 0 ;     // char* module name -> VisitStats*
+static VisitStats               *current_module = 0 ;
+static std::vector<VisitFrame>   frames ;
+
+static unsigned long long Now()
+{
+    struct timespec now ;
+    clock_gettime(CLOCK_MONOTONIC, &now) ;
+    return (unsigned long long)now.tv_sec * 1000000000ULL + (unsigned long long)now.tv_nsec ;
+}
+
+static VisitStats *GetStats(Map *&stats, const char *name)
+{
+    if (!stats) stats = new Map(STRING_HASH) ;
+    VisitStats *s = (VisitStats*)stats->GetValue(name) ;
+    if (s) return s ;
+    s = new VisitStats ;
+    s->name = Strings::save(name) ;
+    (void) stats->Insert(s->name, s) ;
+    return s ;
+}
+
+/*-----------------------------------------------------------------*/
+//                            Recording
+/*-----------------------------------------------------------------*/
+
+// static
+void VisitProfiler::Enter(const char *node_class, unsigned long long bytes)
+{
+    VisitFrame frame ;
+    frame.stats = GetStats(class_stats, node_class) ;
+    frame.start_bytes = bytes ;
+    frame.child_time = 0 ;
+    frame.child_bytes = 0 ;
+    frame.start = Now() ;
+    frame.stats->active++ ;
+    frames.push_back(frame) ;
+}
+
+// static
+void VisitProfiler::Exit(unsigned long long bytes_now)
+{
+    if (frames.empty()) return ;
+    unsigned long long now = Now() ;
+    VisitFrame frame = frames.back() ;
+
+    unsigned long long inclusive = now - frame.start ;
+    unsigned long long bytes = bytes_now - frame.start_bytes ;
+    unsigned long long exclusive = (inclusive > frame.child_time) ? inclusive - frame.child_time : 0 ;
+    unsigned long long own_bytes = (bytes > frame.child_bytes) ? bytes - frame.child_bytes : 0 ;
+
+    VisitStats *stats = frame.stats ;
+    stats->calls++ ;
+    // A nested visit of the same class : its time is already inside the outer one
+    if (!--stats->active) stats->inclusive += inclusive ;
+    stats->exclusive += exclusive ;
+    stats->bytes += own_bytes ;
+    if (current_module) {
+        current_module->calls++ ;
+        current_module->exclusive += exclusive ;
+        current_module->bytes += own_bytes ;
+    }
+
+    frames.pop_back() ;
+    if (!frames.empty()) {
+        frames.back().child_time += inclusive ;
+        frames.back().child_bytes += bytes ;
+    }
+}
+
+// static
+void VisitProfiler::SetModule(const char *module_name)
+{
+    current_module = (module_name) ? GetStats(module_stats, module_name) : 0 ;
+}
+
+/*-----------------------------------------------------------------*/
+//                             Report
+/*-----------------------------------------------------------------*/
+
+static bool MoreExclusive(const VisitStats *a, const VisitStats *b) { return a->exclusive > b->exclusive ; }
+
+static void ReportTable(std::ostream &os, Map *stats, const char *what, unsigned top_n, unsigned inclusive)
+{
+    std::vector<VisitStats*> sorted ;
+    unsigned long long total = 0 ;
+    MapIter mi ;
+    char *name ;
+    VisitStats *s ;
+    FOREACH_MAP_ITEM(stats, mi, &name, &s) {
+        sorted.push_back(s) ;
+        total += s->exclusive ;
+    }
+    std::sort(sorted.begin(), sorted.end(), MoreExclusive) ;
+
+    os << "-- top " << top_n << " " << what << " by exclusive time (of " << sorted.size() << ", "
+       << (double)total / 1e6 << " ms in total)" << std::endl ;
+    char line[256] ;
+    snprintf(line, sizeof(line), "   %-32s %12s %12s %12s %6s %14s", what, "calls", (inclusive) ? "incl ms" : "", "excl ms", "%", "bytes") ;
+    os << line << std::endl ;
+    for (size_t i = 0; (i < sorted.size()) && (i < top_n); i++) {
+        s = sorted[i] ;
+        char incl[32] = "" ;
+        if (inclusive) snprintf(incl, sizeof(incl), "%.3f", (double)s->inclusive / 1e6) ;
+        snprintf(line, sizeof(line), "   %-32s %12llu %12s %12.3f %6.1f %14llu", s->name, s->calls, incl,
+                 (double)s->exclusive / 1e6, (total) ? 100.0 * (double)s->exclusive / (double)total : 0.0, s->bytes) ;
+        os << line << std::endl ;
+    }
+}
+
+// static
+void VisitProfiler::Report(std::ostream &os, unsigned top_n)
+{
+    if (class_stats) ReportTable(os, class_stats, "node classes", top_n, 1) ;
+    if (module_stats) ReportTable(os, module_stats, "modules", top_n, 0) ;
+}
+
+// static
+void VisitProfiler::Reset()
+{
+    Map *maps[2] = { class_stats, module_stats } ;
+    for (unsigned i = 0; i < 2; i++) {
+        if (!maps[i]) continue ;
+        MapIter mi ;
+        char *name ;
+        VisitStats *s ;
+        FOREACH_MAP_ITEM(maps[i], mi, &name, &s) {
+            Strings::free(name) ;
+            delete s ;
+        }
+        delete maps[i] ;
+    }
+    class_stats = 0 ;
+    module_stats = 0 ;
+    current_module = 0 ;
+    frames.clear() ;
+}
+
+#endif // VISIT_PROFILE
+
+/*---------------------------------------------*/
@@ -0,0 +1,111 @@
+/*
+ *
+ * Optional per-node-class profiling of the visitors.
+ *
+ * Built with VISIT_PROFILE defined (make VISIT_PROFILE=1), every visit
+ * method of PrettyPrintVisitor records a call, its inclusive and exclusive
+ * time, and the bytes it wrote, both per node class and per module.
+ * Report() prints the top entries. Without VISIT_PROFILE the macros below
+ * expand to nothing, and none of this is compiled.
+ *
+*/
+#ifndef _VERIFIC_VISIT_PROFILER_H_
+#define _VERIFIC_VISIT_PROFILER_H_
+
+#ifdef VISIT_PROFILE
+
+#include <ostream>
+#include <streambuf>
+
+#ifdef VERIFIC_NAMESPACE
+namespace Verific { // start definitions in verific namespace
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+class VisitProfiler
+{
+public:
+    // A node of class 'node_class' is entered / left, after the visitor
+    // wrote 'bytes' bytes in total
+    static void Enter(const char *node_class, unsigned long long bytes) ;
+    static void Exit(unsigned long long bytes) ;
+
+    // Module the following visits belong to
+    static void SetModule(const char *module_name) ;
+
+    // Top 'top_n' node classes and modules, by exclusive time
+    static void Report(std::ostream &os, unsigned top_n) ;
+
+    static void Reset() ;
+
+private:
+    // Prevent the compiler from implementing the following
+    VisitProfiler() ;
+} ;
+
+// Passes the output of a visitor on to 'target', counting the bytes
+class VisitByteCounter : public std::streambuf
+{
+public:
+    explicit VisitByteCounter(std::streambuf *target) : _target(target), _count(0) { }
+
+    unsigned long long Count() const { return _count ; }
+    std::streambuf *Target() const { return _target ; }
+
+protected:
+    virtual int_type overflow(int_type ch)
+    {
+        if (traits_type::eq_int_type(ch, traits_type::eof())) return traits_type::not_eof(ch) ;
+        _count++ ;
+        return _target->sputc(traits_type::to_char_type(ch)) ;
+    }
+    virtual std::streamsize xsputn(const char *s, std::streamsize n)
+    {
+        std::streamsize written = _target->sputn(s, n) ;
+        _count += (unsigned long long)written ;
+        return written ;
+    }
+    virtual int sync() { return _target->pubsync() ; }
+
+private:
+    std::streambuf      *_target ;
+    unsigned long long   _count ;
+
+    // Prevent the compiler from implementing the following
+    VisitByteCounter(const VisitByteCounter &node) ;
+    VisitByteCounter& operator=(const VisitByteCounter &rhs) ;
+} ;
+
+// Enter on construction, exit on destruction
+class VisitProfileScope
+{
+public:
+    VisitProfileScope(const char *node_class, const VisitByteCounter &bytes) : _bytes(bytes) { VisitProfiler::Enter(node_class, bytes.Count()) ; }
+    ~VisitProfileScope() { VisitProfiler::Exit(_bytes.Count()) ; }
+
+private:
+    const VisitByteCounter  &_bytes ;
+
+    // Prevent the compiler from implementing the following
+    VisitProfileScope(const VisitProfileScope &node) ;
+    VisitProfileScope& operator=(const VisitProfileScope &rhs) ;
+} ;
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef VERIFIC_NAMESPACE
+} // end definitions in verific namespace
+#endif
+
+#define VISIT_PROFILE_SCOPE(CLASS, BYTES)   VisitProfileScope visit_profile_scope(#CLASS, (BYTES))
+#define VISIT_PROFILE_MODULE(NAME)          VisitProfiler::SetModule(NAME)
+
+#else // VISIT_PROFILE
+
+#define VISIT_PROFILE_SCOPE(CLASS, BYTES)
+#define VISIT_PROFILE_MODULE(NAME)
+
+#endif // VISIT_PROFILE
+
+#endif // #ifndef _VERIFIC_VISIT_PROFILER_H_
@@ -17,10 +17,12 @@
 
 #include <cstring>          // strchr ...
 #include <cctype>           // isalpha, etc ...
+#include <sstream>          // ostringstream
 
 #include "Visitor.h"        // Visitor base class definition
 
 #include "Array.h"          // Make dynamic array class Array available
+#include "Map.h"            // Make associated hash table class Map available
 #include "Strings.h"        // A string utility/wrapper class
 #include "Message.h"        // Make message handlers available, not used in this example
 
@@ -33,6 +35,8 @@
 #include "VeriConstVal.h"   // Definitions of parse-tree nodes representing constant values in Verilog.
 #include "veri_tokens.h"
 
+#include "ModuleItemSorter.h" // Module items by kind
+
 #ifdef VERIFIC_NAMESPACE
 using namespace Verific ;
 #endif
@@ -42,20 +46,55 @@ using namespace Verific ;
 /*-----------------------------------------------------------------*/
 
 PrettyPrintVisitor::PrettyPrintVisitor(char *pFileName)
-    : _ofs(pFileName, std::ios::out),
+    : _file(pFileName, std::ios::out),
+      _ofs(_file),
       _bFileGood(true),
-      _nLevel(0)
+      _nLevel(0),
+      _chains()
+#ifdef VISIT_PROFILE
+      , _bytes(_ofs.rdbuf())
+#endif
 {
-    if (!_ofs.rdbuf()->is_open()){
+    if (!_file.is_open()){
         Message::Error(0, "cannot open file ", pFileName) ;
         _bFileGood = false;
     }
+    Init() ;
+}
+
+PrettyPrintVisitor::PrettyPrintVisitor(std::ostream &os)
+    : _file(),
+      _ofs(os),
+      _bFileGood(os.good()),
+      _nLevel(0),
+      _chains()
+#ifdef VISIT_PROFILE
+      , _bytes(_ofs.rdbuf())
+#endif
+{
+    Init() ;
+}
+
+void PrettyPrintVisitor::Init()
+{
+#ifdef VISIT_PROFILE
+    // Count what is written, for the visit profile
+    (void) _ofs.rdbuf(&_bytes) ;
+#endif
 }
 
 PrettyPrintVisitor::~PrettyPrintVisitor()
 {
-    _ofs.close();
+#ifdef VISIT_PROFILE
+    (void) _ofs.rdbuf(_bytes.Target()) ;
+#endif
+    _ofs.flush();
+    if (_file.is_open()) _file.close();
     _bFileGood = false;
+
+    unsigned i ;
+    Array *operands ;
+    FOREACH_ARRAY_ITEM(&_chains, i, operands) delete operands ;
 }
 
 /*-----------------------------------------------------------------*/
@@ -339,6 +378,8 @@ void PrettyPrintVisitor::VERI_VISIT(VeriTreeNode, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriModule, node)
 {
+    VISIT_PROFILE_MODULE(node.Name()) ;
+    VISIT_PROFILE_SCOPE(VeriModule, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     // Start myself on a new line
@@ -389,10 +430,16 @@ void PrettyPrintVisitor::VERI_VISIT(VeriModule, node)
     _ofs << " ;" << std::endl ;
 
     // VeriModule Items
-    VeriModuleItem *mi ;
-    FOREACH_ARRAY_ITEM(node.GetModuleItems(), i, mi) {
-        // Write them with one _nLevel indent deeper
-        if (mi) { IncTabLevel(1) ; mi->Accept(*this) ; DecTabLevel(1) ; }
+    ModuleItemSorter items(node.GetModuleItems()) ;
+    if (items.IsStructural()) {
+        // Netlist : instances grouped per cell
+        IncTabLevel(1) ; PrintStructuralItems(node.GetModuleItems()) ; DecTabLevel(1) ;
+    } else {
+        VeriModuleItem *mi ;
+        FOREACH_ARRAY_ITEM(node.GetModuleItems(), i, mi) {
+            // Write them with one _nLevel indent deeper
+            if (mi) { IncTabLevel(1) ; mi->Accept(*this) ; DecTabLevel(1) ; }
+        }
     }
 
     // Close module
@@ -406,8 +453,168 @@ void PrettyPrintVisitor::VERI_VISIT(VeriModule, node)
     _ofs << std::endl ; // extra linefeed.
 }
 
+/*-----------------------------------------------------------------*/
+//                 Structural (netlist) module output
+/*-----------------------------------------------------------------*/
+
+// Synthesized netlists are almost only instantiations of a few cells, the
+// instances of one cell mostly next to each other. Rather than one statement
+// per instantiation with a visitor call per port, each run of instantiations
+// of the same cell is printed as one statement, the '.formal(' prefixes of
+// the cell are formatted once, and nothing is flushed per line. The order of
+// the items is kept.
+
+// static
+const char *PrettyPrintVisitor::GroupKey(const VeriModuleItem &mi, unsigned &is_gate)
+{
+    if (mi.GetAttributes() && mi.GetAttributes()->Size()) return 0 ;
+    if (mi.GetClassId() == ID_VERIMODULEINSTANTIATION) {
+        const VeriModuleInstantiation &inst = static_cast<const VeriModuleInstantiation&>(mi) ;
+        is_gate = 0 ;
+        return (inst.GetParamValues() || inst.GetStrength()) ? 0 : inst.GetModuleName() ;
+    }
+    if (mi.GetClassId() == ID_VERIGATEINSTANTIATION) {
+        const VeriGateInstantiation &gate = static_cast<const VeriGateInstantiation&>(mi) ;
+        is_gate = 1 ;
+        return (gate.GetStrength() || gate.GetDelay()) ? 0 : PrintToken(gate.GetInstType()) ;
+    }
+    return 0 ;
+}
+
+void PrettyPrintVisitor::PrintStructuralItems(const Array *items)
+{
+    Array group(64) ;           // Instances of the run being collected
+    VeriModuleItem *first = 0 ; // Its first instantiation
+    const char *key = 0 ;       // Its cell name or gate keyword
+    unsigned is_gate = 0 ;
+
+    unsigned i ;
+    VeriModuleItem *mi ;
+    FOREACH_ARRAY_ITEM(items, i, mi) {
+        if (!mi) continue ;
+
+        unsigned mi_is_gate = 0 ;
+        const char *mi_key = GroupKey(*mi, mi_is_gate) ;
+        unsigned same = first && mi_key && (mi_is_gate == is_gate) && Strings::compare(mi_key, key) ;
+
+        if (first && !same) {
+            PrintGroup(*first, group) ;
+            group.Reset() ;
+            first = 0 ;
+        }
+        if (!mi_key) {
+            mi->Accept(*this) ;
+            continue ;
+        }
+        if (!first) {
+            first = mi ;
+            key = mi_key ;
+            is_gate = mi_is_gate ;
+        }
+        unsigned j ;
+        VeriInstId *inst ;
+        FOREACH_ARRAY_ITEM((mi_is_gate) ? static_cast<VeriGateInstantiation*>(mi)->GetInstances() : static_cast<VeriModuleInstantiation*>(mi)->GetInstances(), j, inst) {
+            if (inst) group.InsertLast(inst) ;
+        }
+    }
+    if (first) PrintGroup(*first, group) ;
+}
+
+void PrettyPrintVisitor::PrintGroup(const VeriModuleItem &first, const Array &instances)
+{
+    if (first.GetClassId() == ID_VERIMODULEINSTANTIATION) {
+        const VeriModuleInstantiation &inst = static_cast<const VeriModuleInstantiation&>(first) ;
+        PrintInstanceGroup(inst.GetModuleName(), 1, instances, inst.GetInstantiatedModule()) ;
+    } else {
+        const VeriGateInstantiation &gate = static_cast<const VeriGateInstantiation&>(first) ;
+        PrintInstanceGroup(PrintToken(gate.GetInstType()), 0, instances, 0) ;
+    }
+}
+
+void PrettyPrintVisitor::PrintInstanceGroup(const char *keyword, unsigned is_module, const Array &instances, const VeriModule *cell)
+{
+    if (!_bFileGood) return ; // file stream is not good
+
+    // Format the named port prefixes of the cell once
+    Array formals ;
+    Array prefixes ;
+    unsigned i ;
+    if (cell) {
+        VeriIdDef *port ;
+        FOREACH_ARRAY_ITEM(cell->GetPorts(), i, port) {
+            if (!port) break ;
+            std::ostringstream prefix ;
+            prefix << "." ;
+            PrintIdentifier(prefix, port->Name()) ;
+            prefix << "(" ;
+            formals.InsertLast(port->Name()) ;
+            prefixes.InsertLast(Strings::save(prefix.str().c_str())) ;
+        }
+    }
+
+    _ofs << PrintLevel(_nLevel) ;
+    if (is_module) PrintIdentifier(_ofs, keyword) ;
+    else _ofs << keyword ;
+    _ofs << " " ;
+
+    VeriInstId *inst ;
+    IncTabLevel(1) ;
+    FOREACH_ARRAY_ITEM(&instances, i, inst) {
+        if (i) _ofs << ",\n" << PrintLevel(_nLevel) ;
+        PrintGroupedInstance(*inst, formals, prefixes) ;
+    }
+    DecTabLevel(1) ;
+    _ofs << " ; \n" ;
+
+    char *prefix ;
+    FOREACH_ARRAY_ITEM(&prefixes, i, prefix) Strings::free(prefix) ;
+}
+
+void PrettyPrintVisitor::PrintGroupedInstance(const VeriInstId &inst, const Array &formals, const Array &prefixes)
+{
+    if (inst.GetName()) { _ofs << inst.GetName() << " " ; }
+    if (inst.GetRange()) {
+        _ofs << "[" ;
+        inst.GetRange()->Accept(*this) ;
+        _ofs << "] " ;
+    }
+
+    _ofs << "(" ;
+    unsigned i ;
+    VeriExpression *pc ;
+    FOREACH_ARRAY_ITEM(inst.GetPortConnects(), i, pc) {
+        if (i) _ofs << ", " ;
+        if (!pc) continue ;
+        const char *formal = (pc->GetClassId() == ID_VERIPORTCONNECT) ? pc->GetNamedFormal() : 0 ;
+        if (!formal) {
+            PrintConnection(pc) ;
+            continue ;
+        }
+        // Netlists connect in port order : the prefix at the same position is usually the one
+        if ((i < formals.Size()) && Strings::compare(formal, (const char*)formals.At(i))) {
+            _ofs << (const char*)prefixes.At(i) ;
+        } else {
+            _ofs << "." ; PrintIdentifier(_ofs, formal) ; _ofs << "(" ;
+        }
+        PrintConnection(pc->GetConnection()) ;
+        _ofs << ")" ;
+    }
+    _ofs << ")" ;
+}
+
+void PrettyPrintVisitor::PrintConnection(VeriExpression *expr)
+{
+    if (!expr) return ;
+    if (expr->GetClassId() == ID_VERIIDREF) {
+        PrintIdentifier(_ofs, (expr->GetName()) ? expr->GetName() : expr->FullId()->GetName()) ;
+    } else {
+        expr->Accept(*this) ;
+    }
+}
+
 void PrettyPrintVisitor::VERI_VISIT(VeriPrimitive, node)
 {
+    VISIT_PROFILE_SCOPE(VeriPrimitive, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     VERI_VISIT_NODE(VeriModule, static_cast<VeriModule&>(node));
@@ -424,6 +631,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriStatement, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriBlockingAssign, node)
 {
+    VISIT_PROFILE_SCOPE(VeriBlockingAssign, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     _ofs << PrintLevel(_nLevel) ;
@@ -470,6 +678,7 @@ void PrettyPrintVisitor::PrettyPrintWOSemi(VeriBlockingAssign &node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriNonBlockingAssign, node)
 {
+    VISIT_PROFILE_SCOPE(VeriNonBlockingAssign, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     _ofs << PrintLevel(_nLevel) ;
@@ -494,6 +703,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriNonBlockingAssign, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriGenVarAssign, node)
 {
+    VISIT_PROFILE_SCOPE(VeriGenVarAssign, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     _ofs << PrintLevel(_nLevel) ;
@@ -509,6 +719,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriGenVarAssign, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriAssign, node)
 {
+    VISIT_PROFILE_SCOPE(VeriAssign, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
     _ofs << PrintLevel(_nLevel) ;
     _ofs << PrintToken(VERI_ASSIGN) << " " ;
@@ -518,6 +729,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriAssign, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriDeAssign, node)
 {
+    VISIT_PROFILE_SCOPE(VeriDeAssign, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     _ofs << PrintLevel(_nLevel) ;
@@ -528,6 +740,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriDeAssign, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriForce, node)
 {
+    VISIT_PROFILE_SCOPE(VeriForce, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     _ofs << PrintLevel(_nLevel) ;
@@ -538,6 +751,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriForce, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriRelease, node)
 {
+    VISIT_PROFILE_SCOPE(VeriRelease, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     _ofs << PrintLevel(_nLevel) ;
@@ -548,6 +762,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriRelease, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriTaskEnable, node)
 {
+    VISIT_PROFILE_SCOPE(VeriTaskEnable, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     _ofs << PrintLevel(_nLevel) ;
@@ -570,6 +785,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriTaskEnable, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriSystemTaskEnable, node)
 {
+    VISIT_PROFILE_SCOPE(VeriSystemTaskEnable, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     _ofs << PrintLevel(_nLevel) ;
@@ -592,6 +808,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriSystemTaskEnable, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriDelayControlStatement, node)
 {
+    VISIT_PROFILE_SCOPE(VeriDelayControlStatement, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     if (node.GetDelay()) {
@@ -607,6 +824,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriDelayControlStatement, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriEventControlStatement, node)
 {
+    VISIT_PROFILE_SCOPE(VeriEventControlStatement, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     if (node.GetAt()) {
@@ -635,6 +853,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriEventControlStatement, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriConditionalStatement, node)
 {
+    VISIT_PROFILE_SCOPE(VeriConditionalStatement, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     _ofs << PrintLevel(_nLevel) ;
@@ -652,6 +871,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriConditionalStatement, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriCaseStatement, node)
 {
+    VISIT_PROFILE_SCOPE(VeriCaseStatement, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     _ofs << PrintLevel(_nLevel) ;
@@ -684,6 +904,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriCaseStatement, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriForever, node)
 {
+    VISIT_PROFILE_SCOPE(VeriForever, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     _ofs << PrintLevel(_nLevel) ;
@@ -694,6 +915,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriForever, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriRepeat, node)
 {
+    VISIT_PROFILE_SCOPE(VeriRepeat, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     _ofs << PrintLevel(_nLevel) ;
@@ -706,6 +928,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriRepeat, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriWhile, node)
 {
+    VISIT_PROFILE_SCOPE(VeriWhile, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     _ofs << PrintLevel(_nLevel) ;
@@ -718,6 +941,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriWhile, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriFor, node)
 {
+    VISIT_PROFILE_SCOPE(VeriFor, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     _ofs << PrintLevel(_nLevel) ;
@@ -759,6 +983,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriFor, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriWait, node)
 {
+    VISIT_PROFILE_SCOPE(VeriWait, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     _ofs << PrintLevel(_nLevel) ;
@@ -772,6 +997,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriWait, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriDisable, node)
 {
+    VISIT_PROFILE_SCOPE(VeriDisable, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     _ofs << PrintLevel(_nLevel) ;
@@ -782,6 +1008,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriDisable, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriEventTrigger, node)
 {
+    VISIT_PROFILE_SCOPE(VeriEventTrigger, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     _ofs << PrintLevel(_nLevel) ;
@@ -792,6 +1019,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriEventTrigger, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriSeqBlock, node)
 {
+    VISIT_PROFILE_SCOPE(VeriSeqBlock, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     _ofs << PrintLevel(_nLevel) ;
@@ -824,6 +1052,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriSeqBlock, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriParBlock, node)
 {
+    VISIT_PROFILE_SCOPE(VeriParBlock, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     _ofs << PrintLevel(_nLevel) ;
@@ -864,6 +1093,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriModuleItem, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriDataDecl, node)
 {
+    VISIT_PROFILE_SCOPE(VeriDataDecl, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     // Print direction (if there) :
@@ -943,6 +1173,7 @@ void PrettyPrintVisitor::PrettyPrintWOSemi(VeriDataDecl &node)
 }
 void PrettyPrintVisitor::VERI_VISIT(VeriNetDecl, node)
 {
+    VISIT_PROFILE_SCOPE(VeriNetDecl, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     _ofs << PrintLevel(_nLevel) ;
@@ -977,6 +1208,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriNetDecl, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriFunctionDecl, node)
 {
+    VISIT_PROFILE_SCOPE(VeriFunctionDecl, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     _ofs << PrintLevel(_nLevel) ;
@@ -1014,6 +1246,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriFunctionDecl, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriTaskDecl, node)
 {
+    VISIT_PROFILE_SCOPE(VeriTaskDecl, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     _ofs << PrintLevel(_nLevel) ;
@@ -1047,6 +1280,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriTaskDecl, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriDefParam, node)
 {
+    VISIT_PROFILE_SCOPE(VeriDefParam, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     _ofs << PrintLevel(_nLevel) ;
@@ -1068,6 +1302,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriDefParam, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriContinuousAssign, node)
 {
+    VISIT_PROFILE_SCOPE(VeriContinuousAssign, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     _ofs << PrintLevel(_nLevel) ;
@@ -1102,6 +1337,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriContinuousAssign, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriGateInstantiation, node)
 {
+    VISIT_PROFILE_SCOPE(VeriGateInstantiation, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     _ofs << PrintLevel(_nLevel) ;
@@ -1136,6 +1372,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriGateInstantiation, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriModuleInstantiation, node)
 {
+    VISIT_PROFILE_SCOPE(VeriModuleInstantiation, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     _ofs << PrintLevel(_nLevel) ;
@@ -1171,6 +1408,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriModuleInstantiation, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriSpecifyBlock, node)
 {
+    VISIT_PROFILE_SCOPE(VeriSpecifyBlock, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     _ofs << PrintLevel(_nLevel) ;
@@ -1188,6 +1426,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriSpecifyBlock, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriPathDecl, node)
 {
+    VISIT_PROFILE_SCOPE(VeriPathDecl, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     _ofs << PrintLevel(_nLevel) ;
@@ -1220,6 +1459,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriPathDecl, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriSystemTimingCheck, node)
 {
+    VISIT_PROFILE_SCOPE(VeriSystemTimingCheck, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     _ofs << PrintLevel(_nLevel) ;
@@ -1242,6 +1482,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriSystemTimingCheck, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriInitialConstruct, node)
 {
+    VISIT_PROFILE_SCOPE(VeriInitialConstruct, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     _ofs << PrintLevel(_nLevel) ;
@@ -1251,6 +1492,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriInitialConstruct, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriAlwaysConstruct, node)
 {
+    VISIT_PROFILE_SCOPE(VeriAlwaysConstruct, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     _ofs << PrintLevel(_nLevel) ;
@@ -1260,6 +1502,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriAlwaysConstruct, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriGenerateConstruct, node)
 {
+    VISIT_PROFILE_SCOPE(VeriGenerateConstruct, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     _ofs << PrintLevel(_nLevel) ;
@@ -1274,6 +1517,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriGenerateConstruct, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriGenerateConditional, node)
 {
+    VISIT_PROFILE_SCOPE(VeriGenerateConditional, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     _ofs << PrintLevel(_nLevel) ;
@@ -1293,6 +1537,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriGenerateConditional, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriGenerateCase, node)
 {
+    VISIT_PROFILE_SCOPE(VeriGenerateCase, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     _ofs << PrintLevel(_nLevel) ;
@@ -1317,6 +1562,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriGenerateCase, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriGenerateFor, node)
 {
+    VISIT_PROFILE_SCOPE(VeriGenerateFor, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     _ofs << PrintLevel(_nLevel) ;
@@ -1352,6 +1598,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriGenerateFor, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriGenerateBlock, node)
 {
+    VISIT_PROFILE_SCOPE(VeriGenerateBlock, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     _ofs << PrintLevel(_nLevel) ;
@@ -1375,6 +1622,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriGenerateBlock, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriTable, node)
 {
+    VISIT_PROFILE_SCOPE(VeriTable, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     _ofs << PrintLevel(_nLevel) ;
@@ -1396,6 +1644,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriTable, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriStrength, node)
 {
+    VISIT_PROFILE_SCOPE(VeriStrength, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     _ofs << "(" << PrintToken(node.GetLVal()) ;
@@ -1408,6 +1657,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriStrength, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriNetRegAssign, node)
 {
+    VISIT_PROFILE_SCOPE(VeriNetRegAssign, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     if (node.GetLValExpr()) node.GetLValExpr()->Accept(*this) ;
@@ -1419,6 +1669,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriNetRegAssign, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriInstId, node)
 {
+    VISIT_PROFILE_SCOPE(VeriInstId, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     if (node.GetName()) { _ofs << node.GetName() << " " ; }
@@ -1441,6 +1692,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriInstId, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriCaseItem, node)
 {
+    VISIT_PROFILE_SCOPE(VeriCaseItem, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     // Each item starts at a new line
@@ -1470,6 +1722,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriCaseItem, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriGenerateCaseItem, node)
 {
+    VISIT_PROFILE_SCOPE(VeriGenerateCaseItem, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     // Each item starts at a new line
@@ -1499,6 +1752,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriGenerateCaseItem, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriPath, node)
 {
+    VISIT_PROFILE_SCOPE(VeriPath, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     unsigned i ;
@@ -1537,6 +1791,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriPath, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriDelayOrEventControl, node)
 {
+    VISIT_PROFILE_SCOPE(VeriDelayOrEventControl, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     if (node.GetDelayControl()) {
@@ -1568,6 +1823,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriDelayOrEventControl, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriIdDef, node)
 {
+    VISIT_PROFILE_SCOPE(VeriIdDef, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     // NOTE: The following function VeriNode::PrintIdentifier is now the primary
@@ -1578,6 +1834,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriIdDef, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriVariable, node)
 {
+    VISIT_PROFILE_SCOPE(VeriVariable, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     // Print the id name with optional initial value and dimensions
@@ -1596,6 +1853,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriVariable, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriModuleId, node)
 {
+    VISIT_PROFILE_SCOPE(VeriModuleId, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     VERI_VISIT_NODE(VeriIdDef, static_cast<VeriIdDef&>(node)) ;
@@ -1603,6 +1861,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriModuleId, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriUdpId, node)
 {
+    VISIT_PROFILE_SCOPE(VeriUdpId, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     VERI_VISIT_NODE(VeriIdDef, static_cast<VeriIdDef&>(node)) ;
@@ -1610,6 +1869,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriUdpId, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriTaskId, node)
 {
+    VISIT_PROFILE_SCOPE(VeriTaskId, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     VERI_VISIT_NODE(VeriIdDef, static_cast<VeriIdDef&>(node)) ;
@@ -1617,6 +1877,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriTaskId, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriFunctionId, node)
 {
+    VISIT_PROFILE_SCOPE(VeriFunctionId, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     VERI_VISIT_NODE(VeriIdDef, static_cast<VeriIdDef&>(node)) ;
@@ -1624,6 +1885,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriFunctionId, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriGenVarId, node)
 {
+    VISIT_PROFILE_SCOPE(VeriGenVarId, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     VERI_VISIT_NODE(VeriIdDef, static_cast<VeriIdDef&>(node)) ;
@@ -1631,6 +1893,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriGenVarId, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriBlockId, node)
 {
+    VISIT_PROFILE_SCOPE(VeriBlockId, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     VERI_VISIT_NODE(VeriIdDef, static_cast<VeriIdDef&>(node)) ;
@@ -1638,6 +1901,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriBlockId, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriParamId, node)
 {
+    VISIT_PROFILE_SCOPE(VeriParamId, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     // Print the id name with initial value
@@ -1648,6 +1912,249 @@ void PrettyPrintVisitor::VERI_VISIT(VeriParamId, node)
     }
 }
 
+/*-----------------------------------------------------------------*/
+//        Expression output : one ExpressionWalker event at a time
+/*-----------------------------------------------------------------*/
+
+unsigned PrettyPrintVisitor::StepList(const char *open, const char *close, const Array *list, unsigned k, VeriExpression *&child)
+{
+    if (!k) _ofs << open ;
+    if (list && (k < list->Size())) {
+        if (k) _ofs << "," ;
+        child = (VeriExpression*)list->At(k) ;
+        return 1 ;
+    }
+    _ofs << close ;
+    return 0 ;
+}
+
+unsigned PrettyPrintVisitor::PrintStep(VeriExpression &node, unsigned class_id, unsigned step, VeriExpression *&child)
+{
+    switch (class_id) {
+    case ID_VERIIDREF :
+        VERI_VISIT_NODE(VeriIdRef, static_cast<VeriIdRef&>(node)) ;
+        return 0 ;
+
+    case ID_VERICONSTVAL :
+        VERI_VISIT_NODE(VeriConstVal, static_cast<VeriConstVal&>(node)) ;
+        return 0 ;
+
+    case ID_VERIINTVAL :
+        VERI_VISIT_NODE(VeriIntVal, static_cast<VeriIntVal&>(node)) ;
+        return 0 ;
+
+    case ID_VERIINDEXEDID :
+    {
+        VeriIndexedId &id = static_cast<VeriIndexedId&>(node) ;
+        switch (step) {
+        case 0 : child = id.GetPrefix() ; return 1 ;
+        case 1 : _ofs << "[" ; child = id.GetIndexExpr() ; return 1 ;
+        default : _ofs << "]" ; return 0 ;
+        }
+    }
+
+    case ID_VERISELECTEDNAME :
+    {
+        VeriSelectedName &name = static_cast<VeriSelectedName&>(node) ;
+        if (!step) {
+            child = name.GetPrefix() ;
+            return 1 ;
+        }
+        _ofs << "." ;
+        PrintIdentifier(_ofs, name.GetSuffix()) ;
+        return 0 ;
+    }
+
+    case ID_VERIINDEXEDMEMORYID :
+    {
+        VeriIndexedMemoryId &id = static_cast<VeriIndexedMemoryId&>(node) ;
+        if (!step) {
+            child = id.GetPrefix() ;
+            return 1 ;
+        }
+        unsigned k = step - 1 ;
+        if (k) _ofs << "]" ;
+        if (id.GetIndexes() && (k < id.GetIndexes()->Size())) {
+            _ofs << "[" ;
+            child = (VeriExpression*)id.GetIndexes()->At(k) ;
+            return 1 ;
+        }
+        return 0 ;
+    }
+
+    case ID_VERICONCAT :
+        return StepList("{", "}", static_cast<VeriConcat&>(node).GetExpressions(), step, child) ;
+
+    case ID_VERIMULTICONCAT :
+    {
+        VeriMultiConcat &concat = static_cast<VeriMultiConcat&>(node) ;
+        if (!step) {
+            _ofs << "{" ;
+            child = concat.GetRepeat() ;
+            return 1 ;
+        }
+        return StepList("{", "}}", concat.GetExpressions(), step - 1, child) ;
+    }
+
+    case ID_VERIFUNCTIONCALL :
+    {
+        VeriFunctionCall &call = static_cast<VeriFunctionCall&>(node) ;
+        if (!step) {
+            child = call.GetFunctionName() ;
+            return 1 ;
+        }
+        if (!call.GetArgs()) return 0 ;
+        return StepList("(", ")", call.GetArgs(), step - 1, child) ;
+    }
+
+    case ID_VERISYSTEMFUNCTIONCALL :
+    {
+        VeriSystemFunctionCall &call = static_cast<VeriSystemFunctionCall&>(node) ;
+        // System function call names can't be escaped or hierarchical, so don't call VeriNode::PrintIdentifier.
+        if (!step) _ofs << "$" << call.GetName() ;
+        if (!call.GetArgs()) return 0 ;
+        return StepList("(", ")", call.GetArgs(), step, child) ;
+    }
+
+    case ID_VERIMINTYPMAXEXPR :
+    {
+        VeriMinTypMaxExpr &expr = static_cast<VeriMinTypMaxExpr&>(node) ;
+        switch (step) {
+        case 0 : _ofs << "(" ; child = expr.GetMinExpr() ; return 1 ;
+        case 1 : _ofs << ":" ; child = expr.GetTypExpr() ; return 1 ;
+        case 2 : _ofs << ":" ; child = expr.GetMaxExpr() ; return 1 ;
+        default : _ofs << ")" ; return 0 ;
+        }
+    }
+
+    case ID_VERIUNARYOPERATOR :
+    {
+        VeriUnaryOperator &oper = static_cast<VeriUnaryOperator&>(node) ;
+        if (!step) {
+            // Parenthesize the result to get precedence right
+            _ofs << PrintToken(oper.OperType()) << "(" ;
+            child = oper.GetArg() ;
+            return 1 ;
+        }
+        _ofs << ")" ;
+        return 0 ;
+    }
+
+    case ID_VERIBINARYOPERATOR :
+    {
+        VeriBinaryOperator &oper = static_cast<VeriBinaryOperator&>(node) ;
+        if (IsChain(oper)) {
+            // a + b + c ... : one pair of parentheses around the whole chain
+            if (!step) {
+                Array *operands = new Array(8) ;
+                FlattenChain(&oper, oper.OperType(), *operands) ;
+                _chains.InsertLast(operands) ;
+                _ofs << "(" ;
+            }
+            Array *operands = (Array*)_chains.GetLast() ;
+            if (step < operands->Size()) {
+                if (step) _ofs << " " << PrintToken(oper.OperType()) << " " ;
+                child = (VeriExpression*)operands->At(step) ;
+                return 1 ;
+            }
+            _ofs << ")" ;
+            delete (Array*)_chains.RemoveLast() ;
+            return 0 ;
+        }
+        switch (step) {
+        // Parenthesize the result to get precedence right
+        case 0 : _ofs << "(" ; child = oper.GetLeft() ; return 1 ;
+        case 1 : _ofs << " " << PrintToken(oper.OperType()) << " " ; child = oper.GetRight() ; return 1 ;
+        default : _ofs << ")" ; return 0 ;
+        }
+    }
+
+    case ID_VERIQUESTIONCOLON :
+    {
+        VeriQuestionColon &expr = static_cast<VeriQuestionColon&>(node) ;
+        switch (step) {
+        // Parenthesize the result to get precedence right
+        case 0 : _ofs << "(" ; child = expr.GetIfExpr() ; return 1 ;
+        case 1 : _ofs << " ? " ; child = expr.GetThenExpr() ; return 1 ;
+        case 2 : _ofs << " : " ; child = expr.GetElseExpr() ; return 1 ;
+        default : _ofs << ")" ; return 0 ;
+        }
+    }
+
+    case ID_VERIEVENTEXPRESSION :
+    {
+        VeriEventExpression &expr = static_cast<VeriEventExpression&>(node) ;
+        if (!step) {
+            _ofs << PrintToken(expr.GetEdgeToken()) << " " ;
+            child = expr.GetExpr() ;
+            return 1 ;
+        }
+        return 0 ;
+    }
+
+    case ID_VERIPORTCONNECT :
+    {
+        if (!step) {
+            if (node.GetNamedFormal()) {
+                _ofs << "." ; PrintIdentifier(_ofs, node.GetNamedFormal()) ; _ofs << "(" ;
+            }
+            child = node.GetConnection() ;
+            return 1 ;
+        }
+        // named connection always has ()
+        if (node.GetNamedFormal()) _ofs << ")" ;
+        return 0 ;
+    }
+
+    default :
+        // Everything else does not nest (deeply) : print it through its visit method
+        node.Accept(*this) ;
+        return 0 ;
+    }
+}
+
+#ifdef VISIT_PROFILE
+// Node class printed by PrintStep itself, 0 for those printed through their visit method
+static const char *WalkedClassName(unsigned class_id)
+{
+    switch (class_id) {
+    case ID_VERIINDEXEDID :             return "VeriIndexedId" ;
+    case ID_VERISELECTEDNAME :          return "VeriSelectedName" ;
+    case ID_VERIINDEXEDMEMORYID :       return "VeriIndexedMemoryId" ;
+    case ID_VERICONCAT :                return "VeriConcat" ;
+    case ID_VERIMULTICONCAT :           return "VeriMultiConcat" ;
+    case ID_VERIFUNCTIONCALL :          return "VeriFunctionCall" ;
+    case ID_VERISYSTEMFUNCTIONCALL :    return "VeriSystemFunctionCall" ;
+    case ID_VERIMINTYPMAXEXPR :         return "VeriMinTypMaxExpr" ;
+    case ID_VERIUNARYOPERATOR :         return "VeriUnaryOperator" ;
+    case ID_VERIBINARYOPERATOR :        return "VeriBinaryOperator" ;
+    case ID_VERIQUESTIONCOLON :         return "VeriQuestionColon" ;
+    case ID_VERIEVENTEXPRESSION :       return "VeriEventExpression" ;
+    case ID_VERIPORTCONNECT :           return "VeriPortConnect" ;
+    default :                           return 0 ;
+    }
+}
+#endif
+
+void PrettyPrintVisitor::Descend(VeriExpression &child)
+{
+    child.Accept(*this) ;
+}
+
+unsigned PrettyPrintVisitor::Step(VeriExpression &node, unsigned class_id, unsigned step, VeriExpression *&child)
+{
+#ifdef VISIT_PROFILE
+    // A walked node is visited from its first step to the step that ends it
+    const char *node_class = WalkedClassName(class_id) ;
+    if (node_class && !step) VisitProfiler::Enter(node_class, _bytes.Count()) ;
+    unsigned more = PrintStep(node, class_id, step, child) ;
+    if (node_class && !more) VisitProfiler::Exit(_bytes.Count()) ;
+    return more ;
+#else
+    return PrintStep(node, class_id, step, child) ;
+#endif
+}
+
 /*-----------------------------------------------------------------*/
 //        Visit Methods : Class details in VeriExpression.h
 /*-----------------------------------------------------------------*/
@@ -1659,191 +2166,109 @@ void PrettyPrintVisitor::VERI_VISIT(VeriExpression, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriIdRef, node)
 {
+    VISIT_PROFILE_SCOPE(VeriIdRef, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     PrintIdentifier(_ofs, (node.GetName()) ? node.GetName() : node.FullId()->GetName()) ;
 }
 
+// From here on, the visit methods of expressions that nest start a walk :
+// they are printed without recursion, see Step()
+
 void PrettyPrintVisitor::VERI_VISIT(VeriIndexedId, node)
 {
     if (!_bFileGood) return ; // file stream is not good
 
-    if (node.GetPrefix()) node.GetPrefix()->Accept(*this) ;
-
-    _ofs << "[" ;
-    node.GetIndexExpr()->Accept(*this) ;
-    _ofs << "]" ;
+    Walk(&node, ID_VERIINDEXEDID) ;
 }
 
 void PrettyPrintVisitor::VERI_VISIT(VeriSelectedName, node)
 {
     if (!_bFileGood) return ; // file stream is not good
 
-    if (node.GetPrefix()) node.GetPrefix()->Accept(*this) ;
-
-    _ofs << "." ;
-    PrintIdentifier(_ofs, node.GetSuffix()) ;
+    Walk(&node, ID_VERISELECTEDNAME) ;
 }
 
 void PrettyPrintVisitor::VERI_VISIT(VeriIndexedMemoryId, node)
 {
     if (!_bFileGood) return ; // file stream is not good
 
-    if (node.GetPrefix()) node.GetPrefix()->Accept(*this) ;
-
-    unsigned i ;
-    VeriExpression *index ;
-    FOREACH_ARRAY_ITEM(node.GetIndexes(), i, index) {
-        _ofs << "[" ;
-        index->Accept(*this) ;
-        _ofs << "]" ;
-    }
+    Walk(&node, ID_VERIINDEXEDMEMORYID) ;
 }
 
 void PrettyPrintVisitor::VERI_VISIT(VeriConcat, node)
 {
     if (!_bFileGood) return ; // file stream is not good
 
-    _ofs << "{" ;
-    unsigned i ;
-    VeriExpression *expr ;
-    FOREACH_ARRAY_ITEM(node.GetExpressions(), i, expr) {
-        if (i) _ofs << "," ;
-        if (!expr) continue ;
-        expr->Accept(*this);
-    }
-    _ofs << "}" ;
+    Walk(&node, ID_VERICONCAT) ;
 }
 
 void PrettyPrintVisitor::VERI_VISIT(VeriMultiConcat, node)
 {
     if (!_bFileGood) return ; // file stream is not good
 
-    _ofs << "{" ;
-    node.GetRepeat()->Accept(*this) ;
-    _ofs << "{" ;
-    unsigned i ;
-    VeriExpression *expr ;
-    FOREACH_ARRAY_ITEM(node.GetExpressions(), i, expr) {
-        if (i) _ofs << "," ;
-        if (!expr) continue ;
-        if (expr) expr->Accept(*this) ;
-    }
-    _ofs << "}}" ;
+    Walk(&node, ID_VERIMULTICONCAT) ;
 }
 
 void PrettyPrintVisitor::VERI_VISIT(VeriFunctionCall, node)
 {
     if (!_bFileGood) return ; // file stream is not good
 
-    if (node.GetFunctionName()) node.GetFunctionName()->Accept(*this) ;
-
-    if (node.GetArgs()) {
-        _ofs << "(" ;
-        unsigned i ;
-        VeriExpression *expr ;
-        FOREACH_ARRAY_ITEM(node.GetArgs(), i, expr) {
-            if (i) _ofs << "," ;
-            if (!expr) continue ;
-            expr->Accept(*this) ;
-        }
-        _ofs << ")" ;
-    }
+    Walk(&node, ID_VERIFUNCTIONCALL) ;
 }
 
 void PrettyPrintVisitor::VERI_VISIT(VeriSystemFunctionCall, node)
 {
     if (!_bFileGood) return ; // file stream is not good
 
-    // System function call names can't be escaped or hierarchical, so don't call VeriNode::PrintIdentifier.
-    _ofs << "$" << node.GetName() ;
-    if (node.GetArgs()) {
-        _ofs << "(" ;
-        unsigned i ;
-        VeriExpression *expr ;
-        FOREACH_ARRAY_ITEM(node.GetArgs(), i, expr) {
-            if (i) _ofs << "," ;
-            if (!expr) continue ;
-            expr->Accept(*this) ;
-        }
-        _ofs << ")" ;
-    }
+    Walk(&node, ID_VERISYSTEMFUNCTIONCALL) ;
 }
 
 void PrettyPrintVisitor::VERI_VISIT(VeriMinTypMaxExpr, node)
 {
     if (!_bFileGood) return ; // file stream is not good
 
-    _ofs << "(" ;
-    if (node.GetMinExpr()) node.GetMinExpr()->Accept(*this) ;
-    _ofs << ":" ;
-    if (node.GetTypExpr()) node.GetTypExpr()->Accept(*this) ;
-    _ofs << ":" ;
-    if (node.GetMaxExpr()) node.GetMaxExpr()->Accept(*this) ;
-    _ofs << ")" ;
+    Walk(&node, ID_VERIMINTYPMAXEXPR) ;
 }
 
 void PrettyPrintVisitor::VERI_VISIT(VeriUnaryOperator, node)
 {
     if (!_bFileGood) return ; // file stream is not good
 
-    _ofs << PrintToken(node.OperType()) ;
-    // Parenthesize the result to get precedence right
-    _ofs << "(" ;
-    if (node.GetArg()) node.GetArg()->Accept(*this) ;
-    _ofs << ")" ;
+    Walk(&node, ID_VERIUNARYOPERATOR) ;
 }
 
 void PrettyPrintVisitor::VERI_VISIT(VeriBinaryOperator, node)
 {
     if (!_bFileGood) return ; // file stream is not good
 
-    // Parenthesize the result to get precedence right
-    _ofs << "(" ;
-    if (node.GetLeft()) node.GetLeft()->Accept(*this) ;
-    _ofs << " " << PrintToken(node.OperType()) << " " ;
-    if (node.GetRight()) node.GetRight()->Accept(*this) ;
-    _ofs << ")" ;
+    Walk(&node, ID_VERIBINARYOPERATOR) ;
 }
 
 void PrettyPrintVisitor::VERI_VISIT(VeriQuestionColon, node)
 {
     if (!_bFileGood) return ; // file stream is not good
 
-    // Parenthesize the result to get precedence right
-    _ofs << "(" ;
-    if (node.GetIfExpr()) node.GetIfExpr()->Accept(*this) ;
-    _ofs << " ? " ;
-    if (node.GetThenExpr()) node.GetThenExpr()->Accept(*this) ;
-    _ofs << " : " ;
-    if (node.GetElseExpr()) node.GetElseExpr()->Accept(*this) ;
-    _ofs << ")" ;
+    Walk(&node, ID_VERIQUESTIONCOLON) ;
 }
 
 void PrettyPrintVisitor::VERI_VISIT(VeriEventExpression, node)
 {
     if (!_bFileGood) return ; // file stream is not good
 
-    _ofs << PrintToken(node.GetEdgeToken()) << " " ;
-    if (node.GetExpr()) node.GetExpr()->Accept(*this) ;
+    Walk(&node, ID_VERIEVENTEXPRESSION) ;
 }
 
 void PrettyPrintVisitor::VERI_VISIT(VeriPortConnect, node)
 {
     if (!_bFileGood) return ; // file stream is not good
 
-    if (node.GetNamedFormal()) {
-        _ofs << "." ; PrintIdentifier(_ofs, node.GetNamedFormal()) ; _ofs << "(" ;
-    }
-    if (node.GetConnection()) {
-        node.GetConnection()->Accept(*this) ;
-    }
-    // named connection always has ()
-    if (node.GetNamedFormal()) _ofs << ")" ;
+    Walk(&node, ID_VERIPORTCONNECT) ;
 }
 
 void PrettyPrintVisitor::VERI_VISIT(VeriPortOpen, node)
 {
+    VISIT_PROFILE_SCOPE(VeriPortOpen, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     // Verilog prints nothing for an open port
@@ -1851,6 +2276,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriPortOpen, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriAnsiPortDecl, node)
 {
+    VISIT_PROFILE_SCOPE(VeriAnsiPortDecl, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     // Start on a newline :
@@ -1872,6 +2298,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriAnsiPortDecl, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriTimingCheckEvent, node)
 {
+    VISIT_PROFILE_SCOPE(VeriTimingCheckEvent, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     if (node.GetEdgeToken()) {
@@ -1891,6 +2318,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriTimingCheckEvent, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriRange, node)
 {
+    VISIT_PROFILE_SCOPE(VeriRange, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     // []'s are printed in the caller of range
@@ -1914,6 +2342,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriRange, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriDataType, node)
 {
+    VISIT_PROFILE_SCOPE(VeriDataType, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
     if (node.GetType()) _ofs << PrintToken(node.GetType()) << " " ;
     if (node.GetSigning()) _ofs << PrintToken(node.GetSigning()) << " " ;
@@ -1930,11 +2359,13 @@ void PrettyPrintVisitor::VERI_VISIT(VeriDataType, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriConst, node)
 {
+    VISIT_PROFILE_SCOPE(VeriConst, _bytes) ;
     // Do nothing
 }
 
 void PrettyPrintVisitor::VERI_VISIT(VeriIntVal, node)
 {
+    VISIT_PROFILE_SCOPE(VeriIntVal, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     _ofs << node.GetNum() ;
@@ -1942,6 +2373,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriIntVal, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriRealVal, node)
 {
+    VISIT_PROFILE_SCOPE(VeriRealVal, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     char *image = Strings::dtoa(node.GetNum()) ;
@@ -1953,6 +2385,7 @@ void PrettyPrintVisitor::VERI_VISIT(VeriRealVal, node)
 
 void PrettyPrintVisitor::VERI_VISIT(VeriConstVal, node)
 {
+    VISIT_PROFILE_SCOPE(VeriConstVal, _bytes) ;
     if (!_bFileGood) return ; // file stream is not good
 
     // Print as a sized bit-array
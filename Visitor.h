@@ -20,6 +20,9 @@
 #define _VERIFIC_VERI_PRETTYPRINT_VISITOR_H_
 
 #include "VeriVisitor.h"    // Visitor base class definition
+#include "ExpressionWalker.h" // Iterative expression traversal
+#include "VisitProfiler.h"  // Optional visit profile (VISIT_PROFILE)
+#include "Array.h"          // Make dynamic array class Array available
 
 #include <fstream>
 
@@ -29,12 +32,17 @@ namespace Verific { // start definitions in verific namespace
 
 /* -------------------------------------------------------------------------- */
 
-class PrettyPrintVisitor : public VeriVisitor
+class PrettyPrintVisitor : public VeriVisitor, private ExpressionWalker
 {
 public:
     PrettyPrintVisitor(char *pFileName);
+    explicit PrettyPrintVisitor(std::ostream &os);   // Print to 'os' (a string stream, say)
     virtual ~PrettyPrintVisitor();
 
+    // Print sub-expressions by recursion through Accept(), as this visitor
+    // did before it walked them (only to compare the two, see bench_walker)
+    void SetRecursive(unsigned recursive) { ExpressionWalker::SetRecursive(recursive) ; }
+
 /* ================================================================= */
 /*                         VISIT METHODS                             */
 /* ================================================================= */
@@ -150,9 +158,16 @@ public:
     bool IsFileGood() const { return _bFileGood; }
 
 private:
-    std::ofstream    _ofs;         // Output file stream
+    std::ofstream    _file;        // Output file, when printing to a file
+    std::ostream    &_ofs;         // Output stream : _file, or the caller's stream
     bool            _bFileGood;    // States whether the file was opened correctly
     unsigned        _nLevel;       // Indentation level - used for output blank spaces
+    Array           _chains;       // Operands (Array*) of the operator chains being printed, innermost last
+#ifdef VISIT_PROFILE
+    VisitByteCounter _bytes;       // Bytes written to _ofs, for the visit profile
+#endif
+
+    void Init();
 
     // _nLevel modifiers
     void IncTabLevel(unsigned nIncVal)     { _nLevel += nIncVal ; }    // Increase indentation level
@@ -174,6 +189,45 @@ private:
     // Print token characters (definition below)
     static const char* PrintToken(unsigned veri_token);
 
+    /* ================================================================= */
+    /*                 STRUCTURAL (NETLIST) MODULE OUTPUT                */
+    /* ================================================================= */
+
+    // Print the items of a module that only holds declarations, assignments and
+    // instantiations, in order, with each run of instantiations of one cell in a single statement
+    void PrintStructuralItems(const Array *items);
+
+    // Cell name (or gate keyword) of an instantiation that may join a run, 0 if
+    // it keeps its own statement : parameters, strengths, delays or attributes
+    static const char *GroupKey(const VeriModuleItem &mi, unsigned &is_gate);
+
+    // Print the 'instances' of a run that starts with instantiation 'first'
+    void PrintGroup(const VeriModuleItem &first, const Array &instances);
+
+    // Print one grouped instantiation statement. 'cell' (if known) supplies the port order.
+    void PrintInstanceGroup(const char *keyword, unsigned is_module, const Array &instances, const VeriModule *cell);
+
+    // Print a single instance, using the pre-formatted '.formal(' prefixes where the port order matches
+    void PrintGroupedInstance(const VeriInstId &inst, const Array &formals, const Array &prefixes);
+
+    // Print a port connection (plain identifiers without going through Accept)
+    void PrintConnection(VeriExpression *expr);
+
+    /* ================================================================= */
+    /*                 ITERATIVE EXPRESSION OUTPUT                       */
+    /* ================================================================= */
+
+    // Print one event of an expression walk. The visit methods of nested
+    // expressions go through here, so expression depth costs no C stack.
+    virtual unsigned Step(VeriExpression &node, unsigned class_id, unsigned step, VeriExpression *&child);
+    unsigned PrintStep(VeriExpression &node, unsigned class_id, unsigned step, VeriExpression *&child);
+
+    // Recursive walks (SetRecursive) : visit 'child' through Accept()
+    virtual void Descend(VeriExpression &child);
+
+    // Print element 'k' of a comma separated 'list' (opened by 'open', closed by 'close')
+    unsigned StepList(const char *open, const char *close, const Array *list, unsigned k, VeriExpression *&child);
+
     // Prevent the compiler from implementing the following
     PrettyPrintVisitor(const PrettyPrintVisitor &node);
     PrettyPrintVisitor& operator=(const PrettyPrintVisitor &rhs);
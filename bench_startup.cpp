@@ -0,0 +1,146 @@
+/*
+ *
+ * Benchmark of the startup time of the translator binaries.
+ *
+ * Runs every binary given on a tiny design (or on -design <file>, with
+ * -top <module>) -runs times, and reports the time from fork to the first
+ * line of the UCLID model on its standard output, and to its exit. Meant to
+ * compare the default build with the FAST_START one :
+ *
+ *     make && make FAST_START=1 && make bench_startup
+ *     bench_startup-linux ./iterate_parse_tree_prettyprint-linux ./iterate_parse_tree_prettyprint-fast-linux
+ *
+ * Does not link Verific itself.
+ *
+*/
+
+#include <algorithm>        // std::sort
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <sys/wait.h>       // waitpid
+#include <unistd.h>         // fork, pipe, execv, getpid
+
+static double Seconds()
+{
+    struct timespec now ;
+    clock_gettime(CLOCK_MONOTONIC, &now) ;
+    return (double)now.tv_sec + (double)now.tv_nsec * 1e-9 ;
+}
+
+static unsigned WriteDesign(const char *file_name)
+{
+    std::ofstream f(file_name) ;
+    if (!f) return 0 ;
+    f << "module tiny (a, b, y) ;\n" ;
+    f << "    input [7:0] a, b ;\n" ;
+    f << "    output [7:0] y ;\n" ;
+    f << "    assign y = a & b ;\n" ;
+    f << "endmodule\n" ;
+    return f.good() ? 1 : 0 ;
+}
+
+// Run 'binary' once. Returns 0 if it could not be run or failed.
+static unsigned RunOnce(const char *binary, const char *top, const char *design, double &first_output, double &exit_time)
+{
+    int fds[2] ;
+    if (pipe(fds)) return 0 ;
+
+    double start = Seconds() ;
+    pid_t pid = fork() ;
+    if (pid < 0) return 0 ;
+    if (pid == 0) {
+        (void) dup2(fds[1], 1) ;
+        (void) close(fds[0]) ;
+        (void) close(fds[1]) ;
+        execl(binary, binary, "-top", top, design, (char*)0) ;
+        _exit(127) ;
+    }
+    (void) close(fds[1]) ;
+
+    // Verific prints its messages on standard output too : wait for the model
+    first_output = 0.0 ;
+    std::string seen ;
+    char buffer[4096] ;
+    ssize_t n ;
+    while ((n = read(fds[0], buffer, sizeof(buffer))) > 0) {
+        if (first_output > 0.0) continue ;
+        seen.append(buffer, (size_t)n) ;
+        if (!seen.compare(0, 7, "module ") || (seen.find("\nmodule ") != std::string::npos)) first_output = Seconds() - start ;
+    }
+    (void) close(fds[0]) ;
+
+    int status = 0 ;
+    (void) waitpid(pid, &status, 0) ;
+    exit_time = Seconds() - start ;
+    return (WIFEXITED(status) && !WEXITSTATUS(status) && (first_output > 0.0)) ? 1 : 0 ;
+}
+
+static double Median(std::vector<double> &times)
+{
+    std::sort(times.begin(), times.end()) ;
+    return times[times.size() / 2] ;
+}
+
+int main(int argc, char **argv)
+{
+    unsigned long runs = 20 ;
+    const char *design = 0 ;
+    const char *top = "tiny" ;
+    std::vector<const char*> binaries ;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-runs") && (i + 1 < argc)) {
+            runs = strtoul(argv[++i], 0, 10) ;
+        } else if (!strcmp(argv[i], "-design") && (i + 1 < argc)) {
+            design = argv[++i] ;
+        } else if (!strcmp(argv[i], "-top") && (i + 1 < argc)) {
+            top = argv[++i] ;
+        } else if (argv[i][0] == '-') {
+            binaries.clear() ;
+            break ;
+        } else {
+            binaries.push_back(argv[i]) ;
+        }
+    }
+    if (binaries.empty()) {
+        fprintf(stderr, "usage : %s [-runs <n>] [-design <file> -top <module>] <binary> ...\n", argv[0]) ;
+        return 1 ;
+    }
+    if (!runs) runs = 1 ;
+
+    char file_name[64] ;
+    if (!design) {
+        snprintf(file_name, sizeof(file_name), "/tmp/bench_startup_%d.v", (int)getpid()) ;
+        if (!WriteDesign(file_name)) {
+            fprintf(stderr, "cannot write %s\n", file_name) ;
+            return 1 ;
+        }
+        design = file_name ;
+    }
+
+    unsigned ok = 1 ;
+    printf("%-48s %16s %16s\n", "binary (median of runs)", "first model ms", "exit ms") ;
+    for (size_t b = 0; b < binaries.size(); b++) {
+        std::vector<double> first_times ;
+        std::vector<double> exit_times ;
+        for (unsigned long r = 0; r < runs; r++) {
+            double first_output, exit_time ;
+            if (!RunOnce(binaries[b], top, design, first_output, exit_time)) break ;
+            first_times.push_back(first_output) ;
+            exit_times.push_back(exit_time) ;
+        }
+        if (first_times.size() < runs) {
+            printf("%-48s %16s %16s\n", binaries[b], "failed", "failed") ;
+            ok = 0 ;
+            continue ;
+        }
+        printf("%-48s %16.2f %16.2f\n", binaries[b], Median(first_times) * 1e3, Median(exit_times) * 1e3) ;
+    }
+
+    if (design == file_name) (void) unlink(file_name) ;
+    return (ok) ? 0 : 1 ;
+}
@@ -0,0 +1,156 @@
+/*
+ *
+ * Benchmark of the pretty-printer on deeply nested expressions.
+ *
+ * Writes a module with a '-' chain of the given depth (left-associative, so
+ * the parser does not nest, but the expression tree does), a '^' chain (which
+ * is printed flattened) and a concatenation of the same length, and a second
+ * module with a right-leaning ?: chain (a mux tree as synthesis writes it) of
+ * that depth. Analyzes them and times PrettyPrintVisitor, which walks
+ * expressions iteratively (ExpressionWalker). Up to -recursive <depth> the
+ * same visitor is also timed printing sub-expressions by recursion through
+ * Accept(), as it did before (SetRecursive). Deeper than that it would
+ * overflow the stack.
+ *
+ * Built with VISIT_PROFILE (make VISIT_PROFILE=1 bench_walker), -profile <n>
+ * prints the <n> node classes the iterative printer spent most time in.
+ *
+ *     bench_walker-linux [-depth <n>] [-recursive <n>] [-profile <n>]
+ *
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <unistd.h>         // getpid
+
+#include "Message.h"
+#include "veri_file.h"
+#include "VeriModule.h"
+
+#include "Visitor.h"        // PrettyPrintVisitor
+
+#ifdef VERIFIC_NAMESPACE
+using namespace Verific ;
+#endif
+
+static double Seconds()
+{
+    struct timespec now ;
+    clock_gettime(CLOCK_MONOTONIC, &now) ;
+    return (double)now.tv_sec + (double)now.tv_nsec * 1e-9 ;
+}
+
+// Module 'deep' : y = x - x - ..., p = x ^ x ^ ... (depth terms), z = {x, x, ...} (depth bits)
+static unsigned WriteDesign(const char *file_name, unsigned long depth)
+{
+    std::ofstream f(file_name) ;
+    if (!f) return 0 ;
+    f << "module deep (x, y, p, z) ;\n" ;
+    f << "    input [31:0] x ;\n" ;
+    f << "    output [31:0] y, p ;\n" ;
+    f << "    output [" << depth - 1 << ":0] z ;\n" ;
+    f << "    assign y = x" ;
+    for (unsigned long i = 1; i < depth; i++) f << ((i % 16) ? " - x" : "\n        - x") ;
+    f << " ;\n" ;
+    f << "    assign p = x" ;
+    for (unsigned long i = 1; i < depth; i++) f << ((i % 16) ? " ^ x" : "\n        ^ x") ;
+    f << " ;\n" ;
+    f << "    assign z = {x[0]" ;
+    for (unsigned long i = 1; i < depth; i++) f << ((i % 16) ? ", x[0]" : ",\n        x[0]") ;
+    f << "} ;\n" ;
+    f << "endmodule\n" ;
+    return f.good() ? 1 : 0 ;
+}
+
+// Module 'mux' : c = x[0] ? x : x[1] ? x : ... : x (depth conditions), nested to the right
+static unsigned WriteMux(const char *file_name, unsigned long depth)
+{
+    std::ofstream f(file_name) ;
+    if (!f) return 0 ;
+    f << "module mux (x, c) ;\n" ;
+    f << "    input [31:0] x ;\n" ;
+    f << "    output [31:0] c ;\n" ;
+    f << "    assign c =" ;
+    for (unsigned long i = 0; i < depth; i++) f << ((i % 8) ? " x[" : "\n        x[") << (i % 32) << "] ? x :" ;
+    f << " x ;\n" ;
+    f << "endmodule\n" ;
+    return f.good() ? 1 : 0 ;
+}
+
+// Write, analyze and return module 'name' (0 on error)
+static VeriModule *Generate(const char *name, unsigned (*write)(const char*, unsigned long), unsigned long depth)
+{
+    char file_name[64] ;
+    snprintf(file_name, sizeof(file_name), "/tmp/bench_walker_%s_%d.v", name, (int)getpid()) ;
+    if (!write(file_name, depth)) {
+        Message::Error(0, "cannot write ", file_name) ;
+        return 0 ;
+    }
+    double start = Seconds() ;
+    unsigned ok = veri_file::Analyze(file_name, veri_file::VERILOG_2K) ;
+    (void) unlink(file_name) ;
+    VeriModule *module = (ok) ? veri_file::GetModule(name) : 0 ;
+    if (!module) {
+        Message::Error(0, "cannot analyze the generated module ", name) ;
+        return 0 ;
+    }
+    printf("%s, depth %lu : analyzed in %.3f s\n", name, depth, Seconds() - start) ;
+    return module ;
+}
+
+// Pretty-print 'module' to /dev/null, by recursion if 'recursive' is set
+static void TimePrint(VeriModule *module, unsigned recursive)
+{
+    char out_name[] = "/dev/null" ;
+    double start = Seconds() ;
+    {
+        PrettyPrintVisitor printer(out_name) ;
+        printer.SetRecursive(recursive) ;
+        module->Accept(printer) ;
+    }
+    printf("%s %s pretty-print : %.3f s\n", module->Name(), (recursive) ? "recursive" : "iterative", Seconds() - start) ;
+}
+
+int main(int argc, char **argv)
+{
+    unsigned long depth = 1000000 ;
+    unsigned long recursive_limit = 20000 ;
+    unsigned long profile_top = 0 ;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-depth") && (i + 1 < argc)) {
+            depth = strtoul(argv[++i], 0, 10) ;
+        } else if (!strcmp(argv[i], "-recursive") && (i + 1 < argc)) {
+            recursive_limit = strtoul(argv[++i], 0, 10) ;
+        } else if (!strcmp(argv[i], "-profile") && (i + 1 < argc)) {
+            profile_top = strtoul(argv[++i], 0, 10) ;
+        } else {
+            fprintf(stderr, "usage : %s [-depth <n>] [-recursive <n>] [-profile <n>]\n", argv[0]) ;
+            return 1 ;
+        }
+    }
+    if (!depth) depth = 1 ;
+
+    VeriModule *modules[2] = { Generate("deep", WriteDesign, depth), Generate("mux", WriteMux, depth) } ;
+    if (!modules[0] || !modules[1]) return 1 ;
+
+    for (unsigned m = 0; m < 2; m++) TimePrint(modules[m], 0) ;
+#ifdef VISIT_PROFILE
+    if (profile_top) VisitProfiler::Report(std::cout, (unsigned)profile_top) ;
+#else
+    if (profile_top) printf("visit profile : not built in (make VISIT_PROFILE=1)\n") ;
+#endif
+
+    if (depth <= recursive_limit) {
+        for (unsigned m = 0; m < 2; m++) TimePrint(modules[m], 1) ;
+    } else {
+        printf("recursive pretty-print : skipped above depth %lu\n", recursive_limit) ;
+    }
+
+    // The parse tree is not deleted : its destructors recurse as deep as the expression
+    fflush(stdout) ;
+    _exit(0) ;
+}
@@ -0,0 +1,126 @@
+/*
+ *
+ * Checks of the canonical hashes (see UclidCanonicalizer), without Verific.
+ *
+ * Each case builds a module the way UclidEmitter builds it, twice : as is,
+ * and with internal names changed. Renaming must keep the hash, and an edit
+ * of the model must change it :
+ *
+ *     make check_canonical
+ *
+ * Prints one line per case and exits with 1 if any of them fails.
+ *
+*/
+
+#include <cstdio>
+#include <map>
+#include <string>
+
+#include "UclidCanonicalizer.h" // UclidCanonicalizer
+#include "UclidModel.h"     // UclidItem, UclidModule
+
+#ifdef VERIFIC_NAMESPACE
+using namespace Verific ;
+#endif
+
+// Internal names of a module, by their name in the first version
+typedef std::map<std::string, std::string> Names ;
+
+static std::string Name(const Names &names, const char *name)
+{
+    Names::const_iterator ni = names.find(name) ;
+    return (ni != names.end()) ? ni->second : std::string(name) ;
+}
+
+static UclidItem Var(const std::string &name, const char *type)
+{
+    return UclidItem(UclidItem::ITEM_VAR, name, "var " + name + " : " + type + " ;\n") ;
+}
+
+// 'var a : bv8 ; var b : bv1 ;', each a register of the next block. 'a_width' : the width of a.
+static UclidModule Registers(const Names &names, unsigned a_width)
+{
+    std::string a = Name(names, "a"), b = Name(names, "b") ;
+    UclidModule module ;
+    module.name = "regs" ;
+    module.items.push_back(UclidItem(UclidItem::ITEM_INPUT, "clk", "input clk : bv1 ;\n")) ;
+    module.items.push_back(UclidItem(UclidItem::ITEM_INPUT, "d", "input d : bv8 ;\n")) ;
+    module.items.push_back(UclidItem(UclidItem::ITEM_OUTPUT, "q", "output q : bv8 ;\n")) ;
+    module.items.push_back(Var(a, ("bv" + std::to_string(a_width)).c_str())) ;
+    module.items.push_back(Var(b, "bv1")) ;
+    module.items.push_back(UclidItem::Assign(a, "d")) ;
+    module.items.push_back(UclidItem::Assign(b, "clk")) ;
+    module.items.push_back(UclidItem::Assign("q", a)) ;
+    return module ;
+}
+
+// Defines reading each other, a parameter and an instance
+static UclidModule Datapath(const Names &names, unsigned)
+{
+    std::string p = Name(names, "p"), s = Name(names, "s"), t = Name(names, "t"), u = Name(names, "u"), r = Name(names, "r") ;
+    UclidModule module ;
+    module.name = "datapath" ;
+    UclidItem param(UclidItem::ITEM_PARAMETER, p, "var " + p + " : bv8 ;\n") ;
+    param.init = "\t" + p + " = 3bv8 ;\n" ;
+    module.items.push_back(param) ;
+    module.items.push_back(UclidItem(UclidItem::ITEM_INPUT, "x", "input x : bv8 ;\n")) ;
+    module.items.push_back(UclidItem(UclidItem::ITEM_OUTPUT, "y", "output y : bv8 ;\n")) ;
+    module.items.push_back(Var(r, "bv8")) ;
+    module.items.push_back(UclidItem::Define(s, "", 8, "x + " + p)) ;
+    module.items.push_back(UclidItem::Define(t, "", 8, s + "() - 1bv8")) ;
+    UclidItem instance(UclidItem::ITEM_INSTANCE, u, "instance " + u + " : adder(a : (" + t + "()), b : (x), sum : (" + r + ")) ;\n") ;
+    instance.cell = "adder" ;
+    instance.uses.push_back(t) ;
+    instance.uses.push_back("x") ;
+    instance.defines.push_back(r) ;
+    module.items.push_back(instance) ;
+    module.items.push_back(UclidItem(UclidItem::ITEM_STEP, u, "\tnext (" + u + ") ;\n")) ;
+    module.items.push_back(UclidItem::Assign("y", r)) ;
+    return module ;
+}
+
+static std::string Hash(const UclidModule &module)
+{
+    UclidCanonicalizer canonicalizer ;
+    (void) canonicalizer.Canonicalize(module) ;
+    return UclidCanonicalizer::HexImage(canonicalizer.Hash()) ;
+}
+
+// Does the hash of 'build' with 'renamed' and 'width' match it as is (width 8), as 'same' says?
+static unsigned Check(const char *title, UclidModule (*build)(const Names&, unsigned), const Names &renamed, unsigned width, unsigned same)
+{
+    std::string before = Hash(build(Names(), 8)) ;
+    std::string after = Hash(build(renamed, width)) ;
+    unsigned ok = ((before == after) == (same != 0)) ? 1 : 0 ;
+    printf("%s %s : %s %s\n", (ok) ? "ok  " : "FAIL", title, before.c_str(), after.c_str()) ;
+    return ok ;
+}
+
+int main()
+{
+    unsigned ok = 1 ;
+    Names names ;
+
+    names["a"] = "c" ;
+    if (!Check("rename a var", Registers, names, 8, 1)) ok = 0 ;
+
+    names.clear() ;
+    names["a"] = "z" ;
+    names["b"] = "a" ;
+    if (!Check("rename vars past each other", Registers, names, 8, 1)) ok = 0 ;
+
+    names.clear() ;
+    if (!Check("change a width", Registers, names, 4, 0)) ok = 0 ;
+
+    names["s"] = "zz" ;
+    names["t"] = "aa" ;
+    if (!Check("rename defines", Datapath, names, 8, 1)) ok = 0 ;
+
+    names.clear() ;
+    names["p"] = "q0" ;
+    names["u"] = "adder_0" ;
+    names["r"] = "a" ;
+    if (!Check("rename a parameter, an instance and a var", Datapath, names, 8, 1)) ok = 0 ;
+
+    return (ok) ? 0 : 1 ;
+}
@@ -0,0 +1,108 @@
+/*
+ *
+ * Queries on a design index (see DesignIndexReader.h), without Verific.
+ *
+ * The index is written by the translator with -index <file>. Each query maps
+ * it and looks the module up by hash, so it answers in about the time it
+ * takes to start the process :
+ *
+ *     design_query-linux design.idx module mAlu       ports, parameters and location
+ *     design_query-linux design.idx instances mAlu    where it is instantiated
+ *     design_query-linux design.idx modules           every module, roots marked
+ *
+ * Does not link Verific.
+ *
+*/
+
+#include <cstdio>
+#include <cstring>
+
+#include "DesignIndexReader.h" // DesignIndexReader
+
+static void Usage(const char *prog)
+{
+    fprintf(stderr, "usage: %s <index> modules | module <name> | instances <name>\n", prog) ;
+}
+
+static const char *Direction(uint32_t direction)
+{
+    switch (direction) {
+    case DESIGN_INDEX_INPUT :   return "input" ;
+    case DESIGN_INDEX_OUTPUT :  return "output" ;
+    case DESIGN_INDEX_INOUT :   return "inout" ;
+    default :                   return "?" ;
+    }
+}
+
+static void PrintLocation(const DesignIndexReader &index, uint32_t file, uint32_t line)
+{
+    if (file) printf(" %s:%u", index.String(file), line) ;
+    printf("\n") ;
+}
+
+static void PrintModule(const DesignIndexReader &index, uint32_t m)
+{
+    const DesignIndexModule &module = index.Module(m) ;
+    printf("module %s", index.String(module.name)) ;
+    if (!(module.flags & DESIGN_INDEX_DEFINED)) printf(" (not defined)") ;
+    PrintLocation(index, module.file, module.line) ;
+    for (uint32_t i = 0; i < module.num_ports; i++) {
+        const DesignIndexPort &port = index.Port(module.first_port + i) ;
+        printf("port %s %s %u", Direction(port.direction), index.String(port.name), port.width) ;
+        if (port.flags & DESIGN_INDEX_HAS_RANGE) printf(" [%d:%d]", port.msb, port.lsb) ;
+        if (port.flags & DESIGN_INDEX_SIGNED) printf(" signed") ;
+        printf("\n") ;
+    }
+    for (uint32_t i = 0; i < module.num_params; i++) {
+        const DesignIndexParam &param = index.Param(module.first_param + i) ;
+        printf("param %s = %s\n", index.String(param.name), index.String(param.image)) ;
+    }
+}
+
+static void PrintInstances(const DesignIndexReader &index, uint32_t m)
+{
+    const DesignIndexModule &module = index.Module(m) ;
+    for (uint32_t i = 0; i < module.num_sites; i++) {
+        const DesignIndexInstance &inst = index.Instance(module.first_site + i) ;
+        printf("instance %s.%s", index.String(index.Module(inst.parent).name), index.String(inst.name)) ;
+        PrintLocation(index, inst.file, inst.line) ;
+    }
+}
+
+int main(int argc, const char **argv)
+{
+    if (argc < 3) {
+        Usage(argv[0]) ;
+        return 1 ;
+    }
+    DesignIndexReader index ;
+    if (!index.Open(argv[1])) {
+        fprintf(stderr, "%s: not a design index of version %d : %s\n", argv[0], DESIGN_INDEX_VERSION, argv[1]) ;
+        return 1 ;
+    }
+
+    const char *query = argv[2] ;
+    if (strcmp(query, "modules") == 0) {
+        for (uint32_t m = 0; m < index.NumModules(); m++) {
+            const DesignIndexModule &module = index.Module(m) ;
+            printf("%s%s", index.String(module.name), (module.flags & DESIGN_INDEX_ROOT) ? " (root)" : "") ;
+            PrintLocation(index, module.file, module.line) ;
+        }
+        return 0 ;
+    }
+    if (argc < 4 || (strcmp(query, "module") && strcmp(query, "instances"))) {
+        Usage(argv[0]) ;
+        return 1 ;
+    }
+    uint32_t m = index.FindModule(argv[3]) ;
+    if (m == DESIGN_INDEX_NONE) {
+        fprintf(stderr, "%s: module not found : %s\n", argv[0], argv[3]) ;
+        return 1 ;
+    }
+    if (strcmp(query, "module") == 0) {
+        PrintModule(index, m) ;
+    } else {
+        PrintInstances(index, m) ;
+    }
+    return 0 ;
+}
@@ -1,6 +1,8 @@
 using namespace std ;
 #include <bits/stdc++.h>
 #include <fstream>
+#include <sys/resource.h>   // getrusage
+#include <unistd.h>         // STDOUT_FILENO
 #include "Array.h"
 #include "Map.h"
 #include "Set.h"
@@ -11,236 +13,416 @@ using namespace std ;
 #include "VeriExpression.h"
 #include "VeriId.h"
 #include "VeriScope.h"
+#include "VeriLibrary.h"
 #include "VeriRuntimeFlags.h"
 #include "VeriMisc.h"
+#include "UclidEmitter.h"
+#include "UclidVisitor.h"
+#include "UclidTranslator.h"
+#include "TranslationServer.h"
+#include "DependencyScanner.h"
+#include "AsyncWriter.h"
 #ifdef VERIFIC_NAMESPACE
 using namespace Verific ;
 #endif
  //static void TraverseVerilog(const VeriModule *top) ;
 
- int main(int argc, const char **argv)
- {
-     char *file_name = (char *)"alu.v" ;
-     char *top_name = (char *)"mAlu" ;
-     char *work_lib = (char *)"work" ;
-     unsigned vlog_mode = 1 ;
-     veri_file veri_reader ;
-     if (!veri_reader.Analyze(file_name, vlog_mode, work_lib)) return 1 ;
-     if (veri_file::GetModule(top_name)) {
-         if (!veri_file::ElaborateStatic(top_name)) return 0 ;
-         VeriModule *top_module = veri_file::GetModule(top_name) ;
-         if (!top_module) {
-             return 0 ;
-         }
-
+ /*-----------------------------------------------------------------*/
+ //                   Process memory accounting
+ /*-----------------------------------------------------------------*/
 
+ // Read one 'Vm...:  <n> kB' field from /proc/self/status. Returns 0 if unavailable.
+ static unsigned long ReadProcStatusKb(const char *field)
+ {
+     ifstream status("/proc/self/status") ;
+     string line ;
+     size_t len = strlen(field) ;
+     while (getline(status, line)) {
+         if (line.compare(0, len, field) == 0) return strtoul(line.c_str() + len, 0, 10) ;
+     }
+     return 0 ;
+ }
 
+ // Current resident set size in kB
+ static unsigned long CurrentRssKb()
+ {
+     return ReadProcStatusKb("VmRSS:") ;
+ }
 
+ // Resident high-water mark in kB since the last ResetHighWater() call
+ static unsigned long HighWaterKb()
+ {
+     unsigned long hwm = ReadProcStatusKb("VmHWM:") ;
+     if (hwm) return hwm ;
+     struct rusage usage ;
+     if (getrusage(RUSAGE_SELF, &usage) == 0) return (unsigned long)usage.ru_maxrss ;
+     return 0 ;
+ }
+
+ // Reset the kernel's VmHWM counter so it measures the next module only.
+ // Returns 0 if the kernel does not support it (the mark then stays process-wide).
+ static unsigned ResetHighWater()
+ {
+     ofstream clear_refs("/proc/self/clear_refs") ;
+     if (!clear_refs) return 0 ;
+     clear_refs << "5" ;
+     clear_refs.flush() ;
+     return clear_refs.good() ? 1 : 0 ;
+ }
+
+ /*-----------------------------------------------------------------*/
+ //                        Streaming mode
+ /*-----------------------------------------------------------------*/
+
+ // Analyze the files one at a time. Every module that appears in the library
+ // is emitted, then detached from the library and deleted, so only the modules
+ // of the file currently being translated are held in memory. Modules are not
+ // elaborated in this mode, so it only suits designs that translate per module
+ // (such as flat gate-level netlists). The emitter takes the settings of 'translator'.
+ static unsigned StreamTranslate(const Array &files, unsigned vlog_mode, UclidTranslator &translator, ostream &os, ostream &report)
+ {
+     const char *work_lib = translator.WorkLib() ;
+     UclidEmitter emitter(os) ;
+     translator.Configure(emitter) ;
+     unsigned long peak = 0 ;
+     unsigned num_modules = 0 ;
+     unsigned per_module_hwm = 1 ;
+
+     report << "-- streaming report" << endl ;
+
+     unsigned i ;
+     const char *file_name ;
+     FOREACH_ARRAY_ITEM(&files, i, file_name) {
+         if (!translator.Analyze(file_name, vlog_mode)) return 0 ;
+
+         // Collect the names first : we cannot detach while iterating the library map
+         Array names ;
+         MapIter mi ;
+         char *name ;
+         VeriModule *module ;
+         FOREACH_MAP_ITEM(veri_file::AllModules(work_lib), mi, &name, &module) {
+             if (module) names.InsertLast(Strings::save(module->Name())) ;
+         }
 
-         string sparam="";
-         string spardec = "",sparini = "";
-         //module->AnalyzeFull();
-         //top_module->PrettyPrint(cout,0);
-         Array *para = top_module->GetParameters();
-         for(int i=0;i<para->Size();i++){
-           VeriIdDef *param = (VeriIdDef *)para->At(i);
-           string val = param->GetInitialValue()->GetPrettyPrintedString();
-           if(param->IsArray()){
-             //cout<<param->GetMsbOfRange()<<endl;
-             string rang;
-             int app = 0;
-             for(int j=0;j<val.length();j++){
-               char ch = val[j];
-               if(ch != '\'')
-               rang = rang + ch;
-               else {
-                 app = j;
-                 break;
-               }
+         VeriLibrary *lib = veri_file::GetLibrary(work_lib) ;
+         unsigned j ;
+         FOREACH_ARRAY_ITEM(&names, j, name) {
+             if (!ResetHighWater()) per_module_hwm = 0 ;
+             module = veri_file::GetModule(name, 1, work_lib) ;
+             if (module) {
+                 emitter.EmitModule(*module) ;
+                 os.flush() ;
+
+                 unsigned long hwm = HighWaterKb() ;
+                 if (hwm > peak) peak = hwm ;
+                 report << "-- module " << name << " : rss " << CurrentRssKb() << " kB, high-water " << hwm << " kB" << endl ;
+                 num_modules++ ;
+
+                 // Output is written : drop the parse tree of this module
+                 if (lib && lib->DetachModule(module)) delete module ;
              }
-             spardec = spardec + "var " + param->Name() + " : " + "bv" + rang+ " ;\n";
-             sparini = sparini + "\t" + param->Name() + " = " + val.substr(app+2) + "bv" + rang + " ;\n";
-           }//->GetPrettyPrintedString()<<endl;
-           else{
-             spardec = spardec + "var " + param->Name() + " : " + "integer ;\n";
-             sparini = sparini + "\t" + param->Name() + " = " + val + " ;\n";
-           }
+             Strings::free(name) ;
          }
-         sparam = spardec + "init {\n" + sparini + "}\n";
-         cout<<sparam;
-
+     }
 
+     report << "-- " << num_modules << " modules, peak high-water " << peak << " kB" ;
+     if (!per_module_hwm) report << " (process-wide : kernel does not support resetting VmHWM)" ;
+     report << endl ;
+     return 1 ;
+ }
 
+ // Send 'out' to stdout through a background writer (-async)
+ static void OpenOutput(AsyncWriter *&async, ostream &out)
+ {
+     cout.flush() ;
+     async = new AsyncWriter(STDOUT_FILENO) ;
+     (void) out.rdbuf(async) ;
+ }
 
+ // Close the -async output, if any, and report how long the translation waited for it
+ static unsigned CloseOutput(AsyncWriter *&async, ostream &report)
+ {
+     if (!async) return 1 ;
+     unsigned ok = async->Close() ;
+     async->Report(report) ;
+     delete async ;
+     async = 0 ;
+     return ok ;
+ }
+
+ /*-----------------------------------------------------------------*/
+ //                              main
+ /*-----------------------------------------------------------------*/
+
+ static void Usage(const char *prog)
+ {
+     cerr << "usage: " << prog << " [-top <module>] [-lib <library>] [-stream] [-report <file>] [-async] [-scan <path>] [-I <dir>] [-output <kind>] [-keep_dead] [-keep_widths] [-canonical <file>] [-export <file>] [-index <file>] [-partition <dir> [-targets <a,b,...>] [-overlap <percent>] [-max_partitions <n>]] [-unroll <n>] [-inline <n>] [-uf <mul,div,mod>] [-uf_width <n>] [-uf_lemmas] [-blackbox <pattern> ... [-blackbox_uf]] [-server <socket> | -connect <socket>] [file ...]" << endl ;
+     cerr << "    -top <module>    top level module to elaborate and translate (default mAlu)" << endl ;
+     cerr << "    -lib <library>   work library name (default work)" << endl ;
+     cerr << "    -stream          emit every module and unload it right away (no elaboration)" << endl ;
+     cerr << "    -report <file>   write the translation report here instead of stderr" << endl ;
+     cerr << "    -async           write the output from a background thread, and report the time spent waiting for it" << endl ;
+     cerr << "    -scan <path>     scan a file or directory tree and analyze only the files the top needs" << endl ;
+     cerr << "    -I <dir>         `include search directory" << endl ;
+     cerr << "    -output <kind>   uclid (default) or pretty" << endl ;
+     cerr << "    -keep_dead       keep the signals and parameters that cannot reach an output" << endl ;
+     cerr << "    -keep_widths     declare internal signals with their full width, even if only low bits are used" << endl ;
+     cerr << "    -canonical <file> write the model in canonical form and the content hash of each module to this file" << endl ;
+     cerr << "    -export <file>   write the elaborated tree to this file in binary (see ParseTreeReader.h) instead of the model" << endl ;
+     cerr << "    -index <file>    also write an index of the modules, their ports, parameters and instances (see design_query)" << endl ;
+     cerr << "    -partition <dir> write one model per group of outputs with overlapping cones into dir, with a manifest" << endl ;
+     cerr << "    -targets <a,b,...> outputs of the top to partition (default all)" << endl ;
+     cerr << "    -overlap <percent> group outputs whose cones share this part of the smaller one (default 50)" << endl ;
+     cerr << "    -max_partitions <n> merge the closest partitions down to n" << endl ;
+     cerr << "    -unroll <n>      unroll at most n iterations of procedural loops per always block (default 4096)" << endl ;
+     cerr << "    -inline <n>      inline the functions whose value is at most n characters long (default 64)" << endl ;
+     cerr << "    -uf <mul,div,mod> emit these operators as uninterpreted functions, one per width" << endl ;
+     cerr << "    -uf_width <n>    only those at least n bits wide (all three if -uf is not given)" << endl ;
+     cerr << "    -uf_lemmas       add axioms for their identities (x * 1 == x, x * y == y * x ...)" << endl ;
+     cerr << "    -blackbox <pattern> emit the modules matching pattern (* and ? wildcards) as their ports only, outputs free" << endl ;
+     cerr << "    -blackbox_uf     make the outputs of black boxes uninterpreted functions of their inputs" << endl ;
+     cerr << "    -server <socket> analyze the files once, then serve translation requests on this socket" << endl ;
+     cerr << "    -connect <socket> have the server on this socket translate the files" << endl ;
+ }
 
-         Array *por = top_module->GetPorts();
-         string spor = "";
-         //top_module->PrettyPrintPortConnects(cout,0);
-         for(int i=0;i<por->Size();i++){
-           VeriIdDef *po = (VeriIdDef *)por->At(i);
-           if(po->IsInput()){
-             if(po->IsArray()){
-               string stri = to_string(po->GetMsbOfRange()+1);
-               spor = spor + "input " + po->GetPrettyPrintedString() + " : " + "bv"+stri + " ;\n";
-               }
-             else{
-               spor = spor + "input " + po->GetPrettyPrintedString() + " : " + "bv1 ;\n";
+ int main(int argc, const char **argv)
+ {
+     const char *top_name = "mAlu" ;
+     const char *work_lib = "work" ;
+     const char *report_name = 0 ;
+     const char *hashes_name = 0 ;
+     const char *export_name = 0 ;
+     const char *index_name = 0 ;
+     const char *partition_dir = 0 ;
+     vector<string> targets ;
+     unsigned overlap = 0 ;
+     unsigned max_partitions = 0 ;
+     unsigned uf_operators = 0 ;
+     unsigned uf_min_width = 0 ;
+     unsigned uf_lemmas = 0 ;
+     vector<string> black_boxes ;
+     unsigned black_box_functions = 0 ;
+     const char *output = "uclid" ;
+     const char *server_socket = 0 ;
+     const char *client_socket = 0 ;
+     unsigned stream_mode = 0 ;
+     unsigned async_output = 0 ;
+     unsigned prune = 1 ;
+     unsigned narrow = 1 ;
+     unsigned unroll = 0 ;
+     unsigned inline_limit = 0 ;
+     unsigned vlog_mode = 1 ;
+     Array files ;
+     Array scan_paths ;
+     Array include_dirs ;
+
+     for (int i = 1; i < argc; i++) {
+         if (Strings::compare(argv[i], "-top") && (i+1 < argc)) {
+             top_name = argv[++i] ;
+         } else if (Strings::compare(argv[i], "-lib") && (i+1 < argc)) {
+             work_lib = argv[++i] ;
+         } else if (Strings::compare(argv[i], "-report") && (i+1 < argc)) {
+             report_name = argv[++i] ;
+         } else if (Strings::compare(argv[i], "-canonical") && (i+1 < argc)) {
+             hashes_name = argv[++i] ;
+         } else if (Strings::compare(argv[i], "-export") && (i+1 < argc)) {
+             export_name = argv[++i] ;
+         } else if (Strings::compare(argv[i], "-index") && (i+1 < argc)) {
+             index_name = argv[++i] ;
+         } else if (Strings::compare(argv[i], "-partition") && (i+1 < argc)) {
+             partition_dir = argv[++i] ;
+         } else if (Strings::compare(argv[i], "-targets") && (i+1 < argc)) {
+             string list = argv[++i] ;
+             size_t start = 0 ;
+             while (start <= list.size()) {
+                 size_t comma = list.find(',', start) ;
+                 if (comma == string::npos) comma = list.size() ;
+                 if (comma > start) targets.push_back(list.substr(start, comma - start)) ;
+                 start = comma + 1 ;
              }
-           }
-           else {
-             if(po->IsArray()){
-               spor = spor + "output " + po->GetPrettyPrintedString() + " : " + "bv"+to_string(po->GetMsbOfRange()+1) + " ;\n";
-               }
-             else{
-               spor = spor + "output " + po->GetPrettyPrintedString() + " : " + "bv1 ;\n";
+         } else if (Strings::compare(argv[i], "-overlap") && (i+1 < argc)) {
+             overlap = (unsigned)strtoul(argv[++i], 0, 10) ;
+             if (!overlap || (overlap > 100)) {
+                 Usage(argv[0]) ;
+                 return 1 ;
              }
-           }
-
+         } else if (Strings::compare(argv[i], "-max_partitions") && (i+1 < argc)) {
+             max_partitions = (unsigned)strtoul(argv[++i], 0, 10) ;
+         } else if (Strings::compare(argv[i], "-unroll") && (i+1 < argc)) {
+             unroll = (unsigned)strtoul(argv[++i], 0, 10) ;
+             if (!unroll) {
+                 Usage(argv[0]) ;
+                 return 1 ;
+             }
+         } else if (Strings::compare(argv[i], "-inline") && (i+1 < argc)) {
+             inline_limit = (unsigned)strtoul(argv[++i], 0, 10) ;
+         } else if (Strings::compare(argv[i], "-uf") && (i+1 < argc)) {
+             string list = argv[++i] ;
+             size_t start = 0 ;
+             while (start <= list.size()) {
+                 size_t comma = list.find(',', start) ;
+                 if (comma == string::npos) comma = list.size() ;
+                 string oper = list.substr(start, comma - start) ;
+                 if (oper == "mul") {
+                     uf_operators |= UCLID_UF_MUL ;
+                 } else if (oper == "div") {
+                     uf_operators |= UCLID_UF_DIV ;
+                 } else if (oper == "mod") {
+                     uf_operators |= UCLID_UF_MOD ;
+                 } else if (!oper.empty()) {
+                     Usage(argv[0]) ;
+                     return 1 ;
+                 }
+                 start = comma + 1 ;
+             }
+         } else if (Strings::compare(argv[i], "-uf_width") && (i+1 < argc)) {
+             uf_min_width = (unsigned)strtoul(argv[++i], 0, 10) ;
+         } else if (Strings::compare(argv[i], "-uf_lemmas")) {
+             uf_lemmas = 1 ;
+         } else if (Strings::compare(argv[i], "-blackbox") && (i+1 < argc)) {
+             black_boxes.push_back(argv[++i]) ;
+         } else if (Strings::compare(argv[i], "-blackbox_uf")) {
+             black_box_functions = 1 ;
+         } else if (Strings::compare(argv[i], "-scan") && (i+1 < argc)) {
+             scan_paths.InsertLast(argv[++i]) ;
+         } else if (Strings::compare(argv[i], "-I") && (i+1 < argc)) {
+             include_dirs.InsertLast(argv[++i]) ;
+         } else if (Strings::compare(argv[i], "-output") && (i+1 < argc)) {
+             output = argv[++i] ;
+         } else if (Strings::compare(argv[i], "-server") && (i+1 < argc)) {
+             server_socket = argv[++i] ;
+         } else if (Strings::compare(argv[i], "-connect") && (i+1 < argc)) {
+             client_socket = argv[++i] ;
+         } else if (Strings::compare(argv[i], "-stream")) {
+             stream_mode = 1 ;
+         } else if (Strings::compare(argv[i], "-async")) {
+             async_output = 1 ;
+         } else if (Strings::compare(argv[i], "-keep_dead")) {
+             prune = 0 ;
+         } else if (Strings::compare(argv[i], "-keep_widths")) {
+             narrow = 0 ;
+         } else if (argv[i][0] == '-') {
+             Usage(argv[0]) ;
+             return 1 ;
+         } else {
+             files.InsertLast(argv[i]) ;
          }
-         cout<<spor;
-
-
+     }
+     if (!files.Size() && !scan_paths.Size() && !server_socket) files.InsertLast("alu.v") ;
+     if (uf_min_width && !uf_operators) uf_operators = UCLID_UF_MUL | UCLID_UF_DIV | UCLID_UF_MOD ;
+     if (!Strings::compare(output, "uclid") && !Strings::compare(output, "pretty")) {
+         Usage(argv[0]) ;
+         return 1 ;
+     }
+     // -stream only emits the UCLID model, module by module
+     if (stream_mode) {
+         const char *conflict = 0 ;
+         if (Strings::compare(output, "pretty")) conflict = "-output pretty" ;
+         if (export_name) conflict = "-export" ;
+         if (partition_dir) conflict = "-partition" ;
+         if (index_name) conflict = "-index" ;
+         if (server_socket) conflict = "-server" ;
+         if (client_socket) conflict = "-connect" ;
+         if (conflict) {
+             Message::Error(0, "-stream cannot be combined with ", conflict) ;
+             return 1 ;
+         }
+     }
 
+     ofstream report_file ;
+     if (report_name) {
+         report_file.open(report_name) ;
+         if (!report_file) {
+             Message::Error(0, "cannot open file ", report_name) ;
+             return 1 ;
+         }
+     }
+     ostream &report = (report_name) ? report_file : cerr ;
+
+     ofstream hashes ;
+     if (hashes_name) {
+         hashes.open(hashes_name) ;
+         if (!hashes) {
+             Message::Error(0, "cannot open file ", hashes_name) ;
+             return 1 ;
+         }
+     }
 
+     unsigned i ;
+     const char *dir ;
+     FOREACH_ARRAY_ITEM(&include_dirs, i, dir) veri_file::AddIncludeDir(dir) ;
+
+     // Pre-analysis scan : only hand the files reachable from the top to Analyze
+     vector<string> needed ;
+     if (scan_paths.Size()) {
+         DependencyScanner scanner ;
+         FOREACH_ARRAY_ITEM(&include_dirs, i, dir) scanner.AddIncludeDir(dir) ;
+         const char *path ;
+         FOREACH_ARRAY_ITEM(&scan_paths, i, path) {
+             if (!scanner.AddPath(path)) Message::Warning(0, "cannot scan ", path) ;
+         }
+         if (!scanner.ComputeClosure(top_name, needed)) {
+             Message::Error(0, "top level module not found by dependency scan : ", top_name) ;
+             return 1 ;
+         }
+         report << "-- dependency scan : " << scanner.NumFiles() << " files (" << scanner.NumBytes() << " bytes), "
+                << scanner.NumModules() << " design units, " << needed.size() << " files needed for " << top_name << endl ;
+         for (unsigned j = 0; j < needed.size(); j++) files.InsertLast(needed[j].c_str()) ;
+     }
 
+     // Client : the server does the work
+     if (client_socket) return TranslationServer::Request(client_socket, files, top_name, output, cout) ? 0 : 1 ;
+
+     // The model goes to stdout, through a background writer with -async
+     AsyncWriter *async = 0 ;
+     ostream out(cout.rdbuf()) ;
+
+     UclidTranslator translator(work_lib) ;
+     translator.SetPruning(prune, &report) ;
+     translator.SetNarrowing(narrow, &report) ;
+     if (hashes_name) translator.SetCanonical(1, &hashes) ;
+     translator.SetUnrollLimit(unroll) ;
+     translator.SetInlining(inline_limit, &report) ;
+     translator.SetUninterpreted(uf_operators, uf_min_width, uf_lemmas, &report) ;
+     translator.SetBlackBoxes(black_boxes, black_box_functions, &report) ;
+     translator.SetPartitioning(overlap, max_partitions, &report) ;
+
+     if (stream_mode) {
+         if (async_output) OpenOutput(async, out) ;
+         unsigned streamed = StreamTranslate(files, vlog_mode, translator, out, report) ;
+         if (!CloseOutput(async, report)) streamed = 0 ;
+         return (streamed) ? 0 : 1 ;
+     }
 
+     const char *file_name ;
+     FOREACH_ARRAY_ITEM(&files, i, file_name) {
+         if (!translator.Analyze(file_name, vlog_mode)) return 1 ;
+     }
 
-         Array *items = top_module->GetItems();
-         string sreg = "";
-         for(int i=0;i<items->Size();i++){
-           VeriModuleItem *item =(VeriModuleItem *) items->At(i);
-           if(item->IsRegDecl()){
-             //cout<<item->GetPrettyPrintedString();
-             if(item->GetDataType()->GetDimensions()){
-               string s = item->GetPrettyPrintedString();
-               int flag = 0;
-               string svar = "";
-               for(int j=0;j<s.length();j++){
-                 char c = s[j];
-                 if(c==']'){
-                 flag = 1;
-                 continue;
-               }
+     // Server : the files analyzed so far are shared by all requests
+     if (server_socket) {
+         TranslationServer server(translator, server_socket) ;
+         return server.Run() ? 0 : 1 ;
+     }
 
-                 if(flag == 1 && c != ' ' && c != ',' && c!=';'){
-                   svar = svar + c;
-                 }
-                 else if(c == ',' || c == ';'){
-                   sreg = sreg + "var " + svar + " : " + "bv" + to_string(item->GetDataType()->GetDimensions()->GetMsbOfRange() + 1) + " ;\n";
-                   svar = "";
-                 }
-               }
-              }
-              else {
-                string s = item->GetPrettyPrintedString();
-                int flag = 0;
-                string svar = "";
-                for(int j=0;j<s.length();j++){
-                  char c = s[j];
-                  if(c==' '){
-                    flag = 1;
-                    continue;
-                  }                  
-                  if(flag == 1 && c != ' ' && c != ',' && c!=';'){
-                    svar = svar + c;
-                  }
-                  else if(c == ',' || c == ';'){
-                    sreg = sreg + "var " + svar + " : " + "bv" + "1" + " ;\n";
-                    svar = "";
-                  }
-                }
-              }
-           }
-         }
-         cout<<sreg;
-         /*Array *re = (Array *)top_module->GetNetAssigns();
-         Map *ma = (Map *)top_module->GetAttributes();
-         cout<<"sdmvsfdf;gkd;fl"<<endl;
-         cout<<top_module<<endl;
-         if(!re){
-           cout<<"Hello f"<<re<<endl;
-         }
-         if(!ma){
-           cout<<"Hello f"<<ma<<endl;
-         }
-         cout<<re->Size();*/
-
-         /*for(int i=0;i<re->Size();i++){
-           VeriNetRegAssign *regis = (VeriNetRegAssign *)re->At(i);
-           cout<<regis->GetPrettyPrintedString();
-         }*/
-         /*Array *items = top_module->GetItems();
-         for(int i=0;i<items->Size();i++){
-           VeriModuleItem *item = (VeriModuleItem *)items->At(i);
-           /*string s = item->GetPrettyPrintedString();
-            vector <string> vs;
-            string vss = "";
-            int bloc = 0;
-            for(int j = 0;j<s.length();j++){
-              char ch = s[j];
-              if ((ch == " " || ch == ";" || ch == ",") && bloc == 0){
-
-              }
-              else if(ch == "[")
-              bloc = 1;
-              else if(ch == "]")
-              bloc = 0;
-              else if(ch == "(" || ch == ")")
-              continue;
-              else if
-            }
-            if(item->IsRegDecl()){
-              cout<<item->GetPrettyPrintedString()<<endl;
-            }
-         }*/
-
-
-
-
-
-
-
-
-
-
-         /*
-           string s = item->GetPrettyPrintedString();
-           //cout<<s;
-           string s1 = "";
-           int fs = 0;
-           vector <string> v;
-           for(int i=0;i<s.length();i++){
-             char c = s[i];
-             if(c != ' ')
-             s1 = s1 + c;
-             else{
-               fs = i;
-             break;
-           }
-           }
-           cout<<s1<<endl;
-           if( s1 == "wire"){
-
-           }
-           else if ( s1 == "input"){
-
-           }
-           else if(s1 == "output"){
-
-           }
-           else if(s1 == "parameter"){
-
-           }
-           else if(s1 == "reg"){
-
-           }
-           else if(s1 == )
-         }*/
-
-         //cout<<param->Name()<<endl;
-         top_module->Info("Start hierarchy traversal here at Verilog top level module '%s'", top_module->Name()) ;
+     if (async_output) OpenOutput(async, out) ;
+     unsigned ok = 1 ;
+     if (export_name) {
+         ok = translator.ExportTree(top_name, export_name) ;
+     } else if (partition_dir) {
+         ok = translator.TranslatePartitions(top_name, targets, partition_dir) ;
+     } else if (Strings::compare(output, "pretty")) {
+         ok = translator.PrettyPrint(top_name, out) ;
+     } else if (veri_file::GetModule(top_name, 1, work_lib) && translator.TranslateUclid(top_name, out)) {
+         VeriModule *top_module = veri_file::GetModule(top_name, 1, work_lib) ;
+         if (top_module) top_module->Info("Start hierarchy traversal here at Verilog top level module '%s'", top_module->Name()) ;
         // TraverseVerilog(top_module) ; // Traverse top level module and the hierarchy under it
      }
 
-     return 0 ; // all good
+     if (!CloseOutput(async, report)) ok = 0 ;
+
+     // The index covers the library as analyzed, and elaborated by the run above
+     if (index_name && !translator.WriteIndex(index_name)) return 1 ;
+
+     return (ok) ? 0 : 1 ; // all good
 }